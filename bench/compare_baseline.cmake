@@ -0,0 +1,23 @@
+# Script behind the bench-compare target: runs the benchmarks recorded in BASELINE again and checks
+# them against it with COMPARE. Baselines only mean something on the machine that recorded them,
+# so without one the comparison is skipped rather than failed.
+#
+#     cmake -DBENCH=<run_bench> -DCOMPARE=<bench_compare> -DBASELINE=<baseline.json> -DCURRENT=<out.json>
+#           -DFILTER=<regex> -DTOLERANCE=<percent> -P compare_baseline.cmake
+
+if (NOT EXISTS "${BASELINE}")
+  message(STATUS "No benchmark baseline at ${BASELINE}, skipping the comparison; build bench-baseline to record one")
+  return()
+endif()
+
+execute_process(
+  COMMAND "${BENCH}" "--benchmark_filter=${FILTER}" "--benchmark_out=${CURRENT}" --benchmark_out_format=json
+  RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "run_bench failed: ${result}")
+endif()
+
+execute_process(COMMAND "${COMPARE}" "${BASELINE}" "${CURRENT}" "${TOLERANCE}" RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "Benchmarks regressed against ${BASELINE}")
+endif()
@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Compares two JSON reports of run_bench (`--benchmark_out_format=json`), a recorded baseline
+ * and a new run, benchmark by benchmark.
+ *
+ *     bench_compare <baseline.json> <current.json> [tolerance percent, default 10]
+ *
+ * Prints the time of every benchmark present in both reports and the change against the baseline,
+ * and exits with status 1 when any of them got slower by more than the tolerance.
+ */
+#include <cstdio>   // std::printf
+#include <cstdlib>  // std::strtod
+#include <fstream>  // std::ifstream
+#include <iostream> // std::cerr
+#include <map>      // std::map
+#include <sstream>  // std::stringstream
+#include <string>   // std::string
+
+namespace
+{
+/// Returns the value of the string field `key` in `object`, or an empty string.
+std::string string_field(const std::string &object, const std::string &key)
+{
+    std::string::size_type at = object.find("\"" + key + "\": \"");
+    if (at == std::string::npos)
+        return std::string();
+    at += key.size() + 5;
+    return object.substr(at, object.find('"', at) - at);
+}
+
+/// Returns the value of the number field `key` in `object`, or -1.
+double number_field(const std::string &object, const std::string &key)
+{
+    std::string::size_type at = object.find("\"" + key + "\": ");
+    if (at == std::string::npos)
+        return -1;
+    return std::strtod(object.c_str() + at + key.size() + 4, nullptr);
+}
+
+/// Returns the factor converting `unit` to nanoseconds.
+double to_ns(const std::string &unit)
+{
+    return unit == "s" ? 1e9 : unit == "ms" ? 1e6 : unit == "us" ? 1e3 : 1;
+}
+
+/// Reads the real time, in nanoseconds, of every iteration run in the report at `path`.
+bool read_report(const char *path, std::map<std::string, double> &times)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string json = text.str();
+
+    // Each run is a flat object of the "benchmarks" array; aggregates of repetitions are skipped.
+    std::string::size_type at = json.find("\"benchmarks\"");
+    while (at != std::string::npos && (at = json.find('{', at)) != std::string::npos)
+    {
+        std::string::size_type end = json.find('}', at);
+        std::string object = json.substr(at, end - at);
+        at = end;
+        if (string_field(object, "run_type") == "aggregate")
+            continue;
+        std::string name = string_field(object, "name");
+        double time = number_field(object, "real_time");
+        if (!name.empty() && time >= 0)
+            times[name] = time * to_ns(string_field(object, "time_unit"));
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <baseline.json> <current.json> [tolerance percent]\n";
+        return 2;
+    }
+    double tolerance = argc > 3 ? std::strtod(argv[3], nullptr) : 10;
+
+    std::map<std::string, double> baseline, current;
+    if (!read_report(argv[1], baseline) || !read_report(argv[2], current))
+    {
+        std::cerr << "cannot read " << (baseline.empty() ? argv[1] : argv[2]) << "\n";
+        return 2;
+    }
+
+    int regressions = 0;
+    std::printf("%-48s %14s %14s %9s\n", "Benchmark", "Baseline (ns)", "Current (ns)", "Change");
+    for (const auto &entry : current)
+    {
+        auto base = baseline.find(entry.first);
+        if (base == baseline.end())
+            continue;
+        double change = (entry.second / base->second - 1) * 100;
+        bool slower = change > tolerance;
+        regressions += slower;
+        std::printf("%-48s %14.1f %14.1f %+8.1f%%%s\n", entry.first.c_str(), base->second, entry.second, change,
+                    slower ? "  SLOWER" : "");
+    }
+    if (regressions > 0)
+        std::printf("%d benchmark(s) slower than the baseline by more than %.0f%%\n", regressions, tolerance);
+    return regressions > 0 ? 1 : 0;
+}
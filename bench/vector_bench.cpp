@@ -0,0 +1,808 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "benchmark/benchmark.h"             // google benchmark lib
+#include "../include/vector.h"              // header file for benchmarked functions
+#include "../include/flat_map.h"            // header file for benchmarked functions
+#include "../include/static_search_index.h" // header file for benchmarked functions
+#include "../include/segmented_vector.h"    // header file for benchmarked functions
+#include "../include/bit_vector.h"          // header file for benchmarked functions
+#include "../include/ndarray.h"             // header file for benchmarked functions
+#include "../include/vector_expr.h"         // header file for benchmarked functions
+#include "../include/vector_pool.h"         // header file for benchmarked functions
+#include "../include/vector_bulk.h"         // header file for benchmarked functions
+#include "../include/sharded_vector.h"      // header file for benchmarked functions
+#include "../include/byte_buffer.h"         // header file for benchmarked functions
+
+// ============================================================================
+// BENCHMARKING VECTOR OPERATIONS
+// This suite is also the training run of the profile-guided build (see README).
+// ============================================================================
+
+static void BM_PushBack(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        sc::vector<int> vec;
+        for (auto i{0}; i < state.range(0); ++i)
+            vec.push_back(i);
+        benchmark::DoNotOptimize(vec[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PushBack)->Range(8, 1 << 20);
+
+static void BM_SegmentedPushBack(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        sc::segmented_vector<int> vec;
+        for (auto i{0}; i < state.range(0); ++i)
+            vec.push_back(i);
+        benchmark::DoNotOptimize(vec[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SegmentedPushBack)->Range(8, 1 << 20);
+
+static void BM_PushBackReserved(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        sc::vector<int> vec;
+        vec.reserve(state.range(0));
+        for (auto i{0}; i < state.range(0); ++i)
+            vec.push_back(i);
+        benchmark::DoNotOptimize(vec[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PushBackReserved)->Range(8, 1 << 20);
+
+static void BM_CopyConstruct(benchmark::State &state)
+{
+    sc::vector<int> source(state.range(0));
+    source.assign(state.range(0), 42);
+
+    for (auto _ : state)
+    {
+        sc::vector<int> copy(source);
+        benchmark::DoNotOptimize(copy[0]);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(int));
+}
+BENCHMARK(BM_CopyConstruct)->Range(8, 1 << 22);
+
+static void BM_AssignCountValue(benchmark::State &state)
+{
+    sc::vector<int> vec;
+
+    for (auto _ : state)
+    {
+        vec.assign(state.range(0), 7);
+        benchmark::DoNotOptimize(vec[0]);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(int));
+}
+BENCHMARK(BM_AssignCountValue)->Range(8, 1 << 22);
+
+static void BM_IndexSum(benchmark::State &state)
+{
+    sc::vector<int> vec;
+    vec.assign(state.range(0), 1);
+
+    for (auto _ : state)
+    {
+        long sum{0};
+        for (auto i{0u}; i < vec.size(); ++i)
+            sum += vec[i];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IndexSum)->Range(8, 1 << 20);
+
+static void BM_InsertFront(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        sc::vector<int> vec;
+        for (auto i{0}; i < state.range(0); ++i)
+            vec.insert(vec.begin(), i);
+        benchmark::DoNotOptimize(vec[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InsertFront)->Range(8, 1 << 12);
+
+static void BM_EraseFront(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sc::vector<int> vec;
+        vec.assign(state.range(0), 3);
+        state.ResumeTiming();
+
+        while (not vec.empty())
+            vec.erase(vec.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EraseFront)->Range(8, 1 << 12);
+
+static void BM_PushBackString(benchmark::State &state)
+{
+    const std::string payload(32, 'x');
+
+    for (auto _ : state)
+    {
+        sc::vector<std::string> vec;
+        for (auto i{0}; i < state.range(0); ++i)
+            vec.push_back(payload);
+        benchmark::DoNotOptimize(vec[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PushBackString)->Range(8, 1 << 16);
+
+/// Looks up every key of a table of `range(0)` pairs, in a scattered order.
+template <typename Map>
+static void lookup_table(benchmark::State &state)
+{
+    const long n = state.range(0);
+    Map map;
+    for (long i = 0; i < n; ++i)
+        map.insert({i * 2, i});
+
+    for (auto _ : state)
+    {
+        long hits = 0;
+        for (long i = 0; i < n; ++i)
+            hits += map.count(((i * 7919) % n) * 2);
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_FlatMapLookup(benchmark::State &state)
+{
+    lookup_table<sc::flat_map<long, long>>(state);
+}
+BENCHMARK(BM_FlatMapLookup)->Range(64, 1 << 16);
+
+static void BM_StdMapLookup(benchmark::State &state)
+{
+    lookup_table<std::map<long, long>>(state);
+}
+BENCHMARK(BM_StdMapLookup)->Range(64, 1 << 16);
+
+/// `range(0)` sorted keys and 4096 scattered queries over them.
+struct search_fixture
+{
+    sc::vector<std::uint64_t> keys;
+    sc::vector<std::uint64_t> queries;
+
+    explicit search_fixture(long n)
+    {
+        for (long i = 0; i < n; ++i)
+            keys.push_back(3 * i);
+        for (long i = 0; i < 4096; ++i)
+            queries.push_back((i * 2654435761u) % (3 * n));
+    }
+};
+
+static void BM_SortedLowerBound(benchmark::State &state)
+{
+    search_fixture f(state.range(0));
+
+    for (auto _ : state)
+    {
+        unsigned long sum = 0;
+        for (auto i{0u}; i < f.queries.size(); ++i)
+            sum += std::lower_bound(f.keys.data(), f.keys.data() + f.keys.size(), f.queries[i]) - f.keys.data();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * f.queries.size());
+}
+BENCHMARK(BM_SortedLowerBound)->Range(1 << 10, 1 << 24);
+
+static void BM_EytzingerLowerBound(benchmark::State &state)
+{
+    search_fixture f(state.range(0));
+    sc::static_search_index<std::uint64_t> index(f.keys);
+
+    for (auto _ : state)
+    {
+        unsigned long sum = 0;
+        for (auto i{0u}; i < f.queries.size(); ++i)
+            sum += index.lower_bound(f.queries[i]);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * f.queries.size());
+}
+BENCHMARK(BM_EytzingerLowerBound)->Range(1 << 10, 1 << 24);
+
+static void BM_EytzingerLowerBoundBatch(benchmark::State &state)
+{
+    search_fixture f(state.range(0));
+    sc::static_search_index<std::uint64_t> index(f.keys);
+    sc::vector<unsigned long> ranks;
+    ranks.assign(f.queries.size(), 0ul);
+
+    for (auto _ : state)
+    {
+        index.lower_bound(f.queries, ranks);
+        benchmark::DoNotOptimize(ranks.data());
+    }
+    state.SetItemsProcessed(state.iterations() * f.queries.size());
+}
+BENCHMARK(BM_EytzingerLowerBoundBatch)->Range(1 << 10, 1 << 24);
+
+static void BM_BitVectorAndCount(benchmark::State &state)
+{
+    sc::bit_vector rows(state.range(0)), visible(state.range(0));
+    for (long i = 0; i < state.range(0); i += 3)
+        rows[i] = true;
+    for (long i = 0; i < state.range(0); i += 5)
+        visible[i] = true;
+
+    for (auto _ : state)
+    {
+        sc::bit_vector mask(rows);
+        mask &= visible;
+        benchmark::DoNotOptimize(mask.count());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) / 8);
+}
+BENCHMARK(BM_BitVectorAndCount)->Range(1 << 10, 1 << 24);
+
+static void BM_HashVector(benchmark::State &state)
+{
+    sc::vector<std::uint8_t> bytes;
+    for (long i = 0; i < state.range(0); i++)
+        bytes.push_back(std::uint8_t(i * 131));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::hash<sc::vector<std::uint8_t>>()(bytes));
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HashVector)->Range(16, 1 << 20);
+
+static void BM_HashElementwise(benchmark::State &state)
+{
+    sc::vector<std::uint8_t> bytes;
+    for (long i = 0; i < state.range(0); i++)
+        bytes.push_back(std::uint8_t(i * 131));
+
+    for (auto _ : state)
+    {
+        std::size_t h = 0;
+        for (auto i(0u); i < bytes.size(); i++)
+            h ^= std::hash<std::uint8_t>()(static_cast<const sc::vector<std::uint8_t> &>(bytes)[i]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        benchmark::DoNotOptimize(h);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HashElementwise)->Range(16, 1 << 20);
+
+/// Short keys with a long common prefix, as in a sorted index of composite keys.
+template <typename T>
+static sc::vector<sc::vector<T>> make_sort_keys(long count)
+{
+    sc::vector<sc::vector<T>> keys;
+    std::uint32_t seed = 12345;
+    for (long i = 0; i < count; i++)
+    {
+        sc::vector<T> key;
+        for (int k = 0; k < 24; k++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            key.push_back(T(k < 16 ? k : (seed >> 24) % 4));
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+template <typename T>
+static void BM_SortKeys(benchmark::State &state)
+{
+    sc::vector<sc::vector<T>> keys = make_sort_keys<T>(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sc::vector<sc::vector<T>> copy(keys);
+        state.ResumeTiming();
+        std::sort(copy.begin(), copy.end());
+        benchmark::DoNotOptimize(copy[0]);
+    }
+}
+BENCHMARK_TEMPLATE(BM_SortKeys, std::uint8_t)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_SortKeys, int)->Range(1 << 10, 1 << 16);
+
+template <typename T>
+static void BM_SortKeysElementwise(benchmark::State &state)
+{
+    sc::vector<sc::vector<T>> keys = make_sort_keys<T>(state.range(0));
+    auto less = [](const sc::vector<T> &a, const sc::vector<T> &b) {
+        for (auto i(0u); i < a.size() && i < b.size(); i++)
+            if (a.data()[i] != b.data()[i])
+                return a.data()[i] < b.data()[i];
+        return a.size() < b.size();
+    };
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sc::vector<sc::vector<T>> copy(keys);
+        state.ResumeTiming();
+        std::sort(copy.begin(), copy.end(), less);
+        benchmark::DoNotOptimize(copy[0]);
+    }
+}
+BENCHMARK_TEMPLATE(BM_SortKeysElementwise, std::uint8_t)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_SortKeysElementwise, int)->Range(1 << 10, 1 << 16);
+
+/// Filling a vector from a buffer that was read elsewhere, element by element.
+static void BM_FillPushBack(benchmark::State &state)
+{
+    sc::vector<std::uint8_t> source;
+    source.resize(state.range(0), 1);
+    for (auto _ : state)
+    {
+        sc::vector<std::uint8_t> vec;
+        vec.reserve(state.range(0));
+        for (auto i(0u); i < source.size(); i++)
+            vec.push_back(source.data()[i]);
+        benchmark::DoNotOptimize(vec.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FillPushBack)->Range(1 << 10, 1 << 22);
+
+/// The same fill, sizing the vector once and copying into data().
+static void BM_FillResizeForOverwrite(benchmark::State &state)
+{
+    sc::vector<std::uint8_t> source;
+    source.resize(state.range(0), 1);
+    for (auto _ : state)
+    {
+        sc::vector<std::uint8_t> vec;
+        std::memcpy(vec.resize_for_overwrite(state.range(0)), source.data(), source.size());
+        benchmark::DoNotOptimize(vec.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FillResizeForOverwrite)->Range(1 << 10, 1 << 22);
+
+/// Transposing a row-major float matrix with two plain loops; every write of a column misses.
+static void BM_TransposeNaive(benchmark::State &state)
+{
+    unsigned long n = state.range(0);
+    sc::ndarray<float, 2> src({n, n}, 1.0f), dst({n, n});
+    for (auto _ : state)
+    {
+        for (unsigned long i = 0; i < n; i++)
+            for (unsigned long j = 0; j < n; j++)
+                dst.data()[j * n + i] = src.data()[i * n + j];
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetBytesProcessed(state.iterations() * n * n * sizeof(float));
+}
+BENCHMARK(BM_TransposeNaive)->RangeMultiplier(4)->Range(64, 4096);
+
+/// The same transpose through sc::transpose, which walks the matrices in cache-sized blocks.
+static void BM_TransposeBlocked(benchmark::State &state)
+{
+    unsigned long n = state.range(0);
+    sc::ndarray<float, 2> src({n, n}, 1.0f), dst({n, n});
+    for (auto _ : state)
+    {
+        sc::transpose(dst.view(), src.view());
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetBytesProcessed(state.iterations() * n * n * sizeof(float));
+}
+BENCHMARK(BM_TransposeBlocked)->RangeMultiplier(4)->Range(64, 4096);
+
+/// Transposing between tiled matrices, one tile at a time.
+static void BM_TransposeTiled(benchmark::State &state)
+{
+    unsigned long n = state.range(0);
+    sc::ndarray<float, 2, sc::layout_tiled<8>> src({n, n}, 1.0f), dst({n, n});
+    for (auto _ : state)
+    {
+        sc::transpose(dst.view(), src.view());
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetBytesProcessed(state.iterations() * n * n * sizeof(float));
+}
+BENCHMARK(BM_TransposeTiled)->RangeMultiplier(4)->Range(64, 4096);
+
+/// Summing a float array with one accumulator, as a hand-written loop does.
+static void BM_SumLoop(benchmark::State &state)
+{
+    sc::ndarray<float, 2> array({1024, (unsigned long)state.range(0)}, 1.0f);
+    for (auto _ : state)
+    {
+        float total = 0;
+        for (unsigned long i = 0; i < array.size(); i++)
+            total += array.data()[i];
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(state.iterations() * array.size() * sizeof(float));
+}
+BENCHMARK(BM_SumLoop)->Range(16, 4096);
+
+/// The same sum through sc::sum, which keeps eight partial sums the compiler vectorizes.
+static void BM_SumNdarray(benchmark::State &state)
+{
+    sc::ndarray<float, 2> array({1024, (unsigned long)state.range(0)}, 1.0f);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(sc::sum(array));
+    state.SetBytesProcessed(state.iterations() * array.size() * sizeof(float));
+}
+BENCHMARK(BM_SumNdarray)->Range(16, 4096);
+
+/// `c = a * 2 + b` computed one operation at a time, through a temporary vector.
+static void BM_AxpyTemporaries(benchmark::State &state)
+{
+    sc::vector<float> a, b, c, scaled;
+    a.resize(state.range(0), 1.5f);
+    b.resize(state.range(0), 2.5f);
+    const unsigned long n = a.size();
+    for (auto _ : state)
+    {
+        const float *pa = a.data(), *pb = b.data();
+        float *ps = scaled.resize_for_overwrite(n);
+        for (auto i(0ul); i < n; i++)
+            ps[i] = pa[i] * 2;
+        float *pc = c.resize_for_overwrite(n);
+        for (auto i(0ul); i < n; i++)
+            pc[i] = ps[i] + pb[i];
+        benchmark::DoNotOptimize(pc);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AxpyTemporaries)->Range(1 << 10, 1 << 22);
+
+/// The same computation as an expression, fused into one pass.
+static void BM_AxpyExpression(benchmark::State &state)
+{
+    sc::vector<float> a, b, c;
+    a.resize(state.range(0), 1.5f);
+    b.resize(state.range(0), 2.5f);
+    for (auto _ : state)
+    {
+        c = a * 2 + b;
+        benchmark::DoNotOptimize(c.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AxpyExpression)->Range(1 << 10, 1 << 22);
+
+/// A dot product with a single accumulator, as a hand-written loop does.
+static void BM_DotLoop(benchmark::State &state)
+{
+    sc::vector<float> a, b;
+    a.resize(state.range(0), 1.5f);
+    b.resize(state.range(0), 2.5f);
+    for (auto _ : state)
+    {
+        float total = 0;
+        for (auto i(0u); i < a.size(); i++)
+            total += a.data()[i] * b.data()[i];
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DotLoop)->Range(1 << 10, 1 << 22);
+
+/// The same dot product through sc::dot.
+static void BM_DotExpression(benchmark::State &state)
+{
+    sc::vector<float> a, b;
+    a.resize(state.range(0), 1.5f);
+    b.resize(state.range(0), 2.5f);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(sc::dot(a, b));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DotExpression)->Range(1 << 10, 1 << 22);
+
+/// The buffers of a request-shaped workload taken from and returned to the global allocator.
+static void BM_BuffersOperatorNew(benchmark::State &state)
+{
+    const std::size_t sizes[] = {96, 400, 1200, 4096, 160, 24000};
+    for (auto _ : state)
+    {
+        void *buffers[6];
+        for (int i = 0; i < 6; i++)
+            buffers[i] = ::operator new(sizes[i] * state.range(0));
+        for (int i = 0; i < 6; i++)
+            ::operator delete(buffers[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK(BM_BuffersOperatorNew)->Arg(1)->Arg(8);
+
+/// The same workload served from the thread's buffer pool.
+static void BM_BuffersPool(benchmark::State &state)
+{
+    const std::size_t sizes[] = {96, 400, 1200, 4096, 160, 24000};
+    for (auto _ : state)
+    {
+        void *buffers[6];
+        for (int i = 0; i < 6; i++)
+            buffers[i] = sc::pool::allocate(sizes[i] * state.range(0));
+        for (int i = 0; i < 6; i++)
+            sc::pool::deallocate(buffers[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK(BM_BuffersPool)->Arg(1)->Arg(8);
+
+/// Fills a vector of state.range(0) longs; the second argument streams (1) or not (0).
+static void BM_Fill(benchmark::State &state)
+{
+    sc::bulk::set_stream_threshold(sc::bulk::kernel::fill, state.range(1) ? 0 : sc::bulk::NEVER);
+    sc::vector<long> vec;
+    vec.resize(state.range(0));
+    for (auto _ : state)
+    {
+        vec.assign(state.range(0), 7);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(long));
+}
+BENCHMARK(BM_Fill)->Args({1 << 16, 0})->Args({1 << 16, 1})->Args({1 << 23, 0})->Args({1 << 23, 1});
+
+/// Copies state.range(0) longs between two vectors; the second argument streams (1) or not (0).
+static void BM_Copy(benchmark::State &state)
+{
+    sc::bulk::set_stream_threshold(sc::bulk::kernel::copy, state.range(1) ? 0 : sc::bulk::NEVER);
+    sc::vector<long> source, target;
+    source.resize(state.range(0), 7);
+    target.resize(state.range(0));
+    for (auto _ : state)
+    {
+        sc::bulk::copy(source.data(), source.size(), target.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(long));
+}
+BENCHMARK(BM_Copy)->Args({1 << 16, 0})->Args({1 << 16, 1})->Args({1 << 23, 0})->Args({1 << 23, 1});
+
+/// Random increments of a shared counter table guarded by one mutex.
+static void BM_CounterTableMutex(benchmark::State &state)
+{
+    static sc::vector<long> table;
+    static std::mutex lock;
+    if (state.thread_index() == 0)
+        table.assign(std::size_t(1) << 16, 0L);
+    std::uint32_t seed = 12345 + state.thread_index();
+    for (auto _ : state)
+    {
+        seed = seed * 1664525 + 1013904223;
+        std::lock_guard<std::mutex> guard(lock);
+        table[seed >> 16]++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CounterTableMutex)->Threads(1)->Threads(4);
+
+/// The same increments on a sharded_vector, which locks only the shard of the counter.
+static void BM_CounterTableSharded(benchmark::State &state)
+{
+    static sc::sharded_vector<long> table(std::size_t(1) << 16, 0);
+    std::uint32_t seed = 12345 + state.thread_index();
+    for (auto _ : state)
+    {
+        seed = seed * 1664525 + 1013904223;
+        table.update(seed >> 16, [](long &value) { value++; });
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CounterTableSharded)->Threads(1)->Threads(4);
+
+/// Lock-free reads of the sharded table.
+static void BM_CounterTableShardedLoad(benchmark::State &state)
+{
+    static sc::sharded_vector<long> table(std::size_t(1) << 16, 1);
+    std::uint32_t seed = 12345 + state.thread_index();
+    long sum = 0;
+    for (auto _ : state)
+    {
+        seed = seed * 1664525 + 1013904223;
+        sum += table.load(seed >> 16);
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CounterTableShardedLoad)->Threads(1)->Threads(4);
+
+/// Fills `indices` with `count` pseudo-random indices below `bound`.
+static void make_indices(sc::vector<std::uint32_t> &indices, long count, long bound)
+{
+    std::uint32_t seed = 12345;
+    indices.clear();
+    for (long i = 0; i < count; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        indices.push_back(std::uint32_t(seed % bound));
+    }
+}
+
+/// out[i] = vec[idx[i]] through operator[], from a source of state.range(0) ints.
+static void BM_GatherIndexLoop(benchmark::State &state)
+{
+    sc::vector<int> source, out;
+    source.resize(state.range(0), 1);
+    sc::vector<std::uint32_t> indices;
+    make_indices(indices, 1 << 20, state.range(0));
+    out.resize(indices.size());
+    for (auto _ : state)
+    {
+        for (unsigned long i = 0; i < indices.size(); i++)
+            out[i] = source[indices[i]];
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(BM_GatherIndexLoop)->Arg(1 << 12)->Arg(1 << 18)->Arg(1 << 24);
+
+/// The same reads through sc::vector::gather.
+static void BM_Gather(benchmark::State &state)
+{
+    sc::vector<int> source, out;
+    source.resize(state.range(0), 1);
+    sc::vector<std::uint32_t> indices;
+    make_indices(indices, 1 << 20, state.range(0));
+    out.resize(indices.size());
+    for (auto _ : state)
+    {
+        source.gather(indices, out);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(BM_Gather)->Arg(1 << 12)->Arg(1 << 18)->Arg(1 << 24);
+
+/// In-place permutation of state.range(0) ints.
+static void BM_Permute(benchmark::State &state)
+{
+    sc::vector<int> vec;
+    vec.resize(state.range(0), 1);
+    sc::vector<std::uint32_t> order;
+    for (long i = 0; i < state.range(0); i++)
+        order.push_back(std::uint32_t(i));
+    std::uint32_t seed = 12345;
+    for (long i = state.range(0); i > 1; i--)
+    {
+        seed = seed * 1664525 + 1013904223;
+        std::swap(order[i - 1], order[seed % i]);
+    }
+    for (auto _ : state)
+    {
+        vec.permute(order);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Permute)->Arg(1 << 12)->Arg(1 << 20);
+
+/// Load spikes on a long-lived cache: it grows to 64K elements, drains back to 1000 and then churns at
+/// that size. Arg 1 turns auto-shrink on; the "bytes" counter is the memory held between spikes.
+static void BM_LoadSpikes(benchmark::State &state)
+{
+    sc::vector<long> cache;
+    cache.set_auto_shrink(state.range(0) != 0);
+    for (auto _ : state)
+    {
+        for (long i = 0; i < 1 << 16; i++)
+            cache.push_back(i);
+        while (cache.size() > 1000)
+            cache.pop_back();
+        for (long r = 0; r < 1 << 16; r++)
+        {
+            cache.push_back(r);
+            cache.pop_back();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.counters["bytes"] = double(cache.memory_usage());
+}
+BENCHMARK(BM_LoadSpikes)->Arg(0)->Arg(1);
+
+/// 64 KiB of text lines of 20 to 60 bytes, as a stream parser would receive them.
+static std::string make_lines()
+{
+    std::string text;
+    std::uint32_t seed = 12345;
+    while (text.size() < (1 << 16))
+    {
+        seed = seed * 1664525 + 1013904223;
+        text.append(20 + seed % 41, char('a' + seed % 26));
+        text += '\n';
+    }
+    return text;
+}
+
+/// Splits the lines off the front of an sc::vector<char> with find and erase, one line at a time.
+static void BM_LinesVectorErase(benchmark::State &state)
+{
+    std::string text = make_lines();
+    for (auto _ : state)
+    {
+        sc::vector<char> buffer(text.begin(), text.end());
+        long lines = 0;
+        for (;;)
+        {
+            auto newline = std::find(buffer.begin(), buffer.end(), '\n');
+            if (newline == buffer.end())
+                break;
+            buffer.erase(buffer.begin(), newline + 1);
+            lines++;
+        }
+        benchmark::DoNotOptimize(lines);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_LinesVectorErase);
+
+/// The same lines through sc::byte_buffer: find('\n') and consume_front.
+static void BM_LinesByteBuffer(benchmark::State &state)
+{
+    std::string text = make_lines();
+    for (auto _ : state)
+    {
+        sc::byte_buffer<> buffer;
+        buffer.append(text.data(), text.size());
+        long lines = 0;
+        for (;;)
+        {
+            unsigned long newline = buffer.find('\n');
+            if (newline == buffer.npos)
+                break;
+            buffer.consume_front(newline + 1);
+            lines++;
+        }
+        benchmark::DoNotOptimize(lines);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_LinesByteBuffer);
+
+/// Finds the next delimiter of a four-byte set in 64 KiB of text, with a loop over sc::vector<char>
+/// (Arg 0) and with byte_buffer::find_first_of (Arg 1).
+static void BM_FindFirstOf(benchmark::State &state)
+{
+    std::string text = make_lines();
+    for (char &c : text)
+        if (c == '\n')
+            c = 'n';
+    text.back() = '\t';
+    sc::vector<char> vec(text.begin(), text.end());
+    sc::byte_buffer<> buffer;
+    buffer.append(text.data(), text.size());
+    for (auto _ : state)
+    {
+        unsigned long at;
+        if (state.range(0) == 0)
+            at = std::find_if(vec.cbegin(), vec.cend(), [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }) -
+                 vec.cbegin();
+        else
+            at = buffer.find_first_of_str(" \t\r\n");
+        benchmark::DoNotOptimize(at);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_FindFirstOf)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
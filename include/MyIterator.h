@@ -7,6 +7,15 @@
  * 
  * Iterator used by the vector class.
  */
+#ifndef MYITERATOR_H
+#define MYITERATOR_H
+
+#include <cassert>  // assert
+#include <cstddef>  // std::ptrdiff_t
+#include <iterator> // std::random_access_iterator_tag
+#include <type_traits> // std::remove_cv
+
+#include "./vector_config.h"
 
 /**
  * @brief Iterator class
@@ -20,52 +29,68 @@ class MyIterator
 public:
   // Below we have the iterator_traits common interface
   typedef std::ptrdiff_t difference_type;                    //!< Difference type used to calculated distance between iterators.
-  typedef T value_type;                                      //!< Value type the iterator points to.
+  typedef typename std::remove_cv<T>::type value_type;       //!< Value type the iterator points to.
   typedef T *pointer;                                        //!< Pointer to the value type.
   typedef T &reference;                                      //!< Reference to the value type.
-  typedef std::bidirectional_iterator_tag iterator_category; //!< Iterator category.
+  typedef std::random_access_iterator_tag iterator_category; //!< Iterator category.
+#ifdef SC_VECTOR_HAS_CONCEPTS
+  typedef std::contiguous_iterator_tag iterator_concept;     //!< Lets C++20 algorithms see the elements as contiguous memory.
+  typedef T element_type;                                    //!< Pointee type, used by std::to_address.
+#endif
 
   /// Default constructor that creates an nullptr.
-  MyIterator()
+  SC_CONSTEXPR14 MyIterator() : current(nullptr)
   {
-    current = nullptr;
   }
 
   /// Copy assignment operator.
-  MyIterator &operator=(const MyIterator &other)
+  SC_CONSTEXPR14 MyIterator &operator=(const MyIterator &other)
   {
     current = other.current;
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+    owner_generation = other.owner_generation;
+    generation = other.generation;
+#endif
     return *this;
   }
 
   /// Constructs a iterator from a address reference.
-  MyIterator(pointer ref)
+  SC_CONSTEXPR14 MyIterator(pointer ref) : current(ref)
+  {
+  }
+
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+  /// Constructs an iterator into a buffer whose owner counts its reallocations in `*owner`.
+  SC_CONSTEXPR14 MyIterator(pointer ref, const std::size_t *owner)
+      : current(ref), owner_generation(owner), generation(*owner)
   {
-    current = ref;
   }
+#endif
 
   /// Returns a value from the iterator pointer.
-  reference operator*() const
+  SC_CONSTEXPR14 reference operator*() const
   {
+    check();
     return *current;
   }
 
   /// Return a pointer to the location in the vector the it points to.
-  pointer operator->(void)const
+  SC_CONSTEXPR14 pointer operator->(void)const
   {
     assert(current != nullptr);
+    check();
     return current;
   }
 
   /// Advances iterator to the next location within the vector and returns itself.
-  MyIterator &operator++() // ++it;
+  SC_CONSTEXPR14 MyIterator &operator++() // ++it;
   {
     current++;
     return *this;
   }
 
   /// Advances iterator to the next location within the vector and returns itself before the increment.
-  MyIterator operator++(int n) // it++;
+  SC_CONSTEXPR14 MyIterator operator++(int n) // it++;
   {
     MyIterator temp = *this;
     current++;
@@ -73,72 +98,132 @@ public:
   }
 
   /// Backs the iterator to the next location within the vector and returns itself.
-  MyIterator &operator--() // --it;
+  SC_CONSTEXPR14 MyIterator &operator--() // --it;
   {
     current--;
     return *this;
   }
 
   /// Backs the iterator to the next location within the vector and returns itself before that.
-  MyIterator operator--(int n) // it--;
+  SC_CONSTEXPR14 MyIterator operator--(int n) // it--;
   {
     MyIterator temp = *this;
     current--;
     return temp;
   }
 
+  /// Returns the element `n` positions after the one the iterator points to.
+  SC_CONSTEXPR14 reference operator[](difference_type n) const
+  {
+    check();
+    return current[n];
+  }
+
+  /// Advances the iterator `n` positions and returns itself.
+  SC_CONSTEXPR14 MyIterator &operator+=(difference_type n)
+  {
+    current += n;
+    return *this;
+  }
+
+  /// Backs the iterator `n` positions and returns itself.
+  SC_CONSTEXPR14 MyIterator &operator-=(difference_type n)
+  {
+    current -= n;
+    return *this;
+  }
+
   /// Return a iterator pointing to the n-th sucessor in the vector from `it`.
-  friend MyIterator operator+(difference_type n, MyIterator it)
+  friend SC_CONSTEXPR14 MyIterator operator+(difference_type n, MyIterator it)
   {
     it.current += n;
     return it;
   }
 
   /// Return a iterator pointing to the n-th sucessor in the vector from `it`.
-  friend MyIterator operator+(MyIterator it, difference_type n)
+  friend SC_CONSTEXPR14 MyIterator operator+(MyIterator it, difference_type n)
   {
     it.current += n;
     return it;
   }
 
   /// Return the sum `std::ptrdiff_t` from two iterators.
-  friend difference_type operator+(MyIterator it, MyIterator other)
+  friend SC_CONSTEXPR14 difference_type operator+(MyIterator it, MyIterator other)
   {
     return it.current + other.current;
   }
 
   /// Return a iterator pointing to the n-th predecessor in the vector from `it`.
-  friend MyIterator operator-(difference_type n, MyIterator it)
+  friend SC_CONSTEXPR14 MyIterator operator-(difference_type n, MyIterator it)
   {
     it.current -= n;
     return it;
   }
 
   /// Return a iterator pointing to the n-th predecessor in the vector from `it`.
-  friend MyIterator operator-(MyIterator it, difference_type n)
+  friend SC_CONSTEXPR14 MyIterator operator-(MyIterator it, difference_type n)
   {
     it.current -= n;
     return it;
   }
 
   /// Return the difference `std::ptrdiff_t` from two iterators.
-  friend difference_type operator-(MyIterator it, MyIterator other)
+  friend SC_CONSTEXPR14 difference_type operator-(MyIterator it, MyIterator other)
   {
     return it.current - other.current;
   }
 
   /// Returns true if both iterators refer to the same location within the vector, and false otherwise.
-  bool operator==(const MyIterator &other) const
+  SC_CONSTEXPR14 bool operator==(const MyIterator &other) const
   {
     return (current - other.current) == 0;
   }
 
   /// Returns true if both iterators refer to differents location within the vector, and false otherwise.
-  bool operator!=(const MyIterator &other) const
+  SC_CONSTEXPR14 bool operator!=(const MyIterator &other) const
   {
     return (current - other.current) != 0;
   }
 
+  /// Returns true if the iterator points to an element before the one `other` points to.
+  SC_CONSTEXPR14 bool operator<(const MyIterator &other) const
+  {
+    return current < other.current;
+  }
+
+  /// Returns true if the iterator points to an element after the one `other` points to.
+  SC_CONSTEXPR14 bool operator>(const MyIterator &other) const
+  {
+    return other < *this;
+  }
+
+  /// Returns true if the iterator does not point after the element `other` points to.
+  SC_CONSTEXPR14 bool operator<=(const MyIterator &other) const
+  {
+    return not(other < *this);
+  }
+
+  /// Returns true if the iterator does not point before the element `other` points to.
+  SC_CONSTEXPR14 bool operator>=(const MyIterator &other) const
+  {
+    return not(*this < other);
+  }
+
 private:
+  /// In hardened builds, reports the use of an iterator whose buffer has been reallocated.
+  SC_CONSTEXPR14 void check() const
+  {
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+    SC_VECTOR_REQUIRE(owner_generation == nullptr || *owner_generation == generation,
+                      "iterator used after the vector reallocated");
+#endif
+  }
+
   T *current; //<! The pointer to the vector data.
-};
\ No newline at end of file
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+  const std::size_t *owner_generation = nullptr; //!< Reallocation counter of the owning vector, if any.
+  std::size_t generation = 0;                    //!< Value of the counter when the iterator was made.
+#endif
+};
+
+#endif
@@ -0,0 +1,696 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Asynchronous bulk loading of binary files into sc::vector.
+ *
+ * A load sizes the vector once, to the size of the file, and splits the file into large blocks
+ * that are read straight into the vector's buffer, all of them in flight at once. The reads are
+ * submitted through io_uring when the library is available (SC_VECTOR_HAS_IO_URING) and handed
+ * to a small pool of threads calling pread() otherwise. Completions are delivered by
+ * io_context::run() on the calling thread, so one thread can drive many loads at the same time,
+ * through callbacks or, in C++20, through coroutines returning sc::task.
+ *
+ * With `load_options::direct` the file is opened with O_DIRECT and the page cache is bypassed,
+ * which keeps a multi-GB load from evicting everything else. O_DIRECT needs block-aligned
+ * buffers, which an sc::vector buffer is not, so direct reads land in an aligned staging block
+ * and are copied into the vector from there.
+ */
+#ifndef ASYNC_LOAD_H
+#define ASYNC_LOAD_H
+
+#include <cerrno>             // errno, EINTR, EINVAL
+#include <cstddef>            // std::size_t
+#include <cstdint>            // std::uint64_t
+#include <cstdlib>            // std::free
+#include <cstring>            // std::memcpy
+#include <condition_variable> // std::condition_variable
+#include <deque>              // std::deque
+#include <functional>         // std::function
+#include <memory>             // std::shared_ptr
+#include <mutex>              // std::mutex, std::unique_lock
+#include <stdexcept>          // std::logic_error
+#include <string>             // std::string
+#include <system_error>       // std::error_code, std::system_error
+#include <type_traits>        // std::is_trivially_copyable
+#include <utility>            // std::move
+
+#include <fcntl.h>    // open, O_RDONLY, O_DIRECT
+#include <stdlib.h>   // posix_memalign
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // pread, close
+
+#include "./vector_config.h"
+#include "./vector.h"
+#include "./vector_threads.h"
+
+#ifdef SC_VECTOR_HAS_IO_URING
+#include <liburing.h>
+#endif
+
+#ifdef SC_VECTOR_HAS_COROUTINES
+#include <coroutine>
+#include <exception>
+#include <optional>
+#endif
+
+namespace sc
+{
+namespace detail
+{
+/// Alignment O_DIRECT asks of buffers, lengths and offsets.
+constexpr std::size_t DIRECT_ALIGNMENT = 4096;
+
+/// Reads `length` bytes at `offset`, retrying short reads. Returns the bytes read (fewer only at the end of the file) or -errno.
+inline long read_fully(int fd, char *buffer, std::size_t length, std::uint64_t offset)
+{
+    std::size_t done = 0;
+    while (done < length)
+    {
+        ssize_t got = ::pread(fd, buffer + done, length - done, off_t(offset + done));
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got < 0)
+            return -errno;
+        if (got == 0)
+            break;
+        done += std::size_t(got);
+    }
+    return long(done);
+}
+
+/// Rounds `n` up to a multiple of DIRECT_ALIGNMENT.
+constexpr std::size_t align_up(std::size_t n)
+{
+    return (n + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+}
+} // namespace detail
+
+/// How a file is loaded.
+struct load_options
+{
+    std::size_t block_size = 8u << 20; //!< Bytes per read request; all the blocks of a file are in flight at once.
+    bool direct = false;               //!< Open with O_DIRECT, when the file system allows it, to bypass the page cache.
+};
+
+/**
+ * @brief Event loop for asynchronous reads
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Operations are started from any thread that owns the loop; their completion handlers run
+ * inside run() / run_one(), one at a time, on the thread that calls them. Run the loop until it
+ * is idle before destroying it or the buffers it reads into.
+ */
+class io_context
+{
+public:
+    using size_type = unsigned long;                       //!< The size type.
+    using read_handler = std::function<void(long result)>; //!< Receives the number of bytes read, or -errno.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Creates a loop with `threads` pread() workers (unused with io_uring) and room for `queue_depth` reads in the ring.
+    explicit io_context(unsigned threads = 4, unsigned queue_depth = 64)
+        : PENDING(0), STOPPING(false)
+#ifndef SC_VECTOR_HAS_IO_URING
+        , WORKERS(threads == 0 ? 1 : threads)
+#endif
+    {
+#ifdef SC_VECTOR_HAS_IO_URING
+        (void)threads;
+        INFLIGHT = 0;
+        int err = io_uring_queue_init(queue_depth, &RING, 0);
+        if (err < 0)
+            throw std::system_error(-err, std::system_category(), "io_uring_queue_init");
+#else
+        (void)queue_depth;
+        try
+        {
+            for (unsigned t = 0; t < (threads == 0 ? 1 : threads); t++)
+                WORKERS.start(&io_context::work, this);
+        }
+        catch (...)
+        {
+            stop_workers(); // the destructor does not run
+            throw;
+        }
+#endif
+    }
+
+    io_context(const io_context &) = delete;
+    io_context &operator=(const io_context &) = delete;
+
+    /// Stops the workers once the reads already queued are done.
+    ~io_context()
+    {
+#ifdef SC_VECTOR_HAS_IO_URING
+        io_uring_queue_exit(&RING);
+#else
+        stop_workers();
+#endif
+    }
+
+    //=== [II] Operations
+    /// Reads `length` bytes of `fd` at `offset` into `buffer`, then calls `done` from run().
+    /// With `direct`, the read goes through an aligned staging block and `offset` must be block-aligned.
+    void async_read(int fd, void *buffer, std::size_t length, std::uint64_t offset, bool direct, read_handler done)
+    {
+        read_op op;
+        op.fd = fd;
+        op.buffer = static_cast<char *>(buffer);
+        op.length = length;
+        op.offset = offset;
+        op.direct = direct;
+        op.done = std::move(done);
+#ifdef SC_VECTOR_HAS_IO_URING
+        PENDING++;
+        submit(new read_op(std::move(op)));
+#else
+        {
+            std::lock_guard<std::mutex> lock(MUTEX);
+            PENDING++;
+            JOBS.push_back(std::move(op));
+        }
+        WORK_READY.notify_one();
+#endif
+    }
+
+    /// Calls `fn` from run(), after the handlers already due.
+    void post(std::function<void()> fn)
+    {
+        {
+            std::lock_guard<std::mutex> lock(MUTEX);
+            PENDING++;
+            COMPLETIONS.push_back(std::move(fn));
+        }
+        DONE_READY.notify_one();
+    }
+
+    /// Waits for one operation to complete and runs its handler. Returns false if nothing is pending.
+    bool run_one()
+    {
+        std::function<void()> fn;
+#ifdef SC_VECTOR_HAS_IO_URING
+        while (COMPLETIONS.empty())
+        {
+            if (INFLIGHT == 0 && BACKLOG.empty())
+                return false;
+            reap();
+        }
+        fn = std::move(COMPLETIONS.front());
+        COMPLETIONS.pop_front();
+        PENDING--;
+#else
+        {
+            std::unique_lock<std::mutex> lock(MUTEX);
+            if (PENDING == 0)
+                return false;
+            while (COMPLETIONS.empty())
+                DONE_READY.wait(lock);
+            fn = std::move(COMPLETIONS.front());
+            COMPLETIONS.pop_front();
+            PENDING--;
+        }
+#endif
+        fn();
+        return true;
+    }
+
+    /// Runs handlers until no operation is pending. Returns how many handlers ran.
+    size_type run()
+    {
+        size_type count = 0;
+        while (run_one())
+            count++;
+        return count;
+    }
+
+private:
+    /// One read request.
+    struct read_op
+    {
+        int fd = -1;              //!< File to read.
+        char *buffer = nullptr;   //!< Destination.
+        std::size_t length = 0;   //!< Bytes wanted.
+        std::uint64_t offset = 0; //!< Position in the file.
+        bool direct = false;      //!< Read through an aligned staging block.
+        read_handler done;        //!< Called with the result.
+#ifdef SC_VECTOR_HAS_IO_URING
+        std::size_t transferred = 0; //!< Bytes read so far, for short reads.
+        char *staging = nullptr;     //!< Aligned block of a direct read.
+#endif
+    };
+
+    /// Allocates a DIRECT_ALIGNMENT-aligned block of `bytes` bytes, or returns nullptr.
+    static char *aligned_block(std::size_t bytes)
+    {
+        void *block = nullptr;
+        if (posix_memalign(&block, detail::DIRECT_ALIGNMENT, bytes) != 0)
+            return nullptr;
+        return static_cast<char *>(block);
+    }
+
+    /// Queues the handler of `op` with `result`.
+    void complete(read_op &op, long result)
+    {
+        read_handler done = std::move(op.done);
+        std::function<void()> fn = [done, result]() { done(result); };
+        std::lock_guard<std::mutex> lock(MUTEX);
+        COMPLETIONS.push_back(std::move(fn));
+    }
+
+#ifdef SC_VECTOR_HAS_IO_URING
+    /// Puts `op` (or what is left of it) in the submission ring, or in the backlog when the ring is full.
+    void submit(read_op *op)
+    {
+        if (op->direct && op->staging == nullptr)
+        {
+            op->staging = aligned_block(detail::align_up(op->length));
+            if (op->staging == nullptr)
+            {
+                complete(*op, -ENOMEM);
+                delete op;
+                return;
+            }
+        }
+
+        io_uring_sqe *sqe = io_uring_get_sqe(&RING);
+        if (sqe == nullptr)
+        {
+            BACKLOG.push_back(op);
+            return;
+        }
+
+        if (op->direct)
+            io_uring_prep_read(sqe, op->fd, op->staging, unsigned(detail::align_up(op->length)), op->offset);
+        else
+            io_uring_prep_read(sqe, op->fd, op->buffer + op->transferred, unsigned(op->length - op->transferred),
+                               op->offset + op->transferred);
+        io_uring_sqe_set_data(sqe, op);
+        io_uring_submit(&RING);
+        INFLIGHT++;
+    }
+
+    /// Waits for one completion from the ring and either finishes its operation or resubmits the rest of a short read.
+    void reap()
+    {
+        if (INFLIGHT == 0)
+        {
+            read_op *op = BACKLOG.front();
+            BACKLOG.pop_front();
+            submit(op);
+            return;
+        }
+
+        io_uring_cqe *cqe = nullptr;
+        int err = io_uring_wait_cqe(&RING, &cqe);
+        if (err == -EINTR)
+            return;
+        if (err < 0)
+            throw std::system_error(-err, std::system_category(), "io_uring_wait_cqe");
+
+        read_op *op = static_cast<read_op *>(io_uring_cqe_get_data(cqe));
+        long res = cqe->res;
+        io_uring_cqe_seen(&RING, cqe);
+        INFLIGHT--;
+
+        if (op->direct)
+        {
+            if (res > 0)
+            {
+                res = long(res < long(op->length) ? res : long(op->length));
+                std::memcpy(op->buffer, op->staging, std::size_t(res));
+            }
+            std::free(op->staging);
+            complete(*op, res);
+            delete op;
+        }
+        else if (res > 0 && op->transferred + std::size_t(res) < op->length)
+        {
+            op->transferred += std::size_t(res);
+            submit(op);
+        }
+        else
+        {
+            complete(*op, res < 0 ? res : long(op->transferred + std::size_t(res)));
+            delete op;
+        }
+
+        while (not BACKLOG.empty() && io_uring_sq_space_left(&RING) > 0)
+        {
+            read_op *next = BACKLOG.front();
+            BACKLOG.pop_front();
+            submit(next);
+        }
+    }
+#else
+    /// Tells the workers to return once the queued reads are done, and joins them.
+    void stop_workers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(MUTEX);
+            STOPPING = true;
+        }
+        WORK_READY.notify_all();
+        WORKERS.join();
+    }
+
+    /// Worker loop: performs queued reads and queues their handlers.
+    void work()
+    {
+        for (;;)
+        {
+            read_op op;
+            {
+                std::unique_lock<std::mutex> lock(MUTEX);
+                while (JOBS.empty() && not STOPPING)
+                    WORK_READY.wait(lock);
+                if (JOBS.empty())
+                    return;
+                op = std::move(JOBS.front());
+                JOBS.pop_front();
+            }
+
+            long result = 0;
+            if (op.direct)
+            {
+                char *staging = aligned_block(detail::align_up(op.length));
+                if (staging == nullptr)
+                    result = -ENOMEM;
+                else
+                {
+                    result = detail::read_fully(op.fd, staging, detail::align_up(op.length), op.offset);
+                    if (result > long(op.length))
+                        result = long(op.length);
+                    if (result > 0)
+                        std::memcpy(op.buffer, staging, std::size_t(result));
+                    std::free(staging);
+                }
+            }
+            else
+                result = detail::read_fully(op.fd, op.buffer, op.length, op.offset);
+
+            complete(op, result);
+            DONE_READY.notify_one();
+        }
+    }
+#endif
+
+    std::mutex MUTEX;                                //!< Guards the queues and PENDING.
+    std::condition_variable DONE_READY;              //!< Signalled when a handler is queued.
+    std::deque<std::function<void()>> COMPLETIONS;   //!< Handlers due to run.
+    size_type PENDING;                               //!< Operations whose handler has not been taken by run_one() yet.
+    bool STOPPING;                                   //!< Set by the destructor.
+#ifdef SC_VECTOR_HAS_IO_URING
+    io_uring RING;                  //!< The submission and completion rings.
+    size_type INFLIGHT;             //!< Reads submitted to the ring and not reaped yet.
+    std::deque<read_op *> BACKLOG;  //!< Reads waiting for a free submission slot.
+#else
+    std::condition_variable WORK_READY; //!< Signalled when a read is queued or the loop stops.
+    std::deque<read_op> JOBS;           //!< Reads waiting for a worker.
+    detail::thread_group WORKERS;       //!< The pread() workers.
+#endif
+};
+
+/// Loads the binary file at `path`, an array of trivially copyable `T`, into an sc::vector and
+/// hands it to `done` from `ctx.run()`. On failure `done` gets the error and an empty vector.
+template <typename T>
+void async_load(io_context &ctx, const std::string &path, std::function<void(std::error_code, sc::vector<T>)> done,
+                load_options options = load_options())
+{
+    static_assert(std::is_trivially_copyable<T>::value, "async_load reads raw bytes into the elements");
+
+    /// State shared by the reads of one file.
+    struct load_state
+    {
+        int fd = -1;
+        sc::vector<T> data;
+        std::size_t outstanding = 0;
+        std::error_code error;
+        std::function<void(std::error_code, sc::vector<T>)> done;
+    };
+
+    auto fail = [&ctx, &done](int err) {
+        std::function<void(std::error_code, sc::vector<T>)> callback = done;
+        ctx.post([callback, err]() { callback(std::error_code(err, std::system_category()), sc::vector<T>()); });
+    };
+
+    int flags = O_RDONLY | O_CLOEXEC;
+#ifdef O_DIRECT
+    if (options.direct)
+        flags |= O_DIRECT;
+#else
+    options.direct = false;
+#endif
+    int fd = ::open(path.c_str(), flags);
+    if (fd < 0 && options.direct && errno == EINVAL)
+    {
+        // The file system does not support O_DIRECT (tmpfs, for one): read through the page cache.
+        options.direct = false;
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0)
+        return fail(errno);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        int err = errno;
+        ::close(fd);
+        return fail(err);
+    }
+    if (std::size_t(info.st_size) % sizeof(T) != 0)
+    {
+        // Not a whole number of elements: not a file of `T`.
+        ::close(fd);
+        return fail(EINVAL);
+    }
+
+    std::shared_ptr<load_state> state = std::make_shared<load_state>();
+    state->fd = fd;
+    state->done = std::move(done);
+    std::size_t bytes = std::size_t(info.st_size);
+    char *dest = reinterpret_cast<char *>(state->data.resize_for_overwrite(bytes / sizeof(T)));
+
+    std::size_t block = options.block_size == 0 ? 1 : options.block_size;
+    if (options.direct)
+        block = detail::align_up(block);
+    state->outstanding = bytes == 0 ? 1 : (bytes + block - 1) / block;
+
+    auto finish_block = [state](std::size_t wanted, long result) {
+        if (not state->error && result < 0)
+            state->error = std::error_code(int(-result), std::system_category());
+        else if (not state->error && std::size_t(result) != wanted)
+            state->error = std::make_error_code(std::errc::io_error); // the file shrank under us
+        if (--state->outstanding > 0)
+            return;
+
+        ::close(state->fd);
+        if (state->error)
+            state->data = sc::vector<T>();
+        state->done(state->error, std::move(state->data));
+    };
+
+    if (bytes == 0)
+        return ctx.post([finish_block]() { finish_block(0, 0); });
+
+    for (std::size_t offset = 0; offset < bytes; offset += block)
+    {
+        std::size_t length = bytes - offset < block ? bytes - offset : block;
+        ctx.async_read(fd, dest + offset, length, offset, options.direct,
+                       [finish_block, length](long result) { finish_block(length, result); });
+    }
+}
+
+#ifdef SC_VECTOR_HAS_COROUTINES
+/**
+ * @brief Lazily started coroutine producing a `T`
+ *
+ * Starts when awaited (or on start()); the awaiting coroutine resumes when it co_returns.
+ * Exceptions escaping the coroutine are rethrown to the awaiter.
+ */
+template <typename T>
+class task
+{
+public:
+    /// The coroutine side of a task.
+    struct promise_type
+    {
+        std::optional<T> value;              //!< What the coroutine co_returned.
+        std::exception_ptr error;            //!< What escaped the coroutine.
+        std::coroutine_handle<> continuation; //!< Who awaits the task.
+
+        /// Resumes the awaiter, if any, when the coroutine finishes.
+        struct final_awaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept
+            {
+                std::coroutine_handle<> next = self.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept
+            {
+            }
+        };
+
+        task get_return_object()
+        {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        final_awaiter final_suspend() noexcept
+        {
+            return {};
+        }
+
+        template <typename U>
+        void return_value(U &&result)
+        {
+            value.emplace(std::forward<U>(result));
+        }
+
+        void unhandled_exception()
+        {
+            error = std::current_exception();
+        }
+    };
+
+    /// Takes over the coroutine of `other`.
+    task(task &&other) noexcept : HANDLE(other.HANDLE)
+    {
+        other.HANDLE = nullptr;
+    }
+
+    task &operator=(task &&) = delete;
+
+    /// Destroys the coroutine.
+    ~task()
+    {
+        if (HANDLE)
+            HANDLE.destroy();
+    }
+
+    /// Runs the coroutine up to its first suspension point, without awaiting it.
+    void start()
+    {
+        if (not STARTED)
+        {
+            STARTED = true;
+            HANDLE.resume();
+        }
+    }
+
+    /// Returns true once the coroutine has finished.
+    bool done() const
+    {
+        return HANDLE.done();
+    }
+
+    /// Returns the result of a finished coroutine, or rethrows what escaped it.
+    T result()
+    {
+        if (HANDLE.promise().error)
+            std::rethrow_exception(HANDLE.promise().error);
+        return std::move(*HANDLE.promise().value);
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    /// Starts the coroutine; `waiting` resumes when it finishes.
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiting) noexcept
+    {
+        HANDLE.promise().continuation = waiting;
+        STARTED = true;
+        return HANDLE;
+    }
+
+    T await_resume()
+    {
+        return result();
+    }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> handle) : HANDLE(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> HANDLE; //!< The coroutine.
+    bool STARTED = false;                       //!< Whether the coroutine ran already.
+};
+
+namespace detail
+{
+/// Suspends a coroutine until async_load delivers the vector.
+template <typename T>
+struct load_awaiter
+{
+    io_context &ctx;        //!< Loop that runs the load.
+    std::string path;       //!< File to load.
+    load_options options;   //!< How to load it.
+    std::error_code error;  //!< Outcome of the load.
+    sc::vector<T> result;   //!< The elements.
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> waiting)
+    {
+        async_load<T>(ctx, path, [this, waiting](std::error_code ec, sc::vector<T> data) {
+            error = ec;
+            result = std::move(data);
+            waiting.resume();
+        }, options);
+    }
+
+    sc::vector<T> await_resume()
+    {
+        if (error)
+            throw std::system_error(error, path);
+        return std::move(result);
+    }
+};
+} // namespace detail
+
+/// Loads the binary file at `path` into an sc::vector; resumes from `ctx.run()` once every block is read.
+/// Throws std::system_error from the co_await on failure.
+template <typename T>
+task<sc::vector<T>> async_load(io_context &ctx, std::string path, load_options options = load_options())
+{
+    // Named awaiter and result: GCC 12 destroys temporaries of a `co_return co_await` expression twice.
+    detail::load_awaiter<T> awaiter{ctx, std::move(path), options, {}, {}};
+    sc::vector<T> data = co_await awaiter;
+    co_return std::move(data);
+}
+
+/// Runs `ctx` until `work` finishes, and returns its result.
+template <typename T>
+T sync_wait(io_context &ctx, task<T> work)
+{
+    work.start();
+    while (not work.done())
+        if (not ctx.run_one())
+            throw std::logic_error("sc::sync_wait: the task waits for something the io_context does not run");
+    return work.result();
+}
+#endif
+} // namespace sc
+
+#endif
@@ -0,0 +1,866 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Implementation of a packed vector of bits.
+ *
+ * sc::vector<bool> keeps one byte per flag and hands out real `bool &`, which is what code that
+ * takes the address of an element expects. sc::bit_vector packs 64 flags per word instead and
+ * gives access through proxy references; bulk logic, counting and searching then work a word
+ * (or, with AVX2, four words) at a time. bit_rank_index adds constant-time rank and fast select
+ * over a bit_vector that no longer changes.
+ */
+#ifndef BIT_VECTOR_H
+#define BIT_VECTOR_H
+
+#include <cstddef>          // std::size_t, std::ptrdiff_t
+#include <cstdint>          // std::uint64_t
+#include <initializer_list> // std::initializer_list
+#include <iterator>         // std::random_access_iterator_tag
+#include <stdexcept>        // std::out_of_range
+#include <string>           // std::to_string
+#include <type_traits>      // std::conditional
+
+#include "./vector_config.h"
+#include "./vector.h"
+#include "./vector_view.h"
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace sc
+{
+namespace detail
+{
+/// Number of bits set in `word`.
+inline unsigned popcount64(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return unsigned((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/// Index of the lowest bit set in `word`, which must not be zero.
+inline unsigned countr_zero64(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    unsigned n = 0;
+    for (; (word & 1) == 0; word >>= 1)
+        n++;
+    return n;
+#endif
+}
+
+/// Index of the `k`-th (from 0) bit set in `word`, which must have more than `k` bits set.
+inline unsigned select64(std::uint64_t word, unsigned k)
+{
+#ifdef __BMI2__
+    return countr_zero64(_pdep_u64(std::uint64_t(1) << k, word));
+#else
+    for (; k > 0; k--)
+        word &= word - 1;
+    return countr_zero64(word);
+#endif
+}
+
+/// Total number of bits set in `count` words.
+inline std::uint64_t popcount_words(const std::uint64_t *words, std::size_t count)
+{
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+#ifdef __AVX2__
+    // Per-nibble lookup with vpshufb, summed per 64-bit lane by vpsadbw.
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+    __m256i sum = _mm256_setzero_si256();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+        __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_nibble));
+        __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibble));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    total += std::uint64_t(_mm256_extract_epi64(sum, 0)) + std::uint64_t(_mm256_extract_epi64(sum, 1)) +
+             std::uint64_t(_mm256_extract_epi64(sum, 2)) + std::uint64_t(_mm256_extract_epi64(sum, 3));
+
+    // At most three words are left. Spelled out, because GCC 12 at -O3 -march=native (AVX-512)
+    // miscompiles the vectorized form of this loop once it is inlined.
+    switch (count - i)
+    {
+    case 3:
+        total += popcount64(words[i + 2]);
+        /* fall through */
+    case 2:
+        total += popcount64(words[i + 1]);
+        /* fall through */
+    case 1:
+        total += popcount64(words[i]);
+    }
+#else
+    for (; i < count; i++)
+        total += popcount64(words[i]);
+#endif
+    return total;
+}
+
+/// The bulk operations of bit_vector, applied word by word.
+enum class bit_op
+{
+    and_,
+    or_,
+    xor_,
+    and_not
+};
+
+/// Computes `dst[i] = dst[i] op src[i]` for `count` words.
+template <bit_op Op>
+inline void combine_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t count)
+{
+    std::size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        __m256i r = Op == bit_op::and_ ? _mm256_and_si256(a, b)
+                  : Op == bit_op::or_  ? _mm256_or_si256(a, b)
+                  : Op == bit_op::xor_ ? _mm256_xor_si256(a, b)
+                                       : _mm256_andnot_si256(b, a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), r);
+    }
+#endif
+    for (; i < count; i++)
+        dst[i] = Op == bit_op::and_ ? dst[i] & src[i]
+               : Op == bit_op::or_  ? dst[i] | src[i]
+               : Op == bit_op::xor_ ? dst[i] ^ src[i]
+                                    : dst[i] & ~src[i];
+}
+} // namespace detail
+
+/**
+ * @brief Proxy reference to one bit of a bit_vector
+ *
+ * Converts to bool and can be assigned a bool, which is all most code needs from a `bool &`.
+ */
+class bit_reference
+{
+public:
+    /// Refers to the bits of `*word` selected by `mask`, a single bit.
+    bit_reference(std::uint64_t *word, std::uint64_t mask) : WORD(word), MASK(mask)
+    {
+    }
+
+    /// Returns the value of the bit.
+    operator bool() const
+    {
+        return (*WORD & MASK) != 0;
+    }
+
+    /// Returns the opposite of the bit.
+    bool operator~() const
+    {
+        return (*WORD & MASK) == 0;
+    }
+
+    /// Sets the bit to `value`.
+    bit_reference &operator=(bool value)
+    {
+        if (value)
+            *WORD |= MASK;
+        else
+            *WORD &= ~MASK;
+        return *this;
+    }
+
+    /// Sets the bit to the value of the bit `other` refers to.
+    bit_reference &operator=(const bit_reference &other)
+    {
+        return *this = bool(other);
+    }
+
+    /// Inverts the bit.
+    bit_reference &flip()
+    {
+        *WORD ^= MASK;
+        return *this;
+    }
+
+    /// Exchanges the bits `a` and `b` refer to, so algorithms that swap through iterators work.
+    friend void swap(bit_reference a, bit_reference b)
+    {
+        bool bit = a;
+        a = bool(b);
+        b = bit;
+    }
+
+private:
+    std::uint64_t *WORD; //!< Word that holds the bit.
+    std::uint64_t MASK;  //!< The bit within the word.
+};
+
+/**
+ * @brief Iterator over the bits of a bit_vector
+ *
+ * Holds the address of the first word and a bit index. `Const` iterators yield plain bools,
+ * the others yield bit_reference proxies.
+ */
+template <bool Const>
+class bit_iterator
+{
+    using word_pointer = typename std::conditional<Const, const std::uint64_t *, std::uint64_t *>::type; //!< Address of a word.
+
+public:
+    using difference_type = std::ptrdiff_t;                                         //!< Difference type.
+    using value_type = bool;                                                        //!< Value type the iterator points to.
+    using reference = typename std::conditional<Const, bool, bit_reference>::type;  //!< What dereferencing yields.
+    using pointer = void;                                                           //!< Bits have no address.
+    using iterator_category = std::random_access_iterator_tag;                      //!< Iterator category.
+
+    /// Default constructor that creates a singular iterator.
+    bit_iterator() : WORDS(nullptr), INDEX(0)
+    {
+    }
+
+    /// Constructs an iterator on bit `index` of the words at `words`.
+    bit_iterator(word_pointer words, std::size_t index) : WORDS(words), INDEX(index)
+    {
+    }
+
+    /// A mutable iterator converts to a constant one.
+    template <bool Other, typename = typename std::enable_if<Const && not Other>::type>
+    bit_iterator(const bit_iterator<Other> &other) : WORDS(other.words()), INDEX(other.index())
+    {
+    }
+
+    /// Returns the bit at the current position.
+    reference operator*() const
+    {
+        return make_reference(WORDS + INDEX / 64, std::uint64_t(1) << (INDEX % 64));
+    }
+
+    /// Returns the bit `n` positions away.
+    reference operator[](difference_type n) const
+    {
+        return *(*this + n);
+    }
+
+    /// Advances the iterator to the next bit.
+    bit_iterator &operator++()
+    {
+        ++INDEX;
+        return *this;
+    }
+
+    /// Advances the iterator to the next bit.
+    bit_iterator operator++(int)
+    {
+        bit_iterator old(*this);
+        ++INDEX;
+        return old;
+    }
+
+    /// Moves the iterator to the previous bit.
+    bit_iterator &operator--()
+    {
+        --INDEX;
+        return *this;
+    }
+
+    /// Moves the iterator to the previous bit.
+    bit_iterator operator--(int)
+    {
+        bit_iterator old(*this);
+        --INDEX;
+        return old;
+    }
+
+    /// Advances the iterator by `n` bits.
+    bit_iterator &operator+=(difference_type n)
+    {
+        INDEX += n;
+        return *this;
+    }
+
+    /// Moves the iterator back by `n` bits.
+    bit_iterator &operator-=(difference_type n)
+    {
+        INDEX -= n;
+        return *this;
+    }
+
+    /// Returns an iterator `n` bits ahead.
+    bit_iterator operator+(difference_type n) const
+    {
+        return bit_iterator(WORDS, INDEX + n);
+    }
+
+    /// Returns an iterator `n` bits behind.
+    bit_iterator operator-(difference_type n) const
+    {
+        return bit_iterator(WORDS, INDEX - n);
+    }
+
+    /// Returns the number of bits between both iterators.
+    difference_type operator-(const bit_iterator &other) const
+    {
+        return difference_type(INDEX) - difference_type(other.INDEX);
+    }
+
+    /// Check if both iterators point to the same bit.
+    bool operator==(const bit_iterator &other) const
+    {
+        return INDEX == other.INDEX;
+    }
+
+    /// Check if the iterators point to different bits.
+    bool operator!=(const bit_iterator &other) const
+    {
+        return INDEX != other.INDEX;
+    }
+
+    /// Check if this iterator comes before `other`.
+    bool operator<(const bit_iterator &other) const
+    {
+        return INDEX < other.INDEX;
+    }
+
+    /// Check if this iterator comes after `other`.
+    bool operator>(const bit_iterator &other) const
+    {
+        return INDEX > other.INDEX;
+    }
+
+    /// Check if this iterator does not come after `other`.
+    bool operator<=(const bit_iterator &other) const
+    {
+        return INDEX <= other.INDEX;
+    }
+
+    /// Check if this iterator does not come before `other`.
+    bool operator>=(const bit_iterator &other) const
+    {
+        return INDEX >= other.INDEX;
+    }
+
+    /// Returns the address of the first word.
+    word_pointer words() const
+    {
+        return WORDS;
+    }
+
+    /// Returns the index of the current bit.
+    std::size_t index() const
+    {
+        return INDEX;
+    }
+
+private:
+    /// A constant iterator reads the bit.
+    static bool make_reference(const std::uint64_t *word, std::uint64_t mask)
+    {
+        return (*word & mask) != 0;
+    }
+
+    /// A mutable iterator wraps the bit in a proxy.
+    static bit_reference make_reference(std::uint64_t *word, std::uint64_t mask)
+    {
+        return bit_reference(word, mask);
+    }
+
+    word_pointer WORDS; //!< The words of the container.
+    std::size_t INDEX;  //!< Index of the current bit.
+};
+
+/// Returns an iterator `n` bits ahead of `it`.
+template <bool Const>
+bit_iterator<Const> operator+(typename bit_iterator<Const>::difference_type n, const bit_iterator<Const> &it)
+{
+    return it + n;
+}
+
+/**
+ * @brief Packed vector of bits
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Stores `size()` bits in 64-bit words, in an sc::vector. The bits past `size()` in the last word
+ * are always zero, so whole-word operations never need to mask the tail on reads.
+ */
+class bit_vector
+{
+public:
+    using size_type = unsigned long;         //!< The size type.
+    using value_type = bool;                 //!< The value type.
+    using word_type = std::uint64_t;         //!< The storage unit.
+    using reference = bit_reference;         //!< Proxy reference to a bit.
+    using const_reference = bool;            //!< Bits are read by value.
+    using iterator = bit_iterator<false>;    //!< Iterator over the bits.
+    using const_iterator = bit_iterator<true>; //!< Constant iterator over the bits.
+
+    static constexpr size_type WORD_BITS = 64; //!< Bits per word.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Default constructor that creates an empty list.
+    bit_vector() : WORDS(), SIZE(0)
+    {
+    }
+
+    /// Constructs the list with `count` bits equal to `value`.
+    explicit bit_vector(size_type count, bool value = false) : WORDS(), SIZE(0)
+    {
+        resize(count, value);
+    }
+
+    /// Constructs the list with the contents of the initializer list init.
+    bit_vector(std::initializer_list<bool> ilist) : WORDS(), SIZE(0)
+    {
+        reserve(ilist.size());
+        for (bool bit : ilist)
+            push_back(bit);
+    }
+
+    //=== [II] ITERATORS
+    /// Returns an iterator pointing to the first bit.
+    iterator begin()
+    {
+        return iterator(WORDS.data(), 0);
+    }
+
+    /// Returns an iterator pointing just after the last bit.
+    iterator end()
+    {
+        return iterator(WORDS.data(), SIZE);
+    }
+
+    /// Returns a constant iterator pointing to the first bit.
+    const_iterator begin() const
+    {
+        return cbegin();
+    }
+
+    /// Returns a constant iterator pointing just after the last bit.
+    const_iterator end() const
+    {
+        return cend();
+    }
+
+    /// Returns a constant iterator pointing to the first bit.
+    const_iterator cbegin() const
+    {
+        return const_iterator(WORDS.data(), 0);
+    }
+
+    /// Returns a constant iterator pointing just after the last bit.
+    const_iterator cend() const
+    {
+        return const_iterator(WORDS.data(), SIZE);
+    }
+
+    /// Returns the storage words; bit `i` is bit `i % 64` of word `i / 64`.
+    vector_view<const word_type> words() const
+    {
+        return vector_view<const word_type>(WORDS.data(), WORDS.size());
+    }
+
+    //=== [III] Capacity
+    /// Return the number of bits in the container.
+    size_type size() const
+    {
+        return SIZE;
+    }
+
+    /// Return the number of bits the current allocation can hold.
+    size_type capacity() const
+    {
+        return WORDS.capacity() * WORD_BITS;
+    }
+
+    /// Returns true if the container holds no bits, and false otherwise.
+    bool empty() const
+    {
+        return SIZE == 0;
+    }
+
+    /// Makes room for `new_cap` bits.
+    void reserve(size_type new_cap)
+    {
+        WORDS.reserve(word_count(new_cap));
+    }
+
+    //=== [IV] Modifiers
+    /// Removes every bit.
+    void clear()
+    {
+        WORDS.clear();
+        SIZE = 0;
+    }
+
+    /// Adds a bit to the end.
+    void push_back(bool value)
+    {
+        if (SIZE % WORD_BITS == 0)
+            WORDS.push_back(0);
+        if (value)
+            WORDS[SIZE / WORD_BITS] |= word_type(1) << (SIZE % WORD_BITS);
+        ++SIZE;
+    }
+
+    /// Removes the last bit.
+    void pop_back()
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "pop_back() on an empty vector");
+        resize(SIZE - 1);
+    }
+
+    /// Changes the number of bits to `count`; new bits are set to `value`.
+    void resize(size_type count, bool value = false)
+    {
+        if (count > SIZE && value && SIZE % WORD_BITS != 0)
+            WORDS[SIZE / WORD_BITS] |= ~word_type(0) << (SIZE % WORD_BITS);
+
+        size_type words = word_count(count);
+        if (words < WORDS.size())
+            WORDS.erase(WORDS.begin() + words, WORDS.end());
+        else if (words > WORDS.size())
+        {
+            WORDS.reserve(words);
+            while (WORDS.size() < words)
+                WORDS.push_back(value ? ~word_type(0) : 0);
+        }
+
+        SIZE = count;
+        clear_tail();
+    }
+
+    /// Sets bit `pos` to `value`.
+    bit_vector &set(size_type pos, bool value = true)
+    {
+        (*this)[pos] = value;
+        return *this;
+    }
+
+    /// Clears bit `pos`.
+    bit_vector &reset(size_type pos)
+    {
+        return set(pos, false);
+    }
+
+    /// Inverts bit `pos`.
+    bit_vector &flip(size_type pos)
+    {
+        (*this)[pos].flip();
+        return *this;
+    }
+
+    /// Sets every bit.
+    bit_vector &set()
+    {
+        for (size_type w = 0; w < WORDS.size(); w++)
+            WORDS[w] = ~word_type(0);
+        clear_tail();
+        return *this;
+    }
+
+    /// Clears every bit.
+    bit_vector &reset()
+    {
+        for (size_type w = 0; w < WORDS.size(); w++)
+            WORDS[w] = 0;
+        return *this;
+    }
+
+    /// Inverts every bit.
+    bit_vector &flip()
+    {
+        for (size_type w = 0; w < WORDS.size(); w++)
+            WORDS[w] = ~WORDS[w];
+        clear_tail();
+        return *this;
+    }
+
+    /// Keeps the bits set in both vectors, which must have the same size.
+    bit_vector &operator&=(const bit_vector &other)
+    {
+        return combine<detail::bit_op::and_>(other);
+    }
+
+    /// Sets the bits set in either vector; both must have the same size.
+    bit_vector &operator|=(const bit_vector &other)
+    {
+        return combine<detail::bit_op::or_>(other);
+    }
+
+    /// Keeps the bits set in exactly one vector; both must have the same size.
+    bit_vector &operator^=(const bit_vector &other)
+    {
+        return combine<detail::bit_op::xor_>(other);
+    }
+
+    /// Clears the bits that are set in `other`, which must have the same size.
+    bit_vector &and_not(const bit_vector &other)
+    {
+        return combine<detail::bit_op::and_not>(other);
+    }
+
+    //=== [V] Element access
+    /// Returns bit `pos`, with no bounds-checking.
+    reference operator[](size_type pos)
+    {
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return reference(WORDS.data() + pos / WORD_BITS, word_type(1) << (pos % WORD_BITS));
+    }
+
+    /// Returns bit `pos`, with no bounds-checking.
+    bool operator[](size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return (WORDS[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1;
+    }
+
+    /// Returns bit `pos`, with bounds-checking.
+    bool test(size_type pos) const
+    {
+        if (pos >= SIZE)
+            throw std::out_of_range(std::to_string(pos));
+        return (*this)[pos];
+    }
+
+    /// Returns bit `pos`, with bounds-checking.
+    reference at(size_type pos)
+    {
+        if (pos >= SIZE)
+            throw std::out_of_range(std::to_string(pos));
+        return (*this)[pos];
+    }
+
+    //=== [VI] Counting and searching
+    /// Returns the number of bits set.
+    size_type count() const
+    {
+        return detail::popcount_words(WORDS.data(), WORDS.size());
+    }
+
+    /// Returns true if any bit is set.
+    bool any() const
+    {
+        for (size_type w = 0; w < WORDS.size(); w++)
+            if (WORDS[w] != 0)
+                return true;
+        return false;
+    }
+
+    /// Returns true if no bit is set.
+    bool none() const
+    {
+        return not any();
+    }
+
+    /// Returns true if every bit is set (and, vacuously, for an empty vector).
+    bool all() const
+    {
+        return count() == SIZE;
+    }
+
+    /// Returns the index of the first bit set, or size() if there is none.
+    size_type find_first() const
+    {
+        return find_from(0);
+    }
+
+    /// Returns the index of the first bit set after `pos`, or size() if there is none.
+    size_type find_next(size_type pos) const
+    {
+        return pos + 1 >= SIZE ? SIZE : find_from(pos + 1);
+    }
+
+    /// Returns the number of bits set before `pos`. Linear in `pos`; see bit_rank_index for constant time.
+    size_type rank(size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos <= SIZE, "rank() position out of range");
+        size_type total = detail::popcount_words(WORDS.data(), pos / WORD_BITS);
+        if (pos % WORD_BITS != 0)
+            total += detail::popcount64(WORDS[pos / WORD_BITS] & ((word_type(1) << (pos % WORD_BITS)) - 1));
+        return total;
+    }
+
+    /// Returns the index of the bit set with rank `k` (the `k + 1`-th one), or size() if there are not that many.
+    size_type select(size_type k) const
+    {
+        for (size_type w = 0; w < WORDS.size(); w++)
+        {
+            unsigned ones = detail::popcount64(WORDS[w]);
+            if (k < ones)
+                return w * WORD_BITS + detail::select64(WORDS[w], unsigned(k));
+            k -= ones;
+        }
+        return SIZE;
+    }
+
+    /// Check if both vectors hold the same bits
+    bool operator==(const bit_vector &other) const
+    {
+        return SIZE == other.SIZE && WORDS == other.WORDS;
+    }
+
+    /// Check if the vectors hold different bits
+    bool operator!=(const bit_vector &other) const
+    {
+        return not(*this == other);
+    }
+
+private:
+    /// Number of words needed for `bits` bits.
+    static size_type word_count(size_type bits)
+    {
+        return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    /// Zeroes the bits of the last word that lie past size().
+    void clear_tail()
+    {
+        if (SIZE % WORD_BITS != 0)
+            WORDS[SIZE / WORD_BITS] &= (word_type(1) << (SIZE % WORD_BITS)) - 1;
+    }
+
+    /// Index of the first bit set at or after `pos`, or SIZE.
+    size_type find_from(size_type pos) const
+    {
+        const word_type *words = WORDS.data();
+        word_type mask = ~word_type(0) << (pos % WORD_BITS);
+        for (size_type w = pos / WORD_BITS; w < WORDS.size(); w++, mask = ~word_type(0))
+            if (word_type word = words[w] & mask)
+                return w * WORD_BITS + detail::countr_zero64(word);
+        return SIZE;
+    }
+
+    /// Applies `Op` word by word with `other`, which must have the same size.
+    template <detail::bit_op Op>
+    bit_vector &combine(const bit_vector &other)
+    {
+        SC_VECTOR_REQUIRE(SIZE == other.SIZE, "bitwise operation on bit_vectors of different sizes");
+        detail::combine_words<Op>(WORDS.data(), other.WORDS.data(), WORDS.size());
+        return *this;
+    }
+
+    sc::vector<word_type> WORDS; //!< The bits, 64 per word, lowest bit first.
+    size_type SIZE;              //!< Number of bits stored.
+};
+
+/// Returns the bits set in both vectors.
+inline bit_vector operator&(bit_vector a, const bit_vector &b)
+{
+    return a &= b;
+}
+
+/// Returns the bits set in either vector.
+inline bit_vector operator|(bit_vector a, const bit_vector &b)
+{
+    return a |= b;
+}
+
+/// Returns the bits set in exactly one of the vectors.
+inline bit_vector operator^(bit_vector a, const bit_vector &b)
+{
+    return a ^= b;
+}
+
+/// Returns the complement of `a`.
+inline bit_vector operator~(bit_vector a)
+{
+    return a.flip();
+}
+
+/**
+ * @brief Rank/select directory over a bit_vector
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Records the number of bits set before every block of 8 words (512 bits), one cache line, so
+ * rank() reads one counter and at most one line of bits, and select() binary-searches the
+ * counters before scanning one line. Costs 1/8 of the bit_vector in memory. The index refers to
+ * the bit_vector it was built from, which must outlive it and not change while it is in use.
+ */
+class bit_rank_index
+{
+public:
+    using size_type = unsigned long; //!< The size type.
+
+    static constexpr size_type BLOCK_WORDS = 8; //!< Words per counted block.
+
+    /// Builds the directory for `bits`.
+    explicit bit_rank_index(const bit_vector &bits) : BITS(&bits), BLOCK_RANK()
+    {
+        vector_view<const std::uint64_t> words = bits.words();
+        size_type total = 0;
+        BLOCK_RANK.reserve(words.size() / BLOCK_WORDS + 1);
+        for (size_type w = 0; w < words.size(); w += BLOCK_WORDS)
+        {
+            BLOCK_RANK.push_back(total);
+            size_type count = words.size() - w < BLOCK_WORDS ? words.size() - w : BLOCK_WORDS;
+            total += detail::popcount_words(words.data() + w, count);
+        }
+        BLOCK_RANK.push_back(total);
+    }
+
+    /// Returns the number of bits set before `pos`.
+    size_type rank(size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos <= BITS->size(), "rank() position out of range");
+        const std::uint64_t *words = BITS->words().data();
+        size_type w = pos / 64;
+        size_type block = w / BLOCK_WORDS;
+
+        size_type total = BLOCK_RANK[block];
+        for (size_type i = block * BLOCK_WORDS; i < w; i++)
+            total += detail::popcount64(words[i]);
+        if (pos % 64 != 0)
+            total += detail::popcount64(words[w] & ((std::uint64_t(1) << (pos % 64)) - 1));
+        return total;
+    }
+
+    /// Returns the index of the bit set with rank `k`, or the size of the bit_vector if there are not that many.
+    size_type select(size_type k) const
+    {
+        if (k >= BLOCK_RANK[BLOCK_RANK.size() - 1])
+            return BITS->size();
+
+        // Last block whose count of preceding bits is <= k.
+        size_type lo = 0;
+        size_type hi = BLOCK_RANK.size() - 1;
+        while (hi - lo > 1)
+        {
+            size_type mid = lo + (hi - lo) / 2;
+            if (BLOCK_RANK[mid] <= k)
+                lo = mid;
+            else
+                hi = mid;
+        }
+
+        k -= BLOCK_RANK[lo];
+        const std::uint64_t *words = BITS->words().data();
+        for (size_type w = lo * BLOCK_WORDS;; w++)
+        {
+            unsigned ones = detail::popcount64(words[w]);
+            if (k < ones)
+                return w * 64 + detail::select64(words[w], unsigned(k));
+            k -= ones;
+        }
+    }
+
+private:
+    const bit_vector *BITS;         //!< The indexed bits.
+    sc::vector<size_type> BLOCK_RANK; //!< Bits set before each block of BLOCK_WORDS words, plus the total.
+};
+} // namespace sc
+
+#endif
@@ -0,0 +1,518 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * A byte buffer for network and file I/O, built on sc::vector of a byte type.
+ *
+ * The buffer keeps its bytes in one sc::vector with a read offset in front: [0, read) has been
+ * consumed, [read, size) is readable and the rest of the capacity is free for writing. Dropping a
+ * prefix with consume_front() only moves the offset. The consumed prefix is reclaimed when more
+ * room is needed: the readable bytes are moved to the front when they are no more than the
+ * consumed ones, so each byte is moved at most once per byte consumed, and the buffer grows
+ * otherwise, copying only the readable bytes. Writes go through append() or through
+ * prepare()/commit(), which let read() or recv() write straight into the free space.
+ *
+ * read_from() reads with readv() into the free space and a stack spill area of
+ * SC_VECTOR_READ_SPILL_BYTES, so one system call can take more than the free space without
+ * growing the buffer beforehand. write_buffers() sends several buffers with one writev() call.
+ * Both return the bytes transferred or -errno, like the reads of async_load.h.
+ *
+ * find_first_of() compares 32 bytes at a time against every byte of a small set with AVX2 (16 with
+ * SSE2); larger sets use a lookup table. find() of a single byte goes to memchr, which the C
+ * library already vectorizes. The overloads that take a C string are named find_str() and
+ * find_first_of_str(), so a pointer and a length are never mistaken for a string and an offset.
+ */
+#ifndef BYTE_BUFFER_H
+#define BYTE_BUFFER_H
+
+#include <algorithm>        // std::max
+#include <cerrno>           // errno, EINTR
+#include <cstddef>          // std::size_t
+#include <cstring>          // std::memchr, std::memcmp, std::memcpy, std::memmove, std::strlen
+#include <initializer_list> // std::initializer_list
+#include <type_traits>      // std::integral_constant, std::is_same
+#include <utility>          // std::move
+
+#include <sys/uio.h> // readv, writev, iovec
+#include <unistd.h>  // write
+
+#include "./vector_config.h"
+#include "./vector.h"
+#include "./vector_view.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace sc
+{
+/// True for the types a byte_buffer can hold: the character types and std::byte.
+template <typename T>
+struct is_byte : std::integral_constant<bool, std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                                                  std::is_same<T, unsigned char>::value
+#ifdef __cpp_lib_byte
+                                                  || std::is_same<T, std::byte>::value
+#endif
+#ifdef __cpp_char8_t
+                                                  || std::is_same<T, char8_t>::value
+#endif
+                                              >
+{
+};
+
+namespace detail
+{
+/// Sets larger than this are searched through a lookup table rather than one comparison per member.
+constexpr std::size_t SIMD_SET_MAX = 8;
+
+/// Returns the index of the first of the `count` bytes at `bytes` that is one of the `members`
+/// bytes of `set`, or `count` if there is none.
+inline std::size_t find_any(const unsigned char *bytes, std::size_t count, const unsigned char *set, std::size_t members)
+{
+    if (members == 0)
+        return count;
+    if (members == 1)
+    {
+        const void *hit = count == 0 ? nullptr : std::memchr(bytes, set[0], count);
+        return hit ? std::size_t(static_cast<const unsigned char *>(hit) - bytes) : count;
+    }
+
+    std::size_t i = 0;
+    if (members <= SIMD_SET_MAX)
+    {
+#if defined(__AVX2__)
+        __m256i wide[SIMD_SET_MAX];
+        for (std::size_t k = 0; k < members; k++)
+            wide[k] = _mm256_set1_epi8(char(set[k]));
+        for (; i + 32 <= count; i += 32)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i));
+            __m256i hits = _mm256_cmpeq_epi8(x, wide[0]);
+            for (std::size_t k = 1; k < members; k++)
+                hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(x, wide[k]));
+            unsigned mask = unsigned(_mm256_movemask_epi8(hits));
+            if (mask != 0)
+                return i + lowest_bit(mask);
+        }
+#endif
+#if defined(__SSE2__)
+        __m128i narrow[SIMD_SET_MAX];
+        for (std::size_t k = 0; k < members; k++)
+            narrow[k] = _mm_set1_epi8(char(set[k]));
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+            __m128i hits = _mm_cmpeq_epi8(x, narrow[0]);
+            for (std::size_t k = 1; k < members; k++)
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(x, narrow[k]));
+            unsigned mask = unsigned(_mm_movemask_epi8(hits));
+            if (mask != 0)
+                return i + lowest_bit(mask);
+        }
+#endif
+        for (; i < count; i++)
+            if (std::memchr(set, bytes[i], members))
+                return i;
+        return count;
+    }
+
+    bool in_set[256] = {};
+    for (std::size_t k = 0; k < members; k++)
+        in_set[set[k]] = true;
+    for (; i < count; i++)
+        if (in_set[bytes[i]])
+            return i;
+    return count;
+}
+
+/// Returns the index of the first occurrence of the `length` bytes of `needle` in the `count` bytes
+/// at `bytes`, or `count` if there is none; `length` is at least 1.
+inline std::size_t find_bytes(const unsigned char *bytes, std::size_t count, const unsigned char *needle, std::size_t length)
+{
+    for (std::size_t i = 0; i + length <= count;)
+    {
+        const void *hit = std::memchr(bytes + i, needle[0], count - length + 1 - i);
+        if (!hit)
+            break;
+        i = std::size_t(static_cast<const unsigned char *>(hit) - bytes);
+        if (std::memcmp(bytes + i + 1, needle + 1, length - 1) == 0)
+            return i;
+        i++;
+    }
+    return count;
+}
+} // namespace detail
+
+/// Describes the bytes of `bytes` to readv() or writev().
+template <typename Byte>
+iovec as_iovec(vector_view<Byte> bytes)
+{
+    static_assert(is_byte<typename std::remove_cv<Byte>::type>::value, "as_iovec takes a view of bytes");
+    iovec io;
+    io.iov_base = const_cast<void *>(static_cast<const void *>(bytes.data()));
+    io.iov_len = bytes.size();
+    return io;
+}
+
+/**
+ * @brief Byte buffer with O(1) prefix removal
+ *
+ * Holds the bytes of a stream between the code that receives them and the code that parses them.
+ * Byte is one of the character types or std::byte; sc::vector<Byte> converts to and from a buffer
+ * without copying. Pointers, views and iterators into the buffer are invalidated by anything that
+ * adds bytes.
+ */
+template <typename Byte = char>
+class byte_buffer
+{
+    static_assert(is_byte<Byte>::value, "sc::byte_buffer holds a character type or std::byte");
+
+public:
+    using size_type = unsigned long;                 //!< The size type.
+    using value_type = Byte;                         //!< The byte type.
+    using pointer = Byte *;                          //!< Pointer to a byte of the buffer.
+    using iterator = MyIterator<Byte>;               //!< Iterator over the readable bytes.
+    using const_iterator = MyIterator<const Byte>;   //!< Constant iterator over the readable bytes.
+    static const size_type npos = size_type(-1);     //!< Returned by the searches when nothing is found.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Creates an empty buffer.
+    byte_buffer() : READ(0)
+    {
+    }
+
+    /// Creates a buffer whose readable bytes are those of `bytes`, taking over its storage.
+    explicit byte_buffer(vector<Byte> bytes) : STORAGE(std::move(bytes)), READ(0)
+    {
+    }
+
+    /// Moves the readable bytes to the front and hands the storage over as a vector; the buffer is left empty.
+    vector<Byte> release()
+    {
+        compact();
+        vector<Byte> bytes(std::move(STORAGE));
+        READ = 0;
+        return bytes;
+    }
+
+    //=== [II] ACCESS
+    /// Returns the number of readable bytes.
+    size_type size() const
+    {
+        return STORAGE.size() - READ;
+    }
+
+    /// Returns true if there is nothing to read.
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// Returns the number of bytes that can be written before the buffer reclaims space or grows.
+    size_type writable() const
+    {
+        return STORAGE.capacity() - STORAGE.size();
+    }
+
+    /// Returns the size of the underlying storage, consumed prefix included.
+    size_type capacity() const
+    {
+        return STORAGE.capacity();
+    }
+
+    /// Returns a pointer to the first readable byte.
+    pointer data()
+    {
+        return STORAGE.data() + READ;
+    }
+
+    /// Returns a pointer to the first readable byte.
+    const Byte *data() const
+    {
+        return STORAGE.data() + READ;
+    }
+
+    /// Returns the readable byte at `pos`.
+    Byte &operator[](size_type pos)
+    {
+        SC_VECTOR_REQUIRE(pos < size(), "operator[] index out of range");
+        return data()[pos];
+    }
+
+    /// Returns the readable byte at `pos`.
+    const Byte &operator[](size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos < size(), "operator[] index out of range");
+        return data()[pos];
+    }
+
+    /// Returns an iterator to the first readable byte.
+    iterator begin()
+    {
+        return iterator(data());
+    }
+
+    /// Returns an iterator past the last readable byte.
+    iterator end()
+    {
+        return iterator(data() + size());
+    }
+
+    /// Returns a constant iterator to the first readable byte.
+    const_iterator begin() const
+    {
+        return const_iterator(data());
+    }
+
+    /// Returns a constant iterator past the last readable byte.
+    const_iterator end() const
+    {
+        return const_iterator(data() + size());
+    }
+
+    /// Views the readable bytes.
+    vector_view<const Byte> view() const
+    {
+        return vector_view<const Byte>(data(), size());
+    }
+
+    //=== [III] WRITING
+    /// Appends `count` bytes copied from `bytes`, which may point into this buffer.
+    void append(const void *bytes, size_type count)
+    {
+        if (count == 0)
+            return;
+        if (count > writable() && overlaps(bytes, count))
+        {
+            vector<Byte> copy;
+            std::memcpy(copy.resize_for_overwrite(count), bytes, count);
+            return append(copy.data(), count);
+        }
+        std::memcpy(prepare(count), bytes, count);
+        commit(count);
+    }
+
+    /// Appends the bytes of `bytes`.
+    void append(vector_view<const Byte> bytes)
+    {
+        append(bytes.data(), bytes.size());
+    }
+
+    /// Appends one byte.
+    void push_back(Byte byte)
+    {
+        append(&byte, 1);
+    }
+
+    /// Makes room for at least `count` more bytes and returns where they go; commit() then makes
+    /// the bytes actually written readable.
+    pointer prepare(size_type count)
+    {
+        if (count > writable())
+            make_room(count);
+        return STORAGE.data() + STORAGE.size();
+    }
+
+    /// Makes readable the first `count` bytes written at the pointer returned by prepare().
+    void commit(size_type count)
+    {
+        SC_VECTOR_REQUIRE(count <= writable(), "commit() past the prepared bytes");
+        STORAGE.resize_for_overwrite(STORAGE.size() + count);
+    }
+
+    //=== [IV] READING
+    /// Drops the first `count` readable bytes in O(1).
+    void consume_front(size_type count)
+    {
+        SC_VECTOR_REQUIRE(count <= size(), "consume_front() past the readable bytes");
+        READ += count;
+        if (READ == STORAGE.size())
+            clear();
+    }
+
+    /// Drops every readable byte; the storage is kept.
+    void clear()
+    {
+        STORAGE.resize_for_overwrite(0);
+        READ = 0;
+    }
+
+    /// Moves the readable bytes to the front of the storage, giving the consumed prefix back to writes.
+    void compact()
+    {
+        if (READ == 0)
+            return;
+        size_type count = size();
+        if (count > 0)
+            std::memmove(STORAGE.data(), STORAGE.data() + READ, count);
+        STORAGE.resize_for_overwrite(count);
+        READ = 0;
+    }
+
+    /// Compacts and frees the storage beyond the readable bytes.
+    void shrink_to_fit()
+    {
+        compact();
+        STORAGE.shrink_to_fit();
+    }
+
+    //=== [V] SEARCHING
+    /// Returns the offset of the first readable byte equal to `byte` from `from` on, or npos.
+    size_type find(Byte byte, size_type from = 0) const
+    {
+        if (from >= size())
+            return npos;
+        const void *hit = std::memchr(data() + from, static_cast<unsigned char>(byte), size() - from);
+        return hit ? size_type(static_cast<const Byte *>(hit) - data()) : npos;
+    }
+
+    /// Returns the offset of the first occurrence of the `length` bytes at `needle` from `from` on, or npos.
+    size_type find(const void *needle, size_type length, size_type from = 0) const
+    {
+        if (from > size())
+            return npos;
+        if (length == 0)
+            return from;
+        size_type at = detail::find_bytes(bytes() + from, size() - from, static_cast<const unsigned char *>(needle), length);
+        return at == size() - from ? npos : at + from;
+    }
+
+    /// Returns the offset of the first occurrence of the NUL-terminated string `needle` (e.g. "\r\n")
+    /// from `from` on, or npos. Named apart from find() so that a pointer and a length never reach it.
+    size_type find_str(const char *needle, size_type from = 0) const
+    {
+        return find(needle, std::strlen(needle), from);
+    }
+
+    /// Returns the offset of the first readable byte from `from` on that is one of the `members`
+    /// bytes at `set`, or npos.
+    size_type find_first_of(const void *set, size_type members, size_type from = 0) const
+    {
+        if (from >= size())
+            return npos;
+        size_type at = detail::find_any(bytes() + from, size() - from, static_cast<const unsigned char *>(set), members);
+        return at == size() - from ? npos : at + from;
+    }
+
+    /// Returns the offset of the first readable byte from `from` on that is one of the characters
+    /// of the NUL-terminated string `set` (e.g. " \t\r\n"), or npos.
+    size_type find_first_of_str(const char *set, size_type from = 0) const
+    {
+        return find_first_of(set, std::strlen(set), from);
+    }
+
+    //=== [VI] SYSTEM CALLS
+    /// Reads once from `fd` with readv() into the free space and, past it, into a stack spill area
+    /// whose bytes are then appended. Returns the bytes read, 0 at the end of the stream, or -errno.
+    long read_from(int fd)
+    {
+        char spill[SC_VECTOR_READ_SPILL_BYTES];
+        size_type room = writable();
+        iovec io[2];
+        io[0].iov_base = STORAGE.data() + STORAGE.size();
+        io[0].iov_len = room;
+        io[1].iov_base = spill;
+        io[1].iov_len = sizeof(spill);
+
+        int parts = room < sizeof(spill) ? 2 : 1; // with that much free space, the spill is not worth it
+        ssize_t got;
+        do
+            got = ::readv(fd, io, parts);
+        while (got < 0 && errno == EINTR);
+        if (got < 0)
+            return -errno;
+
+        if (size_type(got) <= room)
+            commit(size_type(got));
+        else
+        {
+            commit(room);
+            append(spill, size_type(got) - room);
+        }
+        return long(got);
+    }
+
+    /// Writes the readable bytes to `fd` once and consumes those written. Returns their number or -errno.
+    long write_to(int fd)
+    {
+        ssize_t put;
+        do
+            put = ::write(fd, data(), size());
+        while (put < 0 && errno == EINTR);
+        if (put < 0)
+            return -errno;
+        consume_front(size_type(put));
+        return long(put);
+    }
+
+private:
+    /// The readable bytes, as unsigned char for the search kernels.
+    const unsigned char *bytes() const
+    {
+        return reinterpret_cast<const unsigned char *>(data());
+    }
+
+    /// True when [bytes, bytes + count) lies inside the storage, which growing would free.
+    bool overlaps(const void *bytes, size_type count) const
+    {
+        const char *first = static_cast<const char *>(bytes);
+        const char *storage = reinterpret_cast<const char *>(STORAGE.data());
+        return first + count > storage && first < storage + STORAGE.capacity();
+    }
+
+    /// Slow path of prepare(): reclaims the consumed prefix when that is enough room and moves no
+    /// more bytes than were consumed, and otherwise moves the readable bytes to a larger storage.
+    void make_room(size_type count)
+    {
+        if (READ >= count - writable() && READ >= size())
+            return compact();
+
+        vector<Byte> grown;
+        grown.reserve(std::max(2 * STORAGE.capacity(), size() + count));
+        if (size() > 0)
+            std::memcpy(grown.resize_for_overwrite(size()), data(), size());
+        STORAGE = std::move(grown);
+        READ = 0;
+    }
+
+    vector<Byte> STORAGE; //!< Consumed bytes, then readable bytes; its spare capacity is the free space.
+    size_type READ;       //!< Offset of the first readable byte in STORAGE.
+};
+
+template <typename Byte>
+const typename byte_buffer<Byte>::size_type byte_buffer<Byte>::npos;
+
+/// Writes the readable bytes of up to 16 buffers with one writev() call, then consumes the bytes
+/// written from each buffer in order. Returns their number or -errno.
+template <typename Byte>
+long write_buffers(int fd, std::initializer_list<byte_buffer<Byte> *> buffers)
+{
+    const std::size_t BATCH = 16;
+    iovec io[BATCH];
+    std::size_t count = 0;
+    for (byte_buffer<Byte> *buffer : buffers)
+        if (count < BATCH)
+            io[count++] = as_iovec(buffer->view());
+
+    ssize_t put;
+    do
+        put = ::writev(fd, io, int(count));
+    while (put < 0 && errno == EINTR);
+    if (put < 0)
+        return -errno;
+
+    std::size_t left = std::size_t(put);
+    for (byte_buffer<Byte> *buffer : buffers)
+    {
+        std::size_t taken = left < buffer->size() ? left : buffer->size();
+        buffer->consume_front(taken);
+        left -= taken;
+    }
+    return long(put);
+}
+} // namespace sc
+
+#endif
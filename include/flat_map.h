@@ -0,0 +1,542 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Implementation of a map stored as two parallel sorted sc::vector, one for the keys and one for
+ * the mapped values.
+ *
+ * Keeping the keys apart from the values means a lookup only touches key bytes: the binary search
+ * walks a dense array and the value is read once, at the end. Like sc::flat_set, prefer the bulk
+ * range constructor and insert_range over inserting one pair at a time.
+ */
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <cstddef>          // std::size_t, std::ptrdiff_t
+#include <algorithm>        // std::stable_sort
+#include <functional>       // std::less
+#include <initializer_list> // std::initializer_list
+#include <iterator>         // std::random_access_iterator_tag
+#include <stdexcept>        // std::out_of_range
+#include <type_traits>      // std::conditional, std::enable_if, std::is_convertible
+#include <utility>          // std::pair, std::move
+
+#include "./vector.h"
+#include "./flat_set.h"
+
+namespace sc
+{
+/**
+ * @brief Iterator over a flat_map
+ *
+ * Walks the key and value arrays in lockstep. Dereferencing yields a pair of references,
+ * `std::pair<const Key &, T &>`, built on the fly; `it->second` works through a small proxy.
+ */
+template <typename Key, typename T>
+class flat_map_iterator
+{
+public:
+    using iterator_category = std::random_access_iterator_tag;                  //!< Iterator category.
+    using difference_type = std::ptrdiff_t;                                     //!< Difference type.
+    using value_type = std::pair<Key, typename std::remove_const<T>::type>;     //!< Value type.
+    using reference = std::pair<const Key &, T &>;                              //!< Reference to a key and its value.
+
+    /// Makes `it->first` and `it->second` work on a reference built by value.
+    struct arrow_proxy
+    {
+        reference ref; //!< The pair of references.
+
+        /// Returns the address of the pair of references.
+        reference *operator->()
+        {
+            return &ref;
+        }
+    };
+    using pointer = arrow_proxy; //!< What operator-> returns.
+
+    /// Default constructor that creates a singular iterator.
+    flat_map_iterator() : KEY(nullptr), VALUE(nullptr)
+    {
+    }
+
+    /// Constructs an iterator on the key at `key` and the value at `value`.
+    flat_map_iterator(const Key *key, T *value) : KEY(key), VALUE(value)
+    {
+    }
+
+    /// A mutable iterator converts to a constant one.
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U *, T *>::value>::type>
+    flat_map_iterator(const flat_map_iterator<Key, U> &other) : KEY(other.key()), VALUE(other.value())
+    {
+    }
+
+    /// Returns the key and the value at the current position.
+    reference operator*() const
+    {
+        return reference(*KEY, *VALUE);
+    }
+
+    /// Returns a proxy to the key and the value at the current position.
+    pointer operator->() const
+    {
+        return pointer{**this};
+    }
+
+    /// Returns the key and the value `n` positions away.
+    reference operator[](difference_type n) const
+    {
+        return *(*this + n);
+    }
+
+    /// Advances the iterator to the next pair.
+    flat_map_iterator &operator++()
+    {
+        ++KEY;
+        ++VALUE;
+        return *this;
+    }
+
+    /// Advances the iterator to the next pair.
+    flat_map_iterator operator++(int)
+    {
+        flat_map_iterator old(*this);
+        ++*this;
+        return old;
+    }
+
+    /// Moves the iterator to the previous pair.
+    flat_map_iterator &operator--()
+    {
+        --KEY;
+        --VALUE;
+        return *this;
+    }
+
+    /// Moves the iterator to the previous pair.
+    flat_map_iterator operator--(int)
+    {
+        flat_map_iterator old(*this);
+        --*this;
+        return old;
+    }
+
+    /// Advances the iterator by `n` pairs.
+    flat_map_iterator &operator+=(difference_type n)
+    {
+        KEY += n;
+        VALUE += n;
+        return *this;
+    }
+
+    /// Moves the iterator back by `n` pairs.
+    flat_map_iterator &operator-=(difference_type n)
+    {
+        return *this += -n;
+    }
+
+    /// Returns an iterator `n` pairs ahead.
+    flat_map_iterator operator+(difference_type n) const
+    {
+        return flat_map_iterator(*this) += n;
+    }
+
+    /// Returns an iterator `n` pairs behind.
+    flat_map_iterator operator-(difference_type n) const
+    {
+        return flat_map_iterator(*this) -= n;
+    }
+
+    /// Returns the number of pairs between both iterators.
+    difference_type operator-(const flat_map_iterator &other) const
+    {
+        return KEY - other.KEY;
+    }
+
+    /// Check if both iterators point to the same pair.
+    bool operator==(const flat_map_iterator &other) const
+    {
+        return KEY == other.KEY;
+    }
+
+    /// Check if the iterators point to different pairs.
+    bool operator!=(const flat_map_iterator &other) const
+    {
+        return KEY != other.KEY;
+    }
+
+    /// Check if this iterator comes before `other`.
+    bool operator<(const flat_map_iterator &other) const
+    {
+        return KEY < other.KEY;
+    }
+
+    /// Check if this iterator comes after `other`.
+    bool operator>(const flat_map_iterator &other) const
+    {
+        return KEY > other.KEY;
+    }
+
+    /// Check if this iterator does not come after `other`.
+    bool operator<=(const flat_map_iterator &other) const
+    {
+        return KEY <= other.KEY;
+    }
+
+    /// Check if this iterator does not come before `other`.
+    bool operator>=(const flat_map_iterator &other) const
+    {
+        return KEY >= other.KEY;
+    }
+
+    /// Returns the address of the current key.
+    const Key *key() const
+    {
+        return KEY;
+    }
+
+    /// Returns the address of the current value.
+    T *value() const
+    {
+        return VALUE;
+    }
+
+private:
+    const Key *KEY; //!< Current position in the key array.
+    T *VALUE;       //!< Current position in the value array.
+};
+
+/**
+ * @brief Sorted-vector map
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Maps unique keys, ordered by `Compare`, to values of type `T`. Keys and values live in two
+ * sc::vector of the same length; iterators are invalidated by any insertion or removal.
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map
+{
+public:
+    using size_type = unsigned long;                               //!< The size type.
+    using key_type = Key;                                          //!< The key type.
+    using mapped_type = T;                                         //!< The mapped type.
+    using value_type = std::pair<Key, T>;                          //!< What the range constructor and insert take.
+    using key_compare = Compare;                                   //!< The ordering of the keys.
+    using key_container_type = sc::vector<Key>;                    //!< The underlying key storage.
+    using mapped_container_type = sc::vector<T>;                   //!< The underlying value storage.
+    using iterator = flat_map_iterator<Key, T>;                    //!< Iterator over the pairs.
+    using const_iterator = flat_map_iterator<Key, const T>;        //!< Constant iterator over the pairs.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Default constructor that creates an empty map.
+    explicit flat_map(const Compare &comp = Compare()) : KEYS(), VALUES(), COMP(comp)
+    {
+    }
+
+    /// Constructs the map with the pairs in the range [first, last), which may be unsorted.
+    /// When a key appears more than once, its first pair wins, as with repeated std::map::insert.
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardIt>
+    flat_map(ForwardIt first, ForwardIt last, const Compare &comp = Compare()) : KEYS(), VALUES(), COMP(comp)
+    {
+        insert_range(first, last);
+    }
+
+    /// Constructs the map with the pairs of the initializer list init.
+    flat_map(std::initializer_list<value_type> ilist, const Compare &comp = Compare()) : flat_map(ilist.begin(), ilist.end(), comp)
+    {
+    }
+
+    //=== [II] ITERATORS
+    /// Returns an iterator pointing to the pair with the smallest key.
+    iterator begin()
+    {
+        return iterator(KEYS.data(), VALUES.data());
+    }
+
+    /// Returns an iterator pointing just after the pair with the largest key.
+    iterator end()
+    {
+        return begin() + KEYS.size();
+    }
+
+    /// Returns a constant iterator pointing to the pair with the smallest key.
+    const_iterator begin() const
+    {
+        return cbegin();
+    }
+
+    /// Returns a constant iterator pointing just after the pair with the largest key.
+    const_iterator end() const
+    {
+        return cend();
+    }
+
+    /// Returns a constant iterator pointing to the pair with the smallest key.
+    const_iterator cbegin() const
+    {
+        return const_iterator(KEYS.data(), VALUES.data());
+    }
+
+    /// Returns a constant iterator pointing just after the pair with the largest key.
+    const_iterator cend() const
+    {
+        return cbegin() + KEYS.size();
+    }
+
+    //=== [III] Capacity
+    /// Return the number of pairs in the map.
+    size_type size() const
+    {
+        return KEYS.size();
+    }
+
+    /// Returns true if the map holds no pairs, and false otherwise.
+    bool empty() const
+    {
+        return KEYS.empty();
+    }
+
+    /// Makes room for `new_cap` pairs.
+    void reserve(size_type new_cap)
+    {
+        KEYS.reserve(new_cap);
+        VALUES.reserve(new_cap);
+    }
+
+    //=== [IV] Modifiers
+    /// Removes every pair.
+    void clear()
+    {
+        KEYS.clear();
+        VALUES.clear();
+    }
+
+    /// Inserts `pair` unless its key is present. Returns the position of the key and whether it was inserted.
+    std::pair<iterator, bool> insert(const value_type &pair)
+    {
+        size_type pos = detail::lower_bound_index(KEYS.data(), KEYS.size(), pair.first, COMP);
+        if (pos < KEYS.size() && not COMP(pair.first, KEYS[pos]))
+            return {begin() + pos, false};
+
+        KEYS.insert(KEYS.begin() + pos, pair.first);
+        try
+        {
+            VALUES.insert(VALUES.begin() + pos, pair.second);
+        }
+        catch (...)
+        {
+            KEYS.erase(KEYS.begin() + pos); // keep both arrays the same length
+            throw;
+        }
+        return {begin() + pos, true};
+    }
+
+    /// Inserts `value` under `key`, or overwrites the value already there. Returns whether it was inserted.
+    std::pair<iterator, bool> insert_or_assign(const Key &key, const T &value)
+    {
+        auto result = insert(value_type(key, value));
+        if (not result.second)
+            result.first->second = value;
+        return result;
+    }
+
+    /// Inserts the pairs in [first, last) whose keys are not present yet.
+    /// The new pairs are sorted on their own and merged with the map in a single pass, so inserting
+    /// `m` pairs costs O(m log m + size()) instead of `m` shifts of both arrays. If a copy throws, the
+    /// map is left unchanged.
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardIt>
+    void insert_range(ForwardIt first, ForwardIt last)
+    {
+        sc::vector<value_type> fresh;
+        fresh.assign(first, last);
+
+        const Compare &comp = COMP;
+        value_type *pairs = fresh.data();
+        std::stable_sort(pairs, pairs + fresh.size(),
+                         [&comp](const value_type &a, const value_type &b) { return comp(a.first, b.first); });
+
+        // Keep the first pair of each key and drop the keys already present, in one walk.
+        size_type kept = 0;
+        size_type old = 0;
+        for (size_type i = 0; i < fresh.size(); i++)
+        {
+            if (kept > 0 && not COMP(pairs[kept - 1].first, pairs[i].first))
+                continue;
+            while (old < KEYS.size() && COMP(KEYS[old], pairs[i].first))
+                old++;
+            if (old < KEYS.size() && not COMP(pairs[i].first, KEYS[old]))
+                continue;
+            if (kept != i)
+                pairs[kept] = std::move(pairs[i]);
+            kept++;
+        }
+        if (kept == 0)
+            return;
+
+        // Merge into fresh arrays and swap them in, so a throwing copy leaves the map as it was.
+        // The old pairs are moved only when nothing in the merge can throw; the staged ones always are.
+        typedef typename std::conditional<std::is_nothrow_move_assignable<Key>::value &&
+                                              std::is_nothrow_move_assignable<T>::value,
+                                          Key &&, const Key &>::type old_key;
+        typedef typename std::conditional<std::is_nothrow_move_assignable<Key>::value &&
+                                              std::is_nothrow_move_assignable<T>::value,
+                                          T &&, const T &>::type old_value;
+
+        key_container_type keys;
+        mapped_container_type values;
+        keys.resize(KEYS.size() + kept);
+        values.resize(KEYS.size() + kept);
+
+        size_type i = 0;
+        size_type j = 0;
+        for (size_type k = 0; k < keys.size(); k++)
+        {
+            if (j == kept || (i < KEYS.size() && COMP(KEYS[i], pairs[j].first)))
+            {
+                keys[k] = static_cast<old_key>(KEYS[i]);
+                values[k] = static_cast<old_value>(VALUES[i]);
+                i++;
+            }
+            else
+            {
+                keys[k] = std::move(pairs[j].first);
+                values[k] = std::move(pairs[j].second);
+                j++;
+            }
+        }
+        KEYS.swap(keys);
+        VALUES.swap(values);
+    }
+
+    /// Inserts the pairs of the initializer_list `ilist` whose keys are not present yet.
+    void insert_range(std::initializer_list<value_type> ilist)
+    {
+        insert_range(ilist.begin(), ilist.end());
+    }
+
+    /// Removes the pair at `pos` and returns an iterator to the pair that followed it.
+    iterator erase(const_iterator pos)
+    {
+        size_type offset = pos - cbegin();
+        KEYS.erase(KEYS.begin() + offset);
+        VALUES.erase(VALUES.begin() + offset);
+        return begin() + offset;
+    }
+
+    /// Removes the pair whose key is equivalent to `key`, if any. Returns the number of pairs removed (0 or 1).
+    size_type erase(const Key &key)
+    {
+        size_type pos = find_index(key);
+        if (pos == KEYS.size())
+            return 0;
+
+        KEYS.erase(KEYS.begin() + pos);
+        VALUES.erase(VALUES.begin() + pos);
+        return 1;
+    }
+
+    //=== [V] Element access
+    /// Returns the value mapped to `key`, inserting a default-constructed one if the key is absent.
+    T &operator[](const Key &key)
+    {
+        return insert(value_type(key, T())).first->second;
+    }
+
+    /// Returns the value mapped to `key`, with bounds-checking.
+    T &at(const Key &key)
+    {
+        size_type pos = find_index(key);
+        if (pos == KEYS.size())
+            throw std::out_of_range("sc::flat_map::at: key not found");
+        return VALUES[pos];
+    }
+
+    /// Returns the value mapped to `key`, with bounds-checking.
+    const T &at(const Key &key) const
+    {
+        size_type pos = find_index(key);
+        if (pos == KEYS.size())
+            throw std::out_of_range("sc::flat_map::at: key not found");
+        return VALUES[pos];
+    }
+
+    //=== [VI] Lookup
+    /// Returns an iterator to the pair whose key is equivalent to `key`, or end() if there is none.
+    iterator find(const Key &key)
+    {
+        return begin() + find_index(key);
+    }
+
+    /// Returns an iterator to the pair whose key is equivalent to `key`, or end() if there is none.
+    const_iterator find(const Key &key) const
+    {
+        return cbegin() + find_index(key);
+    }
+
+    /// Returns true if a key equivalent to `key` is present.
+    bool contains(const Key &key) const
+    {
+        return find_index(key) != KEYS.size();
+    }
+
+    /// Returns the number of pairs whose key is equivalent to `key` (0 or 1).
+    size_type count(const Key &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /// Returns an iterator to the first pair whose key is not less than `key`.
+    const_iterator lower_bound(const Key &key) const
+    {
+        return cbegin() + detail::lower_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+    }
+
+    /// Returns an iterator to the first pair whose key is greater than `key`.
+    const_iterator upper_bound(const Key &key) const
+    {
+        return cbegin() + detail::upper_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+    }
+
+    /// Returns the sorted keys.
+    const key_container_type &keys() const
+    {
+        return KEYS;
+    }
+
+    /// Returns the values, in the order of their keys.
+    const mapped_container_type &values() const
+    {
+        return VALUES;
+    }
+
+    /// Check if both maps hold the same pairs
+    bool operator==(const flat_map &other) const
+    {
+        return KEYS == other.KEYS && VALUES == other.VALUES;
+    }
+
+    /// Check if the maps hold different pairs
+    bool operator!=(const flat_map &other) const
+    {
+        return not(*this == other);
+    }
+
+private:
+    /// Position of the key equivalent to `key`, or size() if there is none.
+    size_type find_index(const Key &key) const
+    {
+        size_type pos = detail::lower_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+        if (pos == KEYS.size() || COMP(key, KEYS[pos]))
+            return KEYS.size();
+        return pos;
+    }
+
+    key_container_type KEYS;      //!< The keys, sorted by `COMP` and without equivalent pairs.
+    mapped_container_type VALUES; //!< The value of each key, at the same position.
+    Compare COMP;                 //!< The ordering of the keys.
+};
+} // namespace sc
+
+#endif
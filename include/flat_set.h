@@ -0,0 +1,317 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Implementation of a set stored as a sorted sc::vector.
+ *
+ * Keys sit next to each other in one allocation, so a lookup is a binary search over a
+ * contiguous array instead of a pointer chase through tree nodes, and the container costs
+ * `sizeof(Key)` per element instead of a node per element. Insertions and removals shift the
+ * tail, so build the set in bulk (range constructor or insert_range) whenever possible.
+ */
+#ifndef FLAT_SET_H
+#define FLAT_SET_H
+
+#include <cstddef>          // std::size_t, std::ptrdiff_t
+#include <algorithm>        // std::sort, std::unique
+#include <functional>       // std::less
+#include <initializer_list> // std::initializer_list
+#include <type_traits>      // std::conditional, std::is_nothrow_move_assignable
+#include <utility>          // std::pair, std::move
+
+#include "./vector.h"
+
+namespace sc
+{
+namespace detail
+{
+/// Index of the first of the `count` sorted keys at `keys` that is not less than `key`.
+/// The loop has a fixed trip count and no data-dependent branch, so the compiler turns it into conditional moves.
+template <typename Key, typename Compare>
+std::size_t lower_bound_index(const Key *keys, std::size_t count, const Key &key, const Compare &comp)
+{
+    if (count == 0)
+        return 0;
+
+    const Key *base = keys;
+    while (count > 1)
+    {
+        std::size_t half = count / 2;
+        base = comp(base[half], key) ? base + half : base;
+        count -= half;
+    }
+    return (base - keys) + comp(*base, key);
+}
+
+/// Index of the first of the `count` sorted keys at `keys` that is greater than `key`.
+template <typename Key, typename Compare>
+std::size_t upper_bound_index(const Key *keys, std::size_t count, const Key &key, const Compare &comp)
+{
+    if (count == 0)
+        return 0;
+
+    const Key *base = keys;
+    while (count > 1)
+    {
+        std::size_t half = count / 2;
+        base = comp(key, base[half]) ? base : base + half;
+        count -= half;
+    }
+    return (base - keys) + not comp(key, *base);
+}
+} // namespace detail
+
+/**
+ * @brief Sorted-vector set
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Holds unique keys, ordered by `Compare`, in an sc::vector. Iterators are invalidated by any
+ * insertion or removal, like the iterators of the underlying vector.
+ */
+template <typename Key, typename Compare = std::less<Key>>
+class flat_set
+{
+public:
+    using size_type = unsigned long;                      //!< The size type.
+    using key_type = Key;                                 //!< The key type.
+    using value_type = Key;                               //!< The value type.
+    using key_compare = Compare;                          //!< The ordering of the keys.
+    using const_reference = const value_type &;           //!< Const reference to a key stored in the container.
+    using container_type = sc::vector<Key>;               //!< The underlying storage.
+    using iterator = typename container_type::const_iterator;       //!< Keys cannot be changed in place.
+    using const_iterator = typename container_type::const_iterator; //!< Iterator that points to a specific key.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Default constructor that creates an empty set.
+    explicit flat_set(const Compare &comp = Compare()) : KEYS(), COMP(comp)
+    {
+    }
+
+    /// Constructs the set with the keys in the range [first, last), which may be unsorted and hold duplicates.
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardIt>
+    flat_set(ForwardIt first, ForwardIt last, const Compare &comp = Compare()) : KEYS(), COMP(comp)
+    {
+        KEYS.assign(first, last);
+        sort_unique(KEYS);
+    }
+
+    /// Constructs the set with the keys of the initializer list init.
+    flat_set(std::initializer_list<Key> ilist, const Compare &comp = Compare()) : flat_set(ilist.begin(), ilist.end(), comp)
+    {
+    }
+
+    /// Replaces the contents with the keys of initializer list ilist.
+    flat_set &operator=(std::initializer_list<Key> ilist)
+    {
+        KEYS.assign(ilist);
+        sort_unique(KEYS);
+        return *this;
+    }
+
+    //=== [II] ITERATORS
+    /// Returns an iterator pointing to the smallest key.
+    const_iterator begin() const
+    {
+        return KEYS.cbegin();
+    }
+
+    /// Returns an iterator pointing just after the largest key.
+    const_iterator end() const
+    {
+        return KEYS.cend();
+    }
+
+    /// Returns an iterator pointing to the smallest key.
+    const_iterator cbegin() const
+    {
+        return KEYS.cbegin();
+    }
+
+    /// Returns an iterator pointing just after the largest key.
+    const_iterator cend() const
+    {
+        return KEYS.cend();
+    }
+
+    //=== [III] Capacity
+    /// Return the number of keys in the set.
+    size_type size() const
+    {
+        return KEYS.size();
+    }
+
+    /// Returns true if the set holds no keys, and false otherwise.
+    bool empty() const
+    {
+        return KEYS.empty();
+    }
+
+    /// Makes room for `new_cap` keys.
+    void reserve(size_type new_cap)
+    {
+        KEYS.reserve(new_cap);
+    }
+
+    //=== [IV] Modifiers
+    /// Removes every key.
+    void clear()
+    {
+        KEYS.clear();
+    }
+
+    /// Inserts `key` unless an equivalent key is present. Returns its position and whether it was inserted.
+    std::pair<const_iterator, bool> insert(const_reference key)
+    {
+        size_type pos = detail::lower_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+        if (pos < KEYS.size() && not COMP(key, KEYS[pos]))
+            return {KEYS.cbegin() + pos, false};
+
+        KEYS.insert(KEYS.begin() + pos, key);
+        return {KEYS.cbegin() + pos, true};
+    }
+
+    /// Inserts the keys in [first, last) that are not present yet.
+    /// The new keys are sorted on their own and merged with the set in a single pass, so inserting
+    /// `m` keys costs O(m log m + size()) instead of `m` shifts of the tail. If a copy throws, the
+    /// set is left unchanged.
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardIt>
+    void insert_range(ForwardIt first, ForwardIt last)
+    {
+        container_type fresh;
+        fresh.assign(first, last);
+        sort_unique(fresh);
+
+        // Drop the keys already present; both sides are sorted so one walk is enough.
+        size_type kept = 0;
+        size_type old = 0;
+        for (size_type i = 0; i < fresh.size(); i++)
+        {
+            while (old < KEYS.size() && COMP(KEYS[old], fresh[i]))
+                old++;
+            if (old < KEYS.size() && not COMP(fresh[i], KEYS[old]))
+                continue;
+            if (kept != i)
+                fresh[kept] = std::move(fresh[i]);
+            kept++;
+        }
+        if (kept == 0)
+            return;
+
+        // Merge into a fresh array and swap it in, so a throwing copy leaves the set as it was.
+        // The old keys are moved only when that cannot throw; the staged ones always are.
+        typedef typename std::conditional<std::is_nothrow_move_assignable<Key>::value, Key &&, const Key &>::type
+            old_key;
+
+        container_type merged;
+        merged.resize(KEYS.size() + kept);
+
+        size_type i = 0;
+        size_type j = 0;
+        for (size_type k = 0; k < merged.size(); k++)
+        {
+            if (j == kept || (i < KEYS.size() && COMP(KEYS[i], fresh[j])))
+                merged[k] = static_cast<old_key>(KEYS[i++]);
+            else
+                merged[k] = std::move(fresh[j++]);
+        }
+        KEYS.swap(merged);
+    }
+
+    /// Inserts the keys of the initializer_list `ilist` that are not present yet.
+    void insert_range(std::initializer_list<Key> ilist)
+    {
+        insert_range(ilist.begin(), ilist.end());
+    }
+
+    /// Removes the key at `pos` and returns an iterator to the key that followed it.
+    const_iterator erase(const_iterator pos)
+    {
+        size_type offset = pos - KEYS.cbegin();
+        KEYS.erase(KEYS.begin() + offset);
+        return KEYS.cbegin() + offset;
+    }
+
+    /// Removes the key equivalent to `key`, if any. Returns the number of keys removed (0 or 1).
+    size_type erase(const_reference key)
+    {
+        size_type pos = detail::lower_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+        if (pos == KEYS.size() || COMP(key, KEYS[pos]))
+            return 0;
+
+        KEYS.erase(KEYS.begin() + pos);
+        return 1;
+    }
+
+    //=== [V] Lookup
+    /// Returns an iterator to the key equivalent to `key`, or end() if there is none.
+    const_iterator find(const_reference key) const
+    {
+        size_type pos = detail::lower_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+        if (pos == KEYS.size() || COMP(key, KEYS[pos]))
+            return end();
+        return KEYS.cbegin() + pos;
+    }
+
+    /// Returns true if a key equivalent to `key` is present.
+    bool contains(const_reference key) const
+    {
+        size_type pos = detail::lower_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+        return pos < KEYS.size() && not COMP(key, KEYS[pos]);
+    }
+
+    /// Returns the number of keys equivalent to `key` (0 or 1).
+    size_type count(const_reference key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /// Returns an iterator to the first key not less than `key`.
+    const_iterator lower_bound(const_reference key) const
+    {
+        return KEYS.cbegin() + detail::lower_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+    }
+
+    /// Returns an iterator to the first key greater than `key`.
+    const_iterator upper_bound(const_reference key) const
+    {
+        return KEYS.cbegin() + detail::upper_bound_index(KEYS.data(), KEYS.size(), key, COMP);
+    }
+
+    /// Returns the sorted keys.
+    const container_type &keys() const
+    {
+        return KEYS;
+    }
+
+    /// Check if both sets hold the same keys
+    bool operator==(const flat_set &other) const
+    {
+        return KEYS == other.KEYS;
+    }
+
+    /// Check if the sets hold different keys
+    bool operator!=(const flat_set &other) const
+    {
+        return not(*this == other);
+    }
+
+private:
+    /// Sorts `keys` and drops the duplicates.
+    void sort_unique(container_type &keys) const
+    {
+        const Compare &comp = COMP;
+        Key *first = keys.data();
+        std::sort(first, first + keys.size(), comp);
+        Key *last = std::unique(first, first + keys.size(), [&comp](const Key &a, const Key &b) { return not comp(a, b); });
+        keys.erase(keys.begin() + (last - first), keys.end());
+    }
+
+    container_type KEYS; //!< The keys, sorted by `COMP` and without equivalent pairs.
+    Compare COMP;        //!< The ordering of the keys.
+};
+} // namespace sc
+
+#endif
@@ -0,0 +1,428 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Growth tracer used by the vector class when `SC_VECTOR_TRACE` is defined.
+ *
+ * Each reallocation is stored as a growth_event in a ring buffer owned by the thread that
+ * caused it, so recording never takes a lock. The collected events can be exported in the
+ * Chrome trace event format (readable by chrome://tracing and ui.perfetto.dev) or folded
+ * into a per call site heatmap.
+ */
+#ifndef GROWTH_TRACE_H
+#define GROWTH_TRACE_H
+
+#include <algorithm> // std::sort
+#include <atomic>
+#include <chrono>
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <map>
+#include <memory> // std::shared_ptr
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <tuple> // std::tie
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#ifdef __cpp_lib_source_location
+#include <source_location>
+#endif
+
+#ifndef SC_VECTOR_TRACE_RING_SIZE
+/// Number of events kept per thread; older events are overwritten. Must be a power of two.
+#define SC_VECTOR_TRACE_RING_SIZE 4096
+#endif
+
+namespace sc
+{
+namespace trace
+{
+#ifdef __cpp_lib_source_location
+using source_location = std::source_location;
+#else
+/**
+ * @brief Call site of a traced operation
+ *
+ * Stand-in for `std::source_location` on pre-C++20 builds, filled by the GCC/Clang builtins.
+ */
+class source_location
+{
+public:
+    /// Returns the location of the caller.
+    static source_location current(const char *file = __builtin_FILE(),
+                                   const char *function = __builtin_FUNCTION(),
+                                   std::uint_least32_t line = __builtin_LINE()) noexcept
+    {
+        source_location loc;
+        loc.m_file = file;
+        loc.m_function = function;
+        loc.m_line = line;
+        return loc;
+    }
+
+    /// Returns the name of the source file.
+    const char *file_name() const noexcept { return m_file; }
+    /// Returns the name of the enclosing function.
+    const char *function_name() const noexcept { return m_function; }
+    /// Returns the line number.
+    std::uint_least32_t line() const noexcept { return m_line; }
+    /// Column numbers are not available without `std::source_location`.
+    std::uint_least32_t column() const noexcept { return 0; }
+
+private:
+    const char *m_file = "";     //!< Source file of the call site.
+    const char *m_function = ""; //!< Function containing the call site.
+    std::uint_least32_t m_line = 0; //!< Line of the call site.
+};
+#endif
+
+/// One capacity change of a vector.
+struct growth_event
+{
+    std::uint64_t timestamp_ns;  //!< Start of the reallocation, in nanoseconds since the trace epoch.
+    std::uint64_t duration_ns;   //!< Time spent allocating and copying.
+    std::size_t old_capacity;    //!< Capacity before the reallocation.
+    std::size_t new_capacity;    //!< Capacity after the reallocation.
+    std::size_t size;            //!< Number of elements carried over to the new buffer.
+    std::size_t element_size;    //!< `sizeof(T)` of the vector.
+    const char *file;            //!< Source file of the call site.
+    const char *function;        //!< Function containing the call site.
+    std::uint_least32_t line;    //!< Line of the call site.
+    unsigned thread;             //!< Trace id of the recording thread.
+};
+
+/// Nanoseconds elapsed since the trace epoch (the first use of the tracer).
+inline std::uint64_t now() noexcept
+{
+    using clock = std::chrono::steady_clock;
+    static const clock::time_point epoch = clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - epoch).count();
+}
+
+/**
+ * @brief Single-producer ring of growth events
+ *
+ * Only the owning thread pushes; any thread may read a snapshot. Each slot carries a sequence
+ * number so that a reader skips slots that are being overwritten while it copies them.
+ */
+class growth_ring
+{
+public:
+    static constexpr std::size_t capacity = SC_VECTOR_TRACE_RING_SIZE; //!< Number of slots.
+    static_assert((capacity & (capacity - 1)) == 0, "SC_VECTOR_TRACE_RING_SIZE must be a power of two");
+
+    /// Creates an empty ring for the thread with trace id `thread`.
+    explicit growth_ring(unsigned thread) : m_thread(thread), m_head(0) {}
+
+    /// Trace id of the owning thread.
+    unsigned thread() const noexcept { return m_thread; }
+
+    /// Appends an event, overwriting the oldest one when full. Must be called by the owner only.
+    void push(const growth_event &e) noexcept
+    {
+        std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        slot &s = m_slots[head & (capacity - 1)];
+        s.seq.store(2 * head + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.event = e;
+        s.seq.store(2 * head + 2, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    /// Calls `f` for every event still held by the ring, oldest first.
+    template <typename Fn>
+    void for_each(Fn f) const
+    {
+        std::uint64_t head = m_head.load(std::memory_order_acquire);
+        std::uint64_t first = head > capacity ? head - capacity : 0;
+
+        for (std::uint64_t i = first; i < head; i++)
+        {
+            const slot &s = m_slots[i & (capacity - 1)];
+            std::uint64_t seq = s.seq.load(std::memory_order_acquire);
+            if (seq != 2 * i + 2)
+                continue;
+
+            growth_event e = s.event;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) != seq)
+                continue;
+
+            f(e);
+        }
+    }
+
+    /// Number of events lost because the ring wrapped around.
+    std::uint64_t dropped() const noexcept
+    {
+        std::uint64_t head = m_head.load(std::memory_order_acquire);
+        return head > capacity ? head - capacity : 0;
+    }
+
+    /// Forgets every event. Must not race with `push`.
+    void clear() noexcept
+    {
+        for (auto &s : m_slots)
+            s.seq.store(0, std::memory_order_relaxed);
+        m_head.store(0, std::memory_order_release);
+    }
+
+private:
+    /// Storage for one event.
+    struct slot
+    {
+        std::atomic<std::uint64_t> seq{0}; //!< Even when `event` is stable, odd while it is written.
+        growth_event event;                //!< The recorded event.
+    };
+
+    unsigned m_thread;                  //!< Trace id of the owning thread.
+    std::atomic<std::uint64_t> m_head;  //!< Number of events ever pushed.
+    slot m_slots[capacity];             //!< The ring itself.
+};
+
+/**
+ * @brief Registry of the per-thread rings
+ *
+ * Rings are shared with the registry, so events survive the thread that recorded them.
+ * The mutex is only taken when a thread records its first event and when exporting.
+ */
+class registry
+{
+public:
+    /// Returns the process-wide registry.
+    static registry &instance()
+    {
+        static registry r;
+        return r;
+    }
+
+    /// Creates and registers a ring for the calling thread.
+    std::shared_ptr<growth_ring> attach()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::shared_ptr<growth_ring> ring = std::make_shared<growth_ring>(static_cast<unsigned>(m_rings.size()) + 1);
+        m_rings.push_back(ring);
+        return ring;
+    }
+
+    /// Returns every ring registered so far.
+    std::vector<std::shared_ptr<growth_ring>> rings() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_rings;
+    }
+
+private:
+    registry() { now(); }
+
+    mutable std::mutex m_mutex;                        //!< Guards `m_rings`.
+    std::vector<std::shared_ptr<growth_ring>> m_rings; //!< One ring per thread that ever recorded.
+};
+
+/// Returns the ring of the calling thread, registering it on first use.
+inline growth_ring &local_ring()
+{
+    thread_local std::shared_ptr<growth_ring> ring = registry::instance().attach();
+    return *ring;
+}
+
+/**
+ * @brief Records one reallocation
+ *
+ * `start_ns` is the value of now() taken right before the reallocation started; the event is
+ * stored, with its duration, in the ring of the calling thread.
+ */
+inline void record_growth(std::uint64_t start_ns, std::size_t old_cap, std::size_t new_cap, std::size_t size,
+                          std::size_t element_size, const source_location &loc)
+{
+    growth_ring &ring = local_ring();
+    growth_event e;
+
+    e.timestamp_ns = start_ns;
+    e.duration_ns = now() - start_ns;
+    e.old_capacity = old_cap;
+    e.new_capacity = new_cap;
+    e.size = size;
+    e.element_size = element_size;
+    e.file = loc.file_name();
+    e.function = loc.function_name();
+    e.line = loc.line();
+    e.thread = ring.thread();
+    ring.push(e);
+}
+
+/// Returns a copy of every recorded event, ordered by timestamp.
+inline std::vector<growth_event> snapshot()
+{
+    std::vector<growth_event> events;
+    for (const auto &ring : registry::instance().rings())
+        ring->for_each([&events](const growth_event &e) { events.push_back(e); });
+
+    std::sort(events.begin(), events.end(), [](const growth_event &a, const growth_event &b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+    return events;
+}
+
+/// Total number of events lost to ring wrap-around, over all threads.
+inline std::uint64_t dropped()
+{
+    std::uint64_t total = 0;
+    for (const auto &ring : registry::instance().rings())
+        total += ring->dropped();
+    return total;
+}
+
+/// Forgets every recorded event. Must not race with vectors growing on other threads.
+inline void reset()
+{
+    for (const auto &ring : registry::instance().rings())
+        ring->clear();
+}
+
+namespace detail
+{
+/// Writes `str` as a JSON string literal.
+inline void write_json_string(std::ostream &os, const char *str)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    os << '"';
+    for (const char *c = str; *c != '\0'; c++)
+    {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\')
+            os << '\\' << *c;
+        else if (ch < 0x20)
+            os << "\\u00" << hex[ch >> 4] << hex[ch & 0xf];
+        else
+            os << *c;
+    }
+    os << '"';
+}
+
+/// Writes a nanosecond count as fractional microseconds, the unit of the trace event format.
+inline void write_us(std::ostream &os, std::uint64_t ns)
+{
+    std::string frac = std::to_string(ns % 1000);
+    os << ns / 1000 << '.' << std::string(3 - frac.size(), '0') << frac;
+}
+} // namespace detail
+
+/**
+ * @brief Writes every recorded event in the Chrome trace event format
+ *
+ * Each reallocation becomes a complete ("X") event on the thread that caused it, whose
+ * arguments hold the capacities, the size and the call site.
+ */
+inline void export_chrome_trace(std::ostream &os)
+{
+    auto rings = registry::instance().rings();
+    bool first = true;
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (const auto &ring : rings)
+    {
+        os << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->thread()
+           << ",\"args\":{\"name\":\"sc::vector thread " << ring->thread() << "\"}}";
+        first = false;
+    }
+
+    for (const auto &e : snapshot())
+    {
+        os << (first ? "" : ",") << "\n{\"name\":\"sc::vector growth\",\"cat\":\"sc.vector\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+           << e.thread << ",\"ts\":";
+        detail::write_us(os, e.timestamp_ns);
+        os << ",\"dur\":";
+        detail::write_us(os, e.duration_ns);
+        os << ",\"args\":{\"old_capacity\":" << e.old_capacity << ",\"new_capacity\":" << e.new_capacity
+           << ",\"size\":" << e.size << ",\"bytes\":" << e.new_capacity * e.element_size << ",\"file\":";
+        detail::write_json_string(os, e.file);
+        os << ",\"line\":" << e.line << ",\"function\":";
+        detail::write_json_string(os, e.function);
+        os << "}}";
+        first = false;
+    }
+    os << "\n]}\n";
+}
+
+/// Aggregated reallocations of one call site.
+struct hotspot
+{
+    const char *file;                 //!< Source file of the call site.
+    const char *function;             //!< Function containing the call site.
+    std::uint_least32_t line;         //!< Line of the call site.
+    std::uint64_t events;             //!< Number of reallocations.
+    std::uint64_t bytes_allocated;    //!< Sum of the new buffer sizes.
+    std::uint64_t bytes_copied;       //!< Sum of the bytes moved to the new buffers.
+    std::uint64_t total_ns;           //!< Time spent reallocating.
+    std::uint64_t max_ns;             //!< Slowest single reallocation.
+};
+
+/// Folds the recorded events by call site, hottest (most reallocations) first.
+inline std::vector<hotspot> growth_heatmap()
+{
+    std::map<std::tuple<std::string, std::uint_least32_t, std::string>, hotspot> sites;
+
+    for (const auto &e : snapshot())
+    {
+        hotspot &h = sites[std::make_tuple(std::string(e.file), e.line, std::string(e.function))];
+        if (h.events == 0)
+        {
+            h.file = e.file;
+            h.function = e.function;
+            h.line = e.line;
+        }
+        h.events++;
+        h.bytes_allocated += e.new_capacity * e.element_size;
+        h.bytes_copied += e.size * e.element_size;
+        h.total_ns += e.duration_ns;
+        h.max_ns = std::max(h.max_ns, e.duration_ns);
+    }
+
+    std::vector<hotspot> result;
+    for (const auto &site : sites)
+        result.push_back(site.second);
+
+    std::sort(result.begin(), result.end(), [](const hotspot &a, const hotspot &b) {
+        return std::tie(b.events, b.total_ns) < std::tie(a.events, a.total_ns);
+    });
+    return result;
+}
+
+/// Writes the heatmap as a JSON array, hottest call site first.
+inline void export_growth_heatmap(std::ostream &os)
+{
+    bool first = true;
+
+    os << "[";
+    for (const auto &h : growth_heatmap())
+    {
+        os << (first ? "" : ",") << "\n{\"file\":";
+        detail::write_json_string(os, h.file);
+        os << ",\"line\":" << h.line << ",\"function\":";
+        detail::write_json_string(os, h.function);
+        os << ",\"events\":" << h.events << ",\"bytes_allocated\":" << h.bytes_allocated
+           << ",\"bytes_copied\":" << h.bytes_copied << ",\"total_us\":";
+        detail::write_us(os, h.total_ns);
+        os << ",\"max_us\":";
+        detail::write_us(os, h.max_ns);
+        os << "}";
+        first = false;
+    }
+    os << "\n]\n";
+}
+} // namespace trace
+} // namespace sc
+
+#endif
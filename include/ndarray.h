@@ -0,0 +1,889 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Multi-dimensional arrays stored in an sc::vector, and views over them.
+ *
+ * A layout maps an index tuple to a position in the buffer:
+ *  - layout_right (row-major, the last index varies fastest) and layout_left (column-major) are
+ *    dense; their views use layout_stride, which also describes slices with steps and
+ *    transposed views, none of which copy anything.
+ *  - layout_tiled<Tile> stores the last two dimensions in Tile x Tile blocks, row-major inside
+ *    and across tiles. A tile is a few cache lines whichever way it is traversed, so transposing
+ *    or walking a tiled matrix by columns stays in cache where a row-major one would miss on
+ *    every element.
+ *
+ * The kernels (transform, copy, transpose, reduce, sum) walk the index space in blocks of the
+ * last two dimensions and hand their inner loops runs of elements at a fixed stride, which are
+ * unit-stride and vectorize whenever the layouts allow.
+ */
+#ifndef NDARRAY_H
+#define NDARRAY_H
+
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <cstdint>     // std::uintptr_t
+#include <functional>  // std::plus
+#include <stdexcept>   // std::out_of_range
+#include <string>      // std::to_string
+#include <type_traits> // std::remove_cv, std::enable_if
+#include <utility>     // std::swap, std::move
+
+#include "./vector_config.h"
+#include "./vector.h"
+
+namespace sc
+{
+template <typename T, std::size_t Rank, typename Layout>
+class ndarray_view;
+
+namespace detail
+{
+/// Edge of the square blocks of the last two dimensions that the kernels traverse at a time.
+constexpr unsigned long NDARRAY_BLOCK = 32;
+
+/// Number of elements of an array with `extents`.
+template <std::size_t Rank>
+SC_CONSTEXPR14 unsigned long extents_size(const unsigned long (&extents)[Rank])
+{
+    unsigned long size = 1;
+    for (std::size_t d = 0; d < Rank; d++)
+        size *= extents[d];
+    return size;
+}
+
+/// Calls `f(idx, count)` for runs of `count` consecutive indices along the last dimension, covering
+/// every index tuple below `extents` once. The last two dimensions are visited in NDARRAY_BLOCK x
+/// NDARRAY_BLOCK blocks, so operands walked in different orders both stay in cache.
+template <std::size_t Rank, typename F>
+void for_each_run(const unsigned long (&extents)[Rank], F f)
+{
+    if (extents_size(extents) == 0)
+        return;
+
+    unsigned long idx[Rank] = {};
+    const unsigned long B = NDARRAY_BLOCK;
+    const std::size_t LEADING = Rank >= 2 ? Rank - 2 : 0; // dimensions before the blocked ones
+    const unsigned long rows = Rank >= 2 ? extents[LEADING] : 1;
+    const unsigned long cols = extents[Rank - 1];
+
+    for (;;)
+    {
+        for (unsigned long r0 = 0; r0 < rows; r0 += B)
+            for (unsigned long c0 = 0; c0 < cols; c0 += B)
+                for (unsigned long r = r0; r < rows && r < r0 + B; r++)
+                {
+                    if (Rank >= 2)
+                        idx[LEADING] = r;
+                    idx[Rank - 1] = c0;
+                    f(idx, cols - c0 < B ? cols - c0 : B);
+                }
+
+        // Odometer over the leading dimensions.
+        std::size_t d = LEADING;
+        for (;;)
+        {
+            if (d == 0)
+                return;
+            d--;
+            if (++idx[d] < extents[d])
+                break;
+            idx[d] = 0;
+        }
+    }
+}
+
+/// Folds `count` elements starting at `p`, `stride` apart, into `init`. Unit-stride runs use eight
+/// independent partial results so the loop vectorizes; `op` must be associative and commutative.
+template <typename T, typename U, typename BinaryOp>
+U reduce_run(const T *p, unsigned long count, std::ptrdiff_t stride, U init, BinaryOp op)
+{
+    unsigned long k = 0;
+    if (stride == 1 && count >= 16)
+    {
+        U acc[8] = {U(p[0]), U(p[1]), U(p[2]), U(p[3]), U(p[4]), U(p[5]), U(p[6]), U(p[7])};
+        for (k = 8; k + 8 <= count; k += 8)
+            for (int lane = 0; lane < 8; lane++)
+                acc[lane] = op(acc[lane], p[k + lane]);
+        for (int lane = 0; lane < 8; lane++)
+            init = op(init, acc[lane]);
+    }
+    for (; k < count; k++)
+        init = op(init, p[std::ptrdiff_t(k) * stride]);
+    return init;
+}
+} // namespace detail
+
+/**
+ * @brief Mapping of any layout that can be described with one stride per dimension
+ *
+ * Covers dense row-major and column-major arrays and everything obtained from them by slicing,
+ * stepping or transposing.
+ */
+struct layout_stride
+{
+    template <std::size_t Rank>
+    class mapping
+    {
+    public:
+        using size_type = unsigned long;    //!< The size type.
+        using index_type = std::ptrdiff_t; //!< Distance between elements in the buffer.
+
+        /// Creates the mapping of an empty array.
+        mapping() : EXTENTS(), STRIDES()
+        {
+        }
+
+        /// Creates the mapping with the given extents and strides, in elements.
+        mapping(const size_type (&extents)[Rank], const index_type (&strides)[Rank])
+        {
+            for (std::size_t d = 0; d < Rank; d++)
+            {
+                EXTENTS[d] = extents[d];
+                STRIDES[d] = strides[d];
+            }
+        }
+
+        /// Returns the number of indices along dimension `d`.
+        size_type extent(std::size_t d) const
+        {
+            return EXTENTS[d];
+        }
+
+        /// Returns the distance, in elements, between consecutive indices along dimension `d`.
+        index_type stride(std::size_t d) const
+        {
+            return STRIDES[d];
+        }
+
+        /// Returns the offset of the element at `idx`.
+        index_type operator()(const size_type *idx) const
+        {
+            index_type offset = 0;
+            for (std::size_t d = 0; d < Rank; d++)
+                offset += index_type(idx[d]) * STRIDES[d];
+            return offset;
+        }
+
+        /// Stride along the last dimension.
+        index_type inner_stride() const
+        {
+            return STRIDES[Rank - 1];
+        }
+
+        /// How many elements from `idx` on along the last dimension are inner_stride() apart.
+        size_type run_length(const size_type *idx) const
+        {
+            return EXTENTS[Rank - 1] - idx[Rank - 1];
+        }
+
+        /// Returns true if the elements are exactly the first extents_size() of the buffer, in row-major order.
+        bool is_contiguous() const
+        {
+            index_type expected = 1;
+            for (std::size_t d = Rank; d-- > 0;)
+            {
+                if (EXTENTS[d] != 1 && STRIDES[d] != expected)
+                    return false;
+                expected *= index_type(EXTENTS[d]);
+            }
+            return true;
+        }
+
+        /// Keeps the indices first, first + step, ... below last of dimension `dim`; returns the offset of the new origin.
+        index_type slice(std::size_t dim, size_type first, size_type last, size_type step)
+        {
+            index_type offset = index_type(first) * STRIDES[dim];
+            EXTENTS[dim] = (last - first + step - 1) / step;
+            STRIDES[dim] *= index_type(step);
+            return offset;
+        }
+
+        /// Returns the mapping without dimension `dim`; adds the offset of `index` along it to `offset`.
+        mapping<Rank - 1> drop(std::size_t dim, size_type index, index_type &offset) const
+        {
+            size_type extents[Rank - 1];
+            index_type strides[Rank - 1];
+            for (std::size_t d = 0, k = 0; d < Rank; d++)
+                if (d != dim)
+                {
+                    extents[k] = EXTENTS[d];
+                    strides[k++] = STRIDES[d];
+                }
+            offset += index_type(index) * STRIDES[dim];
+            return mapping<Rank - 1>(extents, strides);
+        }
+
+        /// Returns the mapping with the last two dimensions exchanged.
+        mapping transposed() const
+        {
+            mapping result = *this;
+            std::swap(result.EXTENTS[Rank - 1], result.EXTENTS[Rank - 2]);
+            std::swap(result.STRIDES[Rank - 1], result.STRIDES[Rank - 2]);
+            return result;
+        }
+
+    private:
+        size_type EXTENTS[Rank];  //!< Indices per dimension.
+        index_type STRIDES[Rank]; //!< Elements between consecutive indices, per dimension.
+    };
+};
+
+/// Row-major (C order) dense layout: the last index varies fastest.
+struct layout_right
+{
+    using view_layout = layout_stride; //!< Layout of the views of such arrays.
+
+    /// Returns the mapping of a dense row-major array with `extents`.
+    template <std::size_t Rank>
+    static layout_stride::mapping<Rank> make(const unsigned long (&extents)[Rank])
+    {
+        std::ptrdiff_t strides[Rank];
+        std::ptrdiff_t stride = 1;
+        for (std::size_t d = Rank; d-- > 0;)
+        {
+            strides[d] = stride;
+            stride *= std::ptrdiff_t(extents[d]);
+        }
+        return layout_stride::mapping<Rank>(extents, strides);
+    }
+
+    /// Returns the number of elements the buffer needs.
+    template <std::size_t Rank>
+    static unsigned long storage_size(const unsigned long (&extents)[Rank])
+    {
+        return detail::extents_size(extents);
+    }
+};
+
+/// Column-major (Fortran order) dense layout: the first index varies fastest.
+struct layout_left
+{
+    using view_layout = layout_stride; //!< Layout of the views of such arrays.
+
+    /// Returns the mapping of a dense column-major array with `extents`.
+    template <std::size_t Rank>
+    static layout_stride::mapping<Rank> make(const unsigned long (&extents)[Rank])
+    {
+        std::ptrdiff_t strides[Rank];
+        std::ptrdiff_t stride = 1;
+        for (std::size_t d = 0; d < Rank; d++)
+        {
+            strides[d] = stride;
+            stride *= std::ptrdiff_t(extents[d]);
+        }
+        return layout_stride::mapping<Rank>(extents, strides);
+    }
+
+    /// Returns the number of elements the buffer needs.
+    template <std::size_t Rank>
+    static unsigned long storage_size(const unsigned long (&extents)[Rank])
+    {
+        return detail::extents_size(extents);
+    }
+};
+
+/**
+ * @brief Layout that stores the last two dimensions in Tile x Tile blocks
+ *
+ * Planes (the last two dimensions) are padded to whole tiles; tiles are stored row-major, and
+ * so are the elements of each tile. Leading dimensions are row-major over planes. Views may
+ * slice any dimension, but only leading dimensions with a step, and may be transposed.
+ */
+template <std::size_t Tile = 8>
+struct layout_tiled
+{
+    static_assert(Tile > 0 && (Tile & (Tile - 1)) == 0, "the tile edge must be a power of two");
+
+    using view_layout = layout_tiled; //!< Layout of the views of such arrays.
+
+    template <std::size_t Rank>
+    class mapping
+    {
+        static_assert(Rank >= 2, "tiling applies to the last two dimensions");
+
+    public:
+        using size_type = unsigned long;    //!< The size type.
+        using index_type = std::ptrdiff_t; //!< Distance between elements in the buffer.
+
+        /// Creates the mapping of an empty array.
+        mapping() : EXTENTS(), STRIDES(), TILES_PER_ROW(0), ORIGIN_ROW(0), ORIGIN_COL(0), TRANSPOSED(false)
+        {
+        }
+
+        /// Creates the mapping of a whole tiled array with `extents`.
+        explicit mapping(const size_type (&extents)[Rank])
+            : EXTENTS(), STRIDES(), TILES_PER_ROW(pad(extents[Rank - 1]) / Tile), ORIGIN_ROW(0), ORIGIN_COL(0),
+              TRANSPOSED(false)
+        {
+            index_type stride = index_type(pad(extents[Rank - 2]) * pad(extents[Rank - 1]));
+            for (std::size_t d = Rank; d-- > 0;)
+            {
+                EXTENTS[d] = extents[d];
+                if (d < Rank - 2)
+                {
+                    STRIDES[d] = stride;
+                    stride *= index_type(extents[d]);
+                }
+            }
+        }
+
+        /// Returns the number of indices along dimension `d`.
+        size_type extent(std::size_t d) const
+        {
+            return EXTENTS[d];
+        }
+
+        /// Returns the offset of the element at `idx`.
+        index_type operator()(const size_type *idx) const
+        {
+            index_type offset = 0;
+            for (std::size_t d = 0; d + 2 < Rank; d++)
+                offset += index_type(idx[d]) * STRIDES[d];
+            return offset + plane_offset(idx[Rank - 2], idx[Rank - 1]);
+        }
+
+        /// Stride along the last dimension, within a tile.
+        index_type inner_stride() const
+        {
+            return TRANSPOSED ? index_type(Tile) : 1;
+        }
+
+        /// How many elements from `idx` on along the last dimension share its tile, and so are inner_stride() apart.
+        size_type run_length(const size_type *idx) const
+        {
+            size_type position = idx[Rank - 1] + (TRANSPOSED ? ORIGIN_ROW : ORIGIN_COL);
+            size_type left = Tile - position % Tile;
+            return left < EXTENTS[Rank - 1] - idx[Rank - 1] ? left : EXTENTS[Rank - 1] - idx[Rank - 1];
+        }
+
+        /// Tiled arrays are never contiguous in row-major order.
+        bool is_contiguous() const
+        {
+            return false;
+        }
+
+        /// Keeps the indices first, first + step, ... below last of dimension `dim`; returns the offset of the new origin.
+        index_type slice(std::size_t dim, size_type first, size_type last, size_type step)
+        {
+            if (dim + 2 < Rank)
+            {
+                index_type offset = index_type(first) * STRIDES[dim];
+                EXTENTS[dim] = (last - first + step - 1) / step;
+                STRIDES[dim] *= index_type(step);
+                return offset;
+            }
+
+            SC_VECTOR_REQUIRE(step == 1, "tiled dimensions can only be sliced with step 1");
+            EXTENTS[dim] = last - first;
+            bool row = (dim == Rank - 2) != TRANSPOSED;
+            (row ? ORIGIN_ROW : ORIGIN_COL) += first;
+            return 0;
+        }
+
+        /// Returns the mapping without leading dimension `dim`; adds the offset of `index` along it to `offset`.
+        mapping<Rank - 1> drop(std::size_t dim, size_type index, index_type &offset) const
+        {
+            SC_VECTOR_REQUIRE(dim + 2 < Rank, "only leading dimensions of a tiled array can be fixed");
+            mapping<Rank - 1> result;
+            for (std::size_t d = 0, k = 0; d < Rank; d++)
+                if (d != dim)
+                {
+                    result.EXTENTS[k] = EXTENTS[d];
+                    result.STRIDES[k++] = STRIDES[d];
+                }
+            result.TILES_PER_ROW = TILES_PER_ROW;
+            result.ORIGIN_ROW = ORIGIN_ROW;
+            result.ORIGIN_COL = ORIGIN_COL;
+            result.TRANSPOSED = TRANSPOSED;
+            offset += index_type(index) * STRIDES[dim];
+            return result;
+        }
+
+        /// Returns the mapping with the last two dimensions exchanged.
+        mapping transposed() const
+        {
+            mapping result = *this;
+            std::swap(result.EXTENTS[Rank - 1], result.EXTENTS[Rank - 2]);
+            result.TRANSPOSED = not TRANSPOSED;
+            return result;
+        }
+
+    private:
+        template <std::size_t>
+        friend class mapping;
+
+        /// Rounds `n` up to a whole number of tiles.
+        static size_type pad(size_type n)
+        {
+            return (n + Tile - 1) / Tile * Tile;
+        }
+
+        /// Offset inside a plane of the element at (`i`, `j`) of the (possibly transposed) view.
+        index_type plane_offset(size_type i, size_type j) const
+        {
+            size_type r = (TRANSPOSED ? j : i) + ORIGIN_ROW;
+            size_type c = (TRANSPOSED ? i : j) + ORIGIN_COL;
+            return index_type(((r / Tile) * TILES_PER_ROW + c / Tile) * Tile * Tile + (r % Tile) * Tile + c % Tile);
+        }
+
+        size_type EXTENTS[Rank];  //!< Indices per dimension, as seen through the view.
+        index_type STRIDES[Rank]; //!< Elements between consecutive indices of the leading dimensions.
+        size_type TILES_PER_ROW;  //!< Tiles across a padded row of the stored plane.
+        size_type ORIGIN_ROW;     //!< First stored row of the plane the view starts at.
+        size_type ORIGIN_COL;     //!< First stored column of the plane the view starts at.
+        bool TRANSPOSED;          //!< Whether the last two dimensions of the view are stored columns and rows.
+    };
+
+    /// Returns the mapping of a whole tiled array with `extents`.
+    template <std::size_t Rank>
+    static mapping<Rank> make(const unsigned long (&extents)[Rank])
+    {
+        return mapping<Rank>(extents);
+    }
+
+    /// Returns the number of elements the buffer needs, padding included.
+    template <std::size_t Rank>
+    static unsigned long storage_size(const unsigned long (&extents)[Rank])
+    {
+        unsigned long size = (extents[Rank - 2] + Tile - 1) / Tile * Tile * ((extents[Rank - 1] + Tile - 1) / Tile * Tile);
+        for (std::size_t d = 0; d + 2 < Rank; d++)
+            size *= extents[d];
+        return size;
+    }
+};
+
+/**
+ * @brief Non-owning multi-dimensional view
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * A pointer and a mapping; copying, slicing and transposing a view never touches the elements.
+ * Like vector_view, it does not keep its buffer alive. Use `ndarray_view<const T, ...>` for
+ * read-only access.
+ */
+template <typename T, std::size_t Rank, typename Layout = layout_stride>
+class ndarray_view
+{
+    static_assert(Rank >= 1, "an ndarray has at least one dimension");
+
+public:
+    using size_type = unsigned long;                          //!< The size type.
+    using value_type = typename std::remove_cv<T>::type;      //!< The value type.
+    using pointer = T *;                                      //!< Pointer to a viewed element.
+    using reference = T &;                                    //!< Reference to a viewed element.
+    using mapping_type = typename Layout::template mapping<Rank>; //!< Index to offset mapping.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Creates an empty view.
+    ndarray_view() : DATA(nullptr), MAP()
+    {
+    }
+
+    /// Views the elements at `data` through `mapping`.
+    ndarray_view(pointer data, const mapping_type &mapping) : DATA(data), MAP(mapping)
+    {
+    }
+
+    /// Views `data` as a dense row-major array with `extents`, e.g. an image stored in an sc::vector.
+    ndarray_view(pointer data, const size_type (&extents)[Rank]) : DATA(data), MAP(layout_right::make(extents))
+    {
+    }
+
+    /// Converts a view of `U` to a view of `T`, e.g. to a read-only view.
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U *, pointer>::value>::type>
+    ndarray_view(const ndarray_view<U, Rank, Layout> &other) : DATA(other.data()), MAP(other.mapping())
+    {
+    }
+
+    //=== [II] Shape
+    /// Returns the number of indices along dimension `d`.
+    size_type extent(std::size_t d) const
+    {
+        return MAP.extent(d);
+    }
+
+    /// Returns the number of viewed elements.
+    size_type size() const
+    {
+        size_type size = 1;
+        for (std::size_t d = 0; d < Rank; d++)
+            size *= MAP.extent(d);
+        return size;
+    }
+
+    /// Returns true if the view refers to no elements.
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// Returns the mapping from indices to offsets.
+    const mapping_type &mapping() const
+    {
+        return MAP;
+    }
+
+    //=== [III] Element access
+    /// Returns the address the mapping offsets are relative to.
+    pointer data() const
+    {
+        return DATA;
+    }
+
+    /// Returns the element at the given indices, one per dimension; they are checked like sc::vector::operator[].
+    template <typename... Indices>
+    reference operator()(Indices... indices) const
+    {
+        static_assert(sizeof...(Indices) == Rank, "one index per dimension");
+        const size_type idx[Rank] = {size_type(indices)...};
+        for (std::size_t d = 0; d < Rank; d++)
+            SC_VECTOR_REQUIRE(idx[d] < MAP.extent(d), "ndarray index out of range");
+        return DATA[MAP(idx)];
+    }
+
+    /// Returns the element at the index tuple `idx`, with no bounds-checking.
+    reference at_index(const size_type *idx) const
+    {
+        return DATA[MAP(idx)];
+    }
+
+    //=== [IV] Slicing
+    /// Returns the view restricted to indices first, first + step, ... below last of dimension `dim`.
+    ndarray_view slice(std::size_t dim, size_type first, size_type last, size_type step = 1) const
+    {
+        if (dim >= Rank || first > last || last > MAP.extent(dim) || step == 0)
+            throw std::out_of_range("ndarray_view::slice(" + std::to_string(dim) + ", " + std::to_string(first) +
+                                    ", " + std::to_string(last) + ")");
+        mapping_type map = MAP;
+        std::ptrdiff_t offset = map.slice(dim, first, last, step);
+        return ndarray_view(DATA + offset, map);
+    }
+
+    /// Returns the view of one less dimension where dimension `dim` is fixed at `index`, e.g. a row or a channel.
+    ndarray_view<T, Rank - 1, Layout> fix(std::size_t dim, size_type index) const
+    {
+        if (dim >= Rank || index >= MAP.extent(dim))
+            throw std::out_of_range("ndarray_view::fix(" + std::to_string(dim) + ", " + std::to_string(index) + ")");
+        std::ptrdiff_t offset = 0;
+        typename Layout::template mapping<Rank - 1> map = MAP.drop(dim, index, offset);
+        return ndarray_view<T, Rank - 1, Layout>(DATA + offset, map);
+    }
+
+    /// Returns the view with the last two dimensions exchanged (each matrix transposed), without copying.
+    ndarray_view transposed() const
+    {
+        static_assert(Rank >= 2, "transposing needs two dimensions");
+        return ndarray_view(DATA, MAP.transposed());
+    }
+
+private:
+    pointer DATA;     //!< Origin of the offsets.
+    mapping_type MAP; //!< Index to offset mapping.
+};
+
+/**
+ * @brief Multi-dimensional array
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Owns its elements in an sc::vector whose first element is aligned on a 64-byte boundary, so
+ * rows of dense arrays and whole tiles start on a cache line. Indexing, slicing and the kernels
+ * go through view(); the array converts to its view implicitly.
+ */
+template <typename T, std::size_t Rank, typename Layout = layout_right>
+class ndarray
+{
+public:
+    using size_type = unsigned long;                                      //!< The size type.
+    using value_type = T;                                                 //!< The value type.
+    using view_type = ndarray_view<T, Rank, typename Layout::view_layout>; //!< Mutable view of the whole array.
+    using const_view_type = ndarray_view<const T, Rank, typename Layout::view_layout>; //!< Read-only view.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Creates an array with no elements.
+    ndarray() : STORAGE(), SKIP(0), VIEW()
+    {
+    }
+
+    /// Creates an array with `extents`, every element set to `value`.
+    explicit ndarray(const size_type (&extents)[Rank], const T &value = T()) : ndarray()
+    {
+        allocate(extents, value);
+    }
+
+    /// Copy constructor; the copy has its own aligned buffer.
+    ndarray(const ndarray &other) : ndarray()
+    {
+        size_type extents[Rank];
+        for (std::size_t d = 0; d < Rank; d++)
+            extents[d] = other.extent(d);
+        allocate(extents, T());
+        copy(view(), other.view());
+    }
+
+    /// Move constructor; takes over the buffer of `other`, which is left empty.
+    ndarray(ndarray &&other) noexcept : STORAGE(std::move(other.STORAGE)), SKIP(other.SKIP), VIEW(other.VIEW)
+    {
+        other.SKIP = 0;
+        other.VIEW = view_type();
+    }
+
+    /// Copy assignment operator.
+    ndarray &operator=(const ndarray &other)
+    {
+        if (this != &other)
+        {
+            ndarray copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    /// Move assignment operator.
+    ndarray &operator=(ndarray &&other) noexcept
+    {
+        STORAGE = std::move(other.STORAGE);
+        SKIP = other.SKIP;
+        VIEW = other.VIEW;
+        other.SKIP = 0;
+        other.VIEW = view_type();
+        return *this;
+    }
+
+    //=== [II] Shape
+    /// Returns the number of indices along dimension `d`.
+    size_type extent(std::size_t d) const
+    {
+        return VIEW.extent(d);
+    }
+
+    /// Returns the number of elements.
+    size_type size() const
+    {
+        return VIEW.size();
+    }
+
+    //=== [III] Element access
+    /// Returns the address of the buffer.
+    T *data()
+    {
+        return VIEW.data();
+    }
+
+    /// Returns the address of the buffer.
+    const T *data() const
+    {
+        return VIEW.data();
+    }
+
+    /// Returns the element at the given indices, one per dimension.
+    template <typename... Indices>
+    T &operator()(Indices... indices)
+    {
+        return VIEW(indices...);
+    }
+
+    /// Returns the element at the given indices, one per dimension.
+    template <typename... Indices>
+    const T &operator()(Indices... indices) const
+    {
+        return VIEW(indices...);
+    }
+
+    /// Returns a view of the whole array.
+    view_type view()
+    {
+        return VIEW;
+    }
+
+    /// Returns a read-only view of the whole array.
+    const_view_type view() const
+    {
+        return VIEW;
+    }
+
+    /// Converts to a view of the whole array, so arrays can be passed to the kernels directly.
+    operator view_type()
+    {
+        return VIEW;
+    }
+
+    /// Converts to a read-only view of the whole array.
+    operator const_view_type() const
+    {
+        return VIEW;
+    }
+
+private:
+    /// Sizes the buffer for `extents`, aligns the origin and fills every element with `value`.
+    void allocate(const size_type (&extents)[Rank], const T &value)
+    {
+        const size_type ALIGN = 64 % sizeof(T) == 0 ? 64 / sizeof(T) : 1;
+        STORAGE.assign(Layout::storage_size(extents) + ALIGN - 1, value);
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(STORAGE.data());
+        SKIP = ALIGN > 1 ? (64 - address % 64) % 64 / sizeof(T) : 0;
+        VIEW = view_type(STORAGE.data() + SKIP, Layout::make(extents));
+    }
+
+    sc::vector<T> STORAGE; //!< Elements, plus room to align the first one on a cache line.
+    size_type SKIP;        //!< Offset of the first element inside `STORAGE`.
+    view_type VIEW;        //!< View of the whole array.
+};
+
+//=== Kernels
+// Operands of a kernel must have the same extents. They may differ in layout: the index space
+// is walked in cache-sized blocks and each operand is read or written through its own mapping.
+
+/// Sets every element of `dst` to `op(src)` of the element at the same indices; `dst` may be `src`.
+template <typename T, typename U, std::size_t Rank, typename L1, typename L2, typename UnaryOp>
+void transform(ndarray_view<T, Rank, L1> dst, ndarray_view<U, Rank, L2> src, UnaryOp op)
+{
+    unsigned long extents[Rank];
+    for (std::size_t d = 0; d < Rank; d++)
+    {
+        SC_VECTOR_REQUIRE(dst.extent(d) == src.extent(d), "transform() operands of different extents");
+        extents[d] = dst.extent(d);
+    }
+
+    if (dst.mapping().is_contiguous() && src.mapping().is_contiguous())
+    {
+        T *d = dst.data();
+        const U *s = src.data();
+        for (unsigned long i = 0, n = dst.size(); i < n; i++)
+            d[i] = op(s[i]);
+        return;
+    }
+
+    detail::for_each_run(extents, [&](unsigned long *idx, unsigned long count) {
+        while (count > 0)
+        {
+            unsigned long n = count;
+            n = dst.mapping().run_length(idx) < n ? dst.mapping().run_length(idx) : n;
+            n = src.mapping().run_length(idx) < n ? src.mapping().run_length(idx) : n;
+
+            T *d = dst.data() + dst.mapping()(idx);
+            const U *s = src.data() + src.mapping()(idx);
+            std::ptrdiff_t ds = dst.mapping().inner_stride(), ss = src.mapping().inner_stride();
+            if (ds == 1 && ss == 1)
+                for (unsigned long k = 0; k < n; k++)
+                    d[k] = op(s[k]);
+            else
+                for (unsigned long k = 0; k < n; k++)
+                    d[std::ptrdiff_t(k) * ds] = op(s[std::ptrdiff_t(k) * ss]);
+
+            idx[Rank - 1] += n;
+            count -= n;
+        }
+    });
+}
+
+/// Sets every element of `dst` to `op(a, b)` of the elements at the same indices; `dst` may be `a` or `b`.
+template <typename T, typename U, typename V, std::size_t Rank, typename L1, typename L2, typename L3, typename BinaryOp>
+void transform(ndarray_view<T, Rank, L1> dst, ndarray_view<U, Rank, L2> a, ndarray_view<V, Rank, L3> b, BinaryOp op)
+{
+    unsigned long extents[Rank];
+    for (std::size_t d = 0; d < Rank; d++)
+    {
+        SC_VECTOR_REQUIRE(dst.extent(d) == a.extent(d) && dst.extent(d) == b.extent(d),
+                          "transform() operands of different extents");
+        extents[d] = dst.extent(d);
+    }
+
+    if (dst.mapping().is_contiguous() && a.mapping().is_contiguous() && b.mapping().is_contiguous())
+    {
+        T *d = dst.data();
+        const U *x = a.data();
+        const V *y = b.data();
+        for (unsigned long i = 0, n = dst.size(); i < n; i++)
+            d[i] = op(x[i], y[i]);
+        return;
+    }
+
+    detail::for_each_run(extents, [&](unsigned long *idx, unsigned long count) {
+        while (count > 0)
+        {
+            unsigned long n = count;
+            n = dst.mapping().run_length(idx) < n ? dst.mapping().run_length(idx) : n;
+            n = a.mapping().run_length(idx) < n ? a.mapping().run_length(idx) : n;
+            n = b.mapping().run_length(idx) < n ? b.mapping().run_length(idx) : n;
+
+            T *d = dst.data() + dst.mapping()(idx);
+            const U *x = a.data() + a.mapping()(idx);
+            const V *y = b.data() + b.mapping()(idx);
+            std::ptrdiff_t ds = dst.mapping().inner_stride(), xs = a.mapping().inner_stride(), ys = b.mapping().inner_stride();
+            if (ds == 1 && xs == 1 && ys == 1)
+                for (unsigned long k = 0; k < n; k++)
+                    d[k] = op(x[k], y[k]);
+            else
+                for (unsigned long k = 0; k < n; k++)
+                    d[std::ptrdiff_t(k) * ds] = op(x[std::ptrdiff_t(k) * xs], y[std::ptrdiff_t(k) * ys]);
+
+            idx[Rank - 1] += n;
+            count -= n;
+        }
+    });
+}
+
+/// Copies `src` into `dst`, element by element at the same indices; converts between layouts.
+template <typename T, typename U, std::size_t Rank, typename L1, typename L2>
+void copy(ndarray_view<T, Rank, L1> dst, ndarray_view<U, Rank, L2> src)
+{
+    transform(dst, src, [](const U &value) { return value; });
+}
+
+/// Writes the transpose of each matrix of `src` (its last two dimensions) to `dst`, which must not overlap it.
+/// With tiled operands every tile is read and written while it is in cache.
+template <typename T, typename U, std::size_t Rank, typename L1, typename L2>
+void transpose(ndarray_view<T, Rank, L1> dst, ndarray_view<U, Rank, L2> src)
+{
+    copy(dst, src.transposed());
+}
+
+/// Folds every element of `array` into `init` with `op`, in an unspecified order: like
+/// std::reduce, `op` must be associative and commutative.
+template <typename T, std::size_t Rank, typename L, typename U, typename BinaryOp = std::plus<U>>
+U reduce(ndarray_view<T, Rank, L> array, U init, BinaryOp op = BinaryOp())
+{
+    if (array.mapping().is_contiguous())
+        return detail::reduce_run(array.data(), array.size(), 1, init, op);
+
+    unsigned long extents[Rank];
+    for (std::size_t d = 0; d < Rank; d++)
+        extents[d] = array.extent(d);
+
+    detail::for_each_run(extents, [&](unsigned long *idx, unsigned long count) {
+        while (count > 0)
+        {
+            unsigned long n = array.mapping().run_length(idx) < count ? array.mapping().run_length(idx) : count;
+            init = detail::reduce_run(array.data() + array.mapping()(idx), n, array.mapping().inner_stride(), init, op);
+            idx[Rank - 1] += n;
+            count -= n;
+        }
+    });
+    return init;
+}
+
+/// Returns the sum of the elements of `array`.
+template <typename T, std::size_t Rank, typename L>
+typename std::remove_cv<T>::type sum(ndarray_view<T, Rank, L> array)
+{
+    return reduce(array, typename std::remove_cv<T>::type());
+}
+
+/// Same as the view overload, for a whole array.
+template <typename T, std::size_t Rank, typename L, typename U, typename BinaryOp = std::plus<U>>
+U reduce(const ndarray<T, Rank, L> &array, U init, BinaryOp op = BinaryOp())
+{
+    return reduce(array.view(), init, op);
+}
+
+/// Same as the view overload, for a whole array.
+template <typename T, std::size_t Rank, typename L>
+T sum(const ndarray<T, Rank, L> &array)
+{
+    return sum(array.view());
+}
+} // namespace sc
+
+#endif
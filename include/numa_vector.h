@@ -0,0 +1,651 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * A fixed-size array split into partitions, each placed in the memory of one NUMA node.
+ *
+ * The memory of a plain sc::vector ends up on the node of the thread that first touched it, so on
+ * a multi-socket machine the threads of the other sockets scan it through the interconnect.
+ * sc::numa_vector gives every node one contiguous partition of the elements, allocated on that
+ * node, and its parallel for_each() and reduce() run the workers of each partition on the CPUs
+ * of the node that owns it.
+ *
+ * Placement goes through libnuma when the CMake target finds it (SC_VECTOR_HAS_NUMA). Without it,
+ * or on a machine without NUMA support, there is a single node and the partitions are ordinary
+ * heap blocks. A vector may also be asked for more partitions than there are nodes; they are
+ * then dealt to the nodes round-robin, which is how the partitioned code paths get exercised on a
+ * single-node machine.
+ */
+#ifndef NUMA_VECTOR_H
+#define NUMA_VECTOR_H
+
+#include <algorithm>   // std::min
+#include <cstddef>     // std::size_t, std::max_align_t, std::ptrdiff_t
+#include <exception>   // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <functional>  // std::cref
+#include <iterator>    // std::forward_iterator_tag
+#include <mutex>       // std::mutex, std::lock_guard
+#include <new>         // ::operator new, placement new, std::bad_alloc
+#include <stdexcept>   // std::out_of_range
+#include <thread>      // std::thread
+#include <type_traits> // std::conditional
+#include <utility>     // std::move
+
+#include "./vector_config.h"
+#include "./vector.h"
+#include "./vector_threads.h"
+#include "./vector_view.h"
+
+#ifdef SC_VECTOR_HAS_NUMA
+#include <numa.h>
+#include <numaif.h>
+#endif
+
+namespace sc
+{
+namespace numa
+{
+namespace detail
+{
+/// Returns true when the kernel and libnuma can place memory on nodes.
+inline bool available()
+{
+#ifdef SC_VECTOR_HAS_NUMA
+    static const bool yes = numa_available() >= 0;
+    return yes;
+#else
+    return false;
+#endif
+}
+
+/// Lists the nodes this process may allocate memory on.
+inline sc::vector<unsigned> memory_nodes()
+{
+    sc::vector<unsigned> list;
+#ifdef SC_VECTOR_HAS_NUMA
+    if (available())
+        for (int node = 0; node <= numa_max_node(); node++)
+            if (numa_bitmask_isbitset(numa_all_nodes_ptr, unsigned(node)))
+                list.push_back(unsigned(node));
+#endif
+    if (list.empty())
+        list.push_back(0);
+    return list;
+}
+} // namespace detail
+
+/// Returns the ids of the nodes memory can be placed on; a single node 0 without NUMA support.
+inline const sc::vector<unsigned> &nodes()
+{
+    static const sc::vector<unsigned> list = detail::memory_nodes();
+    return list;
+}
+
+/// Returns the number of CPUs of `node`; all of them without NUMA support.
+inline unsigned cpus_of(unsigned node)
+{
+    unsigned count = 0;
+#ifdef SC_VECTOR_HAS_NUMA
+    if (detail::available())
+    {
+        bitmask *cpus = numa_allocate_cpumask();
+        if (numa_node_to_cpus(int(node), cpus) == 0)
+            count = numa_bitmask_weight(cpus);
+        numa_free_cpumask(cpus);
+    }
+#else
+    (void)node;
+#endif
+    if (count == 0)
+        count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+/// Restricts the calling thread to the CPUs of `node`; returns false when that is not possible.
+inline bool run_on_node(unsigned node)
+{
+#ifdef SC_VECTOR_HAS_NUMA
+    return detail::available() && numa_run_on_node(int(node)) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+/// Returns the node holding the page at `address`, or -1 when it is unknown (or not yet touched).
+inline int node_of(const void *address)
+{
+#ifdef SC_VECTOR_HAS_NUMA
+    int node = -1;
+    if (detail::available() &&
+        get_mempolicy(&node, nullptr, 0, const_cast<void *>(address), MPOL_F_NODE | MPOL_F_ADDR) == 0)
+        return node;
+    return -1;
+#else
+    return address == nullptr ? -1 : 0;
+#endif
+}
+
+/// Allocates `bytes` of memory bound to `node`; throws std::bad_alloc on failure.
+inline void *allocate_on_node(std::size_t bytes, unsigned node)
+{
+#ifdef SC_VECTOR_HAS_NUMA
+    if (detail::available())
+    {
+        void *memory = numa_alloc_onnode(bytes, int(node));
+        if (memory == nullptr)
+            throw std::bad_alloc();
+        return memory;
+    }
+#else
+    (void)node;
+#endif
+    return ::operator new(bytes);
+}
+
+/// Frees memory returned by allocate_on_node(); `bytes` must be the size it was allocated with.
+inline void deallocate_on_node(void *memory, std::size_t bytes)
+{
+#ifdef SC_VECTOR_HAS_NUMA
+    if (detail::available())
+        return numa_free(memory, bytes);
+#else
+    (void)bytes;
+#endif
+    ::operator delete(memory);
+}
+} // namespace numa
+
+/**
+ * @brief Fixed-size array whose elements are split into per-node partitions
+ *
+ * Element i lives in partition i / chunk(), and partition p is allocated on node
+ * numa::nodes()[p % numa::nodes().size()]. The element type may not be over-aligned.
+ */
+template <typename T>
+class numa_vector
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "numa_vector does not support over-aligned elements");
+
+public:
+    using size_type = unsigned long; //!< The size type.
+    using value_type = T;            //!< The value type.
+    using reference = T &;           //!< Reference to a value stored in the container.
+    using const_reference = const T &; //!< Const reference to a value stored in the container.
+
+    /// One contiguous run of elements and the node its memory is bound to.
+    struct partition
+    {
+        T *data;            //!< First element.
+        size_type size;     //!< Constructed elements.
+        size_type capacity; //!< Elements the block has room for.
+        unsigned node;      //!< Node the block is allocated on.
+    };
+
+    /// Forward iterator walking the partitions in order.
+    template <bool Const>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag; //!< Iterator category.
+        using value_type = T;                                //!< Type of the elements.
+        using difference_type = std::ptrdiff_t;              //!< Difference type.
+        using pointer = typename std::conditional<Const, const T *, T *>::type;     //!< Pointer type.
+        using reference = typename std::conditional<Const, const T &, T &>::type;   //!< Reference type.
+        using part_pointer = typename std::conditional<Const, const partition *, partition *>::type; //!< Partition pointer.
+
+        /// Creates an iterator at `current` in `part`; `last` is one past the last partition.
+        basic_iterator(part_pointer part = nullptr, part_pointer last = nullptr, pointer current = nullptr)
+            : PART(part), LAST(last), CURRENT(current)
+        {
+            skip_empty();
+        }
+
+        /// Converts an iterator to a const iterator.
+        operator basic_iterator<true>() const
+        {
+            return basic_iterator<true>(PART, LAST, CURRENT);
+        }
+
+        reference operator*() const
+        {
+            return *CURRENT;
+        }
+
+        pointer operator->() const
+        {
+            return CURRENT;
+        }
+
+        basic_iterator &operator++()
+        {
+            if (++CURRENT == PART->data + PART->size)
+            {
+                ++PART;
+                CURRENT = PART == LAST ? nullptr : PART->data;
+                skip_empty();
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            basic_iterator old(*this);
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const basic_iterator &lhs, const basic_iterator &rhs)
+        {
+            return lhs.CURRENT == rhs.CURRENT;
+        }
+
+        friend bool operator!=(const basic_iterator &lhs, const basic_iterator &rhs)
+        {
+            return lhs.CURRENT != rhs.CURRENT;
+        }
+
+    private:
+        /// Moves past partitions without elements; the end iterator has a null CURRENT.
+        void skip_empty()
+        {
+            while (PART != LAST && PART->size == 0)
+                CURRENT = ++PART == LAST ? nullptr : PART->data;
+        }
+
+        part_pointer PART;  //!< Partition of the current element.
+        part_pointer LAST;  //!< One past the last partition.
+        pointer CURRENT;    //!< Current element, null at the end.
+    };
+
+    using iterator = basic_iterator<false>;      //!< Iterator type.
+    using const_iterator = basic_iterator<true>; //!< Const iterator type.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Creates a vector with no elements.
+    numa_vector() : PARTS(), SIZE(0), CHUNK(0)
+    {
+    }
+
+    /// Creates `count` copies of `value` in `partitions` partitions (0 means one per node).
+    explicit numa_vector(size_type count, const T &value = T(), unsigned partitions = 0) : numa_vector()
+    {
+        build(count, partitions, [&value](partition &part, size_type) {
+            for (; part.size < part.capacity; part.size++)
+                new (part.data + part.size) T(value);
+        });
+    }
+
+    /// Copies the elements of `source` into `partitions` partitions (0 means one per node).
+    explicit numa_vector(vector_view<const T> source, unsigned partitions = 0) : numa_vector()
+    {
+        build(source.size(), partitions, [&source](partition &part, size_type first) {
+            for (; part.size < part.capacity; part.size++)
+                new (part.data + part.size) T(source[first + part.size]);
+        });
+    }
+
+    /// Copy constructor; the copy has the same partitions, on the same nodes.
+    numa_vector(const numa_vector &other) : numa_vector()
+    {
+        build(other.SIZE, unsigned(other.PARTS.size()), [&other](partition &part, size_type first) {
+            for (; part.size < part.capacity; part.size++)
+                new (part.data + part.size) T(other[first + part.size]);
+        });
+    }
+
+    /// Move constructor; takes over the partitions of `other`, which is left empty.
+    numa_vector(numa_vector &&other) noexcept : PARTS(std::move(other.PARTS)), SIZE(other.SIZE), CHUNK(other.CHUNK)
+    {
+        other.SIZE = 0;
+        other.CHUNK = 0;
+    }
+
+    /// Destructor.
+    ~numa_vector()
+    {
+        release();
+    }
+
+    /// Copy assignment operator.
+    numa_vector &operator=(const numa_vector &other)
+    {
+        if (this != &other)
+        {
+            numa_vector copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    /// Move assignment operator.
+    numa_vector &operator=(numa_vector &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            PARTS = std::move(other.PARTS);
+            SIZE = other.SIZE;
+            CHUNK = other.CHUNK;
+            other.SIZE = 0;
+            other.CHUNK = 0;
+        }
+        return *this;
+    }
+
+    //=== [II] ITERATORS
+    /// Returns an iterator to the first element.
+    iterator begin()
+    {
+        return PARTS.empty() ? end() : iterator(PARTS.data(), PARTS.data() + PARTS.size(), PARTS[0].data);
+    }
+
+    /// Returns an iterator past the last element.
+    iterator end()
+    {
+        return iterator();
+    }
+
+    /// Returns a const iterator to the first element.
+    const_iterator begin() const
+    {
+        return cbegin();
+    }
+
+    /// Returns a const iterator past the last element.
+    const_iterator end() const
+    {
+        return cend();
+    }
+
+    /// Returns a const iterator to the first element.
+    const_iterator cbegin() const
+    {
+        return PARTS.empty() ? cend()
+                             : const_iterator(PARTS.data(), PARTS.data() + PARTS.size(), PARTS[0].data);
+    }
+
+    /// Returns a const iterator past the last element.
+    const_iterator cend() const
+    {
+        return const_iterator();
+    }
+
+    //=== [III] CAPACITY AND PARTITIONS
+    /// Returns the number of elements.
+    size_type size() const
+    {
+        return SIZE;
+    }
+
+    /// Returns true if the vector has no elements.
+    bool empty() const
+    {
+        return SIZE == 0;
+    }
+
+    /// Returns the number of elements of every partition but the last.
+    size_type chunk() const
+    {
+        return CHUNK;
+    }
+
+    /// Returns the number of partitions.
+    unsigned partitions() const
+    {
+        return unsigned(PARTS.size());
+    }
+
+    /// Returns the elements of partition `p`.
+    vector_view<T> partition_view(unsigned p)
+    {
+        return vector_view<T>(PARTS[p].data, PARTS[p].size);
+    }
+
+    /// Returns the elements of partition `p`.
+    vector_view<const T> partition_view(unsigned p) const
+    {
+        return vector_view<const T>(PARTS[p].data, PARTS[p].size);
+    }
+
+    /// Returns the node partition `p` is allocated on.
+    unsigned node(unsigned p) const
+    {
+        return PARTS[p].node;
+    }
+
+    //=== [IV] ELEMENT ACCESS
+    /// Returns the element at `idx`.
+    T &operator[](size_type idx)
+    {
+        SC_VECTOR_REQUIRE(idx < SIZE, "index out of range");
+        return PARTS[idx / CHUNK].data[idx % CHUNK];
+    }
+
+    /// Returns the element at `idx`.
+    const T &operator[](size_type idx) const
+    {
+        SC_VECTOR_REQUIRE(idx < SIZE, "index out of range");
+        return PARTS[idx / CHUNK].data[idx % CHUNK];
+    }
+
+    /// Returns the element at `idx`; throws std::out_of_range if `idx` is not a valid position.
+    T &at(size_type idx)
+    {
+        if (idx >= SIZE)
+            throw std::out_of_range("numa_vector::at: index out of range");
+        return (*this)[idx];
+    }
+
+    /// Returns the element at `idx`; throws std::out_of_range if `idx` is not a valid position.
+    const T &at(size_type idx) const
+    {
+        if (idx >= SIZE)
+            throw std::out_of_range("numa_vector::at: index out of range");
+        return (*this)[idx];
+    }
+
+    //=== [V] PARALLEL ALGORITHMS
+    /**
+     * Calls `f(view, node)` on a slice of each partition, from workers running on the CPUs of the
+     * partition's node. Each partition is split among the CPUs of its node; vectors with fewer than
+     * SC_VECTOR_PARALLEL_THRESHOLD elements are processed on the calling thread. The first
+     * exception thrown by `f` is rethrown once every worker has finished.
+     */
+    template <typename F>
+    void for_each_partition(F f)
+    {
+        run(split(), [this, &f](const job &task) {
+            f(vector_view<T>(PARTS[task.part].data + task.first, task.last - task.first), PARTS[task.part].node);
+        });
+    }
+
+    /// Read-only version of for_each_partition().
+    template <typename F>
+    void for_each_partition(F f) const
+    {
+        run(split(), [this, &f](const job &task) {
+            f(vector_view<const T>(PARTS[task.part].data + task.first, task.last - task.first),
+              PARTS[task.part].node);
+        });
+    }
+
+    /// Calls `f(element)` on every element, in parallel as for_each_partition() does.
+    template <typename F>
+    void for_each(F f)
+    {
+        for_each_partition([&f](vector_view<T> slice, unsigned) {
+            for (T &value : slice)
+                f(value);
+        });
+    }
+
+    /// Read-only version of for_each().
+    template <typename F>
+    void for_each(F f) const
+    {
+        for_each_partition([&f](vector_view<const T> slice, unsigned) {
+            for (const T &value : slice)
+                f(value);
+        });
+    }
+
+    /**
+     * Folds the elements into `init` with `op`, in parallel as for_each_partition() does. Each
+     * worker folds its slice, and the partial results are folded into `init` in element order, so
+     * `op` must be associative. `U` must be default constructible.
+     */
+    template <typename U, typename BinaryOp>
+    U reduce(U init, BinaryOp op) const
+    {
+        sc::vector<job> jobs = split();
+        sc::vector<U> partials;
+        partials.resize_for_overwrite(jobs.size()); // every slot is assigned by its worker
+        const job *first_job = jobs.data();
+        run(jobs, [this, &op, &partials, first_job](const job &task) {
+            const T *data = PARTS[task.part].data;
+            U acc = U(data[task.first]);
+            for (size_type i = task.first + 1; i < task.last; i++)
+                acc = op(acc, data[i]);
+            partials[size_type(&task - first_job)] = std::move(acc);
+        });
+        for (size_type j = 0; j < partials.size(); j++)
+            init = op(init, partials[j]);
+        return init;
+    }
+
+private:
+    /// A slice of one partition handed to one worker.
+    struct job
+    {
+        unsigned part;   //!< Index of the partition.
+        size_type first; //!< First element of the slice, within the partition.
+        size_type last;  //!< One past the last element of the slice.
+        bool pin;        //!< Whether the worker runs on its own thread, bound to the node.
+    };
+
+    /// Allocates the partitions for `count` elements and fills each with `fill(part, first index)`,
+    /// one thread per partition, bound to the partition's node.
+    template <typename Fill>
+    void build(size_type count, unsigned parts, Fill fill)
+    {
+        if (count == 0)
+            return;
+        const sc::vector<unsigned> &nodes = numa::nodes();
+        if (parts == 0)
+            parts = unsigned(nodes.size());
+        CHUNK = (count + parts - 1) / parts;
+        parts = unsigned((count + CHUNK - 1) / CHUNK); // no trailing empty partitions
+        SIZE = count;
+        PARTS.reserve(parts);
+        try
+        {
+            for (unsigned p = 0; p < parts; p++)
+            {
+                size_type capacity = p + 1 < parts ? CHUNK : count - CHUNK * p;
+                unsigned node = nodes[p % nodes.size()];
+                T *data = static_cast<T *>(numa::allocate_on_node(capacity * sizeof(T), node));
+                PARTS.push_back(partition{data, 0, capacity, node});
+            }
+
+            bool parallel = count >= SC_VECTOR_PARALLEL_THRESHOLD;
+            sc::vector<job> jobs;
+            for (unsigned p = 0; p < parts; p++)
+                jobs.push_back(job{p, 0, PARTS[p].capacity, parallel});
+            run(jobs, [this, &fill](const job &task) { fill(PARTS[task.part], CHUNK * task.part); });
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    /// Splits the partitions into slices, one per CPU of their node when the vector is large enough.
+    sc::vector<job> split() const
+    {
+        sc::vector<job> jobs;
+        bool parallel = SIZE >= SC_VECTOR_PARALLEL_THRESHOLD;
+        const size_type nodes = numa::nodes().size();
+        for (unsigned p = 0; p < PARTS.size(); p++)
+        {
+            // Partitions sharing a node share its CPUs.
+            size_type sharing = (PARTS.size() - p % nodes + nodes - 1) / nodes;
+            size_type workers = parallel ? numa::cpus_of(PARTS[p].node) / sharing : 1;
+            workers = workers == 0 ? 1 : workers;
+            size_type per_worker = (PARTS[p].size + workers - 1) / workers;
+            for (size_type first = 0; first < PARTS[p].size; first += per_worker)
+                jobs.push_back(job{p, first, std::min(PARTS[p].size, first + per_worker), parallel});
+        }
+        return jobs;
+    }
+
+    /// Runs `work(job)` for each job, on threads bound to the node of the job's partition when the
+    /// job asks for it and inline otherwise; rethrows the first exception.
+    template <typename Work>
+    void run(const sc::vector<job> &jobs, Work work) const
+    {
+        std::exception_ptr error;
+        std::mutex error_lock;
+        auto guarded = [this, &work, &error, &error_lock](const job &task) {
+            try
+            {
+                if (task.pin)
+                    numa::run_on_node(PARTS[task.part].node);
+                work(task);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_lock);
+                if (not error)
+                    error = std::current_exception();
+            }
+        };
+
+        detail::thread_group pool(jobs.size());
+        try
+        {
+            for (size_type j = 0; j < jobs.size(); j++)
+            {
+                if (jobs[j].pin)
+                    pool.start(guarded, std::cref(jobs[j]));
+                else
+                    guarded(jobs[j]);
+            }
+        }
+        catch (...)
+        {
+            // A thread could not be started; the remaining jobs do not run.
+            std::lock_guard<std::mutex> lock(error_lock);
+            if (not error)
+                error = std::current_exception();
+        }
+        pool.join();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /// Destroys the elements and frees the partitions.
+    void release() noexcept
+    {
+        for (size_type p = 0; p < PARTS.size(); p++)
+        {
+            for (size_type i = 0; i < PARTS[p].size; i++)
+                PARTS[p].data[i].~T();
+            numa::deallocate_on_node(PARTS[p].data, PARTS[p].capacity * sizeof(T));
+        }
+        PARTS = sc::vector<partition>();
+        SIZE = 0;
+        CHUNK = 0;
+    }
+
+    sc::vector<partition> PARTS; //!< The partitions, in element order.
+    size_type SIZE;              //!< Number of elements.
+    size_type CHUNK;             //!< Elements per partition; the last one may hold fewer.
+};
+} // namespace sc
+
+#endif
@@ -0,0 +1,560 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Implementation of a vector whose elements never move.
+ *
+ * Elements live in fixed-size chunks of `ChunkSize` elements; a growing container allocates one
+ * more chunk and records it in a directory, an sc::vector of chunk pointers. Only the directory
+ * is ever reallocated, so pointers, references and iterators to elements stay valid until the
+ * element is removed, and push_back never copies the elements already stored.
+ */
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H
+
+#include <cstddef>          // std::size_t, std::ptrdiff_t
+#include <initializer_list> // std::initializer_list
+#include <iterator>         // std::random_access_iterator_tag
+#include <memory>           // std::unique_ptr
+#include <stdexcept>        // std::out_of_range
+#include <string>           // std::to_string
+#include <type_traits>      // std::enable_if, std::is_convertible
+#include <utility>          // std::move
+
+#include "./vector_config.h"
+#include "./vector.h"
+#include "./vector_view.h"
+
+namespace sc
+{
+namespace detail
+{
+/// Largest power of two not greater than `n`, and at least 1.
+constexpr std::size_t floor_pow2(std::size_t n)
+{
+    return n < 2 ? 1 : 2 * floor_pow2(n / 2);
+}
+} // namespace detail
+
+/**
+ * @brief Iterator over a segmented_vector
+ *
+ * Holds the address of the container's chunk directory and an element index, so it stays valid
+ * while the container grows. `segment()` returns the contiguous run of
+ * elements from the current position to the end of its chunk, for loops that want to work on
+ * raw memory instead of stepping through the iterator.
+ */
+template <typename T, std::size_t ChunkSize>
+class segmented_iterator
+{
+    using directory = sc::vector<typename std::remove_const<T>::type *>; //!< The chunk directory of a container.
+
+public:
+    using difference_type = std::ptrdiff_t;                    //!< Difference type.
+    using value_type = typename std::remove_cv<T>::type;       //!< Value type the iterator points to.
+    using pointer = T *;                                       //!< Pointer to the value type.
+    using reference = T &;                                     //!< Reference to the value type.
+    using iterator_category = std::random_access_iterator_tag; //!< Iterator category.
+
+    /// Default constructor that creates a singular iterator.
+    segmented_iterator() : CHUNKS(nullptr), INDEX(0)
+    {
+    }
+
+    /// Constructs an iterator on element `index` of the chunks listed in `chunks`.
+    segmented_iterator(const directory *chunks, std::size_t index) : CHUNKS(chunks), INDEX(index)
+    {
+    }
+
+    /// A mutable iterator converts to a constant one.
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U *, T *>::value>::type>
+    segmented_iterator(const segmented_iterator<U, ChunkSize> &other) : CHUNKS(other.chunks()), INDEX(other.index())
+    {
+    }
+
+    /// Returns the element at the current position.
+    reference operator*() const
+    {
+        return CHUNKS->data()[INDEX / ChunkSize][INDEX % ChunkSize];
+    }
+
+    /// Returns the address of the element at the current position.
+    pointer operator->() const
+    {
+        return &**this;
+    }
+
+    /// Returns the element `n` positions away.
+    reference operator[](difference_type n) const
+    {
+        return *(*this + n);
+    }
+
+    /// Advances the iterator to the next element.
+    segmented_iterator &operator++()
+    {
+        ++INDEX;
+        return *this;
+    }
+
+    /// Advances the iterator to the next element.
+    segmented_iterator operator++(int)
+    {
+        segmented_iterator old(*this);
+        ++INDEX;
+        return old;
+    }
+
+    /// Moves the iterator to the previous element.
+    segmented_iterator &operator--()
+    {
+        --INDEX;
+        return *this;
+    }
+
+    /// Moves the iterator to the previous element.
+    segmented_iterator operator--(int)
+    {
+        segmented_iterator old(*this);
+        --INDEX;
+        return old;
+    }
+
+    /// Advances the iterator by `n` elements.
+    segmented_iterator &operator+=(difference_type n)
+    {
+        INDEX += n;
+        return *this;
+    }
+
+    /// Moves the iterator back by `n` elements.
+    segmented_iterator &operator-=(difference_type n)
+    {
+        INDEX -= n;
+        return *this;
+    }
+
+    /// Returns an iterator `n` elements ahead.
+    segmented_iterator operator+(difference_type n) const
+    {
+        return segmented_iterator(CHUNKS, INDEX + n);
+    }
+
+    /// Returns an iterator `n` elements behind.
+    segmented_iterator operator-(difference_type n) const
+    {
+        return segmented_iterator(CHUNKS, INDEX - n);
+    }
+
+    /// Returns the number of elements between both iterators.
+    difference_type operator-(const segmented_iterator &other) const
+    {
+        return difference_type(INDEX) - difference_type(other.INDEX);
+    }
+
+    /// Check if both iterators point to the same element.
+    bool operator==(const segmented_iterator &other) const
+    {
+        return INDEX == other.INDEX;
+    }
+
+    /// Check if the iterators point to different elements.
+    bool operator!=(const segmented_iterator &other) const
+    {
+        return INDEX != other.INDEX;
+    }
+
+    /// Check if this iterator comes before `other`.
+    bool operator<(const segmented_iterator &other) const
+    {
+        return INDEX < other.INDEX;
+    }
+
+    /// Check if this iterator comes after `other`.
+    bool operator>(const segmented_iterator &other) const
+    {
+        return INDEX > other.INDEX;
+    }
+
+    /// Check if this iterator does not come after `other`.
+    bool operator<=(const segmented_iterator &other) const
+    {
+        return INDEX <= other.INDEX;
+    }
+
+    /// Check if this iterator does not come before `other`.
+    bool operator>=(const segmented_iterator &other) const
+    {
+        return INDEX >= other.INDEX;
+    }
+
+    /// Returns the contiguous elements from the current position up to `last`, or to the end of the chunk if that comes first.
+    vector_view<T> segment(const segmented_iterator &last) const
+    {
+        std::size_t chunk_left = ChunkSize - INDEX % ChunkSize;
+        std::size_t count = last.INDEX - INDEX < chunk_left ? last.INDEX - INDEX : chunk_left;
+        return vector_view<T>(count == 0 ? nullptr : &**this, count);
+    }
+
+    /// Returns the chunk directory.
+    const directory *chunks() const
+    {
+        return CHUNKS;
+    }
+
+    /// Returns the index of the current element.
+    std::size_t index() const
+    {
+        return INDEX;
+    }
+
+private:
+    const directory *CHUNKS; //!< The chunk directory of the container; the iterator survives its reallocation.
+    std::size_t INDEX;           //!< Index of the current element.
+};
+
+/// Returns an iterator `n` elements ahead of `it`.
+template <typename T, std::size_t ChunkSize>
+segmented_iterator<T, ChunkSize> operator+(typename segmented_iterator<T, ChunkSize>::difference_type n,
+                                           const segmented_iterator<T, ChunkSize> &it)
+{
+    return it + n;
+}
+
+/// Calls `fn` with a vector_view of each contiguous run of elements in [first, last).
+template <typename T, std::size_t ChunkSize, typename Function>
+Function for_each_segment(segmented_iterator<T, ChunkSize> first, segmented_iterator<T, ChunkSize> last, Function fn)
+{
+    while (first != last)
+    {
+        vector_view<T> run = first.segment(last);
+        fn(run);
+        first += run.size();
+    }
+    return fn;
+}
+
+/**
+ * @brief Vector with stable element addresses
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Stores its elements in chunks of `ChunkSize` elements (a power of two, by default as many as
+ * fit in 4 KiB). Indexing costs a shift, a mask and one extra load through the chunk directory.
+ * Only removing an element invalidates references to it.
+ */
+template <typename T, std::size_t ChunkSize = detail::floor_pow2(4096 / sizeof(T))>
+class segmented_vector
+{
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+public:
+    using size_type = unsigned long;                          //!< The size type.
+    using value_type = T;                                     //!< The value type.
+    using pointer = value_type *;                             //!< Pointer to a value stored in the container.
+    using reference = value_type &;                           //!< Reference to a value stored in the container.
+    using const_reference = const value_type &;               //!< Const reference to a value stored in the container.
+    using iterator = segmented_iterator<T, ChunkSize>;        //!< Iterator that points to a specific element of type T.
+    using const_iterator = segmented_iterator<const T, ChunkSize>; //!< Const iterator that points to a specific element of type T.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Default constructor that creates an empty list.
+    segmented_vector() : CHUNKS(), SIZE(0)
+    {
+    }
+
+    /// Constructs the list with the contents of the range [first, last).
+    template <SC_VECTOR_INPUT_ITERATOR InputIt>
+    segmented_vector(InputIt first, InputIt last) : CHUNKS(), SIZE(0)
+    {
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    /// Constructs the list with the contents of the initializer list init.
+    segmented_vector(std::initializer_list<T> ilist) : segmented_vector(ilist.begin(), ilist.end())
+    {
+    }
+
+    /// Copy constructor. Constructs the list with the deep copy of the contents of other.
+    segmented_vector(const segmented_vector &other) : CHUNKS(), SIZE(0)
+    {
+        *this = other;
+    }
+
+    /// Move constructor. Takes over the chunks of other, which is left empty; no element moves.
+    /// Iterators into `other` keep pointing at its own, now empty, chunk directory.
+    segmented_vector(segmented_vector &&other) noexcept : CHUNKS(std::move(other.CHUNKS)), SIZE(other.SIZE)
+    {
+        other.SIZE = 0;
+    }
+
+    /// Destructs the list.
+    ~segmented_vector()
+    {
+        release_chunks();
+    }
+
+    /// Copy assignment operator. The chunks already allocated are reused.
+    segmented_vector &operator=(const segmented_vector &other)
+    {
+        if (this == &other)
+            return *this;
+
+        reserve(other.SIZE);
+        for (size_type i = 0; i < other.SIZE; i++)
+            CHUNKS[i / ChunkSize][i % ChunkSize] = other[i];
+        SIZE = other.SIZE;
+
+        return *this;
+    }
+
+    /// Move assignment operator. Frees the chunks of this list and takes over those of other, which is left empty.
+    segmented_vector &operator=(segmented_vector &&other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        release_chunks();
+        CHUNKS = std::move(other.CHUNKS);
+        SIZE = other.SIZE;
+        other.SIZE = 0;
+
+        return *this;
+    }
+
+    /// Replaces the contents with those identified by initializer list ilist.
+    segmented_vector &operator=(std::initializer_list<T> ilist)
+    {
+        clear();
+        for (const auto &value : ilist)
+            push_back(value);
+        return *this;
+    }
+
+    //=== [II] ITERATORS
+    /// Returns an iterator pointing to the first item in the list.
+    iterator begin()
+    {
+        return iterator(&CHUNKS, 0);
+    }
+
+    /// Returns an iterator pointing to the end mark in the list, i.e. the position just after the last element of the list.
+    iterator end()
+    {
+        return iterator(&CHUNKS, SIZE);
+    }
+
+    /// Returns a constant iterator pointing to the first item in the list.
+    const_iterator begin() const
+    {
+        return cbegin();
+    }
+
+    /// Returns a constant iterator pointing to the end mark in the list.
+    const_iterator end() const
+    {
+        return cend();
+    }
+
+    /// Returns a constant iterator pointing to the first item in the list.
+    const_iterator cbegin() const
+    {
+        return const_iterator(&CHUNKS, 0);
+    }
+
+    /// Returns a constant iterator pointing to the end mark in the list, i.e. the position just after the last element of the list.
+    const_iterator cend() const
+    {
+        return const_iterator(&CHUNKS, SIZE);
+    }
+
+    //=== [III] Capacity
+    /// Return the number of elements in the container.
+    size_type size() const
+    {
+        return SIZE;
+    }
+
+    /// Return the number of elements the allocated chunks can hold.
+    size_type capacity() const
+    {
+        return CHUNKS.size() * ChunkSize;
+    }
+
+    /// Returns true if the container contains no elements, and false otherwise.
+    bool empty() const
+    {
+        return SIZE == 0;
+    }
+
+    /// Allocates chunks until `new_cap` elements fit. Existing elements are not touched.
+    void reserve(size_type new_cap)
+    {
+        if (new_cap <= capacity())
+            return;
+
+        CHUNKS.reserve((new_cap + ChunkSize - 1) / ChunkSize);
+        while (capacity() < new_cap)
+            CHUNKS.push_back(new T[ChunkSize]);
+    }
+
+    /// Frees the chunks that hold no element.
+    void shrink_to_fit()
+    {
+        size_type used = (SIZE + ChunkSize - 1) / ChunkSize;
+        for (size_type c = used; c < CHUNKS.size(); c++)
+            delete[] CHUNKS[c];
+        CHUNKS.erase(CHUNKS.begin() + used, CHUNKS.end());
+    }
+
+    //=== [IV] Modifiers
+    /// Remove all elements from the container. The chunks are kept for reuse.
+    void clear()
+    {
+        SIZE = 0;
+    }
+
+    /// Adds value to the end of the list. Costs at most one chunk allocation; no element moves.
+    void push_back(const_reference value)
+    {
+        if (SIZE == capacity())
+        {
+            std::unique_ptr<T[]> chunk(new T[ChunkSize]); // freed if the directory cannot grow
+            CHUNKS.push_back(chunk.get());
+            chunk.release();
+        }
+        CHUNKS[SIZE / ChunkSize][SIZE % ChunkSize] = value;
+        ++SIZE;
+    }
+
+    /// Removes the object at the end of the list. The chunk stays allocated for the next push_back.
+    void pop_back()
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "pop_back() on an empty vector");
+        --SIZE;
+    }
+
+    //=== [V] Element access
+    /// Returns the object at the beginning of the list.
+    const_reference front() const
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "front() on an empty vector");
+        return CHUNKS[0][0];
+    }
+
+    /// Returns the object at the beginning of the list.
+    reference front()
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "front() on an empty vector");
+        return CHUNKS[0][0];
+    }
+
+    /// Returns the object at the end of the list.
+    const_reference back() const
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "back() on an empty vector");
+        return (*this)[SIZE - 1];
+    }
+
+    /// Returns the object at the end of the list.
+    reference back()
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "back() on an empty vector");
+        return (*this)[SIZE - 1];
+    }
+
+    /// Returns the object at the index pos, with no bounds-checking.
+    reference operator[](size_type pos)
+    {
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return CHUNKS[pos / ChunkSize][pos % ChunkSize];
+    }
+
+    /// Returns the object at the index pos, with no bounds-checking.
+    const_reference operator[](size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return CHUNKS[pos / ChunkSize][pos % ChunkSize];
+    }
+
+    /// Returns the object at the index pos, with bounds-checking.
+    const_reference at(size_type pos) const
+    {
+        if (pos >= SIZE)
+            throw std::out_of_range(std::to_string(pos));
+        return (*this)[pos];
+    }
+
+    /// Returns the object at the index pos, with bounds-checking.
+    reference at(size_type pos)
+    {
+        if (pos >= SIZE)
+            throw std::out_of_range(std::to_string(pos));
+        return (*this)[pos];
+    }
+
+    /// Returns the number of chunks holding at least one element.
+    size_type segment_count() const
+    {
+        return (SIZE + ChunkSize - 1) / ChunkSize;
+    }
+
+    /// Returns the elements stored in chunk `i`, a contiguous run of at most `ChunkSize` elements.
+    vector_view<T> segment(size_type i)
+    {
+        SC_VECTOR_REQUIRE(i < segment_count(), "segment() index out of range");
+        return vector_view<T>(CHUNKS[i], i + 1 < segment_count() ? ChunkSize : SIZE - i * ChunkSize);
+    }
+
+    /// Returns the elements stored in chunk `i`, a contiguous run of at most `ChunkSize` elements.
+    vector_view<const T> segment(size_type i) const
+    {
+        SC_VECTOR_REQUIRE(i < segment_count(), "segment() index out of range");
+        return vector_view<const T>(CHUNKS[i], i + 1 < segment_count() ? ChunkSize : SIZE - i * ChunkSize);
+    }
+
+    /// Check if contents of both vectors are equal
+    bool operator==(const segmented_vector &other) const
+    {
+        if (SIZE != other.SIZE)
+            return false;
+
+        for (size_type i = 0; i < SIZE; i++)
+            if ((*this)[i] != other[i])
+                return false;
+
+        return true;
+    }
+
+    /// Check if contents of both vectors are different
+    bool operator!=(const segmented_vector &other) const
+    {
+        return not(*this == other);
+    }
+
+private:
+    /// Frees every chunk, leaving the directory pointing at freed memory until it is cleared or replaced.
+    void release_chunks()
+    {
+        for (size_type c = 0; c < CHUNKS.size(); c++)
+            delete[] CHUNKS[c];
+    }
+
+    sc::vector<T *> CHUNKS; //!< Chunk directory; chunk `c` holds elements [c * ChunkSize, (c + 1) * ChunkSize).
+    size_type SIZE;         //!< Logical size of vector, i.e. the amount of elements stored.
+};
+
+/// Folds the elements of `vec` into `init` with `op`, one contiguous chunk at a time.
+template <typename T, std::size_t ChunkSize, typename U, typename BinaryOp = std::plus<U>>
+U reduce(const segmented_vector<T, ChunkSize> &vec, U init, BinaryOp op = BinaryOp())
+{
+    for (unsigned long i = 0; i < vec.segment_count(); i++)
+        init = reduce(vec.segment(i), init, op);
+    return init;
+}
+} // namespace sc
+
+#endif
@@ -0,0 +1,381 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * A vector shared by many threads that read, update and occasionally append elements.
+ *
+ * Guarding one sc::vector with one mutex serializes every access, even when the threads touch
+ * unrelated elements. sharded_vector deals the indices out round-robin to a power-of-two number of
+ * shards (element i lives in shard i % shards()), each with its own buffer and its own lock on a
+ * separate cache line, so threads working on different elements rarely meet. Neighbouring
+ * indices land in different shards: two elements that share a cache line also share a lock.
+ *
+ * Each shard lock is a seqlock combined with a count of locked readers. Writers (update, store,
+ * push_back) take it exclusively. load() on trivially copyable elements does not lock at all: it
+ * copies the element between two reads of the sequence and retries if a writer got in between.
+ * Other element types, and read(), take the shard in shared mode. Buffers replaced by growth are
+ * retired instead of freed, so a lock-free reader never touches released memory; reclaim() frees
+ * them once no other thread uses the vector.
+ */
+#ifndef SHARDED_VECTOR_H
+#define SHARDED_VECTOR_H
+
+#include <algorithm>   // std::copy, std::max
+#include <atomic>      // std::atomic, std::atomic_thread_fence
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uintptr_t
+#include <cstring>     // std::memcpy
+#include <mutex>       // std::mutex, std::lock_guard
+#include <new>         // placement new
+#include <thread>      // std::thread::hardware_concurrency, std::this_thread::yield
+#include <type_traits> // std::is_trivially_copyable
+#include <utility>     // std::declval
+
+#include "./vector_config.h"
+#include "./vector.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h> // _mm_pause
+#endif
+
+namespace sc
+{
+namespace detail
+{
+/// Backs off inside a spin loop: pauses the core for the first iterations, then yields the CPU
+/// so that a lock holder that was preempted gets to run.
+inline void spin_wait(unsigned &spins)
+{
+    if (++spins < 64)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        _mm_pause();
+#endif
+    }
+    else
+        std::this_thread::yield();
+}
+} // namespace detail
+
+/**
+ * @brief Vector of lock-striped shards for concurrent random updates
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Every member may be called from any thread, except reclaim() and the destructor. Indices below
+ * size() stay valid forever; push_back() makes its index visible once the element is stored.
+ */
+template <typename T>
+class sharded_vector
+{
+public:
+    using size_type = unsigned long; //!< The size type.
+    using value_type = T;            //!< The value type.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Creates `count` copies of `value` spread over `shards` shards, rounded up to a power of two
+    /// (0 picks four shards per hardware thread).
+    explicit sharded_vector(size_type count = 0, const T &value = T(), unsigned shards = 0)
+        : RAW(nullptr), SHARDS(nullptr), COUNT(round_up(shards)), MASK(COUNT - 1), SHIFT(0), SIZE(count)
+    {
+        while ((size_type(1) << SHIFT) < COUNT)
+            SHIFT++;
+
+        RAW = ::operator new(sizeof(shard) * COUNT + alignof(shard));
+        SHARDS = reinterpret_cast<shard *>((std::uintptr_t(RAW) + alignof(shard) - 1) / alignof(shard) * alignof(shard));
+
+        size_type built = 0;
+        try
+        {
+            for (; built < COUNT; built++)
+                new (SHARDS + built) shard();
+            for (size_type s = 0; s < COUNT; s++)
+            {
+                size_type slots = (count >> SHIFT) + ((count & MASK) > s);
+                if (slots == 0)
+                    continue;
+                T *elements = new T[slots];
+                SHARDS[s].ELEMENTS.store(elements, std::memory_order_relaxed);
+                SHARDS[s].CAPACITY = slots;
+                SHARDS[s].SLOTS = slots;
+                std::fill(elements, elements + slots, value);
+            }
+        }
+        catch (...)
+        {
+            release(built);
+            throw;
+        }
+    }
+
+    sharded_vector(const sharded_vector &) = delete;
+    sharded_vector &operator=(const sharded_vector &) = delete;
+
+    /// Frees the shards, their buffers and the retired ones.
+    ~sharded_vector()
+    {
+        release(COUNT);
+    }
+
+    //=== [II] CAPACITY
+    /// Returns how many elements were made visible, by the constructor or by push_back().
+    size_type size() const
+    {
+        return SIZE.load(std::memory_order_acquire);
+    }
+
+    /// Returns true when there are no elements.
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// Returns the number of shards, a power of two.
+    size_type shards() const
+    {
+        return COUNT;
+    }
+
+    //=== [III] ELEMENT ACCESS
+    /// Returns a copy of the element at `idx`. Trivially copyable elements are read without locking;
+    /// the others are copied under the shard's shared lock.
+    T load(size_type idx) const
+    {
+        SC_VECTOR_REQUIRE(idx < size(), "index out of range");
+        return load(shard_of(idx), idx >> SHIFT, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+    }
+
+    /// Calls `fn(element)` with a const reference to the element at `idx` under the shard's shared
+    /// lock, and returns what it returns. Writers to the shard wait until `fn` is done.
+    template <typename Fn>
+    auto read(size_type idx, Fn fn) const -> decltype(fn(std::declval<const T &>()))
+    {
+        SC_VECTOR_REQUIRE(idx < size(), "index out of range");
+        shard &s = shard_of(idx);
+        shared_guard guard(s);
+        return fn(static_cast<const T &>(s.ELEMENTS.load(std::memory_order_relaxed)[idx >> SHIFT]));
+    }
+
+    //=== [IV] MODIFIERS
+    /// Calls `fn(element)` with a reference to the element at `idx` while holding the shard
+    /// exclusively, and returns what it returns. If `fn` throws, the lock is released.
+    template <typename Fn>
+    auto update(size_type idx, Fn fn) -> decltype(fn(std::declval<T &>()))
+    {
+        SC_VECTOR_REQUIRE(idx < size(), "index out of range");
+        shard &s = shard_of(idx);
+        exclusive_guard guard(s);
+        return fn(s.ELEMENTS.load(std::memory_order_relaxed)[idx >> SHIFT]);
+    }
+
+    /// Replaces the element at `idx` with `value`.
+    void store(size_type idx, const T &value)
+    {
+        update(idx, [&value](T &element) { element = value; });
+    }
+
+    /// Appends `value` and returns its index. Appends are serialized with each other, but only lock
+    /// the shard that receives the element; readers and writers of the other shards go on.
+    size_type push_back(const T &value)
+    {
+        std::lock_guard<std::mutex> appending(APPEND);
+        size_type idx = SIZE.load(std::memory_order_relaxed);
+        shard &s = shard_of(idx);
+        {
+            exclusive_guard guard(s);
+            if (s.SLOTS == s.CAPACITY)
+                grow(s);
+            s.ELEMENTS.load(std::memory_order_relaxed)[s.SLOTS] = value;
+            s.SLOTS++;
+        }
+        SIZE.store(idx + 1, std::memory_order_release);
+        return idx;
+    }
+
+    /// Frees the buffers that growth replaced. No other thread may use the vector meanwhile.
+    void reclaim()
+    {
+        for (size_type s = 0; s < COUNT; s++)
+            reclaim(SHARDS[s]);
+    }
+
+    //=== [V] OPERATIONS
+    /// Copies every element into an sc::vector, in index order. Each element is read atomically, but
+    /// the copy is not a snapshot of the whole vector if other threads are writing.
+    sc::vector<T> snapshot() const
+    {
+        size_type count = size();
+        sc::vector<T> result;
+        result.reserve(count);
+        for (size_type i = 0; i < count; i++)
+            result.push_back(load(i));
+        return result;
+    }
+
+private:
+    /// A stripe of the elements with its lock, alone on its cache lines.
+    struct alignas(64) shard
+    {
+        std::atomic<unsigned> SEQUENCE{0}; //!< Odd while a writer holds the shard; bumped by every write.
+        std::atomic<unsigned> READERS{0};  //!< Readers holding the shard through the shared lock.
+        std::atomic<T *> ELEMENTS{nullptr}; //!< The buffer; swapped by growth while the shard is held.
+        size_type SLOTS = 0;               //!< Elements stored in the buffer; written under the lock.
+        size_type CAPACITY = 0;            //!< Size of the buffer.
+        sc::vector<T *> RETIRED;           //!< Buffers replaced by growth, kept for lock-free readers.
+    };
+
+    /// Holds a shard exclusively for its lifetime.
+    struct exclusive_guard
+    {
+        explicit exclusive_guard(shard &s) : SHARD(s)
+        {
+            unsigned spins = 0;
+            for (;;)
+            {
+                unsigned sequence = SHARD.SEQUENCE.load(std::memory_order_relaxed);
+                if ((sequence & 1) == 0 && SHARD.SEQUENCE.compare_exchange_weak(sequence, sequence + 1))
+                    break;
+                detail::spin_wait(spins);
+            }
+            // The odd sequence must be visible before the writes it guards (the seqlock writer's fence).
+            std::atomic_thread_fence(std::memory_order_release);
+            // Readers that got in before the sequence turned odd finish first; later ones back off.
+            while (SHARD.READERS.load() != 0)
+                detail::spin_wait(spins);
+        }
+        ~exclusive_guard()
+        {
+            // Nobody else changes an odd sequence, so a plain store releases the shard.
+            SHARD.SEQUENCE.store(SHARD.SEQUENCE.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+        exclusive_guard(const exclusive_guard &) = delete;
+        exclusive_guard &operator=(const exclusive_guard &) = delete;
+
+        shard &SHARD; //!< The shard held.
+    };
+
+    /// Holds a shard in shared mode for its lifetime.
+    struct shared_guard
+    {
+        explicit shared_guard(shard &s) : SHARD(s)
+        {
+            unsigned spins = 0;
+            for (;;)
+            {
+                SHARD.READERS.fetch_add(1);
+                if ((SHARD.SEQUENCE.load() & 1) == 0)
+                    break;
+                SHARD.READERS.fetch_sub(1, std::memory_order_release);
+                while ((SHARD.SEQUENCE.load(std::memory_order_relaxed) & 1) != 0)
+                    detail::spin_wait(spins);
+            }
+        }
+        ~shared_guard()
+        {
+            SHARD.READERS.fetch_sub(1, std::memory_order_release);
+        }
+        shared_guard(const shared_guard &) = delete;
+        shared_guard &operator=(const shared_guard &) = delete;
+
+        shard &SHARD; //!< The shard held.
+    };
+
+    /// Rounds a requested shard count up to a power of two; 0 picks four per hardware thread.
+    static size_type round_up(unsigned requested)
+    {
+        size_type wanted = requested != 0 ? requested : 4 * std::max(1u, std::thread::hardware_concurrency());
+        size_type count = 1;
+        while (count < wanted)
+            count *= 2;
+        return count;
+    }
+
+    /// Returns the shard that holds index `idx`.
+    shard &shard_of(size_type idx) const
+    {
+        return SHARDS[idx & MASK];
+    }
+
+    /// Lock-free read: copies the element between two reads of the sequence, until no writer interfered.
+    /// Growth retires the buffer it replaces, so the copy never reads freed memory.
+    static T load(shard &s, size_type slot, std::true_type)
+    {
+        unsigned spins = 0;
+        for (;;)
+        {
+            unsigned before = s.SEQUENCE.load(std::memory_order_acquire);
+            if ((before & 1) == 0)
+            {
+                T value;
+                std::memcpy(static_cast<void *>(&value), s.ELEMENTS.load(std::memory_order_acquire) + slot, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.SEQUENCE.load(std::memory_order_relaxed) == before)
+                    return value;
+            }
+            detail::spin_wait(spins);
+        }
+    }
+
+    /// Locked read, for elements that cannot be copied byte by byte.
+    static T load(shard &s, size_type slot, std::false_type)
+    {
+        shared_guard guard(s);
+        return s.ELEMENTS.load(std::memory_order_relaxed)[slot];
+    }
+
+    /// Doubles the buffer of `s`, which the caller holds exclusively, and retires the old one.
+    static void grow(shard &s)
+    {
+        size_type capacity = std::max<size_type>(2 * s.CAPACITY, 8);
+        T *old = s.ELEMENTS.load(std::memory_order_relaxed);
+        s.RETIRED.reserve(s.RETIRED.size() + 1);
+
+        T *grown = new T[capacity];
+        try
+        {
+            std::copy(old, old + s.SLOTS, grown);
+        }
+        catch (...)
+        {
+            delete[] grown;
+            throw;
+        }
+        s.ELEMENTS.store(grown, std::memory_order_release);
+        s.CAPACITY = capacity;
+        if (old != nullptr)
+            s.RETIRED.push_back(old);
+    }
+
+    /// Frees the retired buffers of `s`.
+    static void reclaim(shard &s)
+    {
+        for (size_type r = 0; r < s.RETIRED.size(); r++)
+            delete[] s.RETIRED[r];
+        s.RETIRED.clear();
+    }
+
+    /// Frees the first `built` shards, everything they own, and the shard storage.
+    void release(size_type built)
+    {
+        for (size_type s = 0; s < built; s++)
+        {
+            reclaim(SHARDS[s]);
+            delete[] SHARDS[s].ELEMENTS.load(std::memory_order_relaxed);
+            SHARDS[s].~shard();
+        }
+        ::operator delete(RAW);
+    }
+
+    void *RAW;                    //!< Storage of the shards, over-allocated to align them to a cache line.
+    shard *SHARDS;                //!< The shards.
+    const size_type COUNT;        //!< Number of shards.
+    const size_type MASK;         //!< COUNT - 1; `idx & MASK` is the shard of idx.
+    size_type SHIFT;              //!< log2(COUNT); `idx >> SHIFT` is the slot of idx in its shard.
+    std::mutex APPEND;            //!< Serializes push_back().
+    std::atomic<size_type> SIZE;  //!< Elements visible to readers.
+};
+} // namespace sc
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Read-only search index over a sorted array, stored in Eytzinger (breadth-first) order.
+ *
+ * A binary search over a sorted array touches a new cache line at almost every step, and the
+ * next line it needs is unknown until the current comparison is done. In Eytzinger order the
+ * node at slot `k` has its children at `2k` and `2k + 1`, so the keys of the first levels share a
+ * few hot cache lines, and all 16 (or 8, for 8-byte keys) descendants four (three) levels down a
+ * node are adjacent. The search prefetches that line while it is still deciding the next few
+ * steps, which hides most of the memory latency on arrays much larger than the cache.
+ */
+#ifndef STATIC_SEARCH_INDEX_H
+#define STATIC_SEARCH_INDEX_H
+
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uintptr_t
+#include <algorithm>  // std::is_sorted
+#include <functional> // std::less
+
+#include "./vector_config.h"
+#include "./vector.h"
+#include "./vector_view.h"
+
+namespace sc
+{
+/**
+ * @brief Static Eytzinger-layout search index
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * Built once from a sorted sequence of keys; answers lower_bound / contains queries with positions
+ * in the original sorted order, so they can index arrays of payloads kept next to it. The index
+ * holds its own copy of the keys and does not refer to the source after construction.
+ */
+template <typename Key, typename Compare = std::less<Key>>
+class static_search_index
+{
+public:
+    using size_type = unsigned long; //!< The size type.
+    using key_type = Key;            //!< The key type.
+    using key_compare = Compare;     //!< The ordering of the keys.
+
+    /// Number of keys per 64-byte cache line; the search prefetches this many levels ahead.
+    static constexpr size_type BLOCK = 64 % sizeof(Key) == 0 ? 64 / sizeof(Key) : 1;
+    /// How many queries the batched lookups keep in flight at once.
+    static constexpr size_type BATCH = 16;
+
+    //=== [I] SPECIAL MEMBERS
+    /// Default constructor that creates an empty index.
+    static_search_index() : STORAGE(), SKIP(0), SIZE(0), HEIGHT(0), LAST_LEVEL(0), COMP()
+    {
+    }
+
+    /// Builds the index from `sorted`, which must be sorted by `comp`; duplicates are allowed.
+    explicit static_search_index(vector_view<const Key> sorted, const Compare &comp = Compare())
+        : STORAGE(), SKIP(0), SIZE(sorted.size()), HEIGHT(0), LAST_LEVEL(0), COMP(comp)
+    {
+        SC_VECTOR_REQUIRE(std::is_sorted(sorted.begin(), sorted.end(), comp), "static_search_index built from unsorted keys");
+
+        while ((size_type(1) << HEIGHT) - 1 < SIZE)
+            HEIGHT++;
+        LAST_LEVEL = HEIGHT == 0 ? 0 : SIZE - ((size_type(1) << (HEIGHT - 1)) - 1);
+
+        // Slot 0 is unused; slot 0 is placed on a cache line boundary so each block of descendants shares a line.
+        STORAGE.assign(SIZE + BLOCK, Key());
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(STORAGE.data());
+        if (BLOCK > 1 && address % sizeof(Key) == 0)
+            SKIP = (64 - address % 64) % 64 / sizeof(Key);
+
+        Key *keys = slots();
+        for (size_type k = 1; k <= SIZE; k++)
+            keys[k] = sorted[rank(k)];
+    }
+
+    //=== [II] Capacity
+    /// Return the number of keys in the index.
+    size_type size() const
+    {
+        return SIZE;
+    }
+
+    /// Returns true if the index holds no keys, and false otherwise.
+    bool empty() const
+    {
+        return SIZE == 0;
+    }
+
+    //=== [III] Lookup
+    /// Returns the position, in sorted order, of the first key not less than `key`, or size() if there is none.
+    size_type lower_bound(const Key &key) const
+    {
+        return rank(descend(key));
+    }
+
+    /// Returns true if a key equivalent to `key` is present.
+    bool contains(const Key &key) const
+    {
+        size_type k = descend(key);
+        return k != 0 && not COMP(key, slots()[k]);
+    }
+
+    /// Answers `queries.size()` lower_bound queries, writing the positions to `ranks`.
+    /// The queries advance level by level in groups of BATCH, so the cache misses of independent
+    /// lookups overlap instead of being paid one after the other.
+    void lower_bound(vector_view<const Key> queries, vector_view<size_type> ranks) const
+    {
+        SC_VECTOR_REQUIRE(ranks.size() >= queries.size(), "lower_bound() output shorter than the queries");
+
+        size_type k[BATCH];
+        for (size_type first = 0; first < queries.size(); first += BATCH)
+        {
+            size_type count = queries.size() - first < BATCH ? queries.size() - first : BATCH;
+            descend_batch(queries.data() + first, count, k);
+            for (size_type q = 0; q < count; q++)
+                ranks[first + q] = rank(k[q]);
+        }
+    }
+
+    /// Answers `queries.size()` contains queries, writing 1 (found) or 0 (absent) to `found`.
+    void contains(vector_view<const Key> queries, vector_view<bool> found) const
+    {
+        SC_VECTOR_REQUIRE(found.size() >= queries.size(), "contains() output shorter than the queries");
+
+        const Key *keys = slots();
+        size_type k[BATCH];
+        for (size_type first = 0; first < queries.size(); first += BATCH)
+        {
+            size_type count = queries.size() - first < BATCH ? queries.size() - first : BATCH;
+            descend_batch(queries.data() + first, count, k);
+            for (size_type q = 0; q < count; q++)
+                found[first + q] = k[q] != 0 && not COMP(queries[first + q], keys[k[q]]);
+        }
+    }
+
+private:
+    /// Returns the array of slots; slot `k` has its children at `2k` and `2k + 1`.
+    const Key *slots() const
+    {
+        return STORAGE.data() + SKIP;
+    }
+
+    /// Returns the array of slots; slot `k` has its children at `2k` and `2k + 1`.
+    Key *slots()
+    {
+        return STORAGE.data() + SKIP;
+    }
+
+    /// Walks from the root to a leaf and returns the slot of the first key not less than `key`, or 0 if there is none.
+    size_type descend(const Key &key) const
+    {
+        const Key *keys = slots();
+        size_type k = 1;
+        while (k <= SIZE)
+        {
+            SC_VECTOR_PREFETCH(keys + k * BLOCK);
+            k = 2 * k + COMP(keys[k], key);
+        }
+        return resolve(k);
+    }
+
+    /// Runs descend() on `count` queries at once, one tree level at a time.
+    void descend_batch(const Key *queries, size_type count, size_type *k) const
+    {
+        const Key *keys = slots();
+        for (size_type q = 0; q < count; q++)
+            k[q] = 1;
+
+        // Every root-to-leaf path has HEIGHT - 1 full levels; only the last level may be partial.
+        for (size_type level = 1; level < HEIGHT; level++)
+            for (size_type q = 0; q < count; q++)
+            {
+                SC_VECTOR_PREFETCH(keys + k[q] * BLOCK);
+                k[q] = 2 * k[q] + COMP(keys[k[q]], queries[q]);
+            }
+        for (size_type q = 0; q < count; q++)
+        {
+            if (HEIGHT > 0 && k[q] <= SIZE)
+                k[q] = 2 * k[q] + COMP(keys[k[q]], queries[q]);
+            k[q] = resolve(k[q]);
+        }
+    }
+
+    /// Undoes the trailing right turns (1 bits) and the final left turn of a search path, which leads back to the answer.
+    static size_type resolve(size_type k)
+    {
+        return k >> (count_trailing_ones(k) + 1);
+    }
+
+    /// Number of trailing 1 bits of `k`.
+    static unsigned count_trailing_ones(size_type k)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzl(~k);
+#else
+        unsigned n = 0;
+        for (; k & 1; k >>= 1)
+            n++;
+        return n;
+#endif
+    }
+
+    /// Position in sorted order of the key at slot `k`, or SIZE for slot 0.
+    /// The tree is complete, so this is the in-order rank in a perfect tree of HEIGHT levels minus
+    /// the number of absent last-level leaves that would come before it.
+    size_type rank(size_type k) const
+    {
+        if (k == 0)
+            return SIZE;
+
+        size_type depth = 0;
+        while ((k >> depth) > 1)
+            depth++;
+
+        size_type full = ((2 * (k - (size_type(1) << depth)) + 1) << (HEIGHT - 1 - depth)) - 1;
+        return full > 2 * LAST_LEVEL ? full - (full - 2 * LAST_LEVEL + 1) / 2 : full;
+    }
+
+    sc::vector<Key> STORAGE; //!< Slots, plus room to align slot 0 on a cache line.
+    size_type SKIP;          //!< Offset of slot 0 inside `STORAGE`.
+    size_type SIZE;          //!< Number of keys.
+    size_type HEIGHT;        //!< Number of levels of the tree.
+    size_type LAST_LEVEL;    //!< Number of keys on the last level.
+    Compare COMP;            //!< The ordering of the keys.
+};
+} // namespace sc
+
+#endif
@@ -0,0 +1,384 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Implementation of a fixed-capacity vector in C++.
+ */
+#ifndef STATIC_VECTOR_H
+#define STATIC_VECTOR_H
+
+#include <cassert>          // assert
+#include <cstddef>          // std::size_t
+#include <algorithm>        // std::copy
+#include <initializer_list> // std::initializer_list
+#include <iterator>         // std::distance
+#include <stdexcept>        // std::out_of_range, std::length_error
+#include <string>           // std::to_string
+
+#include "./vector_config.h"
+#include "./MyIterator.h"
+
+namespace sc
+{
+/// What a static_vector does when an insertion would exceed its capacity.
+enum class overflow_policy
+{
+    throws,   //!< Throw std::length_error.
+    asserts,  //!< Fail an assert (nothing happens when NDEBUG is defined).
+    unchecked //!< Do not check at all; overflowing is undefined behavior.
+};
+
+/**
+ * @brief Fixed-capacity vector data structure
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * A vector whose elements live inside the object itself, in an array of `N` elements, so it never
+ * touches the heap. It offers the same interface as sc::vector and can be used in constant
+ * expressions from C++14 on. `Policy` selects what happens when more than `N` elements are stored.
+ */
+template <typename T, std::size_t N, overflow_policy Policy = overflow_policy::SC_STATIC_VECTOR_OVERFLOW>
+class static_vector
+{
+public:
+    using size_type = unsigned long;            //!< The size type.
+    using value_type = T;                       //!< The value type.
+    using pointer = value_type *;               //!< Pointer to a value stored in the container.
+    using reference = value_type &;             //!< Reference to a value stored in the container.
+    using const_reference = const value_type &; //!< Const reference to a value stored in the container.
+    using iterator = MyIterator<T>;             //!< Iterator that points to a specific element of type T.
+    using const_iterator = MyIterator<const T>; //!< Const iterator that points to a specific element of type T.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Default constructor that creates an empty list.
+    SC_CONSTEXPR14 static_vector() : SIZE(0), DATA{}
+    {
+    }
+
+    /// Constructs the list with the contents of the range [first, last).
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardIt>
+    SC_CONSTEXPR14 static_vector(ForwardIt first, ForwardIt last) : SIZE(0), DATA{}
+    {
+        assign(first, last);
+    }
+
+    /// Constructs the list with the contents of the initializer list init.
+    SC_CONSTEXPR14 static_vector(std::initializer_list<T> ilist) : SIZE(0), DATA{}
+    {
+        assign(ilist);
+    }
+
+    /// Replaces the contents with those identified by initializer list ilist.
+    SC_CONSTEXPR14 static_vector &operator=(std::initializer_list<T> ilist)
+    {
+        assign(ilist);
+        return *this;
+    }
+
+    //=== [II] ITERATORS
+    /// Returns an iterator pointing to the first item in the list.
+    SC_CONSTEXPR14 iterator begin()
+    {
+        return iterator(DATA);
+    }
+
+    /// Returns an iterator pointing to the end mark in the list, i.e. the position just after the last element of the list.
+    SC_CONSTEXPR14 iterator end()
+    {
+        return iterator(DATA + SIZE);
+    }
+
+    /// Returns a constant iterator pointing to the first item in the list.
+    SC_CONSTEXPR14 const_iterator begin() const
+    {
+        return cbegin();
+    }
+
+    /// Returns a constant iterator pointing to the end mark in the list.
+    SC_CONSTEXPR14 const_iterator end() const
+    {
+        return cend();
+    }
+
+    /// Returns a constant iterator pointing to the first item in the list.
+    SC_CONSTEXPR14 const_iterator cbegin() const
+    {
+        return const_iterator(DATA);
+    }
+
+    /// Returns a constant iterator pointing to the end mark in the list, i.e. the position just after the last element of the list.
+    SC_CONSTEXPR14 const_iterator cend() const
+    {
+        return const_iterator(DATA + SIZE);
+    }
+
+    //=== [III] Capacity
+    /// Return the number of elements in the container.
+    constexpr size_type size() const
+    {
+        return SIZE;
+    }
+
+    /// Return the fixed storage capacity, `N`.
+    constexpr size_type capacity() const
+    {
+        return N;
+    }
+
+    /// Returns true if the container contains no elements, and false otherwise.
+    constexpr bool empty() const
+    {
+        return SIZE == 0;
+    }
+
+    //=== [IV] Modifiers
+    /// Remove all elements from the container.
+    SC_CONSTEXPR14 void clear()
+    {
+        SIZE = 0;
+    }
+
+    /// Adds value to the front of the list.
+    SC_CONSTEXPR14 void push_front(const_reference value)
+    {
+        insert(begin(), value);
+    }
+
+    /// Adds value to the end of the list.
+    SC_CONSTEXPR14 void push_back(const_reference value)
+    {
+        check_room(1);
+        DATA[SIZE++] = value;
+    }
+
+    /// Removes the object at the end of the list.
+    SC_CONSTEXPR14 void pop_back()
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "pop_back() on an empty vector");
+        --SIZE;
+    }
+
+    /// Removes the object at the front of the list.
+    SC_CONSTEXPR14 void pop_front()
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "pop_front() on an empty vector");
+        erase(begin());
+    }
+
+    /// Checks that `new_cap` elements fit; the storage itself never changes.
+    SC_CONSTEXPR14 void reserve(size_type new_cap)
+    {
+        if (new_cap > SIZE)
+            check_room(new_cap - SIZE);
+    }
+
+    /// Does nothing, the storage is fixed.
+    SC_CONSTEXPR14 void shrink_to_fit()
+    {
+    }
+
+    /// Adds value into the list before the position given by the iterator
+    SC_CONSTEXPR14 iterator insert(iterator pos, const_reference value)
+    {
+        std::ptrdiff_t offset = pos - begin();
+
+        if (offset < 0 || size_type(offset) > SIZE)
+            return begin();
+
+        T copy(value); // `value` may be an element of this vector
+        iterator new_pos = open_gap(offset, 1);
+        *new_pos = copy;
+        return new_pos;
+    }
+
+    /// Inserts elements from the range [first; last) before pos
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardItr>
+    SC_CONSTEXPR14 iterator insert(iterator pos, ForwardItr first, ForwardItr last)
+    {
+        std::ptrdiff_t offset = pos - begin();
+
+        if (offset < 0 || size_type(offset) > SIZE)
+            return begin();
+
+        iterator new_pos = open_gap(offset, std::distance(first, last));
+        for (iterator it = new_pos; first != last; ++it, ++first)
+            *it = *first;
+        return new_pos;
+    }
+
+    /// Inserts elements from the initializer_list `ilist` before `pos`
+    SC_CONSTEXPR14 iterator insert(iterator pos, const std::initializer_list<value_type> &ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    /// Replaces the contents with `count` copies of `value`
+    SC_CONSTEXPR14 void assign(size_type count, const_reference value)
+    {
+        check_fits(count, 0);
+
+        SIZE = count;
+        for (size_type i = 0; i < SIZE; i++)
+            DATA[i] = value;
+    }
+
+    /// Replaces the contents of the list with copies of the elements in the `std::initializer_list`
+    SC_CONSTEXPR14 void assign(const std::initializer_list<T> &ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    /// Replaces the contents of the list with copies of the elements in the range [first; last)
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardItr>
+    SC_CONSTEXPR14 void assign(ForwardItr first, ForwardItr last)
+    {
+        check_fits(std::distance(first, last), 0);
+
+        SIZE = 0;
+        insert(begin(), first, last);
+    }
+
+    /// Removes elements in the range [first; last) and returns an iterator to the element that follows last before the call.
+    SC_CONSTEXPR14 iterator erase(iterator first, iterator last)
+    {
+        SC_VECTOR_REQUIRE(begin() <= first && first <= last && last <= end(), "erase() range outside the vector");
+        for (iterator dst = first, src = last; src != end(); ++dst, ++src)
+            *dst = *src;
+        SIZE -= last - first;
+
+        return first;
+    }
+
+    /// Removes the object at position pos and returns an iterator to the element that followed it.
+    SC_CONSTEXPR14 iterator erase(iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    //=== [V] Element access
+    ///  Returns the object at the beginning of the list.
+    SC_CONSTEXPR14 const_reference front() const
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "front() on an empty vector");
+        return DATA[0];
+    }
+
+    /// Returns the object at the beginning of the list.
+    SC_CONSTEXPR14 reference front()
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "front() on an empty vector");
+        return DATA[0];
+    }
+
+    ///  Returns the object at the end of the list.
+    SC_CONSTEXPR14 const_reference back() const
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "back() on an empty vector");
+        return DATA[SIZE - 1];
+    }
+
+    ///  Returns the object at the end of the list.
+    SC_CONSTEXPR14 reference back()
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "back() on an empty vector");
+        return DATA[SIZE - 1];
+    }
+
+    /// Returns a pointer to the underlying array; [data(), data() + size()) is always a valid range.
+    SC_CONSTEXPR14 pointer data()
+    {
+        return DATA;
+    }
+
+    /// Returns a pointer to the underlying array; [data(), data() + size()) is always a valid range.
+    SC_CONSTEXPR14 const value_type *data() const
+    {
+        return DATA;
+    }
+
+    /// Returns the object at the index pos in the array, with no bounds-checking.
+    SC_CONSTEXPR14 reference operator[](size_type pos)
+    {
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return DATA[pos];
+    }
+
+    /// Returns the object at the index pos in the array, with no bounds-checking.
+    SC_CONSTEXPR14 const_reference operator[](size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return DATA[pos];
+    }
+
+    /// Returns the object at the index pos in the array, with bounds-checking.
+    SC_CONSTEXPR14 const_reference at(size_type pos) const
+    {
+        if (pos >= SIZE)
+            throw std::out_of_range(std::to_string(pos));
+        return DATA[pos];
+    }
+
+    /// Returns the object at the index pos in the array, with bounds-checking.
+    SC_CONSTEXPR14 reference at(size_type pos)
+    {
+        if (pos >= SIZE)
+            throw std::out_of_range(std::to_string(pos));
+        return DATA[pos];
+    }
+
+    /// Check if contents of both vectors are equal
+    SC_CONSTEXPR14 bool operator==(const static_vector &other) const
+    {
+        if (SIZE != other.SIZE)
+            return false;
+
+        for (size_type i = 0; i < SIZE; i++)
+            if (DATA[i] != other.DATA[i])
+                return false;
+
+        return true;
+    }
+
+    /// Check if contents of both vectors are different
+    SC_CONSTEXPR14 bool operator!=(const static_vector &other) const
+    {
+        return not(*this == other);
+    }
+
+private:
+    /// Applies the overflow policy if `count` more elements do not fit.
+    SC_CONSTEXPR14 void check_room(size_type count) const
+    {
+        check_fits(count, SIZE);
+    }
+
+    /// Applies the overflow policy if `count` elements do not fit next to `used` ones.
+    static SC_CONSTEXPR14 void check_fits(size_type count, size_type used)
+    {
+        if (Policy == overflow_policy::throws && count > N - used)
+            throw std::length_error("sc::static_vector capacity exceeded");
+        if (Policy == overflow_policy::asserts)
+            assert(count <= N - used && "sc::static_vector capacity exceeded");
+        if (Policy == overflow_policy::unchecked)
+            SC_VECTOR_ASSUME(count <= N - used);
+    }
+
+    /// Makes room for `count` elements at `offset`, shifting the tail to the right. Returns the first free position.
+    SC_CONSTEXPR14 iterator open_gap(size_type offset, size_type count)
+    {
+        check_room(count);
+        for (size_type i = SIZE; i > offset; i--)
+            DATA[i - 1 + count] = DATA[i - 1];
+        SIZE += count;
+
+        return begin() + offset;
+    }
+
+    size_type SIZE;             //!< Logical size of vector, i.e. the amount of elements stored.
+    T DATA[N == 0 ? 1 : N];     //!< Array that actually stores the elements of the vector.
+};
+} // namespace sc
+
+#endif
@@ -14,15 +14,36 @@
 #include <iostream> // std::cerr, std::distance
 #include <exception>
 #include <algorithm>        // std::min
+#include <cstring>          // std::memcmp
 #include <initializer_list> // std::initializer_list
 #include <iterator>
 #include <stdexcept> //std::out_of_range
-#include <string>    //std::to_string
+#include <string>      //std::to_string
+#include <type_traits> // std::is_nothrow_move_assignable, std::integral_constant
+#include <utility>     // std::swap, std::move
 
+#include "./vector_config.h"
 #include "./MyIterator.h"
+#include "./vector_hash.h"
+#include "./vector_compare.h"
+#include "./vector_bulk.h"
+#include "./vector_gather.h"
+#include "./vector_memory.h"
+
+#ifdef SC_VECTOR_TRACE
+#include "./growth_trace.h"
+#endif
+
+#ifdef SC_VECTOR_POOL
+#include <new> // placement new
+#include "./vector_pool.h"
+#endif
 
 namespace sc
 {
+template <typename E>
+class vector_expression;
+
 /**
  * @brief Vector data structure
  * @author Eduardo Sarmento & Victor Vieira
@@ -43,449 +64,608 @@ public:
 
     //=== [I] SPECIAL MEMBERS
     /// Default constructor that creates an empty list.
-    vector()
+    SC_CONSTEXPR20 vector()
     {
+        // Allocate before setting the sizes: GCC 12 assumes operator new may overwrite them, and
+        // then warns about writes it cannot tell are bounded by the zero capacity.
+        DATA = allocate_storage(0);
         SIZE = 0;
         CAPACITY = 0;
-        data = new T[CAPACITY];
     }
 
     /// Constructs the list with count default-inserted instances of T
-    explicit vector(size_type count)
+    SC_CONSTEXPR20 explicit vector(size_type count)
     {
+        DATA = allocate_storage(count);
         SIZE = 0;
         CAPACITY = count;
-        data = new T[CAPACITY];
     }
 
     /// Constructs the list with the contents of the range [first, last).
-    template <typename InputIt>
-    vector(InputIt first, InputIt last)
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardIt>
+    SC_CONSTEXPR20 vector(ForwardIt first, ForwardIt last)
     {
-        SIZE = last - first;
+        SIZE = std::distance(first, last);
         CAPACITY = 2 * SIZE;
-        data = new T[CAPACITY];
-
-        for (auto i(0u); i < SIZE; i++)
-            data[i] = *first++;
+        DATA = allocate_filled(CAPACITY, [&](T *out) { copy_range(first, last, out); });
+        stale_fingerprint();
     }
 
     /// Copy constructor. Constructs the list with the deep copy of the contents of other.
-    vector(const vector &other)
+    SC_CONSTEXPR20 vector(const vector &other)
     {
         SIZE = other.size();
         CAPACITY = 2 * SIZE;
-        data = new T[CAPACITY];
+        DATA = allocate_filled(CAPACITY, [&other](T *out) { copy_elements(other.DATA, other.SIZE, out); });
+        AUTO_SHRINK = other.AUTO_SHRINK;
+        copy_fingerprint(other);
+    }
 
-        for (auto i(0u); i < SIZE; i++)
-            data[i] = other.data[i];
+    /// Move constructor. Takes over the storage of other, which is left empty.
+    SC_CONSTEXPR20 vector(vector &&other) noexcept
+        : SIZE(other.SIZE), CAPACITY(other.CAPACITY), DATA(other.DATA), AUTO_SHRINK(other.AUTO_SHRINK)
+    {
+        copy_fingerprint(other);
+        other.SIZE = 0;
+        other.CAPACITY = 0;
+        other.DATA = nullptr;
+        other.clear_fingerprint();
     }
 
     /// Constructs the list with the contents of the initializer list init.
-    vector(std::initializer_list<T> ilist)
+    SC_CONSTEXPR20 vector(std::initializer_list<T> ilist)
     {
         SIZE = ilist.size();
         CAPACITY = SIZE;
-        data = new T[SIZE];
+        DATA = allocate_filled(SIZE, [&ilist](T *out) { std::copy(ilist.begin(), ilist.end(), out); });
+        stale_fingerprint();
+    }
 
-        for (auto i(0u); i < SIZE; i++)
-            data[i] = *(ilist.begin() + i);
+    /// Constructs the list with the values of an elementwise expression (see vector_expr.h), computed in one pass.
+    template <typename E>
+    vector(const vector_expression<E> &expr) : vector()
+    {
+        expr.evaluate(resize_for_overwrite(expr.size()));
     }
 
     /// Destructs the list.
-    ~vector()
+    SC_CONSTEXPR20 ~vector()
     {
-        delete[] data;
+        release_storage(DATA, CAPACITY);
     }
 
     /// Copy assignment operator.
-    vector &operator=(const vector &other)
+    SC_CONSTEXPR20 vector &operator=(const vector &other)
     {
+        if (this == &other)
+            return *this;
+
+        T *newData = allocate_filled(other.capacity(), [&other](T *out) { copy_elements(other.DATA, other.SIZE, out); });
+
+        release_storage(DATA, CAPACITY);
+        DATA = newData;
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+        GENERATION++;
+#endif
         SIZE = other.size();
         CAPACITY = other.capacity();
-        data = new T[CAPACITY];
+        copy_fingerprint(other);
 
-        for (auto i(0u); i < SIZE; i++)
-            data[i] = other.data[i];
+        return *this;
+    }
+
+    /// Move assignment operator. Frees the current storage and takes over the storage of other, which is left empty.
+    SC_CONSTEXPR20 vector &operator=(vector &&other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        release_storage(DATA, CAPACITY);
+        DATA = other.DATA;
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+        GENERATION++;
+#endif
+        SIZE = other.SIZE;
+        CAPACITY = other.CAPACITY;
+        copy_fingerprint(other);
+
+        other.SIZE = 0;
+        other.CAPACITY = 0;
+        other.DATA = nullptr;
+        other.clear_fingerprint();
+        return *this;
+    }
 
+    /// Replaces the contents with the values of an elementwise expression (see vector_expr.h), computed in one
+    /// pass. The expression may read this vector: element i is read before it is overwritten.
+    template <typename E>
+    vector &operator=(const vector_expression<E> &expr)
+    {
+        size_type count = expr.size();
+        expr.evaluate(resize_for_overwrite(count));
         return *this;
     }
 
     /// Replaces the contents with those identified by initializer list ilist.
-    vector &operator=(std::initializer_list<T> ilist)
+    SC_CONSTEXPR20 vector &operator=(std::initializer_list<T> ilist)
     {
+        T *newData = allocate_filled(ilist.size(), [&ilist](T *out) { std::copy(ilist.begin(), ilist.end(), out); });
+
+        release_storage(DATA, CAPACITY);
+        DATA = newData;
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+        GENERATION++;
+#endif
         SIZE = ilist.size();
         CAPACITY = SIZE;
-        data = new T[CAPACITY];
-
-        for (auto i(0u); i < SIZE; i++)
-            data[i] = *(ilist.begin() + i);
+        stale_fingerprint();
 
         return *this;
     }
 
     //=== [II] ITERATORS
     /// Returns an iterator pointing to the first item in the list.
-    iterator begin()
+    SC_CONSTEXPR20 iterator begin()
     {
-        iterator it(&data[0]);
+        stale_fingerprint();
+        iterator it = make_iterator(DATA);
         return it;
     }
 
     /// Returns an iterator pointing to the end mark in the list, i.e. the position just after the last element of the list.
-    iterator end()
+    SC_CONSTEXPR20 iterator end()
     {
-        iterator it(&data[SIZE]);
+        stale_fingerprint();
+        iterator it = make_iterator(DATA + SIZE);
         return it;
     }
 
     /// Returns a constant iterator pointing to the first item in the list.
-    const_iterator cbegin() const
+    SC_CONSTEXPR20 const_iterator begin() const
     {
-        const_iterator it(&data[0]);
+        return cbegin();
+    }
+
+    /// Returns a constant iterator pointing to the end mark in the list.
+    SC_CONSTEXPR20 const_iterator end() const
+    {
+        return cend();
+    }
+
+    /// Returns a constant iterator pointing to the first item in the list.
+    SC_CONSTEXPR20 const_iterator cbegin() const
+    {
+        const_iterator it = make_iterator(DATA);
         return it;
     }
 
     /// Returns a constant iterator pointing to the end mark in the list, i.e. the position just after the last element of the list.
-    const_iterator cend(void) const
+    SC_CONSTEXPR20 const_iterator cend(void) const
     {
-        const_iterator it(&data[SIZE]);
+        const_iterator it = make_iterator(DATA + SIZE);
         return it;
     }
 
     //=== [III] Capacity
     /// Return the number of elements in the container.
-    size_type size() const
+    SC_CONSTEXPR20 size_type size() const
     {
         return SIZE;
     }
 
     /// Return the internal storage capacity of the array.
-    size_type capacity() const
+    SC_CONSTEXPR20 size_type capacity() const
     {
         return CAPACITY;
     }
 
     /// Returns true if the container contains no elements, and false otherwise.
-    bool empty()
+    SC_CONSTEXPR20 bool empty() const
     {
         return SIZE == 0;
     }
 
+    /// Returns the bytes this vector holds: the object itself, its whole buffer, and whatever the
+    /// elements in every slot of the buffer own in turn (nested vectors, long strings; see vector_memory.h).
+    size_type memory_usage() const
+    {
+        return sizeof(*this) + CAPACITY * sizeof(T) + detail::owned_bytes(DATA, CAPACITY, detail::owns_memory<T>());
+    }
+
+    /// Returns true if removals give back spare capacity by themselves (see set_auto_shrink).
+    SC_CONSTEXPR20 bool auto_shrink() const
+    {
+        return AUTO_SHRINK;
+    }
+
+    /// Turns auto-shrink on or off for this vector. While it is on, a removal (pop_back, pop_front,
+    /// erase, clear, resize) that leaves fewer than a quarter of the capacity in use reallocates to
+    /// twice the remaining size, so that growing again does not reallocate at once either; buffers of
+    /// up to SC_VECTOR_SHRINK_MIN_BYTES are left alone. Such a removal invalidates iterators, and a
+    /// shrink that fails keeps the current buffer. Copies and moves take the setting along;
+    /// assignments and swap leave each vector's own setting in place.
+    SC_CONSTEXPR20 void set_auto_shrink(bool on SC_VECTOR_TRACE_LOC)
+    {
+        AUTO_SHRINK = on;
+        shrink_if_sparse(SC_VECTOR_TRACE_FWD_ONLY);
+    }
+
     //=== [IV] Modifiers
     /// Remove all elements from the container.
-    void clear()
+    SC_CONSTEXPR20 void clear(SC_VECTOR_TRACE_LOC_ONLY)
     {
         SIZE = 0;
+        clear_fingerprint();
+        shrink_if_sparse(SC_VECTOR_TRACE_FWD_ONLY);
     }
 
     /// Adds value to the front of the list.
-    void push_front(const_reference value)
+    SC_CONSTEXPR20 void push_front(const_reference value SC_VECTOR_TRACE_LOC)
     {
-        reserve(SIZE + 1);
-
-        for (int i = SIZE; i > 0; i--)
-            data[i] = data[i - 1];
+        T copy(value); // `value` may be an element of this vector
+        reserve(SIZE + 1 SC_VECTOR_TRACE_FWD);
 
-        data[0] = value;
+        std::move_backward(DATA, DATA + SIZE, DATA + SIZE + 1);
+        DATA[0] = std::move(copy);
 
         ++SIZE;
+        stale_fingerprint();
     }
 
     /// Adds value to the end of the list.
-    void push_back(const_reference value)
+    SC_CONSTEXPR20 void push_back(const_reference value SC_VECTOR_TRACE_LOC)
     {
-        reserve(SIZE + 1);
-        data[SIZE] = value;
+        if (SIZE == CAPACITY)
+            grow_and_store(value SC_VECTOR_TRACE_FWD);
+        else
+            DATA[SIZE] = value;
+#ifdef SC_VECTOR_FINGERPRINT
+        FINGERPRINT += detail::fingerprint_term(SIZE, DATA[SIZE]);
+#endif
         ++SIZE;
     }
 
     /// Removes the object at the end of the list.
-    void pop_back()
+    SC_CONSTEXPR20 void pop_back(SC_VECTOR_TRACE_LOC_ONLY)
     {
+        SC_VECTOR_REQUIRE(SIZE > 0, "pop_back() on an empty vector");
         --SIZE;
+#ifdef SC_VECTOR_FINGERPRINT
+        FINGERPRINT -= detail::fingerprint_term(SIZE, DATA[SIZE]);
+#endif
+        shrink_if_sparse(SC_VECTOR_TRACE_FWD_ONLY);
     }
 
     /// Removes the object at the front of the list.
-    void pop_front()
+    SC_CONSTEXPR20 void pop_front(SC_VECTOR_TRACE_LOC_ONLY)
     {
-        for (auto i(0u); i < SIZE - 1; i++)
-            data[i] = data[i + 1];
+        SC_VECTOR_REQUIRE(SIZE > 0, "pop_front() on an empty vector");
+        std::move(DATA + 1, DATA + SIZE, DATA);
 
         --SIZE;
+        stale_fingerprint();
+        shrink_if_sparse(SC_VECTOR_TRACE_FWD_ONLY);
     }
 
     /// Increases the storage capacity of the array to a value that’s is greater or equal to new_cap.
-    void reserve(size_type new_cap)
+    SC_CONSTEXPR20 void reserve(size_type new_cap SC_VECTOR_TRACE_LOC)
     {
-        if (new_cap < capacity())
+        if (new_cap <= capacity())
             return;
 
-        CAPACITY = CAPACITY == 0 ? 2 : 2 * CAPACITY;
-        T *newData = new T[CAPACITY];
+        reallocate(std::max(new_cap, CAPACITY == 0 ? 2 : 2 * CAPACITY), SIZE SC_VECTOR_TRACE_FWD);
+    }
 
-        for (auto i(0u); i < SIZE; i++)
-            newData[i] = data[i];
+    /// Requests the removal of unused capacity; does nothing when there is none.
+    SC_CONSTEXPR20 void shrink_to_fit(SC_VECTOR_TRACE_LOC_ONLY)
+    {
+        if (SIZE == CAPACITY)
+            return;
+        reallocate(SIZE, SIZE SC_VECTOR_TRACE_FWD);
+    }
 
-        data = newData;
-        delete[] newData;
+    /// Exchanges the contents, sizes and capacities of both vectors in O(1), without copying elements.
+    /// Hardened builds treat it like a reallocation of both: earlier iterators are reported on use.
+    SC_CONSTEXPR20 void swap(vector &other) noexcept
+    {
+        std::swap(SIZE, other.SIZE);
+        std::swap(CAPACITY, other.CAPACITY);
+        std::swap(DATA, other.DATA);
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+        GENERATION++;
+        other.GENERATION++;
+#endif
+#ifdef SC_VECTOR_FINGERPRINT
+        std::swap(FINGERPRINT, other.FINGERPRINT);
+        std::swap(FINGERPRINT_STALE, other.FINGERPRINT_STALE);
+#endif
     }
 
-    /// Requests the removal of unused capacity.
-    void shrink_to_fit()
+    /// Resizes the list to `count` elements; the new ones are value-initialized.
+    SC_CONSTEXPR20 void resize(size_type count SC_VECTOR_TRACE_LOC)
     {
-        CAPACITY = SIZE;
-        T *newData = new T[CAPACITY];
+        resize(count, T() SC_VECTOR_TRACE_FWD);
+    }
 
-        for (auto i(0u); i < SIZE; i++)
-            newData[i] = data[i];
+    /// Resizes the list to `count` elements; the new ones are copies of `value`.
+    /// Removed elements are reset to T(), so whatever they own is released now rather than when the storage goes.
+    SC_CONSTEXPR20 void resize(size_type count, const_reference value SC_VECTOR_TRACE_LOC)
+    {
+        if (count > SIZE)
+        {
+            T copy(value); // `value` may be an element of this vector
+            reserve(count SC_VECTOR_TRACE_FWD);
+            fill_elements(DATA + SIZE, count - SIZE, copy);
+            SIZE = count;
+        }
+        else if (count < SIZE)
+            truncate(count SC_VECTOR_TRACE_FWD);
+        stale_fingerprint();
+    }
+
+    /// Resizes the list to `count` elements without writing the new ones, and returns data().
+    /// The new elements hold unspecified values (indeterminate ones for trivial types) until the
+    /// caller overwrites them, e.g. with read() or memcpy into data(); existing elements are kept.
+    SC_CONSTEXPR20 pointer resize_for_overwrite(size_type count SC_VECTOR_TRACE_LOC)
+    {
+        if (count > CAPACITY)
+            reallocate(count, std::min(SIZE, count) SC_VECTOR_TRACE_FWD);
+        SIZE = count;
+        stale_fingerprint();
+        return DATA;
+    }
 
-        data = newData;
-        delete[] newData;
+    /// Grows the list by `count` elements without writing them, and returns a pointer to the first new one.
+    /// The new elements hold unspecified values until the caller overwrites them. Growth is geometric, as with push_back.
+    SC_CONSTEXPR20 pointer append_uninitialized(size_type count SC_VECTOR_TRACE_LOC)
+    {
+        reserve(SIZE + count SC_VECTOR_TRACE_FWD);
+        SIZE += count;
+        stale_fingerprint();
+        return DATA + SIZE - count;
     }
 
     /// Adds value into the list before the position given by the iterator
-    iterator insert(iterator pos, const_reference value)
+    SC_CONSTEXPR20 iterator insert(iterator pos, const_reference value SC_VECTOR_TRACE_LOC)
     {
         std::ptrdiff_t offset = pos - begin();
 
-        if (offset > SIZE)
+        if (offset < 0 || size_type(offset) > SIZE)
             return begin();
 
-        reserve(SIZE + 1);
-        SIZE++;
-
-        iterator new_pos = begin() + offset;
-        iterator end(&data[SIZE - 1]);
-
-        while (end != new_pos)
-        {
-            *end = *(end - 1);
-            end--;
-        }
-
-        *end = value;
-        return new_pos;
+        T copy(value); // `value` may be an element of this vector
+        return insert_filled(offset, 1, std::is_nothrow_move_assignable<T>(),
+                             [&copy](T *out) { *out = std::move(copy); } SC_VECTOR_TRACE_FWD);
     }
 
     /// Inserts elements from the range [first; last) before pos
-    template <typename InputItr>
-    iterator insert(iterator pos, InputItr first, InputItr last)
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardItr>
+    SC_CONSTEXPR20 iterator insert(iterator pos, ForwardItr first, ForwardItr last SC_VECTOR_TRACE_LOC)
     {
-
         std::ptrdiff_t offset = pos - begin();
 
-        if (offset > SIZE)
+        if (offset < 0 || size_type(offset) > SIZE)
             return begin();
 
-        int dist = std::distance(first, last);
-
-        reserve(SIZE + dist);
-        SIZE += dist;
-
-        iterator new_pos = begin() + offset;
-        iterator old_end = end() - (dist + 1);
-        iterator end(&data[SIZE - 1]);
-
-        while (old_end != (new_pos - 1))
-        {
-            *end = *old_end;
-            old_end--;
-            end--;
-        }
-
-        last--;
-        while (last != (first - 1))
-        {
-            *end = *last;
-            last--;
-            end--;
-        }
-
-        return new_pos;
+        return insert_filled(offset, std::distance(first, last), std::is_nothrow_copy_assignable<T>(),
+                             [&](T *out) { copy_range(first, last, out); } SC_VECTOR_TRACE_FWD);
     }
 
     /// Inserts elements from the initializer_list `ilist` before `pos`
-    iterator insert(iterator pos, const std::initializer_list<value_type> &ilist)
+    SC_CONSTEXPR20 iterator insert(iterator pos, const std::initializer_list<value_type> &ilist SC_VECTOR_TRACE_LOC)
     {
         std::ptrdiff_t offset = pos - begin();
 
-        if (offset > SIZE)
+        if (offset < 0 || size_type(offset) > SIZE)
             return begin();
 
-        int size = ilist.size();
-
-        reserve(SIZE + size);
-        SIZE += size;
-
-        iterator new_pos = begin() + offset;
-        iterator old_end = end() - (size + 1);
-        iterator end(&data[SIZE - 1]);
-        while (old_end != (new_pos - 1))
-        {
-            *end = *old_end;
-            old_end--;
-            end--;
-        }
-
-        auto first = ilist.begin();
-        auto last = ilist.end() - 1;
-        while (last != (first - 1))
-        {
-            *end = *last;
-            last--;
-            end--;
-        }
-        return new_pos;
+        return insert_filled(offset, ilist.size(), std::is_nothrow_copy_assignable<T>(),
+                             [&ilist](T *out) { std::copy(ilist.begin(), ilist.end(), out); } SC_VECTOR_TRACE_FWD);
     }
 
     /// Replaces the contents with `count` copies of `value`
-    void assign(size_type count, const_reference value)
+    SC_CONSTEXPR20 void assign(size_type count, const_reference value SC_VECTOR_TRACE_LOC)
     {
-        SIZE = count;
         if (count > capacity())
-            CAPACITY = count;
-
-        T *newData = new T[CAPACITY];
-
-        for (auto i(0u); i < SIZE; i++)
-            newData[i] = value;
+            replace_storage(count, 0, [&](T *out) { fill_elements(out, count, value); } SC_VECTOR_TRACE_FWD);
+        else
+            fill_elements(DATA, count, value);
 
-        data = newData;
-        delete[] newData;
+        SIZE = count;
+        stale_fingerprint();
     }
 
     /// Replaces the contents of the list with copies of the elements in the `std::initializer_list`
-    void assign(const std::initializer_list<T> &ilist)
+    SC_CONSTEXPR20 void assign(const std::initializer_list<T> &ilist SC_VECTOR_TRACE_LOC)
     {
-        int size = ilist.size();
-        SIZE = size;
+        size_type size = ilist.size();
         if (size > capacity())
-            CAPACITY = size;
-
-        T *newData = new T[CAPACITY];
-
-        for (auto i(0u); i < SIZE; i++)
-            data[i] = *(ilist.begin() + i);
+            replace_storage(size, 0, [&ilist](T *out) { std::copy(ilist.begin(), ilist.end(), out); } SC_VECTOR_TRACE_FWD);
+        else
+            std::copy(ilist.begin(), ilist.end(), DATA);
 
-        data = newData;
-        delete[] newData;
+        SIZE = size;
+        stale_fingerprint();
     }
 
     /// Replaces the contents of the list with copies of the elements in the range [first; last)
-    template <typename InputItr>
-    void assign(InputItr first, InputItr last)
+    template <SC_VECTOR_FORWARD_ITERATOR ForwardItr>
+    SC_CONSTEXPR20 void assign(ForwardItr first, ForwardItr last SC_VECTOR_TRACE_LOC)
     {
-        int size = last - first;
-        SIZE = size;
+        size_type size = std::distance(first, last);
         if (size > capacity())
-            CAPACITY = size;
-
-        T *newData = new T[CAPACITY];
-
-        iterator it = &newData[0];
-        while (first != last)
-        {
-            *it = *first;
-            it++;
-            first++;
-        }
+            replace_storage(size, 0, [&](T *out) { copy_range(first, last, out); } SC_VECTOR_TRACE_FWD);
+        else
+            copy_range(first, last, DATA);
 
-        data = newData;
-        delete[] newData;
+        SIZE = size;
+        stale_fingerprint();
     }
 
     /// Removes elements in the range [first; last) and returns an iterator to the element that follows last before the call.
-    iterator erase(iterator first, iterator last)
+    SC_CONSTEXPR20 iterator erase(iterator first, iterator last SC_VECTOR_TRACE_LOC)
     {
-        iterator past_last = first;
-        iterator actual_last = last;
-        while (first != actual_last)
-        {
-            *first = *last;
-            SIZE--;
-            first++;
-            last++;
-        }
+        SC_VECTOR_REQUIRE(begin() <= first && first <= last && last <= end(), "erase() range outside the vector");
+        if (first == last)
+            return first; // moving the tail onto itself would leave moved-from elements
+        std::move(last, end(), first);
+        SIZE -= last - first;
+
+        if (!AUTO_SHRINK)
+            return first;
+        std::ptrdiff_t offset = first - begin();
+        shrink_if_sparse(SC_VECTOR_TRACE_FWD_ONLY);
+        return begin() + offset;
+    }
 
-        return past_last;
+    /// Removes the object at position pos and returns an iterator to the element that followed it.
+    SC_CONSTEXPR20 iterator erase(iterator pos SC_VECTOR_TRACE_LOC)
+    {
+        SC_VECTOR_REQUIRE(begin() <= pos && pos < end(), "erase() position outside the vector");
+        return erase(pos, pos + 1 SC_VECTOR_TRACE_FWD);
     }
 
-    /// Removes the object at position pos and
-    iterator erase(iterator pos)
+    /// Sets `out[i]` to the element at `indices[i]` for every index. `indices` and `out` are contiguous
+    /// containers or views (anything with data() and size()), and `out` holds at least as many elements
+    /// as there are indices. `threads` as in indexed::gather (1: calling thread, 0: every hardware thread).
+    template <typename Indices, typename Out>
+    void gather(const Indices &indices, Out &&out, unsigned threads = 1) const
     {
-        iterator past_last = pos;
-        while (pos != end())
-        {
-            *pos = *(pos + 1);
-            pos++;
-        }
+        SC_VECTOR_REQUIRE(out.size() >= indices.size(), "gather() output smaller than the indices");
+        indexed::gather(DATA, SIZE, indices.data(), indices.size(), out.data(), threads);
+    }
 
-        SIZE--;
+    /// Sets the element at `indices[i]` to `values[i]` for every index; a repeated index keeps its last
+    /// value. With `threads` other than 1 the indices must be distinct.
+    template <typename Indices, typename Values>
+    void scatter(const Indices &indices, const Values &values, unsigned threads = 1)
+    {
+        SC_VECTOR_REQUIRE(values.size() >= indices.size(), "scatter() given fewer values than indices");
+        indexed::scatter(indices.data(), indices.size(), values.data(), DATA, SIZE, threads);
+        stale_fingerprint();
+    }
 
-        return past_last;
+    /// Reorders the elements in place so that position i receives the element that was at `order[i]`;
+    /// `order` is a permutation of [0, size()). Moves every element once and allocates size() / 8 bytes.
+    template <typename Indices>
+    void permute(const Indices &order)
+    {
+        SC_VECTOR_REQUIRE(order.size() == SIZE, "permute() order does not cover the vector");
+        indexed::permute(DATA, SIZE, order.data());
+        stale_fingerprint();
+    }
+
+    /// Returns a new vector whose element i is the element at `order[i]`; the indices may repeat or
+    /// leave elements out. The out-of-place counterpart of permute(), built with gather().
+    template <typename Indices>
+    vector permuted(const Indices &order, unsigned threads = 1) const
+    {
+        vector result;
+        indexed::gather(DATA, SIZE, order.data(), order.size(), result.resize_for_overwrite(order.size()), threads);
+        return result;
     }
 
     //=== [V] Element access
     ///  Returns the object at the beginning of the list.
-    const_reference front() const
+    SC_CONSTEXPR20 const_reference front() const
     {
-        return data[0];
+        SC_VECTOR_REQUIRE(SIZE > 0, "front() on an empty vector");
+        return DATA[0];
     }
 
     /// Returns the object at the beginning of the list.
-    reference front()
+    SC_CONSTEXPR20 reference front()
     {
-        return data[0];
+        stale_fingerprint();
+        SC_VECTOR_REQUIRE(SIZE > 0, "front() on an empty vector");
+        return DATA[0];
     }
 
     ///  Returns the object at the end of the list.
-    const_reference back() const
+    SC_CONSTEXPR20 const_reference back() const
     {
-        return data[SIZE - 1];
+        SC_VECTOR_REQUIRE(SIZE > 0, "back() on an empty vector");
+        return DATA[SIZE - 1];
     }
 
     ///  Returns the object at the end of the list.
-    reference back()
+    SC_CONSTEXPR20 reference back()
+    {
+        stale_fingerprint();
+        SC_VECTOR_REQUIRE(SIZE > 0, "back() on an empty vector");
+        return DATA[SIZE - 1];
+    }
+
+    /// Returns a pointer to the underlying array; [data(), data() + size()) is always a valid range.
+    SC_CONSTEXPR20 pointer data()
+    {
+        stale_fingerprint();
+        return DATA;
+    }
+
+    /// Returns a pointer to the underlying array; [data(), data() + size()) is always a valid range.
+    SC_CONSTEXPR20 const value_type *data() const
     {
-        return data[SIZE - 1];
+        return DATA;
     }
 
     /// Returns the object at the index pos in the array, with no bounds-checking.
-    reference operator[](size_type pos)
+    SC_CONSTEXPR20 reference operator[](size_type pos)
     {
-        return data[pos];
+        stale_fingerprint();
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return DATA[pos];
     }
 
     /// Returns the object at the index pos in the array, with no bounds-checking.
-    const_reference operator[](size_type pos) const
+    SC_CONSTEXPR20 const_reference operator[](size_type pos) const
     {
-        return data[pos];
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return DATA[pos];
     }
 
     /// Returns the object at the index pos in the array, with bounds-checking.
-    const_reference at(size_type pos) const
+    SC_CONSTEXPR20 const_reference at(size_type pos) const
     {
-        if (pos < 0 || pos >= SIZE)
+        if (pos >= SIZE)
             throw std::out_of_range(std::to_string(pos));
-        return data[pos];
+        return DATA[pos];
     }
 
     /// Returns the object at the index pos in the array, with bounds-checking.
-    reference at(size_type pos)
+    SC_CONSTEXPR20 reference at(size_type pos)
     {
-        if (pos < 0 || pos >= SIZE)
+        stale_fingerprint();
+        if (pos >= SIZE)
             throw std::out_of_range(std::to_string(pos));
-        return data[pos];
+        return DATA[pos];
     }
 
+#ifdef SC_VECTOR_FINGERPRINT
+    /// Returns a 64-bit digest of the contents, cached between calls.
+    /// push_back, pop_back and clear keep it current; any other writable access has it recomputed on the next call.
+    /// A write through a pointer, reference or iterator taken before the previous call is not seen, and the digest
+    /// keeps describing the old contents; only without such writes do equal vectors have equal fingerprints.
+    SC_CONSTEXPR20 std::uint64_t fingerprint() const
+    {
+        if (FINGERPRINT_STALE)
+        {
+            FINGERPRINT = 0;
+            for (auto i(0u); i < SIZE; i++)
+                FINGERPRINT += detail::fingerprint_term(i, DATA[i]);
+            FINGERPRINT_STALE = false;
+        }
+        return FINGERPRINT;
+    }
+
+#endif
     /// Check if contents of both vectors are equal
-    bool operator==(const vector &other) const
+    SC_CONSTEXPR20 bool operator==(const vector &other) const
     {
         if (size() == other.size())
         {
             for (auto i(0u); i < SIZE; i++)
-                if (data[i] != other.data[i])
+                if (DATA[i] != other.DATA[i])
                     return false;
         }
         else
@@ -497,7 +677,7 @@ public:
     }
 
     /// Check if contents of both vectors are different
-    bool operator!=(const vector &other) const
+    SC_CONSTEXPR20 bool operator!=(const vector &other) const
     {
         if (size() != other.size())
         {
@@ -506,18 +686,398 @@ public:
         else
         {
             for (auto i(0u); i < SIZE; i++)
-                if (data[i] != other.data[i])
+                if (DATA[i] != other.DATA[i])
                     return true;
         }
 
         return false;
     }
 
+#ifdef SC_VECTOR_HAS_THREE_WAY
+    /// Compares the contents lexicographically; a vector that is a prefix of the other orders first.
+    /// A template so that vectors of elements without an ordering remain usable.
+    template <typename U = T>
+    SC_CONSTEXPR20 detail::synth_three_way_result<U> operator<=>(const vector &other) const
+    {
+        size_type n = std::min(SIZE, other.SIZE);
+        if (not SC_VECTOR_IS_CONSTANT_EVALUATED() && detail::compare_kind_of<T>() == detail::compare_kind::bytes)
+        {
+            int order = n == 0 ? 0 : std::memcmp(DATA, other.DATA, n * sizeof(T));
+            if (order != 0)
+                return order <=> 0;
+        }
+        else
+        {
+            for (size_type i = 0; i < n; i++)
+            {
+                if (not SC_VECTOR_IS_CONSTANT_EVALUATED())
+                    i = detail::first_mismatch(DATA, other.DATA, i, n);
+                if (i == n)
+                    break;
+                detail::synth_three_way_result<U> order = detail::synth_three_way(DATA[i], other.DATA[i]);
+                if (order != 0)
+                    return order;
+            }
+        }
+        return SIZE <=> other.SIZE;
+    }
+#else
+    /// Check if the contents of this vector order lexicographically before those of other
+    bool operator<(const vector &other) const
+    {
+        return compare(other) < 0;
+    }
+
+    /// Check if the contents of this vector order lexicographically after those of other
+    bool operator>(const vector &other) const
+    {
+        return compare(other) > 0;
+    }
+
+    /// Check if the contents of this vector do not order lexicographically after those of other
+    bool operator<=(const vector &other) const
+    {
+        return compare(other) <= 0;
+    }
+
+    /// Check if the contents of this vector do not order lexicographically before those of other
+    bool operator>=(const vector &other) const
+    {
+        return compare(other) >= 0;
+    }
+#endif
+
 private:
+#ifndef SC_VECTOR_HAS_THREE_WAY
+    /// Lexicographic comparison with operator<: negative, zero or positive as this vector orders before, with or after other.
+    int compare(const vector &other) const
+    {
+        size_type n = std::min(SIZE, other.SIZE);
+        if (detail::compare_kind_of<T>() == detail::compare_kind::bytes)
+        {
+            int order = n == 0 ? 0 : std::memcmp(DATA, other.DATA, n * sizeof(T));
+            if (order != 0)
+                return order;
+        }
+        else
+        {
+            for (size_type i = detail::first_mismatch(DATA, other.DATA, 0, n); i < n;
+                 i = detail::first_mismatch(DATA, other.DATA, i + 1, n))
+            {
+                if (DATA[i] < other.DATA[i])
+                    return -1;
+                if (other.DATA[i] < DATA[i])
+                    return 1;
+            }
+        }
+        return SIZE < other.SIZE ? -1 : SIZE > other.SIZE ? 1 : 0;
+    }
+
+#endif
+    /// Marks the fingerprint for recomputation; called by every member that changes or hands out writable access to the elements.
+    SC_CONSTEXPR20 void stale_fingerprint()
+    {
+#ifdef SC_VECTOR_FINGERPRINT
+        FINGERPRINT_STALE = true;
+#endif
+    }
+
+    /// Resets the fingerprint to that of an empty vector.
+    SC_CONSTEXPR20 void clear_fingerprint()
+    {
+#ifdef SC_VECTOR_FINGERPRINT
+        FINGERPRINT = 0;
+        FINGERPRINT_STALE = false;
+#endif
+    }
+
+    /// Takes the fingerprint of `other`, whose contents were just copied or moved here.
+    SC_CONSTEXPR20 void copy_fingerprint(const vector &other)
+    {
+#ifdef SC_VECTOR_FINGERPRINT
+        FINGERPRINT = other.FINGERPRINT;
+        FINGERPRINT_STALE = other.FINGERPRINT_STALE;
+#else
+        (void)other;
+#endif
+    }
+
+    /// Returns an array of `count` default-initialized elements; with SC_VECTOR_POOL its buffer comes from the pool.
+    static SC_CONSTEXPR20 T *allocate_storage(size_type count)
+    {
+#ifdef SC_VECTOR_POOL
+        if (pool::is_poolable<T>::value && !SC_VECTOR_IS_CONSTANT_EVALUATED())
+        {
+            if (count == 0)
+                return nullptr;
+            T *storage = static_cast<T *>(pool::allocate(count * sizeof(T)));
+            size_type built = 0;
+            try
+            {
+                for (; built < count; built++)
+                    ::new (static_cast<void *>(storage + built)) T;
+            }
+            catch (...)
+            {
+                destroy_storage(storage, built);
+                throw;
+            }
+            return storage;
+        }
+#endif
+        return new T[count];
+    }
+
+    /// Destroys the `count` elements of an array from allocate_storage() and frees it.
+    static SC_CONSTEXPR20 void release_storage(T *storage, size_type count)
+    {
+#ifdef SC_VECTOR_POOL
+        if (pool::is_poolable<T>::value && !SC_VECTOR_IS_CONSTANT_EVALUATED())
+            return destroy_storage(storage, count);
+#else
+        (void)count;
+#endif
+        delete[] storage;
+    }
+
+#ifdef SC_VECTOR_POOL
+    /// Destroys the first `count` elements of a pooled array and returns its buffer to the pool.
+    static void destroy_storage(T *storage, size_type count)
+    {
+        for (size_type i = count; i-- > 0;)
+            storage[i].~T();
+        pool::deallocate(storage);
+    }
+#endif
+
+    /// Shrinking half of resize(): resets the elements from `count` on to T() and drops them. Kept out
+    /// of line, where the growing half cannot make GCC 12 report the loop with -Warray-bounds.
+    SC_VECTOR_NOINLINE SC_CONSTEXPR20 void truncate(size_type count SC_VECTOR_TRACE_ARG)
+    {
+        for (auto i(count); i < SIZE; i++)
+            DATA[i] = T();
+        SIZE = count;
+        shrink_if_sparse(SC_VECTOR_TRACE_FWD_ONLY);
+    }
+
+    /// With auto-shrink on, gives the spare capacity back once fewer than a quarter of the slots are in use.
+    SC_CONSTEXPR20 void shrink_if_sparse(SC_VECTOR_TRACE_ARG_ONLY)
+    {
+        if (AUTO_SHRINK && SIZE < CAPACITY / 4)
+            shrink_sparse(SC_VECTOR_TRACE_FWD_ONLY);
+    }
+
+    /// Slow path of shrink_if_sparse(): reallocates to twice the size, but not to fewer than
+    /// SC_VECTOR_SHRINK_MIN_BYTES. Shrinking is only an economy, so a failure keeps the current buffer.
+    SC_CONSTEXPR20 void shrink_sparse(SC_VECTOR_TRACE_ARG_ONLY)
+    {
+        size_type new_cap = std::max<size_type>(2 * SIZE, SC_VECTOR_SHRINK_MIN_BYTES / sizeof(T));
+        if (new_cap >= CAPACITY)
+            return;
+        try
+        {
+            reallocate(new_cap, SIZE SC_VECTOR_TRACE_FWD);
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /// Slow path of push_back(): grows the storage and stores `value` at DATA[SIZE]. `value` may be an
+    /// element of this vector, so it is copied before the reallocation frees it.
+    SC_CONSTEXPR20 void grow_and_store(const_reference value SC_VECTOR_TRACE_ARG)
+    {
+        T copy(value);
+        reserve(SIZE + 1 SC_VECTOR_TRACE_FWD);
+        DATA[SIZE] = std::move(copy);
+    }
+
+    /// Copies `count` elements to `out`, which must not overlap them. Large ranges of trivially copyable
+    /// elements are written with streaming stores (see vector_bulk.h).
+    static SC_CONSTEXPR20 void copy_elements(const T *from, size_type count, T *out)
+    {
+        if (SC_VECTOR_IS_CONSTANT_EVALUATED())
+            std::copy(from, from + count, out);
+        else
+            bulk::copy(from, count, out);
+    }
+
+    /// Sets `count` elements at `out` to `value`, with streaming stores for large trivially copyable ranges.
+    static SC_CONSTEXPR20 void fill_elements(T *out, size_type count, const T &value)
+    {
+        if (SC_VECTOR_IS_CONSTANT_EVALUATED())
+            std::fill(out, out + count, value);
+        else
+            bulk::fill(out, count, value);
+    }
+
+    /// Returns an array from allocate_storage() whose elements are then set by `fill(array)`. If `fill`
+    /// throws, the array is released before the exception propagates.
+    template <typename Fill>
+    static SC_CONSTEXPR20 T *allocate_filled(size_type count, Fill fill)
+    {
+        T *storage = allocate_storage(count);
+        try
+        {
+            fill(storage);
+        }
+        catch (...)
+        {
+            release_storage(storage, count);
+            throw;
+        }
+        return storage;
+    }
+
+    /// True when growth moves the elements to the new array: their move assignment cannot throw, or
+    /// they cannot be copied anyway. Otherwise they are copied, so that a throwing copy leaves the
+    /// original array intact (the strong guarantee, as with std::move_if_noexcept).
+    using move_on_growth = std::integral_constant<bool, std::is_nothrow_move_assignable<T>::value ||
+                                                            !std::is_copy_assignable<T>::value>;
+
+    /// Transfers [first, last) to `out`, moving the elements.
+    static SC_CONSTEXPR20 void relocate(T *first, T *last, T *out, std::true_type)
+    {
+        if (std::is_trivially_copyable<T>::value)
+            copy_elements(first, last - first, out);
+        else
+            std::move(first, last, out);
+    }
+
+    /// Transfers [first, last) to `out`, copying the elements.
+    static SC_CONSTEXPR20 void relocate(T *first, T *last, T *out, std::false_type)
+    {
+        std::copy(first, last, out);
+    }
+
+    /// Moves the storage to a new array of `new_cap` elements, keeping the first `keep` ones. Has no effect if it throws.
+    SC_CONSTEXPR20 void reallocate(size_type new_cap, size_type keep SC_VECTOR_TRACE_ARG)
+    {
+        replace_storage(new_cap, keep, [&](T *out) { relocate(DATA, DATA + keep, out, move_on_growth()); }
+                        SC_VECTOR_TRACE_FWD);
+    }
+
+    /// Switches to a new array of `new_cap` elements filled by `fill(array)`, which carries over `keep`
+    /// elements (reported to the growth trace), then frees the current one. Has no effect if
+    /// allocation or `fill` throws.
+    template <typename Fill>
+    SC_CONSTEXPR20 void replace_storage(size_type new_cap, size_type keep, Fill fill SC_VECTOR_TRACE_ARG)
+    {
+#ifdef SC_VECTOR_TRACE
+        std::uint64_t trace_start = SC_VECTOR_IS_CONSTANT_EVALUATED() ? 0 : trace::now();
+#else
+        (void)keep;
+#endif
+        T *newData = allocate_filled(new_cap, fill);
+
+        release_storage(DATA, CAPACITY);
+        DATA = newData;
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+        GENERATION++;
+#endif
+#ifdef SC_VECTOR_TRACE
+        if (!SC_VECTOR_IS_CONSTANT_EVALUATED())
+            trace::record_growth(trace_start, CAPACITY, new_cap, keep, sizeof(T), loc);
+#endif
+        CAPACITY = new_cap;
+    }
+
+    /// Wraps a pointer into the buffer in an iterator; hardened builds tag it with the buffer generation.
+    SC_CONSTEXPR20 iterator make_iterator(pointer p)
+    {
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+        return iterator(p, &GENERATION);
+#else
+        return iterator(p);
+#endif
+    }
+
+    /// Wraps a pointer into the buffer in a constant iterator; hardened builds tag it with the buffer generation.
+    SC_CONSTEXPR20 const_iterator make_iterator(const T *p) const
+    {
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+        return const_iterator(p, &GENERATION);
+#else
+        return const_iterator(p);
+#endif
+    }
+
+    /// Copies [first, last) to `dest`. Contiguous sources are copied through raw pointers, which turns trivially copyable elements into a memmove.
+    template <typename ForwardItr>
+    static SC_CONSTEXPR20 void copy_range(ForwardItr first, ForwardItr last, T *dest)
+    {
+#ifdef SC_VECTOR_HAS_CONCEPTS
+        if constexpr (std::contiguous_iterator<ForwardItr>)
+        {
+            if (first != last)
+                std::copy(std::to_address(first), std::to_address(first) + (last - first), dest);
+            return;
+        }
+#endif
+        std::copy(first, last, dest);
+    }
+
+    /// Inserts `count` elements at `offset`, set by `fill(first)`, and returns an iterator to the first one.
+    /// When the storage grows, the new elements are filled in first and the old ones then go straight to
+    /// their final places in the new array, so a throwing `fill` leaves the vector as it was. In place,
+    /// a `fill` that may throw (`FillNothrow` false) writes to a staging array before the tail is shifted;
+    /// there the vector is unchanged on a throw as long as T's move assignment cannot throw.
+    template <bool FillNothrow, typename Fill>
+    SC_CONSTEXPR20 iterator insert_filled(size_type offset, size_type count, std::integral_constant<bool, FillNothrow>,
+                                          Fill fill SC_VECTOR_TRACE_ARG)
+    {
+        if (SIZE + count > CAPACITY)
+        {
+            replace_storage(std::max(SIZE + count, CAPACITY == 0 ? 2 : 2 * CAPACITY), SIZE, [&](T *out) {
+                fill(out + offset);
+                relocate(DATA, DATA + offset, out, move_on_growth());
+                relocate(DATA + offset, DATA + SIZE, out + offset + count, move_on_growth());
+            } SC_VECTOR_TRACE_FWD);
+        }
+        else if (count > 0 && FillNothrow)
+        {
+            std::move_backward(DATA + offset, DATA + SIZE, DATA + SIZE + count);
+            fill(DATA + offset);
+        }
+        else if (count > 0)
+        {
+            T *staged = allocate_filled(count, fill);
+            try
+            {
+                std::move_backward(DATA + offset, DATA + SIZE, DATA + SIZE + count);
+                std::move(staged, staged + count, DATA + offset);
+            }
+            catch (...)
+            {
+                release_storage(staged, count);
+                throw;
+            }
+            release_storage(staged, count);
+        }
+        SIZE += count;
+
+        return begin() + offset;
+    }
+
     size_type SIZE;     //!< Logical size of vector, i.e. the amount of elements stored.
     size_type CAPACITY; //!< Available amount of elements that can be stored with current allocation.
-    T *data;            //!< Array that actually stores the elements of the vector.
+    T *DATA;            //!< Array that actually stores the elements of the vector.
+    bool AUTO_SHRINK = false; //!< Whether removals give back spare capacity (see set_auto_shrink).
+#ifdef SC_VECTOR_CHECKED_ITERATORS
+    std::size_t GENERATION = 0; //!< Number of times `DATA` was replaced; iterators remember the value they saw.
+#endif
+#ifdef SC_VECTOR_FINGERPRINT
+    mutable std::uint64_t FINGERPRINT = 0;  //!< Sum of detail::fingerprint_term over the elements, when not stale.
+    mutable bool FINGERPRINT_STALE = false; //!< Set when the elements may have changed behind the fingerprint's back.
+#endif
 };
+
+/// Exchanges the contents of `a` and `b` in O(1); found by argument-dependent lookup.
+template <typename T>
+SC_CONSTEXPR20 void swap(vector<T> &a, vector<T> &b) noexcept
+{
+    a.swap(b);
+}
 } // namespace sc
 
 #endif
\ No newline at end of file
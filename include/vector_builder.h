@@ -0,0 +1,212 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Builds an sc::vector from a stream of elements produced on another thread.
+ *
+ * Appending to an sc::vector one element at a time stalls the appending thread every time the
+ * vector grows, while the elements already stored are copied over. vector_builder keeps the
+ * producer away from that: it fills fixed-size chunks that never move and hands each full chunk
+ * to the consumer through a bounded single-producer/single-consumer queue. The consumer collects
+ * the chunks and, once the producer is done, allocates the final vector once, at its exact size,
+ * and copies the chunks into it from several threads.
+ */
+#ifndef VECTOR_BUILDER_H
+#define VECTOR_BUILDER_H
+
+#include <cstddef>   // std::size_t
+#include <algorithm> // std::copy, std::min
+#include <atomic>    // std::atomic
+#include <thread>    // std::thread, std::this_thread::yield
+
+#include "./vector_config.h"
+#include "./vector.h"
+#include "./vector_threads.h"
+
+namespace sc
+{
+/**
+ * @brief Chunked producer/consumer vector builder
+ * @author Eduardo Sarmento & Victor Vieira
+ *
+ * One thread (the producer) calls push_back() and then close(); another (the consumer) calls
+ * finish(), which returns the vector. When `max_queued` chunks are waiting for the consumer,
+ * push_back() waits for it to catch up: memory in flight stays bounded and a slow consumer slows
+ * the producer down instead of letting the queue grow. The two roles must run on different
+ * threads unless everything fits in `max_queued` chunks.
+ */
+template <typename T>
+class vector_builder
+{
+public:
+    using size_type = unsigned long; //!< The size type.
+    using value_type = T;            //!< The value type.
+
+    //=== [I] SPECIAL MEMBERS
+    /// Creates a builder that moves `chunk_size` elements at a time and queues at most `max_queued` chunks.
+    /// Both are raised to at least 1.
+    explicit vector_builder(size_type chunk_size = 4096, size_type max_queued = 16)
+        : CHUNK_SIZE(chunk_size == 0 ? 1 : chunk_size), CURRENT(nullptr), FILL(0), STALLS(0), HEAD(0), TAIL(0),
+          CLOSED(false)
+    {
+        QUEUE.assign((max_queued == 0 ? 1 : max_queued) + 1, chunk());
+    }
+
+    vector_builder(const vector_builder &) = delete;
+    vector_builder &operator=(const vector_builder &) = delete;
+
+    /// Frees the chunks that were not collected.
+    ~vector_builder()
+    {
+        delete[] CURRENT;
+        for (size_type i = TAIL.load(); i != HEAD.load(); i = next(i))
+            delete[] QUEUE[i].data;
+        for (size_type c = 0; c < RECEIVED.size(); c++)
+            delete[] RECEIVED[c].data;
+    }
+
+    //=== [II] Producer side
+    /// Appends `value`. When the current chunk fills up it is queued, which waits while the queue is full.
+    void push_back(const T &value)
+    {
+        if (CURRENT == nullptr)
+            CURRENT = new T[CHUNK_SIZE];
+
+        CURRENT[FILL] = value; // counted only once the copy has succeeded
+        ++FILL;
+        if (FILL == CHUNK_SIZE)
+            submit();
+    }
+
+    /// Marks the end of the stream; the partial chunk, if any, is queued first. No push_back may follow.
+    void close()
+    {
+        if (FILL > 0)
+            submit();
+        CLOSED.store(true, std::memory_order_release);
+    }
+
+    /// Returns how many times the producer had to wait for room in the queue.
+    size_type stalls() const
+    {
+        return STALLS;
+    }
+
+    //=== [III] Consumer side
+    /// Collects every chunk until the producer calls close(), then returns the elements in one vector.
+    /// The final vector is allocated once; the chunks are copied into it by up to `threads` threads
+    /// (0 picks the number of hardware threads).
+    sc::vector<T> finish(unsigned threads = 0)
+    {
+        for (;;)
+        {
+            size_type tail = TAIL.load(std::memory_order_relaxed);
+            if (tail != HEAD.load(std::memory_order_acquire))
+            {
+                RECEIVED.push_back(QUEUE[tail]);
+                TAIL.store(next(tail), std::memory_order_release);
+            }
+            else if (CLOSED.load(std::memory_order_acquire))
+            {
+                // close() may have queued a last chunk right before setting the flag.
+                if (TAIL.load(std::memory_order_relaxed) == HEAD.load(std::memory_order_acquire))
+                    break;
+            }
+            else
+                std::this_thread::yield();
+        }
+
+        size_type total = 0;
+        sc::vector<size_type> offsets;
+        offsets.reserve(RECEIVED.size());
+        for (size_type c = 0; c < RECEIVED.size(); c++)
+        {
+            offsets.push_back(total);
+            total += RECEIVED[c].size;
+        }
+
+        sc::vector<T> result;
+        copy_chunks(result.resize_for_overwrite(total), offsets, threads);
+
+        for (size_type c = 0; c < RECEIVED.size(); c++)
+            delete[] RECEIVED[c].data;
+        RECEIVED.clear();
+        return result;
+    }
+
+private:
+    /// A block of elements handed from the producer to the consumer.
+    struct chunk
+    {
+        T *data = nullptr;  //!< The elements; owned by whoever holds the chunk.
+        size_type size = 0; //!< Number of elements in use.
+    };
+
+    /// Slot that follows `i` in the ring.
+    size_type next(size_type i) const
+    {
+        return i + 1 == QUEUE.size() ? 0 : i + 1;
+    }
+
+    /// Queues the current chunk, waiting while the ring is full.
+    void submit()
+    {
+        size_type head = HEAD.load(std::memory_order_relaxed);
+        if (next(head) == TAIL.load(std::memory_order_acquire))
+        {
+            STALLS++;
+            while (next(head) == TAIL.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+
+        QUEUE[head].data = CURRENT;
+        QUEUE[head].size = FILL;
+        HEAD.store(next(head), std::memory_order_release);
+
+        CURRENT = nullptr;
+        FILL = 0;
+    }
+
+    /// Copies the received chunks to `dest`, chunk `c` at `offsets[c]`, splitting the chunks among threads.
+    void copy_chunks(T *dest, const sc::vector<size_type> &offsets, unsigned threads) const
+    {
+        if (threads == 0)
+            threads = std::thread::hardware_concurrency();
+        size_type workers = std::min<size_type>(threads == 0 ? 1 : threads, RECEIVED.size());
+
+        auto copy_range = [&](size_type first, size_type last) {
+            for (size_type c = first; c < last; c++)
+                std::copy(RECEIVED[c].data, RECEIVED[c].data + RECEIVED[c].size, dest + offsets[c]);
+        };
+        if (workers <= 1)
+            return copy_range(0, RECEIVED.size());
+
+        detail::thread_group pool(workers - 1);
+        size_type per_worker = (RECEIVED.size() + workers - 1) / workers;
+        for (size_type first = per_worker; first < RECEIVED.size(); first += per_worker)
+            pool.start(copy_range, first, std::min(first + per_worker, RECEIVED.size()));
+        copy_range(0, per_worker);
+        pool.join();
+    }
+
+    const size_type CHUNK_SIZE; //!< Elements per chunk.
+    sc::vector<chunk> QUEUE;    //!< Ring of queued chunks; one slot always stays free to tell full from empty.
+
+    // Producer state.
+    T *CURRENT;      //!< Chunk being filled, or nullptr.
+    size_type FILL;  //!< Elements already in `CURRENT`.
+    size_type STALLS; //!< Times push_back() waited for the consumer.
+
+    // Consumer state.
+    sc::vector<chunk> RECEIVED; //!< Chunks taken off the queue, in order.
+
+    alignas(64) std::atomic<size_type> HEAD; //!< Next slot the producer writes; only the producer stores it.
+    alignas(64) std::atomic<size_type> TAIL; //!< Next slot the consumer reads; only the consumer stores it.
+    alignas(64) std::atomic<bool> CLOSED;    //!< Set by close() once the last chunk is queued.
+};
+} // namespace sc
+
+#endif
@@ -0,0 +1,331 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Size-adaptive bulk fill and copy used by sc::vector for trivially copyable elements.
+ *
+ * Small and medium ranges go through std::fill and std::copy (memmove). Ranges larger than the
+ * streaming threshold of their kernel are written with non-temporal stores, which bypass the cache:
+ * the destination is not read for ownership first, which saves half of the memory traffic, and
+ * the cache keeps the data the program was working on. Copies also prefetch the source ahead of
+ * the loads. An sfence makes the streamed stores visible before the kernel returns.
+ *
+ * Where streaming starts to pay off depends on the cache sizes and the memory system, so each
+ * threshold is calibrated by a short microbenchmark, on buffers of at most
+ * SC_VECTOR_STREAM_PROBE_BYTES, the first time a range of at least SC_VECTOR_STREAM_MIN_BYTES
+ * reaches its kernel. That first range waits for it, a few milliseconds per kernel; programs that
+ * cannot afford the pause call `set_stream_threshold(k, calibrate(k))` at startup. Defining
+ * SC_VECTOR_STREAM_THRESHOLD (bytes) fixes both thresholds at compile time instead, and
+ * set_stream_threshold() changes them at run time. Without SSE2 the kernels always use std::fill
+ * and std::copy.
+ */
+#ifndef VECTOR_BULK_H
+#define VECTOR_BULK_H
+
+#include <algorithm>   // std::fill, std::copy, std::min
+#include <atomic>      // std::atomic
+#include <chrono>      // std::chrono::steady_clock
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uintptr_t
+#include <cstring>     // std::memcpy
+#include <memory>      // std::unique_ptr
+#include <new>         // std::nothrow
+#include <type_traits> // std::is_trivially_copyable
+
+#include "./vector_config.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h> // _mm_stream_si128, _mm256_stream_si256, _mm_prefetch, _mm_sfence
+/// Defined when the bulk kernels can issue non-temporal stores.
+#define SC_VECTOR_HAS_STREAMING 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SC_VECTOR_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define SC_VECTOR_NOINLINE __declspec(noinline)
+#else
+#define SC_VECTOR_NOINLINE
+#endif
+
+#ifndef SC_VECTOR_STREAM_MIN_BYTES
+/// Ranges smaller than this always use the cached kernels, and never trigger the calibration.
+#define SC_VECTOR_STREAM_MIN_BYTES (1UL << 20)
+#endif
+
+#ifndef SC_VECTOR_STREAM_PROBE_BYTES
+/// Largest range the calibration measures; it allocates one buffer of this size per operand.
+#define SC_VECTOR_STREAM_PROBE_BYTES (8UL << 20)
+#endif
+
+namespace sc
+{
+namespace bulk
+{
+/// The bulk operations that have a streaming variant, each with its own threshold.
+enum class kernel
+{
+    fill, //!< Writing copies of one value.
+    copy  //!< Copying a range to a distinct one.
+};
+
+/// Threshold meaning "never stream".
+static const std::size_t NEVER = ~std::size_t(0);
+
+namespace detail
+{
+/// Threshold value of a kernel that has not been calibrated yet.
+static const std::size_t UNSET = NEVER - 1;
+
+/// Distance, in bytes, at which copies prefetch their source.
+static const std::size_t PREFETCH_DISTANCE = 4096;
+
+/// Returns the threshold of `k`.
+inline std::atomic<std::size_t> &threshold_of(kernel k)
+{
+#ifdef SC_VECTOR_STREAM_THRESHOLD
+    static std::atomic<std::size_t> fill_threshold(SC_VECTOR_STREAM_THRESHOLD);
+    static std::atomic<std::size_t> copy_threshold(SC_VECTOR_STREAM_THRESHOLD);
+#else
+    static std::atomic<std::size_t> fill_threshold(UNSET);
+    static std::atomic<std::size_t> copy_threshold(UNSET);
+#endif
+    return k == kernel::fill ? fill_threshold : copy_threshold;
+}
+
+#ifdef SC_VECTOR_HAS_STREAMING
+#ifdef __AVX__
+typedef __m256i block_type; //!< Register written by one streaming store.
+inline block_type load_block(const void *from)
+{
+    return _mm256_loadu_si256(static_cast<const __m256i *>(from));
+}
+inline void stream_block(void *to, block_type block)
+{
+    _mm256_stream_si256(static_cast<__m256i *>(to), block);
+}
+#else
+typedef __m128i block_type; //!< Register written by one streaming store.
+inline block_type load_block(const void *from)
+{
+    return _mm_loadu_si128(static_cast<const __m128i *>(from));
+}
+inline void stream_block(void *to, block_type block)
+{
+    _mm_stream_si128(static_cast<__m128i *>(to), block);
+}
+#endif
+/// Bytes written by one streaming store.
+static const std::size_t BLOCK = sizeof(block_type);
+/// Streaming stores go to destinations aligned to a cache line.
+static const std::size_t LINE = 64;
+
+/// Copies `bytes` from `from` to `to` (which must not overlap) with non-temporal stores.
+inline void stream_copy(char *to, const char *from, std::size_t bytes)
+{
+    std::size_t head = std::min(bytes, (LINE - std::uintptr_t(to) % LINE) % LINE);
+    std::memcpy(to, from, head);
+    std::size_t done = head;
+    for (; done + LINE <= bytes; done += LINE)
+    {
+        // The hint is T0: an NTA prefetch measured a third slower than no prefetch at all.
+        _mm_prefetch(from + done + PREFETCH_DISTANCE, _MM_HINT_T0);
+        block_type line[LINE / BLOCK];
+        for (std::size_t b = 0; b < LINE / BLOCK; b++)
+            line[b] = load_block(from + done + b * BLOCK);
+        for (std::size_t b = 0; b < LINE / BLOCK; b++)
+            stream_block(to + done + b * BLOCK, line[b]);
+    }
+    _mm_sfence();
+    std::memcpy(to + done, from + done, bytes - done);
+}
+
+/// Fills `count` elements at `out` with `value` using non-temporal stores. sizeof(T) must divide
+/// the block size, so that every aligned block of the destination holds the same bytes.
+template <typename T>
+void stream_fill(T *out, std::size_t count, const T &value)
+{
+    char *bytes = reinterpret_cast<char *>(out);
+    std::size_t head = (LINE - std::uintptr_t(bytes) % LINE) % LINE;
+
+    // Fill enough elements to cover the first aligned block, then reuse that block as the pattern.
+    std::size_t first = (head + BLOCK + sizeof(T) - 1) / sizeof(T);
+    if (first >= count)
+        return (void)std::fill(out, out + count, value);
+    std::fill(out, out + first, value);
+    block_type pattern = load_block(bytes + head);
+
+    std::size_t total = count * sizeof(T), done = head;
+    for (; done + LINE <= total; done += LINE)
+        for (std::size_t b = 0; b < LINE; b += BLOCK)
+            stream_block(bytes + done + b, pattern);
+    _mm_sfence();
+    std::size_t rest = std::max(first, done / sizeof(T)); // the element straddling `done` is rewritten whole
+    std::fill(out + rest, out + count, value);
+}
+
+/// Returns true when the fill of T can stream.
+template <typename T>
+struct streamable_fill : std::integral_constant<bool, BLOCK % sizeof(T) == 0>
+{
+};
+#endif
+
+/// Returns the best of `rounds` timings of `work()`, in nanoseconds.
+template <typename Work>
+double best_time(int rounds, Work work)
+{
+    double best = 1e300;
+    for (int r = 0; r < rounds; r++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        work();
+        double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        best = std::min(best, ns);
+    }
+    return best;
+}
+} // namespace detail
+
+/**
+ * Measures the cached and the streaming variant of `k` on ranges from SC_VECTOR_STREAM_MIN_BYTES
+ * up to `max_bytes`, doubling the size each step, and returns the smallest size from which the
+ * streaming variant was faster at every step (NEVER if it was not faster at the largest one).
+ * Takes about 15 ms per kernel with the default `max_bytes`. Returns NEVER, without throwing, when
+ * the buffers cannot be allocated.
+ */
+inline std::size_t calibrate(kernel k, std::size_t max_bytes = SC_VECTOR_STREAM_PROBE_BYTES)
+{
+#ifdef SC_VECTOR_HAS_STREAMING
+    const std::size_t words = max_bytes / sizeof(std::uint64_t);
+    std::unique_ptr<std::uint64_t[]> target_buffer(new (std::nothrow) std::uint64_t[words]);
+    std::unique_ptr<std::uint64_t[]> source_buffer(k == kernel::copy ? new (std::nothrow) std::uint64_t[words] : nullptr);
+    if (!target_buffer || (k == kernel::copy && !source_buffer))
+        return NEVER;
+    std::uint64_t *target = target_buffer.get();
+    std::uint64_t *source = source_buffer.get();
+    std::fill(target, target + words, 0); // fault every page in before timing
+    if (source != nullptr)
+        std::fill(source, source + words, 1);
+
+    std::size_t threshold = NEVER;
+    for (std::size_t bytes = SC_VECTOR_STREAM_MIN_BYTES; bytes <= max_bytes; bytes *= 2)
+    {
+        std::size_t n = bytes / sizeof(std::uint64_t);
+        double cached, streamed;
+        if (k == kernel::fill)
+        {
+            cached = detail::best_time(3, [&]() { std::fill(target, target + n, std::uint64_t(7)); });
+            streamed = detail::best_time(3, [&]() { detail::stream_fill(target, n, std::uint64_t(7)); });
+        }
+        else
+        {
+            cached = detail::best_time(3, [&]() { std::memcpy(target, source, bytes); });
+            streamed = detail::best_time(3, [&]() {
+                detail::stream_copy(reinterpret_cast<char *>(target), reinterpret_cast<const char *>(source), bytes);
+            });
+        }
+        if (streamed < cached)
+            threshold = std::min(threshold, bytes);
+        else
+            threshold = NEVER; // streaming has to keep winning at every larger size
+    }
+    return threshold;
+#else
+    (void)k;
+    (void)max_bytes;
+    return NEVER;
+#endif
+}
+
+/// Returns the size, in bytes, from which `k` uses streaming stores; calibrates it on first use.
+inline std::size_t stream_threshold(kernel k)
+{
+    std::atomic<std::size_t> &slot = detail::threshold_of(k);
+    std::size_t threshold = slot.load(std::memory_order_relaxed);
+    if (threshold == detail::UNSET)
+    {
+        std::size_t measured = calibrate(k);
+        if (slot.compare_exchange_strong(threshold, measured, std::memory_order_relaxed))
+            threshold = measured;
+    }
+    return threshold;
+}
+
+/// Makes `k` stream from `bytes` on (NEVER turns streaming off), replacing the calibrated value.
+inline void set_stream_threshold(kernel k, std::size_t bytes)
+{
+    detail::threshold_of(k).store(bytes, std::memory_order_relaxed);
+}
+
+/// Returns true when a range of `bytes` should use the streaming variant of `k`.
+inline bool should_stream(kernel k, std::size_t bytes)
+{
+#ifdef SC_VECTOR_HAS_STREAMING
+    return bytes >= SC_VECTOR_STREAM_MIN_BYTES && bytes >= stream_threshold(k);
+#else
+    (void)k;
+    (void)bytes;
+    return false;
+#endif
+}
+
+#ifdef SC_VECTOR_HAS_STREAMING
+namespace detail
+{
+/// Streams the fill if its threshold says so. Kept out of line, like copy_streamed(), so that the
+/// loops that may reach a bulk kernel (push_back's growth) only inline a size test and a call.
+template <typename T>
+SC_VECTOR_NOINLINE bool fill_streamed(T *out, std::size_t count, const T &value)
+{
+    if (!should_stream(kernel::fill, count * sizeof(T)))
+        return false;
+    stream_fill(out, count, value);
+    return true;
+}
+
+/// Streams the copy of `bytes` if its threshold says so.
+SC_VECTOR_NOINLINE inline bool copy_streamed(char *to, const char *from, std::size_t bytes)
+{
+    if (!should_stream(kernel::copy, bytes))
+        return false;
+    stream_copy(to, from, bytes);
+    return true;
+}
+} // namespace detail
+#endif
+
+/// Sets the `count` elements at `out` to `value`.
+template <typename T>
+void fill(T *out, std::size_t count, const T &value)
+{
+    if (count == 0) // `out` may be null then, and GCC would see memset into it
+        return;
+#ifdef SC_VECTOR_HAS_STREAMING
+    if (std::is_trivially_copyable<T>::value && detail::streamable_fill<T>::value &&
+        count * sizeof(T) >= SC_VECTOR_STREAM_MIN_BYTES && detail::fill_streamed(out, count, value))
+        return;
+#endif
+    std::fill(out, out + count, value);
+}
+
+/// Copies the `count` elements at `from` to `to`; the ranges must not overlap.
+template <typename T>
+void copy(const T *from, std::size_t count, T *to)
+{
+    if (count == 0) // either pointer may be null then, and GCC would see memcpy through it
+        return;
+#ifdef SC_VECTOR_HAS_STREAMING
+    if (std::is_trivially_copyable<T>::value && count * sizeof(T) >= SC_VECTOR_STREAM_MIN_BYTES &&
+        detail::copy_streamed(reinterpret_cast<char *>(to), reinterpret_cast<const char *>(from), count * sizeof(T)))
+        return;
+#endif
+    std::copy(from, from + count, to);
+}
+} // namespace bulk
+} // namespace sc
+
+#endif
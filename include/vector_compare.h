@@ -0,0 +1,193 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Building blocks of the lexicographic comparison of sc::vector.
+ *
+ * Comparing two vectors means finding the first position where they differ and comparing the
+ * elements there. Unsigned bytes order like memory, so memcmp does the whole job. For the other
+ * integer types, equal elements have equal bytes, so the first differing byte is found 32 bytes at
+ * a time with AVX2 (16 with SSE2) and turned back into an element index. Floating-point elements
+ * are compared a block at a time with branch-free loops the compiler vectorizes.
+ */
+#ifndef VECTOR_COMPARE_H
+#define VECTOR_COMPARE_H
+
+#include <cstddef>     // std::size_t
+#include <cstring>     // std::memcmp
+#include <type_traits> // std::is_integral, std::is_floating_point
+#include <utility>     // std::declval
+
+#include "./vector_config.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#ifdef SC_VECTOR_HAS_THREE_WAY
+#include <compare>
+#endif
+
+namespace sc
+{
+namespace detail
+{
+/// Elements whose order is the order of their bytes, so vectors of them compare with memcmp.
+template <typename T>
+struct is_memcmp_orderable : std::integral_constant<bool, std::is_same<T, unsigned char>::value || std::is_same<T, bool>::value
+#if defined(__cpp_lib_byte)
+                                                              || std::is_same<T, std::byte>::value
+#endif
+                                                          >
+{
+};
+
+/// Elements whose equality is the equality of their bytes, so their first mismatch is the first differing byte.
+template <typename T>
+struct is_bytewise_comparable
+    : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value>
+{
+};
+
+/// Comparison strategy for the elements of a vector.
+enum class compare_kind
+{
+    bytes,    //!< memcmp over the buffers
+    bytewise, //!< SIMD search for the first differing byte, then operator<
+    blocks,   //!< branch-free search a block at a time, then operator<
+    generic   //!< operator< on each element
+};
+
+/// Picks the comparison strategy for `T`.
+template <typename T>
+constexpr compare_kind compare_kind_of()
+{
+    return is_memcmp_orderable<T>::value      ? compare_kind::bytes
+           : is_bytewise_comparable<T>::value ? compare_kind::bytewise
+           : std::is_floating_point<T>::value ? compare_kind::blocks
+                                              : compare_kind::generic;
+}
+
+/// Index of the lowest set bit of a non-zero `mask`.
+inline unsigned lowest_bit(unsigned mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(__builtin_ctz(mask));
+#else
+    unsigned n = 0;
+    for (; (mask & 1) == 0; mask >>= 1)
+        n++;
+    return n;
+#endif
+}
+
+/// Returns the first index below `count` at which the bytes of `a` and `b` differ, divided by `width`; `count / width` if none.
+inline std::size_t first_byte_mismatch(const void *a, const void *b, std::size_t count, std::size_t width)
+{
+    const unsigned char *pa = static_cast<const unsigned char *>(a), *pb = static_cast<const unsigned char *>(b);
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pa + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pb + i));
+        unsigned differ = ~unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (differ != 0)
+            return (i + lowest_bit(differ)) / width;
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pa + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pb + i));
+        unsigned differ = ~unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFF;
+        if (differ != 0)
+            return (i + lowest_bit(differ)) / width;
+    }
+#endif
+    for (; i < count; i++)
+        if (pa[i] != pb[i])
+            return i / width;
+    return count / width;
+}
+
+/// Returns the first index below `n` at which `a` and `b` differ (or either is NaN), or `n` if none.
+template <typename T>
+std::size_t first_mismatch_blocks(const T *a, const T *b, std::size_t n)
+{
+    const std::size_t BLOCK = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+    std::size_t i = 0;
+    for (; i + BLOCK <= n; i += BLOCK)
+    {
+        bool differ = false;
+        for (std::size_t k = 0; k < BLOCK; k++)
+            differ |= not(a[i + k] == b[i + k]);
+        if (differ)
+            break;
+    }
+    for (; i < n; i++)
+        if (not(a[i] == b[i]))
+            return i;
+    return n;
+}
+
+/// Strategy `K`, as a type to dispatch on.
+template <compare_kind K>
+using compare_tag = std::integral_constant<compare_kind, K>;
+
+/// Returns the first index below `n` at which `a` and `b` may differ, or `n` if none; dispatched on the strategy.
+template <typename T>
+std::size_t mismatch_search(const T *a, const T *b, std::size_t n, compare_tag<compare_kind::bytes>)
+{
+    return first_byte_mismatch(a, b, n * sizeof(T), sizeof(T));
+}
+
+template <typename T>
+std::size_t mismatch_search(const T *a, const T *b, std::size_t n, compare_tag<compare_kind::bytewise>)
+{
+    return first_byte_mismatch(a, b, n * sizeof(T), sizeof(T));
+}
+
+template <typename T>
+std::size_t mismatch_search(const T *a, const T *b, std::size_t n, compare_tag<compare_kind::blocks>)
+{
+    return first_mismatch_blocks(a, b, n);
+}
+
+template <typename T>
+std::size_t mismatch_search(const T *, const T *, std::size_t, compare_tag<compare_kind::generic>)
+{
+    return 0;
+}
+
+/// Returns the first index at or after `first` and below `n` at which `a` and `b` may differ, or `n` if none.
+/// For element types without a fast search this is `first` itself.
+template <typename T>
+std::size_t first_mismatch(const T *a, const T *b, std::size_t first, std::size_t n)
+{
+    return first + mismatch_search(a + first, b + first, n - first, compare_tag<compare_kind_of<T>()>());
+}
+
+#ifdef SC_VECTOR_HAS_THREE_WAY
+/// Three-way comparison of two elements: operator<=> when `T` has it, otherwise derived from operator<.
+template <typename T>
+constexpr auto synth_three_way(const T &a, const T &b)
+{
+    if constexpr (std::three_way_comparable<T>)
+        return a <=> b;
+    else
+        return a < b ? std::weak_ordering::less : b < a ? std::weak_ordering::greater : std::weak_ordering::equivalent;
+}
+
+/// Result type of synth_three_way for `T`.
+template <typename T>
+using synth_three_way_result = decltype(synth_three_way(std::declval<const T &>(), std::declval<const T &>()));
+#endif
+} // namespace detail
+} // namespace sc
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Compile-time switches shared by the vector headers.
+ *
+ * Every switch is a macro that must be defined (or left undefined) before the first
+ * include of vector.h, and must be the same in every translation unit of a program.
+ */
+#ifndef VECTOR_CONFIG_H
+#define VECTOR_CONFIG_H
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+//=== Constant evaluation
+// Members that need relaxed constexpr (loops, several statements) are marked SC_CONSTEXPR14;
+// members that also allocate are marked SC_CONSTEXPR20, since new/delete only became usable
+// in constant expressions with C++20 transient allocation.
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+#define SC_CONSTEXPR14 constexpr
+#else
+#define SC_CONSTEXPR14
+#endif
+
+#if defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L
+#define SC_CONSTEXPR20 constexpr
+/// Defined when sc::vector can be used in constant expressions.
+#define SC_VECTOR_HAS_CONSTEXPR 1
+#else
+#define SC_CONSTEXPR20
+#endif
+
+#if defined(__cpp_lib_is_constant_evaluated)
+#include <type_traits>
+/// True while the enclosing function is being evaluated at compile time.
+#define SC_VECTOR_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define SC_VECTOR_IS_CONSTANT_EVALUATED() false
+#endif
+
+//=== Concepts
+// In C++20 mode iterators advertise std::contiguous_iterator_tag, range members are constrained
+// and contiguous sources are copied through raw pointers. Members that measure the range before
+// copying it require std::forward_iterator, so a single-pass source cannot be consumed by the
+// measuring; those that append one element at a time take any std::input_iterator.
+#if defined(__cpp_lib_concepts) && __cpp_lib_concepts >= 202002L
+/// Defined when the standard library concepts are available.
+#define SC_VECTOR_HAS_CONCEPTS 1
+/// Introduces an iterator template parameter, constrained when concepts are available.
+#define SC_VECTOR_INPUT_ITERATOR std::input_iterator
+/// Introduces an iterator template parameter for a range that is walked twice.
+#define SC_VECTOR_FORWARD_ITERATOR std::forward_iterator
+#else
+#define SC_VECTOR_INPUT_ITERATOR typename
+#define SC_VECTOR_FORWARD_ITERATOR typename
+#endif
+
+//=== Three-way comparison
+// With C++20 three-way comparison sc::vector defines operator<=> and lets the compiler rewrite
+// <, <=, > and >= in terms of it; older builds get the four relational operators instead.
+#if defined(__cpp_impl_three_way_comparison) && __cpp_impl_three_way_comparison >= 201907L && \
+    defined(__cpp_lib_three_way_comparison) && __cpp_lib_three_way_comparison >= 201907L
+/// Defined when sc::vector has operator<=>.
+#define SC_VECTOR_HAS_THREE_WAY 1
+#endif
+
+//=== Checking modes
+// SC_VECTOR_CHECKS selects what happens to the preconditions of operator[], front, back,
+// pop_back, pop_front and erase, and to iterator dereferences:
+//   0 - release: preconditions are turned into optimizer assumptions ([[assume]] or
+//       __builtin_unreachable), which lets index loops vectorize; violating them is UB.
+//   1 - default: preconditions are assert()ed, so they vanish with NDEBUG.
+//   2 - hardened: preconditions are always checked and iterators carry the generation of the
+//       buffer they point into, so using one after a reallocation is reported.
+// A violation in hardened mode calls SC_VECTOR_VIOLATION(msg), which prints and aborts unless
+// it is defined differently.
+#ifndef SC_VECTOR_CHECKS
+#define SC_VECTOR_CHECKS 1
+#endif
+
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(assume) >= 202207L
+#define SC_VECTOR_HAS_ASSUME_ATTRIBUTE 1
+#endif
+#endif
+
+#if defined(SC_VECTOR_HAS_ASSUME_ATTRIBUTE)
+#define SC_VECTOR_ASSUME(cond) [[assume(cond)]]
+#elif defined(__clang__)
+#define SC_VECTOR_ASSUME(cond) __builtin_assume(cond)
+#elif defined(__GNUC__)
+#define SC_VECTOR_ASSUME(cond) (static_cast<bool>(cond) ? void(0) : __builtin_unreachable())
+#elif defined(_MSC_VER)
+#define SC_VECTOR_ASSUME(cond) __assume(cond)
+#else
+#define SC_VECTOR_ASSUME(cond) static_cast<void>(0)
+#endif
+
+#if SC_VECTOR_CHECKS >= 2
+#include <cstdio>  // std::fprintf
+#include <cstdlib> // std::abort
+
+namespace sc
+{
+namespace detail
+{
+/// Reports a broken precondition of a hardened build and aborts.
+[[noreturn]] inline void contract_violation(const char *msg, const char *file, int line)
+{
+    std::fprintf(stderr, "%s:%d: sc::vector contract violation: %s\n", file, line, msg);
+    std::abort();
+}
+} // namespace detail
+} // namespace sc
+
+#ifndef SC_VECTOR_VIOLATION
+#define SC_VECTOR_VIOLATION(msg) ::sc::detail::contract_violation(msg, __FILE__, __LINE__)
+#endif
+/// Checks a precondition.
+#define SC_VECTOR_REQUIRE(cond, msg) (static_cast<bool>(cond) ? void(0) : SC_VECTOR_VIOLATION(msg))
+/// Defined when iterators record the generation of the buffer they point into.
+#define SC_VECTOR_CHECKED_ITERATORS 1
+#elif SC_VECTOR_CHECKS == 1
+#include <cassert> // assert
+#define SC_VECTOR_REQUIRE(cond, msg) assert((cond) && msg)
+#else
+#define SC_VECTOR_REQUIRE(cond, msg) SC_VECTOR_ASSUME(cond)
+#endif
+
+//=== Prefetching
+#if defined(__GNUC__) || defined(__clang__)
+/// Asks for the cache line at `addr` ahead of a read.
+#define SC_VECTOR_PREFETCH(addr) __builtin_prefetch(addr)
+/// Asks for the cache line at `addr`, in a writable state, ahead of a write.
+#define SC_VECTOR_PREFETCH_WRITE(addr) __builtin_prefetch(addr, 1)
+#else
+#define SC_VECTOR_PREFETCH(addr) ((void)(addr))
+#define SC_VECTOR_PREFETCH_WRITE(addr) ((void)(addr))
+#endif
+
+//=== Fixed-capacity vectors
+// What sc::static_vector does when an insertion would exceed its capacity: throw
+// std::length_error (throws), fail an assert (asserts) or nothing at all (unchecked).
+#ifndef SC_STATIC_VECTOR_OVERFLOW
+#define SC_STATIC_VECTOR_OVERFLOW throws
+#endif
+
+//=== Fingerprints
+// Define SC_VECTOR_FINGERPRINT to make every sc::vector carry a 64-bit digest of its contents.
+// push_back and pop_back update it in constant time. Writable access (non-const operator[],
+// iterators, data(), ...) marks it stale and fingerprint() recomputes it, so a pointer, reference or
+// iterator kept across a fingerprint() call can write behind its back; operator== never relies on it
+// for that reason. Marking it stale is a write to the vector itself, so threads that write distinct
+// elements through writable access must not share a vector while fingerprints are on. Elements that
+// are not integers or enums need a std::hash specialization.
+
+//=== Expression templates
+// vector_expr.h evaluates an expression on several threads once it has at least
+// SC_VECTOR_PARALLEL_THRESHOLD elements; smaller ones run on the calling thread, where starting
+// threads would cost more than it saves.
+#ifndef SC_VECTOR_PARALLEL_THRESHOLD
+#define SC_VECTOR_PARALLEL_THRESHOLD (1UL << 20)
+#endif
+
+//=== Gather and scatter
+// sc::vector::gather, scatter and permuted read or write through an index array (see
+// vector_gather.h). Sources and targets smaller than SC_VECTOR_GATHER_PREFETCH_BYTES use AVX2
+// gathers where the element and index types allow; larger ones, which miss the caches anyway,
+// use scalar accesses that prefetch SC_VECTOR_GATHER_PREFETCH_DISTANCE indices ahead.
+#ifndef SC_VECTOR_GATHER_PREFETCH_BYTES
+#define SC_VECTOR_GATHER_PREFETCH_BYTES (32UL << 20)
+#endif
+#ifndef SC_VECTOR_GATHER_PREFETCH_DISTANCE
+#define SC_VECTOR_GATHER_PREFETCH_DISTANCE 64
+#endif
+
+//=== Shrinking
+// A vector with auto-shrink turned on (sc::vector::set_auto_shrink) gives back its spare capacity
+// once a removal leaves fewer than a quarter of its slots in use, keeping twice the remaining size.
+// Buffers of SC_VECTOR_SHRINK_MIN_BYTES or less are never shrunk automatically, nor below that size.
+#ifndef SC_VECTOR_SHRINK_MIN_BYTES
+#define SC_VECTOR_SHRINK_MIN_BYTES 4096UL
+#endif
+
+//=== Buffer pool
+// Define SC_VECTOR_POOL to make sc::vector take its buffers from per-thread free lists instead of
+// new[] and delete[] (see vector_pool.h). Buffers are recycled by size class, so a program that
+// keeps creating and destroying vectors of similar capacities stops calling malloc.
+// SC_VECTOR_POOL_MAX_BYTES and SC_VECTOR_POOL_RETAIN bound the buffers it recycles and keeps.
+
+//=== NUMA placement
+// numa_vector.h binds its partitions to NUMA nodes and runs its workers on the CPUs of those
+// nodes when SC_VECTOR_HAS_NUMA is defined; the CMake target defines it and links libnuma when
+// the library is found. Otherwise there is a single node. Like the expressions, numa_vector only
+// starts threads for vectors of at least SC_VECTOR_PARALLEL_THRESHOLD elements.
+
+//=== Streaming stores
+// Large fills and copies of trivially copyable elements use non-temporal stores past a threshold
+// that vector_bulk.h calibrates on first use, on buffers of up to SC_VECTOR_STREAM_PROBE_BYTES
+// (default 8 MiB). Define SC_VECTOR_STREAM_THRESHOLD (bytes) to skip the calibration; ranges below
+// SC_VECTOR_STREAM_MIN_BYTES (default 1 MiB) are never streamed.
+
+//=== Byte buffers
+// sc::byte_buffer::read_from() lets a read spill past the free space of the buffer into a stack
+// area of SC_VECTOR_READ_SPILL_BYTES, whose bytes are then appended (see byte_buffer.h).
+#ifndef SC_VECTOR_READ_SPILL_BYTES
+#define SC_VECTOR_READ_SPILL_BYTES 65536
+#endif
+
+//=== Asynchronous loading
+// async_load.h offers a coroutine interface when the compiler supports C++20 coroutines, and
+// submits reads through io_uring when SC_VECTOR_HAS_IO_URING is defined; the CMake target
+// defines it and links liburing when the library is found. Otherwise reads go to a thread pool.
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+/// Defined when sc::task and the coroutine overload of sc::async_load are available.
+#define SC_VECTOR_HAS_COROUTINES 1
+#endif
+
+//=== Growth tracing
+// Define SC_VECTOR_TRACE to record every reallocation of an sc::vector, together with the
+// call site that triggered it, into per-thread ring buffers (see growth_trace.h).
+#ifdef SC_VECTOR_TRACE
+/// Trailing parameter added to the public members that may reallocate; captures the caller's location.
+#define SC_VECTOR_TRACE_LOC , SC_VECTOR_TRACE_LOC_ONLY
+/// Same as SC_VECTOR_TRACE_LOC, for members that take no other parameter.
+#define SC_VECTOR_TRACE_LOC_ONLY ::sc::trace::source_location loc = ::sc::trace::source_location::current()
+/// Trailing parameter of the private members that receive a forwarded location.
+#define SC_VECTOR_TRACE_ARG , const ::sc::trace::source_location &loc
+/// Forwards the captured location to the next call.
+#define SC_VECTOR_TRACE_FWD , loc
+/// Same as SC_VECTOR_TRACE_ARG and SC_VECTOR_TRACE_FWD, for members that take no other parameter.
+#define SC_VECTOR_TRACE_ARG_ONLY const ::sc::trace::source_location &loc
+#define SC_VECTOR_TRACE_FWD_ONLY loc
+#else
+#define SC_VECTOR_TRACE_LOC
+#define SC_VECTOR_TRACE_LOC_ONLY
+#define SC_VECTOR_TRACE_ARG
+#define SC_VECTOR_TRACE_FWD
+#define SC_VECTOR_TRACE_ARG_ONLY
+#define SC_VECTOR_TRACE_FWD_ONLY
+#endif
+
+#endif
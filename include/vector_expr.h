@@ -0,0 +1,532 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Lazy elementwise arithmetic on vectors of numbers.
+ *
+ * Including this header gives sc::vector<T> with an arithmetic T the operators +, -, * and /
+ * (against another vector or a scalar) and unary -. They do not compute anything: they return an
+ * expression object recording the operation and its operands. Assigning the expression to a
+ * vector, or constructing one from it, runs a single loop that computes each element from the
+ * operands directly, with no intermediate vectors; the loop body is a few inlined operations, which
+ * the compiler vectorizes. sum, dot, min and max consume an expression the same way. Expressions
+ * with at least SC_VECTOR_PARALLEL_THRESHOLD elements are split among the hardware threads.
+ *
+ * An expression refers to the vectors it reads; evaluate it before they change or go away, and
+ * do not keep one in an `auto` variable beyond the statement that built it.
+ */
+#ifndef VECTOR_EXPR_H
+#define VECTOR_EXPR_H
+
+#include <algorithm>   // std::min
+#include <thread>      // std::thread
+#include <type_traits> // std::enable_if, std::is_arithmetic, std::is_base_of
+#include <utility>     // std::declval
+
+#include "./vector_config.h"
+#include "./vector.h"
+#include "./vector_threads.h"
+
+namespace sc
+{
+namespace detail
+{
+/// Runs `f(first, last, worker)` over consecutive ranges covering [0, n), numbering them from 0: on the
+/// calling thread when `n` is below SC_VECTOR_PARALLEL_THRESHOLD, otherwise one range per hardware thread.
+template <typename F>
+void parallel_for(unsigned long n, F f)
+{
+    unsigned long workers = n < SC_VECTOR_PARALLEL_THRESHOLD ? 1 : std::thread::hardware_concurrency();
+    if (workers <= 1)
+        return f(0, n, 0);
+
+    thread_group pool(workers - 1);
+    unsigned long per_worker = (n + workers - 1) / workers;
+    for (unsigned long w = 1; w * per_worker < n; w++)
+        pool.start(f, w * per_worker, std::min(n, (w + 1) * per_worker), w);
+    f(0, per_worker, 0);
+    pool.join();
+}
+
+/// Number of threads parallel_for() uses for `n` elements.
+inline unsigned long parallel_workers(unsigned long n)
+{
+    unsigned long workers = n < SC_VECTOR_PARALLEL_THRESHOLD ? 1 : std::thread::hardware_concurrency();
+    if (workers <= 1)
+        return 1;
+    unsigned long per_worker = (n + workers - 1) / workers;
+    return (n + per_worker - 1) / per_worker;
+}
+} // namespace detail
+
+/**
+ * @brief Base of the elementwise expressions over vectors
+ *
+ * `E` is the expression type itself. Every expression has a size() and an operator[] returning
+ * the value of its element i, computed from the operands on each call.
+ */
+template <typename E>
+class vector_expression
+{
+public:
+    /// Returns the expression as its own type.
+    const E &derived() const
+    {
+        return static_cast<const E &>(*this);
+    }
+
+    /// Returns the number of elements.
+    unsigned long size() const
+    {
+        return derived().size();
+    }
+
+    /// Writes the elements to `out`, which must have room for size() of them. `out` may be the buffer of
+    /// an operand, as long as it is the whole buffer: element i is read before it is written.
+    template <typename U>
+    void evaluate(U *out) const
+    {
+        const E &expr = derived();
+        detail::parallel_for(expr.size(), [&](unsigned long first, unsigned long last, unsigned long) {
+            for (unsigned long i = first; i < last; i++)
+                out[i] = U(expr[i]);
+        });
+    }
+};
+
+/// A vector, read through its buffer.
+template <typename T>
+class vector_operand : public vector_expression<vector_operand<T>>
+{
+public:
+    using value_type = T; //!< Type of the elements.
+
+    /// Refers to the elements of `vec`.
+    explicit vector_operand(const sc::vector<T> &vec) : DATA(vec.data()), SIZE(vec.size())
+    {
+    }
+
+    /// Returns the number of elements.
+    unsigned long size() const
+    {
+        return SIZE;
+    }
+
+    /// Returns element `i`.
+    T operator[](unsigned long i) const
+    {
+        return DATA[i];
+    }
+
+private:
+    const T *DATA;      //!< Elements of the vector.
+    unsigned long SIZE; //!< Number of elements.
+};
+
+/// A number used as an operand; every element of it is the same value.
+template <typename T>
+class scalar_operand
+{
+public:
+    using value_type = T; //!< Type of the value.
+
+    /// Holds `value`.
+    explicit scalar_operand(T value) : VALUE(value)
+    {
+    }
+
+    /// Returns the value.
+    T operator[](unsigned long) const
+    {
+        return VALUE;
+    }
+
+private:
+    T VALUE; //!< The value.
+};
+
+/// `Op` applied to each element of `Arg`.
+template <typename Op, typename Arg>
+class unary_expression : public vector_expression<unary_expression<Op, Arg>>
+{
+public:
+    using value_type = decltype(Op()(std::declval<typename Arg::value_type>())); //!< Type of the elements.
+
+    /// Applies `Op` to the elements of `arg`.
+    explicit unary_expression(const Arg &arg) : ARG(arg)
+    {
+    }
+
+    /// Returns the number of elements.
+    unsigned long size() const
+    {
+        return ARG.size();
+    }
+
+    /// Returns element `i`.
+    value_type operator[](unsigned long i) const
+    {
+        return Op()(ARG[i]);
+    }
+
+private:
+    Arg ARG; //!< The operand.
+};
+
+/// `Op` applied to the elements of `Left` and `Right` at the same positions.
+template <typename Op, typename Left, typename Right>
+class binary_expression : public vector_expression<binary_expression<Op, Left, Right>>
+{
+public:
+    using value_type = decltype(Op()(std::declval<typename Left::value_type>(),
+                                     std::declval<typename Right::value_type>())); //!< Type of the elements.
+
+    /// Combines the elements of `left` and `right`; when both are vectors or expressions, their sizes must match.
+    binary_expression(const Left &left, const Right &right)
+        : LEFT(left), RIGHT(right), SIZE(size_of(left, right))
+    {
+    }
+
+    /// Returns the number of elements.
+    unsigned long size() const
+    {
+        return SIZE;
+    }
+
+    /// Returns element `i`.
+    value_type operator[](unsigned long i) const
+    {
+        return Op()(LEFT[i], RIGHT[i]);
+    }
+
+private:
+    /// Size of an expression of two sequences, or of a sequence and a scalar.
+    template <typename A, typename B>
+    static unsigned long size_of(const vector_expression<A> &left, const vector_expression<B> &right)
+    {
+        SC_VECTOR_REQUIRE(left.size() == right.size(), "elementwise operands of different sizes");
+        return left.size();
+    }
+
+    template <typename A, typename B>
+    static unsigned long size_of(const vector_expression<A> &left, const scalar_operand<B> &)
+    {
+        return left.size();
+    }
+
+    template <typename A, typename B>
+    static unsigned long size_of(const scalar_operand<A> &, const vector_expression<B> &right)
+    {
+        return right.size();
+    }
+
+    Left LEFT;          //!< The left operand.
+    Right RIGHT;        //!< The right operand.
+    unsigned long SIZE; //!< Number of elements.
+};
+
+namespace detail
+{
+/// The operations of the expressions.
+struct expr_add
+{
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a + b)
+    {
+        return a + b;
+    }
+};
+
+struct expr_subtract
+{
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a - b)
+    {
+        return a - b;
+    }
+};
+
+struct expr_multiply
+{
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a * b)
+    {
+        return a * b;
+    }
+};
+
+struct expr_divide
+{
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a / b)
+    {
+        return a / b;
+    }
+};
+
+struct expr_negate
+{
+    template <typename A>
+    auto operator()(A a) const -> decltype(-a)
+    {
+        return -a;
+    }
+};
+
+/// How a value takes part in an expression: `type` is its operand type and `wrap` converts it.
+/// Vectors of numbers and expressions are sequences; numbers are scalars; anything else is not an operand.
+template <typename X, typename = void>
+struct expr_operand
+{
+    static constexpr bool is_operand = false;
+    static constexpr bool is_sequence = false;
+};
+
+template <typename T>
+struct expr_operand<sc::vector<T>, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+{
+    static constexpr bool is_operand = true;
+    static constexpr bool is_sequence = true;
+    using type = vector_operand<T>;
+
+    static type wrap(const sc::vector<T> &vec)
+    {
+        return type(vec);
+    }
+};
+
+template <typename E>
+struct expr_operand<E, typename std::enable_if<std::is_base_of<vector_expression<E>, E>::value>::type>
+{
+    static constexpr bool is_operand = true;
+    static constexpr bool is_sequence = true;
+    using type = E;
+
+    static const E &wrap(const E &expr)
+    {
+        return expr;
+    }
+};
+
+template <typename T>
+struct expr_operand<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+{
+    static constexpr bool is_operand = true;
+    static constexpr bool is_sequence = false;
+    using type = scalar_operand<T>;
+
+    static type wrap(T value)
+    {
+        return type(value);
+    }
+};
+
+/// Result of `Op` on `L` and `R`, when at least one of them is a sequence and both are operands.
+template <typename Op, typename L, typename R>
+using enable_binary = typename std::enable_if<
+    expr_operand<L>::is_operand && expr_operand<R>::is_operand &&
+        (expr_operand<L>::is_sequence || expr_operand<R>::is_sequence),
+    binary_expression<Op, typename expr_operand<L>::type, typename expr_operand<R>::type>>::type;
+
+/// `R` when a vector of `T` can be updated in place with the operand `X`.
+template <typename T, typename X, typename R>
+using enable_compound =
+    typename std::enable_if<expr_operand<sc::vector<T>>::is_operand && expr_operand<X>::is_operand, R>::type;
+
+/// Result of `Op` on `X`, when it is a sequence.
+template <typename Op, typename X>
+using enable_unary =
+    typename std::enable_if<expr_operand<X>::is_sequence, unary_expression<Op, typename expr_operand<X>::type>>::type;
+
+/// Element type of the sequence `X`, when it is one.
+template <typename X>
+using enable_reduction =
+    typename std::enable_if<expr_operand<X>::is_sequence, typename expr_operand<X>::type::value_type>::type;
+
+/// Builds the binary expression of `Op` on `l` and `r`.
+template <typename Op, typename L, typename R>
+enable_binary<Op, L, R> make_binary(const L &l, const R &r)
+{
+    return enable_binary<Op, L, R>(expr_operand<L>::wrap(l), expr_operand<R>::wrap(r));
+}
+
+/// Folds the elements of `expr` in [first, last) with `op`. Sixteen independent partial results let
+/// the loop vectorize, a whole register of them per step even with AVX-512; `op` must therefore be
+/// associative and commutative.
+template <typename E, typename Op>
+typename E::value_type fold(const E &expr, unsigned long first, unsigned long last, Op op)
+{
+    using value_type = typename E::value_type;
+    const int LANES = 16;
+    if (last - first < 2 * LANES)
+    {
+        value_type result = expr[first];
+        for (unsigned long i = first + 1; i < last; i++)
+            result = op(result, expr[i]);
+        return result;
+    }
+
+    value_type acc[LANES];
+    for (int lane = 0; lane < LANES; lane++)
+        acc[lane] = expr[first + lane];
+    unsigned long blocks = (last - first) / LANES;
+    for (unsigned long b = 1; b < blocks; b++)
+        for (int lane = 0; lane < LANES; lane++)
+            acc[lane] = op(acc[lane], expr[first + b * LANES + lane]);
+
+    value_type result = acc[0];
+    for (int lane = 1; lane < LANES; lane++)
+        result = op(result, acc[lane]);
+    for (unsigned long i = first + blocks * LANES; i < last; i++)
+        result = op(result, expr[i]);
+    return result;
+}
+
+/// Folds all the elements of `expr` with `op`, splitting large expressions among threads; `expr` must not be empty.
+template <typename E, typename Op>
+typename E::value_type fold(const E &expr, Op op)
+{
+    using value_type = typename E::value_type;
+    unsigned long workers = parallel_workers(expr.size());
+    if (workers == 1)
+        return fold(expr, 0, expr.size(), op);
+
+    sc::vector<value_type> partial;
+    partial.resize(workers);
+    value_type *results = partial.data();
+    parallel_for(expr.size(), [&](unsigned long first, unsigned long last, unsigned long worker) {
+        results[worker] = fold(expr, first, last, op);
+    });
+    value_type result = results[0];
+    for (unsigned long w = 1; w < workers; w++)
+        result = op(result, results[w]);
+    return result;
+}
+
+struct expr_min
+{
+    template <typename A>
+    A operator()(A a, A b) const
+    {
+        return b < a ? b : a;
+    }
+};
+
+struct expr_max
+{
+    template <typename A>
+    A operator()(A a, A b) const
+    {
+        return a < b ? b : a;
+    }
+};
+} // namespace detail
+
+//=== Operators
+/// Elementwise sum; either side may be a scalar.
+template <typename L, typename R>
+detail::enable_binary<detail::expr_add, L, R> operator+(const L &l, const R &r)
+{
+    return detail::make_binary<detail::expr_add>(l, r);
+}
+
+/// Elementwise difference; either side may be a scalar.
+template <typename L, typename R>
+detail::enable_binary<detail::expr_subtract, L, R> operator-(const L &l, const R &r)
+{
+    return detail::make_binary<detail::expr_subtract>(l, r);
+}
+
+/// Elementwise product; either side may be a scalar.
+template <typename L, typename R>
+detail::enable_binary<detail::expr_multiply, L, R> operator*(const L &l, const R &r)
+{
+    return detail::make_binary<detail::expr_multiply>(l, r);
+}
+
+/// Elementwise quotient; either side may be a scalar.
+template <typename L, typename R>
+detail::enable_binary<detail::expr_divide, L, R> operator/(const L &l, const R &r)
+{
+    return detail::make_binary<detail::expr_divide>(l, r);
+}
+
+/// Elementwise negation.
+template <typename X>
+detail::enable_unary<detail::expr_negate, X> operator-(const X &x)
+{
+    return detail::enable_unary<detail::expr_negate, X>(detail::expr_operand<X>::wrap(x));
+}
+
+/// Adds `r` (a vector, an expression or a scalar) to every element of `vec`, in one pass.
+template <typename T, typename R>
+detail::enable_compound<T, R, sc::vector<T> &> operator+=(sc::vector<T> &vec, const R &r)
+{
+    return vec = vec + r;
+}
+
+/// Subtracts `r` (a vector, an expression or a scalar) from every element of `vec`, in one pass.
+template <typename T, typename R>
+detail::enable_compound<T, R, sc::vector<T> &> operator-=(sc::vector<T> &vec, const R &r)
+{
+    return vec = vec - r;
+}
+
+/// Multiplies every element of `vec` by `r` (a vector, an expression or a scalar), in one pass.
+template <typename T, typename R>
+detail::enable_compound<T, R, sc::vector<T> &> operator*=(sc::vector<T> &vec, const R &r)
+{
+    return vec = vec * r;
+}
+
+/// Divides every element of `vec` by `r` (a vector, an expression or a scalar), in one pass.
+template <typename T, typename R>
+detail::enable_compound<T, R, sc::vector<T> &> operator/=(sc::vector<T> &vec, const R &r)
+{
+    return vec = vec / r;
+}
+
+//=== Reductions
+// Each takes a vector of numbers or an expression and computes its result in the same single pass
+// that would evaluate the expression, without storing it. The elements are combined in an
+// unspecified order, so floating-point results may differ from a left-to-right loop in the last bits.
+
+/// Returns the sum of the elements, or zero if there are none.
+template <typename X>
+detail::enable_reduction<X> sum(const X &x)
+{
+    using value_type = detail::enable_reduction<X>;
+    auto expr = detail::expr_operand<X>::wrap(x);
+    return expr.size() == 0 ? value_type() : detail::fold(expr, detail::expr_add());
+}
+
+/// Returns the sum of the products of the elements of `x` and `y` at the same positions.
+template <typename X, typename Y>
+auto dot(const X &x, const Y &y) -> decltype(sum(x * y))
+{
+    return sum(x * y);
+}
+
+/// Returns the smallest element; there must be at least one.
+template <typename X>
+detail::enable_reduction<X> min(const X &x)
+{
+    auto expr = detail::expr_operand<X>::wrap(x);
+    SC_VECTOR_REQUIRE(expr.size() > 0, "min() of an empty sequence");
+    return detail::fold(expr, detail::expr_min());
+}
+
+/// Returns the largest element; there must be at least one.
+template <typename X>
+detail::enable_reduction<X> max(const X &x)
+{
+    auto expr = detail::expr_operand<X>::wrap(x);
+    SC_VECTOR_REQUIRE(expr.size() > 0, "max() of an empty sequence");
+    return detail::fold(expr, detail::expr_max());
+}
+} // namespace sc
+
+#endif
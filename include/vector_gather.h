@@ -0,0 +1,252 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Indexed bulk access used by sc::vector::gather, scatter, permute and permuted.
+ *
+ * gather() reads `source[indices[i]]` into `out[i]`, scatter() writes `values[i]` to
+ * `target[indices[i]]`, and permute() reorders an array in place so that slot i receives the
+ * element that was at `order[i]`. With AVX2, gathers of 4- or 8-byte trivially copyable elements
+ * through 4- or 8-byte indices load a whole register per instruction. That only pays while the
+ * source fits in the caches. Beyond SC_VECTOR_GATHER_PREFETCH_BYTES every access misses, and scalar
+ * loops that prefetch the element a few dozen indices ahead keep more misses in flight. Scatter has
+ * no AVX2 instruction and always takes the scalar loop.
+ *
+ * gather() and scatter() take a thread count: 1 (the default) runs on the calling thread, 0 uses
+ * every hardware thread, and ranges below SC_VECTOR_PARALLEL_THRESHOLD indices always run on the
+ * calling thread. Only trivially copyable elements, whose copies cannot throw, are split among
+ * threads. A scatter on several threads needs distinct indices: two threads writing the same slot
+ * would race.
+ */
+#ifndef VECTOR_GATHER_H
+#define VECTOR_GATHER_H
+
+#include <algorithm>   // std::min
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <memory>      // std::unique_ptr
+#include <thread>      // std::thread::hardware_concurrency
+#include <type_traits> // std::is_trivially_copyable, std::is_integral
+#include <utility>     // std::move
+
+#include "./vector_config.h"
+#include "./vector_threads.h"
+
+#ifdef __AVX2__
+#include <immintrin.h> // _mm256_i32gather_epi32, _mm256_i64gather_epi64, ...
+#endif
+
+namespace sc
+{
+namespace indexed
+{
+namespace detail
+{
+/// Checks that every one of the `count` indices is below `bound`. Compiled out in release mode: an
+/// assumption per index tells the kernels nothing, and GCC would still keep the pass over them.
+template <typename Index>
+void require_indices(const Index *indices, std::size_t count, std::size_t bound)
+{
+#if SC_VECTOR_CHECKS >= 1
+    for (std::size_t i = 0; i < count; i++)
+        SC_VECTOR_REQUIRE(static_cast<std::size_t>(indices[i]) < bound, "index out of range");
+#endif
+    (void)indices;
+    (void)count;
+    (void)bound;
+}
+
+/// Runs `work(first, last)` over [0, count), split among `threads` threads (0: one per hardware
+/// thread) when `count` reaches SC_VECTOR_PARALLEL_THRESHOLD.
+template <typename Work>
+void split(std::size_t count, unsigned threads, Work work)
+{
+    std::size_t workers = threads == 0 ? std::thread::hardware_concurrency() : threads;
+    if (count < SC_VECTOR_PARALLEL_THRESHOLD || workers <= 1)
+        return work(std::size_t(0), count);
+
+    std::size_t per_worker = (count + workers - 1) / workers;
+    sc::detail::thread_group pool(workers - 1);
+    for (std::size_t first = per_worker; first < count; first += per_worker)
+        pool.start(work, first, std::min(count, first + per_worker));
+    work(std::size_t(0), std::min(count, per_worker));
+    pool.join();
+}
+
+/// Loads `source[indices[i]]` into `out[i]` for i in [first, last), prefetching ahead when asked.
+template <typename T, typename Index>
+void gather_scalar(const T *source, const Index *indices, std::size_t first, std::size_t last, T *out, bool prefetch)
+{
+    std::size_t i = first;
+    if (prefetch)
+        for (; i + SC_VECTOR_GATHER_PREFETCH_DISTANCE < last; i++)
+        {
+            SC_VECTOR_PREFETCH(source + indices[i + SC_VECTOR_GATHER_PREFETCH_DISTANCE]);
+            out[i] = source[indices[i]];
+        }
+    for (; i < last; i++)
+        out[i] = source[indices[i]];
+}
+
+/// One AVX2 gather step for elements of `Element` bytes read through indices of `Index` bytes.
+template <std::size_t Element, std::size_t Index>
+struct simd_gather
+{
+    static const std::size_t LANES = 0; //!< Elements per step; 0 when there is no instruction.
+};
+
+#ifdef __AVX2__
+template <>
+struct simd_gather<4, 4>
+{
+    static const std::size_t LANES = 8;
+    static void step(const void *source, const void *indices, void *out)
+    {
+        __m256i index = _mm256_loadu_si256(static_cast<const __m256i *>(indices));
+        _mm256_storeu_si256(static_cast<__m256i *>(out), _mm256_i32gather_epi32(static_cast<const int *>(source), index, 4));
+    }
+};
+
+template <>
+struct simd_gather<4, 8>
+{
+    static const std::size_t LANES = 4;
+    static void step(const void *source, const void *indices, void *out)
+    {
+        __m256i index = _mm256_loadu_si256(static_cast<const __m256i *>(indices));
+        _mm_storeu_si128(static_cast<__m128i *>(out), _mm256_i64gather_epi32(static_cast<const int *>(source), index, 4));
+    }
+};
+
+template <>
+struct simd_gather<8, 4>
+{
+    static const std::size_t LANES = 4;
+    static void step(const void *source, const void *indices, void *out)
+    {
+        __m128i index = _mm_loadu_si128(static_cast<const __m128i *>(indices));
+        _mm256_storeu_si256(static_cast<__m256i *>(out),
+                            _mm256_i32gather_epi64(static_cast<const long long *>(source), index, 8));
+    }
+};
+
+template <>
+struct simd_gather<8, 8>
+{
+    static const std::size_t LANES = 4;
+    static void step(const void *source, const void *indices, void *out)
+    {
+        __m256i index = _mm256_loadu_si256(static_cast<const __m256i *>(indices));
+        _mm256_storeu_si256(static_cast<__m256i *>(out),
+                            _mm256_i64gather_epi64(static_cast<const long long *>(source), index, 8));
+    }
+};
+#endif
+
+/// True when T gathered through Index can use simd_gather.
+template <typename T, typename Index>
+struct gatherable : std::integral_constant<bool, std::is_trivially_copyable<T>::value && std::is_integral<Index>::value &&
+                                                     simd_gather<sizeof(T), sizeof(Index)>::LANES != 0>
+{
+};
+
+/// Gathers whole registers from `first` on and returns where the scalar tail starts.
+template <typename T, typename Index>
+std::size_t gather_simd(const T *source, const Index *indices, std::size_t first, std::size_t last, T *out, std::true_type)
+{
+    typedef simd_gather<sizeof(T), sizeof(Index)> kernel;
+    for (; first + kernel::LANES <= last; first += kernel::LANES)
+        kernel::step(source, indices + first, out + first);
+    return first;
+}
+
+template <typename T, typename Index>
+std::size_t gather_simd(const T *, const Index *, std::size_t first, std::size_t, T *, std::false_type)
+{
+    return first;
+}
+
+/// Gathers [first, last) of the indices, picking the kernel from the source size.
+template <typename T, typename Index>
+void gather_range(const T *source, std::size_t size, const Index *indices, std::size_t first, std::size_t last, T *out)
+{
+    bool prefetch = size * sizeof(T) >= SC_VECTOR_GATHER_PREFETCH_BYTES;
+    // 32-bit gather indices are signed, so they only reach the first 2^31 elements.
+    if (!prefetch && (sizeof(Index) == 8 || size <= 0x7FFFFFFFUL))
+        first = gather_simd(source, indices, first, last, out, gatherable<T, Index>());
+    gather_scalar(source, indices, first, last, out, prefetch);
+}
+} // namespace detail
+
+/// Sets `out[i] = source[indices[i]]` for the `count` indices; every index must be below `size`.
+/// `out` must not overlap the source or the indices.
+template <typename T, typename Index>
+void gather(const T *source, std::size_t size, const Index *indices, std::size_t count, T *out, unsigned threads = 1)
+{
+    detail::require_indices(indices, count, size);
+    detail::split(count, std::is_trivially_copyable<T>::value ? threads : 1,
+                  [=](std::size_t first, std::size_t last) { detail::gather_range(source, size, indices, first, last, out); });
+}
+
+/// Sets `target[indices[i]] = values[i]` for the `count` indices; every index must be below `size`.
+/// On one thread a repeated index keeps its last value. With `threads` other than 1 the indices must
+/// be distinct, as two threads writing the same slot would race.
+template <typename T, typename Index>
+void scatter(const Index *indices, std::size_t count, const T *values, T *target, std::size_t size, unsigned threads = 1)
+{
+    detail::require_indices(indices, count, size);
+    bool prefetch = size * sizeof(T) >= SC_VECTOR_GATHER_PREFETCH_BYTES;
+    detail::split(count, std::is_trivially_copyable<T>::value ? threads : 1, [=](std::size_t first, std::size_t last) {
+        std::size_t i = first;
+        if (prefetch)
+            for (; i + SC_VECTOR_GATHER_PREFETCH_DISTANCE < last; i++)
+            {
+                SC_VECTOR_PREFETCH_WRITE(target + indices[i + SC_VECTOR_GATHER_PREFETCH_DISTANCE]);
+                target[indices[i]] = values[i];
+            }
+        for (; i < last; i++)
+            target[indices[i]] = values[i];
+    });
+}
+
+/**
+ * Reorders the `count` elements at `data` in place so that slot i receives the element that was at
+ * `order[i]`; `order` must be a permutation of [0, count). Each cycle of the permutation is walked
+ * once from its lowest slot (cycle-leader), moving every element exactly once; a bitmap of
+ * count / 8 bytes records the slots already placed. If a move throws, the elements are left in a
+ * valid but unspecified order.
+ */
+template <typename T, typename Index>
+void permute(T *data, std::size_t count, const Index *order)
+{
+    detail::require_indices(order, count, count);
+    std::unique_ptr<std::uint64_t[]> placed(new std::uint64_t[(count + 63) / 64]());
+    for (std::size_t start = 0; start < count; start++)
+    {
+        if ((placed[start / 64] >> (start % 64)) & 1)
+            continue;
+
+        T saved(std::move(data[start]));
+        std::size_t slot = start;
+        for (;;)
+        {
+            placed[slot / 64] |= std::uint64_t(1) << (slot % 64);
+            std::size_t from = static_cast<std::size_t>(order[slot]);
+            if (from == start)
+            {
+                data[slot] = std::move(saved);
+                break;
+            }
+            SC_VECTOR_REQUIRE(((placed[from / 64] >> (from % 64)) & 1) == 0, "order is not a permutation");
+            data[slot] = std::move(data[from]);
+            slot = from;
+        }
+    }
+}
+} // namespace indexed
+} // namespace sc
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Hashing of vector contents.
+ *
+ * Vectors of integers, enums and pointers are hashed as one block of bytes, 64 bytes per step,
+ * with the accumulate/scramble scheme of XXH3: eight 64-bit lanes each add a 32x32-bit product of
+ * the input mixed with a key, which AVX2 does four lanes per instruction. Other element types are
+ * hashed one element at a time through std::hash and combined. The values are not those of the
+ * reference XXH3 and may change between versions; do not persist them.
+ *
+ * With SC_VECTOR_FINGERPRINT defined, sc::vector also keeps a fingerprint of its contents, a sum
+ * of one term per (position, element), which push_back and pop_back update in constant time;
+ * see vector.h.
+ */
+#ifndef VECTOR_HASH_H
+#define VECTOR_HASH_H
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <cstring>     // std::memcpy
+#include <functional>  // std::hash
+#include <type_traits> // std::is_integral, std::is_enum, std::is_pointer
+
+#include "./vector_config.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace sc
+{
+template <typename T>
+class vector;
+
+namespace detail
+{
+constexpr std::uint64_t HASH_PRIME_1 = 0x9E3779B185EBCA87ULL; //!< Multipliers borrowed from XXH64/XXH3.
+constexpr std::uint64_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t HASH_PRIME_3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t HASH_PRIME32 = 0x9E3779B1ULL;
+
+/// Per-lane keys xored into the input before it is multiplied.
+constexpr std::uint64_t HASH_KEYS[8] = {0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL,
+                                        0x1f67b3b7a4a44072ULL, 0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL,
+                                        0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL};
+
+/// Elements whose equality is equality of their bytes, so a vector of them can be hashed as raw memory.
+/// Floating point is left out: 0.0 == -0.0 and NaN != NaN.
+template <typename T>
+struct is_bytewise_hashable
+    : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value>
+{
+};
+
+/// Final mix that spreads every input bit over the whole result (the SplitMix64 finalizer).
+SC_CONSTEXPR14 std::uint64_t hash_mix(std::uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/// Multiplies `a` by `b` into 128 bits and folds the halves together.
+inline std::uint64_t mul128_fold(std::uint64_t a, std::uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+    std::uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    std::uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+    std::uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+    std::uint64_t hi_hi = (a >> 32) * (b >> 32);
+    std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    std::uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    std::uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return lower ^ upper;
+#endif
+}
+
+/// Reads 8 bytes at any alignment.
+inline std::uint64_t read64(const unsigned char *p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/// Adds one 64-byte stripe into the eight accumulators.
+inline void hash_accumulate(std::uint64_t *acc, const unsigned char *p)
+{
+#if defined(__AVX2__)
+    for (int half = 0; half < 2; half++)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + 4 * half));
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32 * half));
+        __m256i key = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(HASH_KEYS + 4 * half)));
+        __m256i product = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));
+        a = _mm256_add_epi64(a, _mm256_shuffle_epi32(data, 0x4E)); // lane i receives the input of lane i ^ 1
+        a = _mm256_add_epi64(a, product);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + 4 * half), a);
+    }
+#else
+    for (int i = 0; i < 8; i++)
+    {
+        std::uint64_t data = read64(p + 8 * i);
+        std::uint64_t key = data ^ HASH_KEYS[i];
+        acc[i ^ 1] += data;
+        acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+    }
+#endif
+}
+
+/// Stirs the high bits of the accumulators back into the low bits the next products read.
+inline void hash_scramble(std::uint64_t *acc)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        std::uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= HASH_KEYS[7 - i];
+        acc[i] = a * HASH_PRIME32;
+    }
+}
+
+/// Hashes `length` bytes at `bytes`.
+inline std::uint64_t hash_bytes(const void *bytes, std::size_t length, std::uint64_t seed = 0)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(bytes);
+    std::uint64_t h = seed ^ (length * HASH_PRIME_1);
+
+    if (length <= 16)
+    {
+        unsigned char padded[16] = {};
+        if (length > 0)
+            std::memcpy(padded, p, length);
+        h = mul128_fold(read64(padded) ^ HASH_KEYS[0] ^ seed, read64(padded + 8) ^ HASH_KEYS[1] ^ h);
+        return hash_mix(h);
+    }
+
+    if (length <= 128)
+    {
+        // 16-byte pieces from both ends; the middle ones overlap when the length is not a multiple of 16.
+        for (std::size_t i = 0; i < (length + 31) / 32; i++)
+        {
+            const unsigned char *front = p + 16 * i, *back = p + length - 16 * (i + 1);
+            h += mul128_fold(read64(front) ^ HASH_KEYS[2 * (i % 4)], read64(front + 8) ^ HASH_KEYS[2 * (i % 4) + 1]);
+            h += mul128_fold(read64(back) ^ HASH_KEYS[7 - 2 * (i % 4)], read64(back + 8) ^ HASH_KEYS[6 - 2 * (i % 4)]);
+        }
+        return hash_mix(h);
+    }
+
+    std::uint64_t acc[8] = {HASH_PRIME32, HASH_PRIME_1, HASH_PRIME_2, HASH_PRIME_3,
+                            seed,         HASH_PRIME_2, HASH_PRIME_1, HASH_PRIME32};
+    const std::size_t STRIPE = 64, STRIPES_PER_BLOCK = 16;
+
+    std::size_t stripes = (length - 1) / STRIPE; // the last stripe, full or not, is read from the end
+    for (std::size_t s = 0; s < stripes; s++)
+    {
+        hash_accumulate(acc, p + s * STRIPE);
+        if (s % STRIPES_PER_BLOCK == STRIPES_PER_BLOCK - 1)
+            hash_scramble(acc);
+    }
+    hash_accumulate(acc, p + length - STRIPE);
+
+    for (int i = 0; i < 8; i += 2)
+        h += mul128_fold(acc[i] ^ HASH_KEYS[i], acc[i + 1] ^ HASH_KEYS[i + 1]);
+    return hash_mix(h);
+}
+
+/// Hash of a single element, for the fingerprint of sc::vector.
+template <typename T>
+SC_CONSTEXPR14 typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, std::uint64_t>::type
+element_hash(const T &value)
+{
+    return static_cast<std::uint64_t>(value);
+}
+
+/// Hash of a single element, for the fingerprint of sc::vector.
+template <typename T>
+typename std::enable_if<not(std::is_integral<T>::value || std::is_enum<T>::value), std::uint64_t>::type
+element_hash(const T &value)
+{
+    return std::hash<T>()(value);
+}
+
+/// Contribution of `value` at `position` to the fingerprint of a vector; the fingerprint is the sum of these.
+template <typename T>
+SC_CONSTEXPR14 std::uint64_t fingerprint_term(std::size_t position, const T &value)
+{
+    return hash_mix(element_hash(value) + (position + 1) * HASH_PRIME_1);
+}
+} // namespace detail
+} // namespace sc
+
+namespace std
+{
+/// Hashes the elements of an sc::vector: as one block of bytes when they are integers, enums or
+/// pointers, otherwise by combining std::hash of each element.
+template <typename T>
+struct hash<sc::vector<T>>
+{
+    std::size_t operator()(const sc::vector<T> &vec) const
+    {
+        return apply(vec, sc::detail::is_bytewise_hashable<T>());
+    }
+
+private:
+    static std::size_t apply(const sc::vector<T> &vec, std::true_type)
+    {
+        return std::size_t(sc::detail::hash_bytes(vec.data(), vec.size() * sizeof(T)));
+    }
+
+    static std::size_t apply(const sc::vector<T> &vec, std::false_type)
+    {
+        std::uint64_t h = vec.size() * sc::detail::HASH_PRIME_1;
+        for (unsigned long i = 0; i < vec.size(); i++)
+            h = sc::detail::hash_mix(h ^ std::hash<T>()(vec.data()[i]));
+        return std::size_t(h);
+    }
+};
+} // namespace std
+
+#endif
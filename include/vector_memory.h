@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Memory accounting used by sc::vector::memory_usage.
+ *
+ * The figures are the bytes a container asked its allocator for, not what the allocator reserved
+ * for them (size-class rounding, headers, the buffer pool's free lists), so they are the same on
+ * every run and every platform with the same type sizes. An element counts what it owns when it
+ * has a memory_usage() member of its own (nested sc::vectors, or any type that opts in) or when it
+ * is a std::basic_string whose characters live outside the string object.
+ */
+#ifndef VECTOR_MEMORY_H
+#define VECTOR_MEMORY_H
+
+#include <cstddef>     // std::size_t
+#include <string>      // std::basic_string
+#include <type_traits> // std::integral_constant, std::declval
+#include <utility>     // std::declval
+
+namespace sc
+{
+namespace detail
+{
+/// True when T has a `memory_usage()` member that accounts for its own footprint.
+template <typename T, typename = void>
+struct has_memory_usage : std::false_type
+{
+};
+
+template <typename T>
+struct has_memory_usage<T, decltype(void(std::declval<const T &>().memory_usage()))> : std::true_type
+{
+};
+
+template <typename T>
+struct is_basic_string : std::false_type
+{
+};
+
+template <typename C, typename Traits, typename Alloc>
+struct is_basic_string<std::basic_string<C, Traits, Alloc>> : std::true_type
+{
+};
+
+/// True when elements of type T may own memory outside their own bytes, which memory_usage()
+/// then has to visit one by one.
+template <typename T>
+struct owns_memory : std::integral_constant<bool, has_memory_usage<T>::value || is_basic_string<T>::value>
+{
+};
+
+/// Bytes owned by `value` beyond sizeof(T), through its own memory_usage().
+template <typename T>
+std::size_t owned_bytes(const T &value)
+{
+    return static_cast<std::size_t>(value.memory_usage()) - sizeof(T);
+}
+
+/// Bytes of the character buffer of `value`, or 0 while its characters fit in the string object.
+template <typename C, typename Traits, typename Alloc>
+std::size_t owned_bytes(const std::basic_string<C, Traits, Alloc> &value)
+{
+    const char *chars = reinterpret_cast<const char *>(value.data());
+    const char *object = reinterpret_cast<const char *>(&value);
+    if (chars >= object && chars < object + sizeof(value))
+        return 0;
+    return (value.capacity() + 1) * sizeof(C);
+}
+
+/// Sum of owned_bytes over the `count` elements at `data`; nothing to visit for other types.
+template <typename T>
+std::size_t owned_bytes(const T *data, std::size_t count, std::true_type)
+{
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < count; i++)
+        bytes += owned_bytes(data[i]);
+    return bytes;
+}
+
+template <typename T>
+std::size_t owned_bytes(const T *, std::size_t, std::false_type)
+{
+    return 0;
+}
+} // namespace detail
+} // namespace sc
+
+#endif
@@ -0,0 +1,369 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Per-thread recycling of vector buffers.
+ *
+ * With SC_VECTOR_POOL defined, sc::vector takes its buffers from here instead of new[]. Sizes are
+ * rounded up to size classes, four per power of two, so the rounding never wastes more than a
+ * quarter. Each thread keeps a free list per class. A freed buffer goes back to the free list of
+ * the thread that allocated it: directly when that thread frees it, or through the owner's return
+ * stack (lock-free, drained by the owner when a free list runs dry) when another thread does. Once
+ * a program has reached its working set, allocating and freeing vectors makes no malloc calls.
+ *
+ * A thread caches at most its retention limit (SC_VECTOR_POOL_RETAIN bytes unless changed with
+ * set_retention_limit); buffers freed beyond it, and buffers larger than SC_VECTOR_POOL_MAX_BYTES,
+ * go straight back to the system. When a thread exits its cache is released and kept for the next
+ * thread that starts, so buffers still in use elsewhere always have a cache to return to.
+ */
+#ifndef VECTOR_POOL_H
+#define VECTOR_POOL_H
+
+#include <atomic>      // std::atomic
+#include <cstddef>     // std::size_t, std::max_align_t
+#include <cstdint>     // std::uint32_t
+#include <mutex>       // std::mutex, std::lock_guard
+#include <new>         // ::operator new, ::operator delete
+#include <type_traits> // std::integral_constant
+
+#include "./vector_config.h"
+
+#ifndef SC_VECTOR_POOL_MAX_BYTES
+/// Largest buffer, in bytes, that is recycled; larger ones are allocated and freed directly.
+#define SC_VECTOR_POOL_MAX_BYTES (1UL << 20)
+#endif
+
+#ifndef SC_VECTOR_POOL_RETAIN
+/// Default number of bytes of free buffers each thread keeps.
+#define SC_VECTOR_POOL_RETAIN (16UL << 20)
+#endif
+
+namespace sc
+{
+namespace pool
+{
+/// Counters of a thread's cache, or of all of them.
+struct pool_stats
+{
+    unsigned long hits = 0;           //!< Allocations served from a free list.
+    unsigned long misses = 0;         //!< Allocations that had to call the system allocator.
+    unsigned long remote_frees = 0;   //!< Buffers returned by threads other than their owner.
+    unsigned long retained_bytes = 0; //!< Bytes held in free lists.
+
+    /// Fraction of the allocations served from a free list.
+    double hit_rate() const
+    {
+        return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses);
+    }
+};
+
+namespace detail
+{
+/// Bytes before each buffer; keeps the buffer aligned like the system allocator would.
+constexpr std::size_t HEADER = alignof(std::max_align_t) > 16 ? alignof(std::max_align_t) : 16;
+/// Size class of the buffers that are not recycled.
+constexpr std::uint32_t UNPOOLED = ~std::uint32_t(0);
+
+/// Returns the position of the highest set bit of a non-zero `n`.
+inline unsigned highest_bit(std::size_t n)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(63 - __builtin_clzll(static_cast<unsigned long long>(n)));
+#else
+    unsigned bit = 0;
+    while (n >>= 1)
+        bit++;
+    return bit;
+#endif
+}
+
+/// Returns the size class of a request of `bytes`: 64 bytes and below is class 0, then four
+/// classes per power of two.
+inline std::uint32_t size_class(std::size_t bytes)
+{
+    if (bytes <= 64)
+        return 0;
+    unsigned e = highest_bit(bytes - 1); // 2^e < bytes <= 2^(e + 1)
+    std::size_t quarter = std::size_t(1) << (e - 2);
+    return std::uint32_t((e - 6) * 4 + ((bytes - 1) - (std::size_t(1) << e)) / quarter + 1);
+}
+
+/// Returns the capacity of the buffers of size class `c`.
+inline std::size_t class_bytes(std::uint32_t c)
+{
+    if (c == 0)
+        return 64;
+    unsigned e = (c - 1) / 4 + 6;
+    return (std::size_t(1) << e) + ((c - 1) % 4 + 1) * (std::size_t(1) << (e - 2));
+}
+
+/// Number of size classes, enough for any SC_VECTOR_POOL_MAX_BYTES.
+constexpr std::uint32_t CLASSES = (64 - 6) * 4 + 1;
+
+struct thread_cache;
+
+/// Written in the HEADER bytes before every buffer.
+struct block_header
+{
+    thread_cache *owner; //!< Cache the buffer returns to, or nullptr if it is not recycled.
+    std::uint32_t klass; //!< Size class, or UNPOOLED.
+};
+
+static_assert(sizeof(block_header) <= HEADER, "the header must fit before the buffer");
+
+/// Link to the next buffer of a free list or of a return stack, kept in the first bytes of a free buffer.
+inline block_header *&next_of(block_header *block)
+{
+    return *reinterpret_cast<block_header **>(reinterpret_cast<unsigned char *>(block) + HEADER);
+}
+
+/// Free lists and counters of one thread.
+struct thread_cache
+{
+    block_header *FREE[CLASSES] = {};                   //!< Free buffers, per size class; touched by the owner only.
+    std::atomic<block_header *> RETURNED{nullptr};      //!< Buffers freed by other threads.
+    std::atomic<bool> ACTIVE{false};                    //!< Whether a running thread owns the cache.
+    unsigned long LIMIT = SC_VECTOR_POOL_RETAIN;        //!< Most bytes the free lists may hold.
+    std::atomic<unsigned long> HITS{0};                 //!< See pool_stats.
+    std::atomic<unsigned long> MISSES{0};               //!< See pool_stats.
+    std::atomic<unsigned long> REMOTE_FREES{0};         //!< See pool_stats.
+    std::atomic<unsigned long> RETAINED{0};             //!< See pool_stats.
+    thread_cache *NEXT_CACHE = nullptr;                 //!< Next cache in the registry.
+
+    /// Increments one of the counters; only the owner writes them, other threads only read.
+    static void bump(std::atomic<unsigned long> &counter, long delta = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    /// Keeps `block` in its free list if the limit allows, otherwise frees it.
+    void keep(block_header *block)
+    {
+        std::size_t bytes = class_bytes(block->klass);
+        if (RETAINED.load(std::memory_order_relaxed) + bytes > LIMIT)
+            return ::operator delete(block);
+        next_of(block) = FREE[block->klass];
+        FREE[block->klass] = block;
+        bump(RETAINED, long(bytes));
+    }
+
+    /// Moves the buffers other threads returned into the free lists.
+    void drain()
+    {
+        block_header *block = RETURNED.exchange(nullptr, std::memory_order_acquire);
+        while (block != nullptr)
+        {
+            block_header *next = next_of(block);
+            keep(block);
+            block = next;
+        }
+    }
+
+    /// Frees cached buffers until at most `keep_bytes` remain, largest classes first.
+    void trim(unsigned long keep_bytes)
+    {
+        drain();
+        for (std::uint32_t c = CLASSES; c-- > 0 && RETAINED.load(std::memory_order_relaxed) > keep_bytes;)
+            while (FREE[c] != nullptr && RETAINED.load(std::memory_order_relaxed) > keep_bytes)
+            {
+                block_header *block = FREE[c];
+                FREE[c] = next_of(block);
+                bump(RETAINED, -long(class_bytes(c)));
+                ::operator delete(block);
+            }
+    }
+};
+
+/// Every cache ever created. Caches are never destroyed: buffers may outlive the thread that
+/// allocated them, and their header keeps pointing at its cache.
+struct registry
+{
+    std::mutex LOCK;                 //!< Guards the list.
+    thread_cache *FIRST = nullptr;   //!< Head of the list.
+
+    /// Returns the registry; it is never destroyed, so vectors destroyed during exit can still use it.
+    static registry &instance()
+    {
+        static registry *INSTANCE = new registry();
+        return *INSTANCE;
+    }
+
+    /// Hands an inactive cache to the calling thread, creating one if all are in use.
+    thread_cache *acquire()
+    {
+        std::lock_guard<std::mutex> guard(LOCK);
+        for (thread_cache *cache = FIRST; cache != nullptr; cache = cache->NEXT_CACHE)
+            if (not cache->ACTIVE.load(std::memory_order_acquire))
+            {
+                cache->ACTIVE.store(true, std::memory_order_relaxed);
+                return cache;
+            }
+        thread_cache *cache = new thread_cache();
+        cache->ACTIVE.store(true, std::memory_order_relaxed);
+        cache->NEXT_CACHE = FIRST;
+        FIRST = cache;
+        return cache;
+    }
+};
+
+/// Cache of the calling thread, or nullptr before its first allocation and after it has exited.
+inline thread_cache *&current_cache()
+{
+    static thread_local thread_cache *CURRENT = nullptr;
+    return CURRENT;
+}
+
+/// Gives the cache of a thread up when the thread exits.
+struct cache_owner
+{
+    thread_cache *CACHE = nullptr; //!< The cache, once the thread has one.
+    bool EXITED = false;           //!< Set when the thread is exiting.
+
+    ~cache_owner()
+    {
+        EXITED = true;
+        current_cache() = nullptr;
+        if (CACHE == nullptr)
+            return;
+        CACHE->trim(0);
+        CACHE->LIMIT = SC_VECTOR_POOL_RETAIN;
+        CACHE->ACTIVE.store(false, std::memory_order_release);
+    }
+};
+
+/// Returns the cache of the calling thread, acquiring one on first use, or nullptr while the thread exits.
+inline thread_cache *local_cache()
+{
+    thread_cache *cache = current_cache();
+    if (cache != nullptr)
+        return cache;
+
+    static thread_local cache_owner OWNER;
+    if (OWNER.EXITED)
+        return nullptr;
+    OWNER.CACHE = registry::instance().acquire();
+    current_cache() = OWNER.CACHE;
+    return OWNER.CACHE;
+}
+} // namespace detail
+
+/// Returns a buffer of at least `bytes` bytes, aligned like ::operator new, from the calling thread's cache.
+inline void *allocate(std::size_t bytes)
+{
+    detail::thread_cache *cache = bytes <= SC_VECTOR_POOL_MAX_BYTES ? detail::local_cache() : nullptr;
+    detail::block_header *block;
+    if (cache == nullptr)
+    {
+        block = static_cast<detail::block_header *>(::operator new(detail::HEADER + bytes));
+        block->owner = nullptr;
+        block->klass = detail::UNPOOLED;
+    }
+    else
+    {
+        std::uint32_t c = detail::size_class(bytes);
+        if (cache->FREE[c] == nullptr && cache->RETURNED.load(std::memory_order_relaxed) != nullptr)
+            cache->drain();
+
+        block = cache->FREE[c];
+        if (block != nullptr)
+        {
+            cache->FREE[c] = next_of(block);
+            detail::thread_cache::bump(cache->RETAINED, -long(detail::class_bytes(c)));
+            detail::thread_cache::bump(cache->HITS);
+        }
+        else
+        {
+            block = static_cast<detail::block_header *>(::operator new(detail::HEADER + detail::class_bytes(c)));
+            block->owner = cache;
+            block->klass = c;
+            detail::thread_cache::bump(cache->MISSES);
+        }
+    }
+    return reinterpret_cast<unsigned char *>(block) + detail::HEADER;
+}
+
+/// Returns a buffer obtained from allocate() to the cache of the thread that allocated it; any thread may call it.
+inline void deallocate(void *buffer)
+{
+    if (buffer == nullptr)
+        return;
+    detail::block_header *block =
+        reinterpret_cast<detail::block_header *>(static_cast<unsigned char *>(buffer) - detail::HEADER);
+    detail::thread_cache *owner = block->owner;
+    if (owner == nullptr)
+        return ::operator delete(block);
+
+    if (owner == detail::current_cache())
+        return owner->keep(block);
+
+    if (not owner->ACTIVE.load(std::memory_order_acquire))
+        return ::operator delete(block);
+
+    // Lock-free push onto the owner's return stack; the owner takes the whole stack at once.
+    detail::block_header *&next = detail::next_of(block);
+    next = owner->RETURNED.load(std::memory_order_relaxed);
+    while (not owner->RETURNED.compare_exchange_weak(next, block, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    owner->REMOTE_FREES.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Returns the counters of the calling thread's cache.
+inline pool_stats thread_stats()
+{
+    pool_stats stats;
+    if (detail::thread_cache *cache = detail::current_cache())
+    {
+        stats.hits = cache->HITS.load(std::memory_order_relaxed);
+        stats.misses = cache->MISSES.load(std::memory_order_relaxed);
+        stats.remote_frees = cache->REMOTE_FREES.load(std::memory_order_relaxed);
+        stats.retained_bytes = cache->RETAINED.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+/// Returns the counters summed over every cache, including those of exited threads.
+inline pool_stats global_stats()
+{
+    pool_stats stats;
+    detail::registry &registry = detail::registry::instance();
+    std::lock_guard<std::mutex> guard(registry.LOCK);
+    for (detail::thread_cache *cache = registry.FIRST; cache != nullptr; cache = cache->NEXT_CACHE)
+    {
+        stats.hits += cache->HITS.load(std::memory_order_relaxed);
+        stats.misses += cache->MISSES.load(std::memory_order_relaxed);
+        stats.remote_frees += cache->REMOTE_FREES.load(std::memory_order_relaxed);
+        stats.retained_bytes += cache->RETAINED.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+/// Frees the calling thread's cached buffers, keeping at most `keep_bytes` of them.
+inline void trim(unsigned long keep_bytes = 0)
+{
+    if (detail::thread_cache *cache = detail::current_cache())
+        cache->trim(keep_bytes);
+}
+
+/// Sets how many bytes of free buffers the calling thread keeps, and trims down to it.
+inline void set_retention_limit(unsigned long bytes)
+{
+    if (detail::thread_cache *cache = detail::local_cache())
+    {
+        cache->LIMIT = bytes;
+        cache->trim(bytes);
+    }
+}
+
+/// Whether vectors of `T` can live in pooled buffers: the pool aligns like ::operator new.
+template <typename T>
+struct is_poolable : std::integral_constant<bool, alignof(T) <= detail::HEADER>
+{
+};
+} // namespace pool
+} // namespace sc
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Owner of the worker threads started by the parallel algorithms.
+ *
+ * A thread_group joins every thread it started when it is joined or destroyed, including when an
+ * exception leaves the scope that started them: a std::thread destroyed while still joinable
+ * would call std::terminate, and a worker still running after its caller unwound would touch a
+ * dead stack frame.
+ */
+#ifndef VECTOR_THREADS_H
+#define VECTOR_THREADS_H
+
+#include <cstddef> // std::size_t
+#include <memory>  // std::unique_ptr
+#include <thread>  // std::thread
+#include <utility> // std::forward
+
+#include "./vector_config.h"
+
+namespace sc
+{
+namespace detail
+{
+/**
+ * @brief Fixed-size group of joined-on-exit threads
+ *
+ * Room for the threads is allocated up front, so start() either starts one more thread or throws
+ * with the group unchanged.
+ */
+class thread_group
+{
+public:
+    /// Creates a group with room for `capacity` threads.
+    explicit thread_group(std::size_t capacity) : THREADS(new std::thread[capacity]), CAPACITY(capacity), SIZE(0)
+    {
+    }
+
+    thread_group(const thread_group &) = delete;
+    thread_group &operator=(const thread_group &) = delete;
+
+    /// Joins the threads still running.
+    ~thread_group()
+    {
+        join();
+    }
+
+    /// Starts a thread running `fn(args...)`. If the thread cannot be started, throws std::system_error.
+    template <typename Function, typename... Args>
+    void start(Function &&fn, Args &&...args)
+    {
+        SC_VECTOR_REQUIRE(SIZE < CAPACITY, "thread_group::start() past the capacity");
+        THREADS[SIZE] = std::thread(std::forward<Function>(fn), std::forward<Args>(args)...);
+        SIZE++;
+    }
+
+    /// Waits for every started thread; the group can then start new ones.
+    void join()
+    {
+        for (std::size_t t = 0; t < SIZE; t++)
+            THREADS[t].join();
+        SIZE = 0;
+    }
+
+    /// Returns the number of threads started and not joined yet.
+    std::size_t size() const
+    {
+        return SIZE;
+    }
+
+private:
+    std::unique_ptr<std::thread[]> THREADS; //!< The threads; the first SIZE ones are running.
+    std::size_t CAPACITY;                   //!< Number of slots in THREADS.
+    std::size_t SIZE;                       //!< Number of threads started and not joined yet.
+};
+} // namespace detail
+} // namespace sc
+
+#endif
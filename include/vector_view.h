@@ -0,0 +1,611 @@
+/**
+ * @file
+ * @author Eduardo Sarmento <cealvesarmento@gmail.com> & Victor Vieira <victor@agenciaatwork.com>
+ * @version 1.0
+ *
+ * @section DESCRIPTION
+ *
+ * Non-owning views over the elements of a vector, and algorithms that accept them.
+ *
+ * A view is a pointer and a length (plus a stride or a chunk size); building or slicing one
+ * never copies or allocates. A view does not keep its vector alive and, like an iterator, is
+ * invalidated when the vector reallocates. In C++20 mode vector_view is a borrowed
+ * std::ranges::view, so `std::span<T> s = view;` works directly.
+ */
+#ifndef VECTOR_VIEW_H
+#define VECTOR_VIEW_H
+
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <functional>  // std::plus
+#include <iterator>    // std::random_access_iterator_tag
+#include <stdexcept>   // std::out_of_range
+#include <string>      // std::to_string
+#include <type_traits> // std::enable_if, std::is_convertible
+#include <utility>     // std::declval
+
+#include "./vector_config.h"
+#include "./MyIterator.h"
+
+#ifdef SC_VECTOR_HAS_CONCEPTS
+#include <ranges> // std::ranges::enable_borrowed_range
+#endif
+
+namespace sc
+{
+template <typename T>
+class strided_view;
+template <typename T>
+class chunked_view;
+
+/**
+ * @brief Contiguous non-owning view
+ *
+ * Refers to `size()` consecutive elements owned by someone else: an sc::vector, an
+ * sc::static_vector, a std::vector, a plain array... Use `vector_view<const T>` for read-only access.
+ */
+template <typename T>
+class vector_view
+{
+public:
+    using size_type = unsigned long;                          //!< The size type.
+    using value_type = typename std::remove_cv<T>::type;      //!< The value type.
+    using pointer = T *;                                      //!< Pointer to a viewed element.
+    using reference = T &;                                    //!< Reference to a viewed element.
+    using iterator = MyIterator<T>;                           //!< Iterator over the viewed elements.
+    using const_iterator = MyIterator<T>;                     //!< Views are shallow: constness comes from T.
+
+    /// Creates an empty view.
+    constexpr vector_view() : DATA(nullptr), SIZE(0)
+    {
+    }
+
+    /// Views `count` elements starting at `first`.
+    constexpr vector_view(pointer first, size_type count) : DATA(first), SIZE(count)
+    {
+    }
+
+    /// Views every element of `container`, which must expose `data()` and `size()`.
+    template <typename Container,
+              typename = typename std::enable_if<
+                  std::is_convertible<decltype(std::declval<Container &>().data()), pointer>::value>::type>
+    constexpr vector_view(Container &container) : DATA(container.data()), SIZE(container.size())
+    {
+    }
+
+    /// Converts a view of `U` to a view of `T`, e.g. `vector_view<int>` to `vector_view<const int>`.
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U *, pointer>::value>::type>
+    constexpr vector_view(const vector_view<U> &other) : DATA(other.data()), SIZE(other.size())
+    {
+    }
+
+    //=== [I] ITERATORS
+    /// Returns an iterator pointing to the first viewed element.
+    SC_CONSTEXPR14 iterator begin() const
+    {
+        return iterator(DATA);
+    }
+
+    /// Returns an iterator pointing just after the last viewed element.
+    SC_CONSTEXPR14 iterator end() const
+    {
+        return iterator(DATA + SIZE);
+    }
+
+    //=== [II] Capacity
+    /// Return the number of viewed elements.
+    constexpr size_type size() const
+    {
+        return SIZE;
+    }
+
+    /// Returns true if the view refers to no elements.
+    constexpr bool empty() const
+    {
+        return SIZE == 0;
+    }
+
+    //=== [III] Element access
+    /// Returns a pointer to the first viewed element.
+    constexpr pointer data() const
+    {
+        return DATA;
+    }
+
+    /// Returns the element at index pos, with no bounds-checking.
+    SC_CONSTEXPR14 reference operator[](size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return DATA[pos];
+    }
+
+    /// Returns the element at index pos, with bounds-checking.
+    SC_CONSTEXPR14 reference at(size_type pos) const
+    {
+        if (pos >= SIZE)
+            throw std::out_of_range(std::to_string(pos));
+        return DATA[pos];
+    }
+
+    /// Returns the first viewed element.
+    SC_CONSTEXPR14 reference front() const
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "front() on an empty view");
+        return DATA[0];
+    }
+
+    /// Returns the last viewed element.
+    SC_CONSTEXPR14 reference back() const
+    {
+        SC_VECTOR_REQUIRE(SIZE > 0, "back() on an empty view");
+        return DATA[SIZE - 1];
+    }
+
+    //=== [IV] Slicing
+    /// Returns the view of `count` elements starting at `offset`; `count` is clamped to the end of this view.
+    SC_CONSTEXPR14 vector_view subview(size_type offset, size_type count = size_type(-1)) const
+    {
+        if (offset > SIZE)
+            throw std::out_of_range(std::to_string(offset));
+        return vector_view(DATA + offset, count < SIZE - offset ? count : SIZE - offset);
+    }
+
+    /// Returns the view of the first `count` elements.
+    SC_CONSTEXPR14 vector_view first(size_type count) const
+    {
+        return subview(0, count);
+    }
+
+    /// Returns the view of the last `count` elements.
+    SC_CONSTEXPR14 vector_view last(size_type count) const
+    {
+        return subview(count < SIZE ? SIZE - count : 0);
+    }
+
+    /// Returns the view of every `stride`-th element, starting with the first one.
+    SC_CONSTEXPR14 strided_view<T> strided(size_type stride) const
+    {
+        SC_VECTOR_REQUIRE(stride > 0, "strided() needs a positive stride");
+        return strided_view<T>(DATA, SIZE == 0 ? 0 : (SIZE - 1) / stride + 1, stride);
+    }
+
+    /// Splits the view into consecutive views of `chunk` elements; the last one may be shorter.
+    SC_CONSTEXPR14 chunked_view<T> chunks(size_type chunk) const
+    {
+        SC_VECTOR_REQUIRE(chunk > 0, "chunks() needs a positive chunk size");
+        return chunked_view<T>(*this, chunk);
+    }
+
+private:
+    pointer DATA;   //!< First viewed element.
+    size_type SIZE; //!< Number of viewed elements.
+};
+
+/// Iterator over a strided_view. It keeps the view's first element and a step count, and only forms
+/// the address of the element it dereferences, so end() never points past the viewed array.
+template <typename T>
+class strided_iterator
+{
+public:
+    typedef std::ptrdiff_t difference_type;                    //!< Difference type used to calculated distance between iterators.
+    typedef typename std::remove_cv<T>::type value_type;       //!< Value type the iterator points to.
+    typedef T *pointer;                                        //!< Pointer to the value type.
+    typedef T &reference;                                      //!< Reference to the value type.
+    typedef std::random_access_iterator_tag iterator_category; //!< Iterator category.
+
+    /// Default constructor that creates an nullptr.
+    constexpr strided_iterator() : first(nullptr), index(0), stride(1)
+    {
+    }
+
+    /// Constructs an iterator on step `index` of the elements that start at `first`, `stride` elements apart.
+    constexpr strided_iterator(pointer first, difference_type index, difference_type stride)
+        : first(first), index(index), stride(stride)
+    {
+    }
+
+    /// Returns the element the iterator points to.
+    constexpr reference operator*() const
+    {
+        return first[index * stride];
+    }
+
+    /// Returns the element `n` steps after the one the iterator points to.
+    constexpr reference operator[](difference_type n) const
+    {
+        return first[(index + n) * stride];
+    }
+
+    /// Advances the iterator one step.
+    SC_CONSTEXPR14 strided_iterator &operator++()
+    {
+        ++index;
+        return *this;
+    }
+
+    /// Advances the iterator one step and returns itself before that.
+    SC_CONSTEXPR14 strided_iterator operator++(int)
+    {
+        strided_iterator temp = *this;
+        ++index;
+        return temp;
+    }
+
+    /// Backs the iterator one step.
+    SC_CONSTEXPR14 strided_iterator &operator--()
+    {
+        --index;
+        return *this;
+    }
+
+    /// Backs the iterator one step and returns itself before that.
+    SC_CONSTEXPR14 strided_iterator operator--(int)
+    {
+        strided_iterator temp = *this;
+        --index;
+        return temp;
+    }
+
+    /// Advances the iterator `n` steps.
+    SC_CONSTEXPR14 strided_iterator &operator+=(difference_type n)
+    {
+        index += n;
+        return *this;
+    }
+
+    /// Backs the iterator `n` steps.
+    SC_CONSTEXPR14 strided_iterator &operator-=(difference_type n)
+    {
+        index -= n;
+        return *this;
+    }
+
+    /// Returns an iterator `n` steps after `it`.
+    friend SC_CONSTEXPR14 strided_iterator operator+(strided_iterator it, difference_type n)
+    {
+        return it += n;
+    }
+
+    /// Returns an iterator `n` steps after `it`.
+    friend SC_CONSTEXPR14 strided_iterator operator+(difference_type n, strided_iterator it)
+    {
+        return it += n;
+    }
+
+    /// Returns an iterator `n` steps before `it`.
+    friend SC_CONSTEXPR14 strided_iterator operator-(strided_iterator it, difference_type n)
+    {
+        return it -= n;
+    }
+
+    /// Returns the number of steps between two iterators of the same view.
+    friend constexpr difference_type operator-(strided_iterator it, strided_iterator other)
+    {
+        return it.index - other.index;
+    }
+
+    /// Returns true if both iterators refer to the same element.
+    constexpr bool operator==(const strided_iterator &other) const
+    {
+        return index == other.index;
+    }
+
+    /// Returns true if the iterators refer to different elements.
+    constexpr bool operator!=(const strided_iterator &other) const
+    {
+        return index != other.index;
+    }
+
+    /// Returns true if the iterator points before `other`.
+    constexpr bool operator<(const strided_iterator &other) const
+    {
+        return index < other.index;
+    }
+
+    /// Returns true if the iterator points after `other`.
+    constexpr bool operator>(const strided_iterator &other) const
+    {
+        return other < *this;
+    }
+
+    /// Returns true if the iterator does not point after `other`.
+    constexpr bool operator<=(const strided_iterator &other) const
+    {
+        return not(other < *this);
+    }
+
+    /// Returns true if the iterator does not point before `other`.
+    constexpr bool operator>=(const strided_iterator &other) const
+    {
+        return not(*this < other);
+    }
+
+private:
+    T *first;               //!< The first element of the view.
+    difference_type index;  //!< Number of steps from `first` to the element the iterator points to.
+    difference_type stride; //!< Distance, in elements, between two steps.
+};
+
+/**
+ * @brief Strided non-owning view
+ *
+ * Refers to `size()` elements placed `stride()` elements apart, e.g. one column of a row-major matrix.
+ */
+template <typename T>
+class strided_view
+{
+public:
+    using size_type = unsigned long;                     //!< The size type.
+    using value_type = typename std::remove_cv<T>::type; //!< The value type.
+    using pointer = T *;                                 //!< Pointer to a viewed element.
+    using reference = T &;                               //!< Reference to a viewed element.
+    using iterator = strided_iterator<T>;                //!< Iterator over the viewed elements.
+    using const_iterator = strided_iterator<T>;          //!< Views are shallow: constness comes from T.
+
+    /// Creates an empty view.
+    constexpr strided_view() : DATA(nullptr), SIZE(0), STRIDE(1)
+    {
+    }
+
+    /// Views `count` elements starting at `first`, `stride` elements apart.
+    constexpr strided_view(pointer first, size_type count, size_type stride) : DATA(first), SIZE(count), STRIDE(stride)
+    {
+    }
+
+    /// Returns an iterator pointing to the first viewed element.
+    constexpr iterator begin() const
+    {
+        return iterator(DATA, 0, STRIDE);
+    }
+
+    /// Returns an iterator pointing just after the last viewed element.
+    constexpr iterator end() const
+    {
+        return iterator(DATA, SIZE, STRIDE);
+    }
+
+    /// Return the number of viewed elements.
+    constexpr size_type size() const
+    {
+        return SIZE;
+    }
+
+    /// Returns true if the view refers to no elements.
+    constexpr bool empty() const
+    {
+        return SIZE == 0;
+    }
+
+    /// Distance, in elements, between two consecutive viewed elements.
+    constexpr size_type stride() const
+    {
+        return STRIDE;
+    }
+
+    /// Returns the element at index pos, with no bounds-checking.
+    SC_CONSTEXPR14 reference operator[](size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos < SIZE, "operator[] index out of range");
+        return DATA[pos * STRIDE];
+    }
+
+    /// Returns the view of `count` elements starting at the `offset`-th one; `count` is clamped to the end of this view.
+    SC_CONSTEXPR14 strided_view subview(size_type offset, size_type count = size_type(-1)) const
+    {
+        if (offset > SIZE)
+            throw std::out_of_range(std::to_string(offset));
+        if (offset == SIZE) // DATA + SIZE * STRIDE may lie past the viewed array
+            return strided_view(DATA, 0, STRIDE);
+        return strided_view(DATA + offset * STRIDE, count < SIZE - offset ? count : SIZE - offset, STRIDE);
+    }
+
+private:
+    pointer DATA;     //!< First viewed element.
+    size_type SIZE;   //!< Number of viewed elements.
+    size_type STRIDE; //!< Distance between two viewed elements.
+};
+
+/// Iterator over a chunked_view; dereferencing yields the current chunk.
+template <typename T>
+class chunk_iterator
+{
+public:
+    typedef std::ptrdiff_t difference_type;              //!< Difference type used to calculated distance between iterators.
+    typedef vector_view<T> value_type;                   //!< Chunks are views.
+    typedef const vector_view<T> *pointer;               //!< Unused, required by std::iterator_traits.
+    typedef vector_view<T> reference;                    //!< Chunks are returned by value.
+    typedef std::forward_iterator_tag iterator_category; //!< Iterator category.
+
+    /// Constructs an iterator on the chunk starting at offset `pos` of `whole`.
+    constexpr chunk_iterator(vector_view<T> whole, unsigned long chunk, unsigned long pos)
+        : whole(whole), chunk(chunk), pos(pos)
+    {
+    }
+
+    /// Returns the current chunk.
+    SC_CONSTEXPR14 vector_view<T> operator*() const
+    {
+        return whole.subview(pos, chunk);
+    }
+
+    /// Moves to the next chunk.
+    SC_CONSTEXPR14 chunk_iterator &operator++()
+    {
+        pos = pos + chunk < whole.size() ? pos + chunk : whole.size();
+        return *this;
+    }
+
+    /// Moves to the next chunk and returns itself before that.
+    SC_CONSTEXPR14 chunk_iterator operator++(int)
+    {
+        chunk_iterator temp = *this;
+        ++*this;
+        return temp;
+    }
+
+    /// Returns true if both iterators are on the same chunk.
+    constexpr bool operator==(const chunk_iterator &other) const
+    {
+        return pos == other.pos;
+    }
+
+    /// Returns true if the iterators are on different chunks.
+    constexpr bool operator!=(const chunk_iterator &other) const
+    {
+        return pos != other.pos;
+    }
+
+private:
+    vector_view<T> whole; //!< The view being split.
+    unsigned long chunk;  //!< Elements per chunk.
+    unsigned long pos;    //!< Offset of the current chunk.
+};
+
+/**
+ * @brief View of consecutive fixed-size chunks
+ *
+ * Iterating yields a vector_view per chunk, so a large vector can be processed in blocks
+ * (one per thread, per cache-sized tile...) without copying.
+ */
+template <typename T>
+class chunked_view
+{
+public:
+    using size_type = unsigned long;           //!< The size type.
+    using value_type = vector_view<T>;         //!< Chunks are views.
+    using iterator = chunk_iterator<T>;        //!< Iterator over the chunks.
+    using const_iterator = chunk_iterator<T>;  //!< Views are shallow: constness comes from T.
+
+    /// Splits `whole` into chunks of `chunk` elements.
+    constexpr chunked_view(vector_view<T> whole, size_type chunk) : WHOLE(whole), CHUNK(chunk)
+    {
+    }
+
+    /// Returns an iterator on the first chunk.
+    constexpr iterator begin() const
+    {
+        return iterator(WHOLE, CHUNK, 0);
+    }
+
+    /// Returns an iterator past the last chunk.
+    constexpr iterator end() const
+    {
+        return iterator(WHOLE, CHUNK, WHOLE.size());
+    }
+
+    /// Returns the number of chunks.
+    constexpr size_type size() const
+    {
+        return (WHOLE.size() + CHUNK - 1) / CHUNK;
+    }
+
+    /// Returns true if there are no chunks.
+    constexpr bool empty() const
+    {
+        return WHOLE.empty();
+    }
+
+    /// Returns the chunk at index pos.
+    SC_CONSTEXPR14 vector_view<T> operator[](size_type pos) const
+    {
+        SC_VECTOR_REQUIRE(pos < size(), "operator[] index out of range");
+        return WHOLE.subview(pos * CHUNK, CHUNK);
+    }
+
+private:
+    vector_view<T> WHOLE; //!< The view being split.
+    size_type CHUNK;      //!< Elements per chunk.
+};
+
+/// Views every element of `container`.
+template <typename Container>
+constexpr auto view(Container &container) -> vector_view<typename std::remove_pointer<decltype(container.data())>::type>
+{
+    return vector_view<typename std::remove_pointer<decltype(container.data())>::type>(container);
+}
+
+/// Views `count` elements of `container` starting at `offset`, without copying them.
+template <typename Container>
+SC_CONSTEXPR14 auto subview(Container &container, unsigned long offset, unsigned long count)
+    -> vector_view<typename std::remove_pointer<decltype(container.data())>::type>
+{
+    return view(container).subview(offset, count);
+}
+
+//=== Algorithms
+// They take any range with begin()/end(): vectors, views, strided and chunked views alike.
+
+/// Folds the elements of `range` into `init` with `op`, from first to last.
+template <typename Range, typename U, typename BinaryOp = std::plus<U>>
+SC_CONSTEXPR14 U reduce(const Range &range, U init, BinaryOp op = BinaryOp())
+{
+    for (auto it = range.begin(); it != range.end(); ++it)
+        init = op(init, *it);
+    return init;
+}
+
+/// Returns an iterator to the first element of `range` equal to `value`, or `range.end()`.
+template <typename Range, typename U>
+SC_CONSTEXPR14 auto find(const Range &range, const U &value) -> decltype(range.begin())
+{
+    auto it = range.begin();
+    for (; it != range.end(); ++it)
+        if (*it == value)
+            break;
+    return it;
+}
+
+/// Returns an iterator to the first element of `range` for which `pred` holds, or `range.end()`.
+template <typename Range, typename Pred>
+SC_CONSTEXPR14 auto find_if(const Range &range, Pred pred) -> decltype(range.begin())
+{
+    auto it = range.begin();
+    for (; it != range.end(); ++it)
+        if (pred(*it))
+            break;
+    return it;
+}
+
+/// Returns true if both ranges have the same length and equal elements.
+template <typename Range1, typename Range2>
+SC_CONSTEXPR14 bool equal(const Range1 &a, const Range2 &b)
+{
+    auto i = a.begin();
+    auto j = b.begin();
+    for (; i != a.end() && j != b.end(); ++i, ++j)
+        if (not(*i == *j))
+            return false;
+    return i == a.end() && j == b.end();
+}
+
+/// Lexicographic comparison: negative if `a` orders before `b`, zero if equal, positive otherwise.
+template <typename Range1, typename Range2>
+SC_CONSTEXPR14 int compare(const Range1 &a, const Range2 &b)
+{
+    auto i = a.begin();
+    auto j = b.begin();
+    for (; i != a.end() && j != b.end(); ++i, ++j)
+    {
+        if (*i < *j)
+            return -1;
+        if (*j < *i)
+            return 1;
+    }
+    return (i != a.end()) - (j != b.end());
+}
+} // namespace sc
+
+#ifdef SC_VECTOR_HAS_CONCEPTS
+/// Views refer to elements they do not own, so iterators obtained from a temporary view stay valid.
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<sc::vector_view<T>> = true;
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<sc::strided_view<T>> = true;
+
+/// Views are cheap to copy, so range adaptors take them by value.
+template <typename T>
+inline constexpr bool std::ranges::enable_view<sc::vector_view<T>> = true;
+template <typename T>
+inline constexpr bool std::ranges::enable_view<sc::strided_view<T>> = true;
+#endif
+
+#endif
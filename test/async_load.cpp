@@ -0,0 +1,187 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"           // gtest lib
+#include "../include/async_load.h" // header file for tested functions
+
+// ============================================================================
+// TESTING ASYNC_LOAD
+// ============================================================================
+
+namespace
+{
+/// Writes `count` consecutive integers starting at `first` to a new temporary file and returns its path.
+std::string write_file(std::uint32_t first, std::size_t count)
+{
+    char path[] = "/tmp/sc_async_load_XXXXXX";
+    int fd = ::mkstemp(path);
+    EXPECT_GE(fd, 0);
+    std::FILE *file = ::fdopen(fd, "wb");
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::uint32_t value = first + std::uint32_t(i);
+        std::fwrite(&value, sizeof(value), 1, file);
+    }
+    std::fclose(file);
+    return path;
+}
+} // namespace
+
+TEST(AsyncLoad, CallbackLoadsWholeFile)
+{
+    std::string path = write_file(7, 100000);
+    sc::io_context ctx(2);
+    sc::load_options options;
+    options.block_size = 64 * 1024; // several blocks in flight
+
+    std::error_code error = std::make_error_code(std::errc::interrupted);
+    sc::vector<std::uint32_t> loaded;
+    sc::async_load<std::uint32_t>(ctx, path, [&](std::error_code ec, sc::vector<std::uint32_t> data) {
+        error = ec;
+        loaded = std::move(data);
+    }, options);
+    ctx.run();
+
+    ASSERT_FALSE(error);
+    ASSERT_EQ(loaded.size(), 100000);
+    ASSERT_EQ(loaded.capacity(), 100000);
+    for (auto i{0u}; i < loaded.size(); ++i)
+        ASSERT_EQ(loaded[i], 7 + i);
+    ::unlink(path.c_str());
+}
+
+TEST(AsyncLoad, ConcurrentLoads)
+{
+    std::string paths[3] = {write_file(0, 1000), write_file(1000, 5000), write_file(6000, 0)};
+    sc::io_context ctx(3);
+    sc::load_options options;
+    options.block_size = 4096;
+
+    sc::vector<std::uint32_t> loaded[3];
+    auto done = 0;
+    for (auto f{0}; f < 3; ++f)
+        sc::async_load<std::uint32_t>(ctx, paths[f], [&, f](std::error_code ec, sc::vector<std::uint32_t> data) {
+            ASSERT_FALSE(ec);
+            loaded[f] = std::move(data);
+            ++done;
+        }, options);
+    ctx.run();
+
+    ASSERT_EQ(done, 3);
+    ASSERT_EQ(loaded[0].size(), 1000);
+    ASSERT_EQ(loaded[1].size(), 5000);
+    ASSERT_TRUE(loaded[2].empty());
+    ASSERT_EQ(loaded[1][0], 1000);
+    ASSERT_EQ(loaded[1][4999], 5999);
+    for (auto &path : paths)
+        ::unlink(path.c_str());
+}
+
+TEST(AsyncLoad, DirectMode)
+{
+    // Not a multiple of the 4096-byte alignment, so the last block is short.
+    std::string path = write_file(3, 12345);
+    sc::io_context ctx;
+    sc::load_options options;
+    options.block_size = 10000; // rounded up to 12288
+    options.direct = true;
+
+    sc::vector<std::uint32_t> loaded;
+    sc::async_load<std::uint32_t>(ctx, path, [&](std::error_code ec, sc::vector<std::uint32_t> data) {
+        ASSERT_FALSE(ec);
+        loaded = std::move(data);
+    }, options);
+    ctx.run();
+
+    ASSERT_EQ(loaded.size(), 12345);
+    for (auto i{0u}; i < loaded.size(); ++i)
+        ASSERT_EQ(loaded[i], 3 + i);
+    ::unlink(path.c_str());
+}
+
+TEST(AsyncLoad, Errors)
+{
+    sc::io_context ctx(1);
+    std::error_code missing, misaligned;
+    auto synchronous = true;
+
+    sc::async_load<std::uint32_t>(ctx, "/nonexistent/sc_async_load", [&](std::error_code ec, sc::vector<std::uint32_t> data) {
+        missing = ec;
+        ASSERT_TRUE(data.empty());
+        ASSERT_FALSE(synchronous);
+    });
+
+    // 5 integers read as 8-byte elements: not a whole number of elements.
+    std::string path = write_file(0, 5);
+    sc::async_load<std::uint64_t>(ctx, path, [&](std::error_code ec, sc::vector<std::uint64_t> data) {
+        misaligned = ec;
+        ASSERT_TRUE(data.empty());
+    });
+    synchronous = false;
+    ASSERT_EQ(ctx.run(), 2);
+
+    ASSERT_EQ(missing, std::errc::no_such_file_or_directory);
+    ASSERT_EQ(misaligned, std::errc::invalid_argument);
+    ::unlink(path.c_str());
+}
+
+TEST(AsyncLoad, PostRunsInOrder)
+{
+    sc::io_context ctx(1);
+    std::string order;
+    ctx.post([&] { order += 'a'; });
+    ctx.post([&] {
+        order += 'b';
+        ctx.post([&] { order += 'c'; });
+    });
+
+    ASSERT_EQ(ctx.run(), 3);
+    ASSERT_EQ(order, "abc");
+    ASSERT_FALSE(ctx.run_one());
+}
+
+#ifdef SC_VECTOR_HAS_COROUTINES
+namespace
+{
+/// Loads two files one after the other and returns the sum of all their integers.
+sc::task<std::uint64_t> sum_files(sc::io_context &ctx, std::string first, std::string second)
+{
+    std::uint64_t sum = 0;
+    for (auto value : co_await sc::async_load<std::uint32_t>(ctx, first))
+        sum += value;
+    for (auto value : co_await sc::async_load<std::uint32_t>(ctx, second))
+        sum += value;
+    co_return sum;
+}
+} // namespace
+
+TEST(AsyncLoad, Coroutine)
+{
+    std::string first = write_file(1, 100), second = write_file(101, 100);
+    sc::io_context ctx;
+
+    ASSERT_EQ(sc::sync_wait(ctx, sum_files(ctx, first, second)), 200u * 201 / 2);
+
+    auto loaded = sc::sync_wait(ctx, sc::async_load<std::uint32_t>(ctx, first));
+    ASSERT_EQ(loaded.size(), 100);
+    ASSERT_EQ(loaded.back(), 100);
+    ::unlink(first.c_str());
+    ::unlink(second.c_str());
+}
+
+TEST(AsyncLoad, CoroutineThrowsOnError)
+{
+    sc::io_context ctx;
+    ASSERT_THROW(sc::sync_wait(ctx, sc::async_load<std::uint32_t>(ctx, "/nonexistent/sc_async_load")), std::system_error);
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
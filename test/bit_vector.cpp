@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"           // gtest lib
+#include "../include/bit_vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING BIT_VECTOR
+// ============================================================================
+
+/// A bit_vector and a std::vector<bool> with the same `n` random bits.
+static void random_bits(std::size_t n, unsigned seed, sc::bit_vector &bits, std::vector<bool> &expected)
+{
+    std::mt19937 rng(seed);
+    bits.clear();
+    expected.clear();
+    for (auto i{0u}; i < n; ++i)
+    {
+        bool bit = rng() % 3 == 0;
+        bits.push_back(bit);
+        expected.push_back(bit);
+    }
+}
+
+TEST(BitVector, PackedStorage)
+{
+    sc::bit_vector bits(130, true);
+
+    ASSERT_EQ(bits.size(), 130);
+    ASSERT_EQ(bits.words().size(), 3);
+    ASSERT_EQ(bits.words()[2], 0x3u); // bits past size() stay clear
+    ASSERT_EQ(bits.count(), 130u);
+    ASSERT_TRUE(bits.all());
+}
+
+TEST(BitVector, ProxyReferences)
+{
+    sc::bit_vector bits{true, false, true};
+
+    bits[1] = true;
+    bits[0] = bits[2] = false;
+    bits[2].flip();
+    ASSERT_EQ(bits, (sc::bit_vector{false, true, true}));
+    ASSERT_FALSE(bits[0]);
+    ASSERT_TRUE(~bits[0]);
+
+    const sc::bit_vector &cbits = bits;
+    ASSERT_TRUE(cbits[1]);
+    ASSERT_TRUE(cbits.test(2));
+    EXPECT_THROW(cbits.test(3), std::out_of_range);
+}
+
+TEST(BitVector, Iterators)
+{
+    sc::bit_vector bits;
+    std::vector<bool> expected;
+    random_bits(300, 1, bits, expected);
+
+    ASSERT_EQ(bits.end() - bits.begin(), 300);
+    ASSERT_TRUE(std::equal(bits.cbegin(), bits.cend(), expected.begin()));
+    ASSERT_EQ(static_cast<std::size_t>(std::count(bits.begin(), bits.end(), true)), bits.count());
+
+    for (auto bit : bits)
+        bit = true;
+    ASSERT_TRUE(bits.all());
+}
+
+#ifdef SC_VECTOR_HAS_CONCEPTS
+static_assert(std::random_access_iterator<sc::bit_vector::const_iterator>);
+static_assert(std::random_access_iterator<sc::bit_vector::iterator>);
+#endif
+
+TEST(BitVector, IteratorsWorkWithStdAlgorithms)
+{
+    sc::bit_vector bits;
+    std::vector<bool> expected;
+    random_bits(300, 1, bits, expected);
+
+    auto first = bits.cbegin();
+    auto last = bits.cend();
+    ASSERT_TRUE(first < last && last > first && first <= first && last >= first);
+    ASSERT_TRUE(2 + first == first + 2);
+
+    // Sorting the bits puts every zero in front, which a binary search can then find the end of.
+    auto zeros = bits.size() - bits.count();
+    std::sort(bits.begin(), bits.end());
+    ASSERT_EQ(bits.size() - bits.count(), zeros);
+    ASSERT_EQ(static_cast<std::size_t>(std::lower_bound(bits.cbegin(), bits.cend(), true) - bits.cbegin()), zeros);
+    ASSERT_TRUE(std::is_sorted(bits.cbegin(), bits.cend()));
+}
+
+TEST(BitVector, ResizeAndPop)
+{
+    sc::bit_vector bits(60);
+
+    bits.resize(70, true);
+    ASSERT_EQ(bits.count(), 10u);
+    ASSERT_EQ(bits.find_first(), 60u);
+
+    bits.pop_back();
+    bits.resize(65);
+    ASSERT_EQ(bits.count(), 5u);
+    bits.resize(200);
+    ASSERT_EQ(bits.count(), 5u);
+    bits.resize(3);
+    ASSERT_TRUE(bits.none());
+}
+
+TEST(BitVector, BulkOperations)
+{
+    sc::bit_vector a, b;
+    std::vector<bool> ea, eb;
+    random_bits(1000, 2, a, ea);
+    random_bits(1000, 3, b, eb);
+
+    auto both = a & b;
+    auto either = a | b;
+    auto one = a ^ b;
+    auto not_a = ~a;
+    auto a_minus_b = a;
+    a_minus_b.and_not(b);
+
+    for (auto i{0u}; i < 1000; ++i)
+    {
+        ASSERT_EQ(both[i], ea[i] && eb[i]);
+        ASSERT_EQ(either[i], ea[i] || eb[i]);
+        ASSERT_EQ(one[i], ea[i] != eb[i]);
+        ASSERT_EQ(not_a[i], !ea[i]);
+        ASSERT_EQ(a_minus_b[i], ea[i] && !eb[i]);
+    }
+    ASSERT_EQ(not_a.count(), 1000 - a.count());
+}
+
+TEST(BitVector, FindRankSelect)
+{
+    sc::bit_vector bits;
+    std::vector<bool> expected;
+    random_bits(5000, 4, bits, expected);
+
+    std::vector<std::size_t> ones;
+    for (auto i{0u}; i < expected.size(); ++i)
+        if (expected[i])
+            ones.push_back(i);
+
+    std::vector<std::size_t> found;
+    for (auto i = bits.find_first(); i < bits.size(); i = bits.find_next(i))
+        found.push_back(i);
+    ASSERT_EQ(found, ones);
+
+    sc::bit_rank_index index(bits);
+    std::size_t rank = 0;
+    for (auto i{0u}; i <= bits.size(); ++i)
+    {
+        ASSERT_EQ(bits.rank(i), rank);
+        ASSERT_EQ(index.rank(i), rank);
+        if (i < bits.size() && expected[i])
+            ++rank;
+    }
+    for (auto k{0u}; k < ones.size(); ++k)
+    {
+        ASSERT_EQ(bits.select(k), ones[k]);
+        ASSERT_EQ(index.select(k), ones[k]);
+    }
+    ASSERT_EQ(bits.select(ones.size()), bits.size());
+    ASSERT_EQ(index.select(ones.size()), bits.size());
+}
+
+TEST(BitVector, Empty)
+{
+    sc::bit_vector bits;
+
+    ASSERT_EQ(bits.find_first(), 0u);
+    ASSERT_EQ(bits.count(), 0u);
+    ASSERT_TRUE(bits.all());
+    ASSERT_EQ(sc::bit_rank_index(bits).rank(0), 0u);
+    ASSERT_EQ(sc::bit_rank_index(bits).select(0), 0u);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,195 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"            // gtest lib
+#include "../include/byte_buffer.h" // header file for tested functions
+
+// ============================================================================
+// TESTING BYTE BUFFERS
+// ============================================================================
+
+namespace
+{
+/// The readable bytes of `buffer` as a string.
+template <typename Byte>
+std::string text(const sc::byte_buffer<Byte> &buffer)
+{
+    return std::string(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+}
+
+/// A connected pair of stream sockets, closed on destruction.
+struct socket_pair
+{
+    int fds[2];
+    socket_pair()
+    {
+        EXPECT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    }
+    ~socket_pair()
+    {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+};
+} // namespace
+
+TEST(ByteBuffer, AppendAndConsume)
+{
+    sc::byte_buffer<> buffer;
+    ASSERT_TRUE(buffer.empty());
+    buffer.append("hello ", 6);
+    buffer.append(sc::vector_view<const char>("world", 5));
+    buffer.push_back('!');
+    ASSERT_EQ(text(buffer), "hello world!");
+
+    const char *before = buffer.data();
+    buffer.consume_front(6); // O(1): nothing moves
+    ASSERT_EQ(buffer.data(), before + 6);
+    ASSERT_EQ(text(buffer), "world!");
+    ASSERT_EQ(buffer[0], 'w');
+
+    // Appending its own bytes is fine, even when that grows the buffer.
+    buffer.append(buffer.data(), buffer.size());
+    ASSERT_EQ(text(buffer), "world!world!");
+
+    buffer.consume_front(buffer.size());
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_GT(buffer.writable(), 0u);
+}
+
+TEST(ByteBuffer, ReclaimsTheConsumedPrefixBeforeGrowing)
+{
+    sc::byte_buffer<std::uint8_t> buffer;
+    std::uint8_t chunk[100];
+    for (int i = 0; i < 100; i++)
+        chunk[i] = std::uint8_t(i);
+
+    buffer.append(chunk, 100);
+    unsigned long capacity = buffer.capacity();
+    ASSERT_GE(capacity, 100u);
+
+    // A steady stream that consumes what it appends never grows past the first allocation.
+    for (int round = 0; round < 1000; round++)
+    {
+        buffer.consume_front(90);
+        buffer.append(chunk, 90);
+        ASSERT_EQ(buffer.size(), 100u);
+        long consumed = 90L * (round + 1); // the stream is one 100-byte chunk, then 90-byte ones
+        ASSERT_EQ(buffer[0], std::uint8_t(consumed < 100 ? consumed : (consumed - 100) % 90));
+    }
+    ASSERT_EQ(buffer.capacity(), capacity);
+
+    // prepare() and commit() let the caller write in place.
+    std::uint8_t *free = buffer.prepare(500);
+    std::memset(free, 7, 200);
+    buffer.commit(200);
+    ASSERT_EQ(buffer.size(), 300u);
+    ASSERT_EQ(buffer[299], 7);
+}
+
+TEST(ByteBuffer, ConvertsToAndFromVectors)
+{
+    sc::vector<char> bytes{'a', 'b', 'c', 'd'};
+    const char *storage = bytes.data();
+    sc::byte_buffer<char> buffer(std::move(bytes));
+    ASSERT_EQ(buffer.data(), storage);
+    buffer.consume_front(1);
+
+    sc::vector<char> back = buffer.release();
+    ASSERT_EQ(back, (sc::vector<char>{'b', 'c', 'd'}));
+    ASSERT_EQ(back.data(), storage);
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(ByteBuffer, Searches)
+{
+    sc::byte_buffer<> buffer;
+    std::string request = "GET /index.html HTTP/1.1\r\nHost: example.org\r\n\r\n";
+    for (int i = 0; i < 3; i++) // long enough for the 32-byte steps
+        buffer.append(request.data(), request.size());
+
+    ASSERT_EQ(buffer.find(' '), 3u);
+    ASSERT_EQ(buffer.find(' ', 4), 15u);
+    ASSERT_EQ(buffer.find('#'), buffer.npos);
+    ASSERT_EQ(buffer.find_str("\r\n"), request.find("\r\n"));
+    ASSERT_EQ(buffer.find_str("\r\n\r\n"), request.find("\r\n\r\n"));
+    ASSERT_EQ(buffer.find_str("\r\n\r\n", 50), request.size() + request.find("\r\n\r\n"));
+    ASSERT_EQ(buffer.find_str("HTTP/2"), buffer.npos);
+    ASSERT_EQ(buffer.find_str("", 5), 5u);
+
+    // Every set size, through both the comparison and the table kernels.
+    std::string all = text(buffer);
+    const char *sets[] = {":", "\r\n", " \t\r\n", ".:/", "Hxyzwvuq", "Hxyzwvuqp", "0123456789abcdefghij:"};
+    for (const char *set : sets)
+        for (unsigned long from : {0ul, 1ul, 17ul, 33ul, 60ul, 140ul})
+        {
+            unsigned long expected = all.find_first_of(set, from);
+            ASSERT_EQ(buffer.find_first_of_str(set, from), expected == std::string::npos ? buffer.npos : expected)
+                << "set \"" << set << "\" from " << from;
+        }
+    ASSERT_EQ(buffer.find_first_of_str("", 0), buffer.npos);
+    ASSERT_EQ(buffer.find_first_of_str("G", 1000), buffer.npos);
+
+    // A pointer and a length are a set of that many bytes, never a string and an offset.
+    const char delimiters[] = {':', '/', 'G'}; // not NUL-terminated
+    ASSERT_EQ(buffer.find_first_of(delimiters, 2), 4u);
+    ASSERT_EQ(buffer.find_first_of(delimiters, 3), 0u);
+    ASSERT_EQ(buffer.find(delimiters + 1, 1), 4u);
+
+    // Matches in the last bytes, after the SIMD steps.
+    sc::byte_buffer<unsigned char> tail;
+    unsigned char zeros[70] = {};
+    zeros[69] = 9;
+    tail.append(zeros, 70);
+    const unsigned char set[] = {8, 9};
+    ASSERT_EQ(tail.find_first_of(set, 2), 69u);
+}
+
+TEST(ByteBuffer, ReadsAndWritesSockets)
+{
+    socket_pair sockets;
+    sc::byte_buffer<> out, header, body;
+    header.append("head:", 5);
+    body.append("body", 4);
+
+    // Gathered in one writev() call, and consumed from both buffers.
+    ASSERT_EQ(sc::write_buffers(sockets.fds[0], {&header, &body}), 9);
+    ASSERT_TRUE(header.empty());
+    ASSERT_TRUE(body.empty());
+
+    sc::byte_buffer<> in;
+    ASSERT_EQ(in.read_from(sockets.fds[1]), 9);
+    ASSERT_EQ(text(in), "head:body");
+
+    // A read larger than the free space spills to the stack and is appended.
+    std::string large(100000, 'x');
+    for (unsigned long i = 0; i < large.size(); i += 97)
+        large[i] = char('a' + i % 26);
+    out.append(large.data(), large.size());
+    long total = 0;
+    while (!out.empty())
+    {
+        long put = out.write_to(sockets.fds[0]);
+        ASSERT_GT(put, 0);
+        while (in.size() < 9 + (unsigned long)(total + put))
+            ASSERT_GT(in.read_from(sockets.fds[1]), 0);
+        total += put;
+    }
+    ASSERT_EQ(text(in), "head:body" + large);
+
+    ::close(sockets.fds[0]);
+    ASSERT_EQ(in.read_from(sockets.fds[1]), 0); // end of the stream
+    sockets.fds[0] = ::dup(sockets.fds[1]);
+
+    ASSERT_LT(in.read_from(-1), 0);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
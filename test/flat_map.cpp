@@ -0,0 +1,196 @@
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"         // gtest lib
+#include "../include/flat_map.h" // header file for tested functions
+
+// ============================================================================
+// TESTING FLAT_MAP
+// ============================================================================
+
+namespace
+{
+/// A value whose copies throw while `fail` is set, or once `copies_left` runs out.
+struct fragile
+{
+    static bool fail;
+    static int copies_left; //!< Copies allowed before one throws; negative means no limit.
+    int n = 0;
+
+    fragile() = default;
+    fragile(int value) : n(value) {}
+    fragile(const fragile &other) : n(other.n) { copied(); }
+    fragile &operator=(const fragile &other)
+    {
+        copied();
+        n = other.n;
+        return *this;
+    }
+
+    static void copied()
+    {
+        if (fail || copies_left == 0)
+            throw std::runtime_error("copy failed");
+        if (copies_left > 0)
+            --copies_left;
+    }
+};
+bool fragile::fail = false;
+int fragile::copies_left = -1;
+} // namespace
+
+TEST(FlatMap, BulkConstructorKeepsFirstDuplicate)
+{
+    sc::flat_map<std::string, int> map{{"b", 2}, {"a", 1}, {"c", 3}, {"a", 100}};
+
+    ASSERT_EQ(map.size(), 3);
+    ASSERT_EQ(map.keys(), (sc::vector<std::string>{"a", "b", "c"}));
+    ASSERT_EQ(map.values(), (sc::vector<int>{1, 2, 3}));
+}
+
+TEST(FlatMap, ElementAccess)
+{
+    sc::flat_map<int, std::string> map;
+
+    map[3] = "three";
+    map[1] = "one";
+    map[3] += "!";
+    ASSERT_EQ(map.at(3), "three!");
+    ASSERT_EQ(map.at(1), "one");
+    EXPECT_THROW(map.at(2), std::out_of_range);
+    ASSERT_EQ(map.size(), 2);
+
+    const auto &cmap = map;
+    ASSERT_EQ(cmap.at(1), "one");
+}
+
+TEST(FlatMap, InsertEraseAndIterate)
+{
+    sc::flat_map<int, int> map;
+
+    ASSERT_TRUE(map.insert({5, 50}).second);
+    ASSERT_TRUE(map.insert({1, 10}).second);
+    ASSERT_FALSE(map.insert({5, 0}).second);
+    ASSERT_FALSE(map.insert_or_assign(5, 55).second);
+    ASSERT_TRUE(map.insert_or_assign(3, 30).second);
+
+    std::vector<std::pair<int, int>> pairs;
+    for (auto kv : map)
+        pairs.emplace_back(kv.first, kv.second);
+    ASSERT_EQ(pairs, (std::vector<std::pair<int, int>>{{1, 10}, {3, 30}, {5, 55}}));
+
+    for (auto it = map.begin(); it != map.end(); ++it)
+        it->second *= 2;
+    ASSERT_EQ(map.values(), (sc::vector<int>{20, 60, 110}));
+
+    ASSERT_EQ(map.erase(3), 1u);
+    auto next = map.erase(map.find(1));
+    ASSERT_EQ(next->first, 5);
+    ASSERT_EQ(map.size(), 1);
+}
+
+TEST(FlatMap, FailedInsertKeepsKeysAndValuesTogether)
+{
+    sc::flat_map<int, fragile> map;
+    map.insert({1, fragile(10)});
+    map.insert({3, fragile(30)});
+
+    std::pair<int, fragile> pair(2, fragile(20));
+    fragile::fail = true;
+    ASSERT_THROW(map.insert(pair), std::runtime_error);
+    fragile::fail = false;
+
+    ASSERT_EQ(map.size(), 2);
+    ASSERT_EQ(map.keys(), (sc::vector<int>{1, 3}));
+    ASSERT_EQ(map.at(3).n, 30);
+}
+
+TEST(FlatMap, IteratorsAreOrdered)
+{
+    sc::flat_map<int, int> map{{1, 10}, {2, 20}, {3, 30}};
+    auto first = map.begin();
+    auto last = map.end() - 1;
+    ASSERT_TRUE(first < last);
+    ASSERT_TRUE(last > first);
+    ASSERT_TRUE(first <= first && first <= last);
+    ASSERT_TRUE(last >= last && last >= first);
+    ASSERT_FALSE(first > last || last <= first || first >= last);
+}
+
+TEST(FlatMap, Lookup)
+{
+    const sc::flat_map<int, char> map{{10, 'a'}, {20, 'b'}, {30, 'c'}};
+
+    ASSERT_TRUE(map.contains(20));
+    ASSERT_EQ(map.count(25), 0u);
+    ASSERT_EQ(map.find(25), map.end());
+    ASSERT_EQ(map.find(30)->second, 'c');
+    ASSERT_EQ(map.lower_bound(11)->first, 20);
+    ASSERT_EQ(map.upper_bound(20)->first, 30);
+    ASSERT_EQ(map.end() - map.begin(), 3);
+}
+
+TEST(FlatMap, InsertRangeMatchesStdMap)
+{
+    std::vector<std::pair<int, int>> pairs;
+    for (auto i{0}; i < 400; ++i)
+        pairs.emplace_back((i * 7919) % 173, i);
+
+    sc::flat_map<int, int> map(pairs.begin(), pairs.begin() + 150);
+    map.insert_range(pairs.begin() + 150, pairs.end());
+    std::map<int, int> expected;
+    for (const auto &p : pairs)
+        expected.insert(p);
+
+    ASSERT_EQ(map.size(), expected.size());
+    auto it = map.begin();
+    for (const auto &p : expected)
+    {
+        ASSERT_EQ((*it).first, p.first);
+        ASSERT_EQ((*it).second, p.second);
+        ++it;
+    }
+}
+
+TEST(FlatMap, FailedInsertRangeLeavesMapUnchanged)
+{
+    sc::flat_map<int, fragile> map;
+    for (auto i{0}; i < 8; ++i)
+        map.insert({i * 2, fragile(i * 20)});
+    std::vector<std::pair<int, fragile>> pairs{{5, fragile(50)}, {1, fragile(10)}, {15, fragile(150)}};
+
+    // Let every copy in turn be the one that throws, until insert_range gets through.
+    for (auto budget{0};; ++budget)
+    {
+        fragile::copies_left = budget;
+        try
+        {
+            map.insert_range(pairs.begin(), pairs.end());
+            fragile::copies_left = -1;
+            break;
+        }
+        catch (const std::runtime_error &)
+        {
+            fragile::copies_left = -1;
+        }
+        ASSERT_EQ(map.size(), 8);
+        ASSERT_EQ(map.values().size(), 8);
+        for (auto i{0}; i < 8; ++i)
+            ASSERT_EQ(map.at(i * 2).n, i * 20);
+    }
+
+    ASSERT_EQ(map.size(), 11);
+    ASSERT_EQ(map.at(1).n, 10);
+    ASSERT_EQ(map.at(5).n, 50);
+    ASSERT_EQ(map.at(15).n, 150);
+    ASSERT_EQ(map.at(14).n, 140);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
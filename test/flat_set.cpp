@@ -0,0 +1,155 @@
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"         // gtest lib
+#include "../include/flat_set.h" // header file for tested functions
+
+// ============================================================================
+// TESTING FLAT_SET
+// ============================================================================
+
+namespace
+{
+/// A key whose copies throw once `copies_left` runs out.
+struct fragile
+{
+    static int copies_left; //!< Copies allowed before one throws; negative means no limit.
+    int n = 0;
+
+    fragile() = default;
+    fragile(int value) : n(value) {}
+    fragile(const fragile &other) : n(other.n) { copied(); }
+    fragile &operator=(const fragile &other)
+    {
+        copied();
+        n = other.n;
+        return *this;
+    }
+
+    static void copied()
+    {
+        if (copies_left == 0)
+            throw std::runtime_error("copy failed");
+        if (copies_left > 0)
+            --copies_left;
+    }
+
+    friend bool operator<(const fragile &a, const fragile &b)
+    {
+        return a.n < b.n;
+    }
+};
+int fragile::copies_left = -1;
+} // namespace
+
+TEST(FlatSet, BulkConstructorSortsAndDeduplicates)
+{
+    sc::flat_set<int> set{5, 3, 9, 3, 1, 5, 7};
+
+    ASSERT_EQ(set.size(), 5);
+    ASSERT_EQ(set.keys(), (sc::vector<int>{1, 3, 5, 7, 9}));
+    ASSERT_TRUE(sc::flat_set<int>().empty());
+}
+
+TEST(FlatSet, InsertAndErase)
+{
+    sc::flat_set<std::string> set;
+
+    ASSERT_TRUE(set.insert("pear").second);
+    ASSERT_TRUE(set.insert("apple").second);
+    auto again = set.insert("pear");
+    ASSERT_FALSE(again.second);
+    ASSERT_EQ(*again.first, "pear");
+    ASSERT_TRUE(set.insert("fig").second);
+    ASSERT_EQ(set.keys(), (sc::vector<std::string>{"apple", "fig", "pear"}));
+
+    ASSERT_EQ(set.erase("fig"), 1u);
+    ASSERT_EQ(set.erase("fig"), 0u);
+    auto next = set.erase(set.begin());
+    ASSERT_EQ(*next, "pear");
+    ASSERT_EQ(set.size(), 1);
+}
+
+TEST(FlatSet, Lookup)
+{
+    sc::flat_set<int> set{10, 20, 30, 40};
+
+    ASSERT_TRUE(set.contains(30));
+    ASSERT_FALSE(set.contains(35));
+    ASSERT_EQ(set.count(10), 1u);
+    ASSERT_EQ(set.find(25), set.end());
+    ASSERT_EQ(*set.find(40), 40);
+    ASSERT_EQ(*set.lower_bound(20), 20);
+    ASSERT_EQ(*set.lower_bound(21), 30);
+    ASSERT_EQ(*set.upper_bound(20), 30);
+    ASSERT_EQ(set.lower_bound(41), set.end());
+    ASSERT_EQ(set.upper_bound(5), set.begin());
+}
+
+TEST(FlatSet, InsertRangeMerges)
+{
+    sc::flat_set<int> set{2, 4, 6, 8};
+    std::vector<int> more{9, 1, 4, 5, 5, 0, 8};
+
+    set.insert_range(more.begin(), more.end());
+    ASSERT_EQ(set.keys(), (sc::vector<int>{0, 1, 2, 4, 5, 6, 8, 9}));
+
+    set.insert_range({2, 4});
+    ASSERT_EQ(set.size(), 8);
+}
+
+TEST(FlatSet, FailedInsertRangeLeavesSetUnchanged)
+{
+    sc::flat_set<fragile> set;
+    for (auto i{0}; i < 8; ++i)
+        set.insert(fragile(i * 10));
+    std::vector<fragile> more{fragile(5), fragile(20), fragile(75), fragile(5)};
+
+    // Let every copy in turn be the one that throws, until insert_range gets through.
+    for (auto budget{0};; ++budget)
+    {
+        fragile::copies_left = budget;
+        try
+        {
+            set.insert_range(more.begin(), more.end());
+            fragile::copies_left = -1;
+            break;
+        }
+        catch (const std::runtime_error &)
+        {
+            fragile::copies_left = -1;
+        }
+        ASSERT_EQ(set.size(), 8);
+        for (auto i{0}; i < 8; ++i)
+            ASSERT_EQ(set.keys()[i].n, i * 10);
+    }
+
+    ASSERT_EQ(set.size(), 10);
+    ASSERT_EQ(set.keys()[1].n, 5);
+    ASSERT_EQ(set.keys()[8].n, 70);
+    ASSERT_EQ(set.keys()[9].n, 75);
+}
+
+TEST(FlatSet, CustomOrderMatchesStdSet)
+{
+    std::vector<int> keys;
+    for (auto i{0}; i < 500; ++i)
+        keys.push_back((i * 7919) % 251);
+
+    sc::flat_set<int, std::greater<int>> set(keys.begin(), keys.begin() + 250);
+    set.insert_range(keys.begin() + 250, keys.end());
+    std::set<int, std::greater<int>> expected(keys.begin(), keys.end());
+
+    ASSERT_EQ(set.size(), expected.size());
+    ASSERT_TRUE(std::equal(set.begin(), set.end(), expected.begin()));
+    for (auto i{-5}; i < 260; ++i)
+        ASSERT_EQ(set.contains(i), expected.count(i) == 1) << i;
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+#define SC_VECTOR_TRACE
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"       // gtest lib
+#include "../include/vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING THE GROWTH TRACER
+// ============================================================================
+
+TEST(GrowthTrace, RecordsEachReallocation)
+{
+    sc::trace::reset();
+
+    sc::vector<int> vec;
+    for (auto i{0}; i < 100; ++i)
+        vec.push_back(i);
+
+    // Capacity goes 2, 4, 8, ..., 128.
+    auto events = sc::trace::snapshot();
+    ASSERT_EQ(events.size(), 7u);
+
+    std::size_t expected_cap = 2;
+    for (const auto &e : events)
+    {
+        EXPECT_EQ(e.new_capacity, expected_cap);
+        EXPECT_EQ(e.old_capacity, expected_cap == 2 ? 0 : expected_cap / 2);
+        EXPECT_EQ(e.size, e.old_capacity);
+        EXPECT_EQ(e.element_size, sizeof(int));
+        expected_cap *= 2;
+    }
+}
+
+TEST(GrowthTrace, RecordsCallSite)
+{
+    sc::trace::reset();
+
+    sc::vector<int> vec;
+    vec.reserve(10); auto line = __LINE__;
+    vec.shrink_to_fit();
+
+    auto events = sc::trace::snapshot();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].line, static_cast<std::uint_least32_t>(line));
+    EXPECT_NE(std::string(events[0].file).find("growth_trace.cpp"), std::string::npos);
+    EXPECT_EQ(events[1].line, static_cast<std::uint_least32_t>(line + 1));
+    EXPECT_EQ(events[1].new_capacity, 0u);
+}
+
+TEST(GrowthTrace, NoEventWithoutReallocation)
+{
+    sc::vector<int> vec(16);
+    sc::trace::reset();
+
+    for (auto i{0}; i < 16; ++i)
+        vec.push_back(i);
+    vec.assign(8u, 1);
+    vec.reserve(4);
+
+    EXPECT_TRUE(sc::trace::snapshot().empty());
+}
+
+TEST(GrowthTrace, PerThreadRings)
+{
+    sc::trace::reset();
+
+    std::vector<std::thread> workers;
+    for (auto t{0}; t < 4; ++t)
+        workers.emplace_back([] {
+            sc::vector<long> vec;
+            for (auto i{0}; i < 8; ++i)
+                vec.push_back(i);
+        });
+    for (auto &w : workers)
+        w.join();
+
+    // 2, 4, 8 on each thread, each thread on its own ring.
+    auto events = sc::trace::snapshot();
+    ASSERT_EQ(events.size(), 12u);
+    for (const auto &e : events)
+        EXPECT_EQ(std::count_if(events.begin(), events.end(),
+                                [&](const sc::trace::growth_event &other) { return other.thread == e.thread; }),
+                  3);
+}
+
+TEST(GrowthTrace, ChromeTraceExport)
+{
+    sc::trace::reset();
+
+    sc::vector<char> vec;
+    vec.assign({'a', 'b', 'c'});
+
+    std::ostringstream os;
+    sc::trace::export_chrome_trace(os);
+    auto json = os.str();
+
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"new_capacity\":3"), std::string::npos);
+    EXPECT_NE(json.find("growth_trace.cpp"), std::string::npos);
+}
+
+TEST(GrowthTrace, Heatmap)
+{
+    sc::trace::reset();
+
+    sc::vector<int> vec;
+    for (auto i{0}; i < 32; ++i)
+        vec.push_back(i);
+    vec.insert(vec.begin(), {1, 2, 3});
+
+    auto heatmap = sc::trace::growth_heatmap();
+    ASSERT_EQ(heatmap.size(), 2u);
+    EXPECT_EQ(heatmap[0].events, 5u);
+    EXPECT_EQ(heatmap[0].bytes_allocated, (2 + 4 + 8 + 16 + 32) * sizeof(int));
+    EXPECT_EQ(heatmap[1].events, 1u);
+    EXPECT_EQ(heatmap[1].line, heatmap[0].line + 1);
+
+    std::ostringstream os;
+    sc::trace::export_growth_heatmap(os);
+    EXPECT_NE(os.str().find("\"events\":5"), std::string::npos);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
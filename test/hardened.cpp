@@ -0,0 +1,101 @@
+#undef SC_VECTOR_CHECKS
+#define SC_VECTOR_CHECKS 2
+
+#include <iterator> // std::next
+
+#include "gtest/gtest.h"              // gtest lib
+#include "../include/vector.h"        // header file for tested functions
+#include "../include/static_vector.h" // header file for tested functions
+#include "../include/byte_buffer.h"   // header file for tested functions
+
+// ============================================================================
+// TESTING THE HARDENED MODE (SC_VECTOR_CHECKS == 2)
+// ============================================================================
+
+TEST(HardenedDeathTest, IndexOutOfRange)
+{
+    sc::vector<int> vec{1, 2, 3};
+
+    ASSERT_EQ(vec[2], 3);
+    EXPECT_DEATH(vec[3], "operator\\[\\] index out of range");
+}
+
+TEST(HardenedDeathTest, EmptyAccess)
+{
+    sc::vector<int> vec;
+
+    EXPECT_DEATH(vec.front(), "front\\(\\) on an empty vector");
+    EXPECT_DEATH(vec.back(), "back\\(\\) on an empty vector");
+    EXPECT_DEATH(vec.pop_back(), "pop_back\\(\\) on an empty vector");
+    EXPECT_DEATH(vec.pop_front(), "pop_front\\(\\) on an empty vector");
+}
+
+TEST(HardenedDeathTest, EraseOutsideTheVector)
+{
+    sc::vector<int> vec{1, 2, 3};
+
+    EXPECT_DEATH(vec.erase(vec.end()), "erase\\(\\) position outside the vector");
+    EXPECT_DEATH(vec.erase(std::next(vec.begin(), 2), vec.begin()), "erase\\(\\) range outside the vector");
+}
+
+TEST(HardenedDeathTest, IteratorUsedAfterReallocation)
+{
+    sc::vector<int> vec{1, 2, 3};
+    auto it = vec.begin();
+
+    // No reallocation yet: the iterator stays valid.
+    vec.reserve(2);
+    ASSERT_EQ(*it, 1);
+
+    vec.push_back(4);
+    EXPECT_DEATH(*it, "iterator used after the vector reallocated");
+    EXPECT_DEATH(it[1], "iterator used after the vector reallocated");
+
+    // Fresh iterators are fine.
+    ASSERT_EQ(*vec.begin(), 1);
+}
+
+TEST(HardenedDeathTest, IteratorUsedAfterAssignment)
+{
+    sc::vector<int> vec{1, 2, 3};
+    auto it = vec.cbegin();
+
+    vec = {4, 5, 6};
+    EXPECT_DEATH(*it, "iterator used after the vector reallocated");
+}
+
+TEST(HardenedDeathTest, StaticVector)
+{
+    sc::static_vector<int, 4> vec{1, 2};
+
+    EXPECT_DEATH(vec[2], "operator\\[\\] index out of range");
+    vec.clear();
+    EXPECT_DEATH(vec.back(), "back\\(\\) on an empty vector");
+}
+
+TEST(HardenedDeathTest, IndexedAccess)
+{
+    sc::vector<int> vec{1, 2, 3};
+    sc::vector<int> out{0, 0};
+
+    EXPECT_DEATH(vec.gather(sc::vector<int>{0, 3}, out), "index out of range");
+    EXPECT_DEATH(vec.gather(sc::vector<int>{0, 1, 2}, out), "gather\\(\\) output smaller than the indices");
+    EXPECT_DEATH(vec.scatter(sc::vector<int>{-1}, out), "index out of range");
+    EXPECT_DEATH(vec.permute(sc::vector<int>{1, 1, 0}), "order is not a permutation");
+}
+
+TEST(HardenedDeathTest, ByteBuffer)
+{
+    sc::byte_buffer<> buffer;
+    buffer.append("ab", 2);
+
+    EXPECT_DEATH(buffer[2], "operator\\[\\] index out of range");
+    EXPECT_DEATH(buffer.consume_front(3), "consume_front\\(\\) past the readable bytes");
+    EXPECT_DEATH(buffer.commit(buffer.writable() + 1), "commit\\(\\) past the prepared bytes");
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
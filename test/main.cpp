@@ -2,6 +2,8 @@
 #include <functional> // std::function
 #include <algorithm>  // std::min_element
 #include <iostream>
+#include <string>
+#include <type_traits> // std::is_constructible
 
 #include "gtest/gtest.h"       // gtest lib
 #include "../include/vector.h" // header file for tested functions
@@ -390,6 +392,89 @@ TEST(IntVector, ShrinkToFit)
         ASSERT_EQ(e, ++i);
 }
 
+TEST(IntVector, Swap)
+{
+    sc::vector<int> vec{1, 2, 3};
+    sc::vector<int> vec2{4, 5};
+    const int *data = vec.data();
+
+    vec.swap(vec2);
+    ASSERT_EQ(vec, (sc::vector<int>{4, 5}));
+    ASSERT_EQ(vec2, (sc::vector<int>{1, 2, 3}));
+    ASSERT_EQ(vec2.data(), data); // no element was copied
+
+    using std::swap;
+    swap(vec, vec2); // finds sc::swap
+    ASSERT_EQ(vec, (sc::vector<int>{1, 2, 3}));
+    ASSERT_EQ(vec.data(), data);
+}
+
+TEST(IntVector, Resize)
+{
+    sc::vector<int> vec{1, 2, 3};
+
+    vec.resize(5);
+    ASSERT_EQ(vec, (sc::vector<int>{1, 2, 3, 0, 0}));
+    vec.resize(2);
+    ASSERT_EQ(vec, (sc::vector<int>{1, 2}));
+
+    // Slots left behind by pop_back and clear are overwritten, not revived.
+    vec.push_back(9);
+    vec.pop_back();
+    vec.resize(4, 7);
+    ASSERT_EQ(vec, (sc::vector<int>{1, 2, 7, 7}));
+
+    // The fill value may live in the vector itself.
+    vec.resize(10, vec[0]);
+    ASSERT_EQ(vec.size(), 10);
+    ASSERT_EQ(vec.back(), 1);
+}
+
+TEST(IntVector, ResizeReleasesRemovedElements)
+{
+    sc::vector<std::string> vec{"a", "b", "c"};
+    vec.resize(1);
+    ASSERT_EQ(vec.size(), 1);
+    vec.resize_for_overwrite(3);
+    ASSERT_EQ(vec[1], "");
+    ASSERT_EQ(vec[2], "");
+}
+
+TEST(IntVector, ResizeForOverwrite)
+{
+    sc::vector<int> vec{1, 2};
+
+    int *out = vec.resize_for_overwrite(1000);
+    ASSERT_EQ(out, vec.data());
+    ASSERT_EQ(vec.size(), 1000);
+    ASSERT_EQ(vec.capacity(), 1000); // exact, no geometric slack
+    ASSERT_EQ(vec[0], 1);
+    ASSERT_EQ(vec[1], 2);
+    for (auto i{2}; i < 1000; ++i)
+        out[i] = i;
+    ASSERT_EQ(vec[999], 999);
+
+    vec.resize_for_overwrite(10);
+    ASSERT_EQ(vec.size(), 10);
+    ASSERT_EQ(vec.capacity(), 1000);
+}
+
+TEST(IntVector, AppendUninitialized)
+{
+    sc::vector<int> vec{1, 2};
+
+    int *out = vec.append_uninitialized(3);
+    ASSERT_EQ(vec.size(), 5);
+    out[0] = 3;
+    out[1] = 4;
+    out[2] = 5;
+    ASSERT_EQ(vec, (sc::vector<int>{1, 2, 3, 4, 5}));
+
+    auto capacity = vec.capacity();
+    vec.append_uninitialized(1);
+    ASSERT_GE(vec.capacity(), 2 * capacity); // grows like push_back
+}
+
 TEST(IntVector, OperatorEqual)
 {
     // #1 From an empty vector.
@@ -571,6 +656,64 @@ TEST(IntVector, ErasePos)
     ASSERT_EQ(vec.size(), 4);
 }
 
+TEST(IntVector, RandomAccessIterator)
+{
+    sc::vector<int> vec{5, 3, 1, 4, 2};
+
+    std::sort(vec.begin(), vec.end());
+    ASSERT_EQ(vec, (sc::vector<int>{1, 2, 3, 4, 5}));
+
+    auto it = vec.begin();
+    it += 3;
+    ASSERT_EQ(*it, 4);
+    ASSERT_EQ(it[-1], 3);
+    ASSERT_TRUE(vec.begin() < it);
+    ASSERT_TRUE(it <= vec.end());
+}
+
+#ifdef SC_VECTOR_HAS_CONCEPTS
+static_assert(std::contiguous_iterator<sc::vector<int>::iterator>, "contiguous in C++20 mode");
+static_assert(std::contiguous_iterator<sc::vector<int>::const_iterator>, "contiguous in C++20 mode");
+
+// assign(), insert() and the range constructor measure the range before copying it, which would
+// consume a single-pass source, so they only take forward iterators.
+static_assert(!std::is_constructible<sc::vector<int>, std::istream_iterator<int>, std::istream_iterator<int>>::value,
+              "single-pass ranges are rejected");
+static_assert(std::is_constructible<sc::vector<int>, std::string::iterator, std::string::iterator>::value,
+              "forward ranges are taken");
+
+TEST(IntVector, AssignCountIsNotARange)
+{
+    // Two ints are not an iterator pair, so this picks assign(count, value).
+    sc::vector<int> vec;
+    vec.assign(3, 7);
+    ASSERT_EQ(vec, (sc::vector<int>{7, 7, 7}));
+}
+#endif
+
+#ifdef SC_VECTOR_HAS_CONSTEXPR
+/// Sum of 1..n computed through a vector that only exists during constant evaluation.
+constexpr int constexpr_sum(int n)
+{
+    sc::vector<int> vec;
+    for (auto i{1}; i <= n; ++i)
+        vec.push_back(i);
+    vec.insert(vec.begin(), {0, 0});
+    vec.erase(vec.begin());
+
+    auto sum{0};
+    for (auto i{0u}; i < vec.size(); ++i)
+        sum += vec[i];
+    return sum;
+}
+
+TEST(IntVector, ConstantEvaluation)
+{
+    static_assert(constexpr_sum(10) == 55, "evaluated at compile time");
+    ASSERT_EQ(constexpr_sum(100), 5050);
+}
+#endif
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,229 @@
+#include <cstdint>
+#include <stdexcept>
+
+#include "gtest/gtest.h"        // gtest lib
+#include "../include/vector.h"  // header file for tested functions
+#include "../include/ndarray.h" // header file for tested functions
+
+// ============================================================================
+// TESTING MULTI-DIMENSIONAL ARRAYS
+// ============================================================================
+
+namespace
+{
+/// Fills `array` with 1000 * i + j (+ 1000000 * k for a leading dimension k).
+template <typename Array>
+void number(Array &array)
+{
+    for (unsigned long i = 0; i < array.extent(0); i++)
+        for (unsigned long j = 0; j < array.extent(1); j++)
+            array(i, j) = int(1000 * i + j);
+}
+} // namespace
+
+TEST(NdArray, RowMajorIndexing)
+{
+    sc::ndarray<int, 2> a({3, 4});
+    number(a);
+
+    ASSERT_EQ(a.extent(0), 3u);
+    ASSERT_EQ(a.extent(1), 4u);
+    ASSERT_EQ(a.size(), 12u);
+    ASSERT_EQ(a.data()[1 * 4 + 2], 1002);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 64, 0u);
+    ASSERT_TRUE(a.view().mapping().is_contiguous());
+}
+
+TEST(NdArray, ColumnMajorIndexing)
+{
+    sc::ndarray<int, 2, sc::layout_left> a({3, 4});
+    number(a);
+
+    ASSERT_EQ(a.data()[2 * 3 + 1], 1002);
+    ASSERT_EQ(a(2, 3), 2003);
+    ASSERT_FALSE(a.view().mapping().is_contiguous());
+}
+
+TEST(NdArray, TiledIndexing)
+{
+    sc::ndarray<int, 2, sc::layout_tiled<4>> a({6, 10});
+    number(a);
+
+    // Tiles of 4x4, three per padded row: element (5, 9) is in tile (1, 2), at (1, 1) inside it.
+    ASSERT_EQ(a.data()[(1 * 3 + 2) * 16 + 1 * 4 + 1], 5009);
+    for (unsigned long i = 0; i < 6; i++)
+        for (unsigned long j = 0; j < 10; j++)
+            ASSERT_EQ(a(i, j), int(1000 * i + j));
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 64, 0u);
+}
+
+TEST(NdArray, ViewsExistingVector)
+{
+    sc::vector<float> pixels;
+    pixels.resize(6);
+    sc::ndarray_view<float, 2> image(pixels.data(), {2, 3});
+
+    image(1, 2) = 5.0f;
+    ASSERT_EQ(pixels[5], 5.0f);
+    ASSERT_EQ(sc::sum(image), 5.0f);
+}
+
+TEST(NdArray, SlicesWithoutCopying)
+{
+    sc::ndarray<int, 2> a({6, 8});
+    number(a);
+
+    auto part = a.view().slice(0, 1, 5, 2).slice(1, 3, 8, 2);
+    ASSERT_EQ(part.extent(0), 2u);
+    ASSERT_EQ(part.extent(1), 3u);
+    ASSERT_EQ(part(0, 0), 1003);
+    ASSERT_EQ(part(1, 2), 3007);
+
+    part(1, 1) = -1;
+    ASSERT_EQ(a(3, 5), -1);
+    ASSERT_THROW(a.view().slice(1, 2, 9), std::out_of_range);
+}
+
+TEST(NdArray, SlicesTiled)
+{
+    sc::ndarray<int, 3, sc::layout_tiled<4>> a({2, 9, 9});
+    for (unsigned long k = 0; k < 2; k++)
+        for (unsigned long i = 0; i < 9; i++)
+            for (unsigned long j = 0; j < 9; j++)
+                a(k, i, j) = int(1000000 * k + 1000 * i + j);
+
+    auto part = a.view().slice(1, 3, 8).slice(2, 2, 7);
+    ASSERT_EQ(part(1, 0, 0), 1003002);
+    ASSERT_EQ(part(0, 4, 4), 7006);
+
+    auto plane = part.fix(0, 1);
+    ASSERT_EQ(plane(2, 3), 1005005);
+}
+
+TEST(NdArray, FixesDimensions)
+{
+    sc::ndarray<int, 2> a({3, 4});
+    number(a);
+
+    auto row = a.view().fix(0, 2);
+    auto column = a.view().fix(1, 1);
+    ASSERT_EQ(row.extent(0), 4u);
+    ASSERT_EQ(row(3), 2003);
+    ASSERT_EQ(column.extent(0), 3u);
+    ASSERT_EQ(column(2), 2001);
+    ASSERT_THROW(a.view().fix(0, 3), std::out_of_range);
+}
+
+TEST(NdArray, TransposedViews)
+{
+    sc::ndarray<int, 2> a({3, 5});
+    sc::ndarray<int, 2, sc::layout_tiled<4>> t({3, 5});
+    number(a);
+    number(t);
+
+    auto at = a.view().transposed();
+    auto tt = t.view().transposed();
+    ASSERT_EQ(at.extent(0), 5u);
+    ASSERT_EQ(tt.extent(0), 5u);
+    for (unsigned long i = 0; i < 5; i++)
+        for (unsigned long j = 0; j < 3; j++)
+        {
+            ASSERT_EQ(at(i, j), int(1000 * j + i));
+            ASSERT_EQ(tt(i, j), int(1000 * j + i));
+        }
+
+    // Slicing a transposed tiled view shifts the stored rows and columns it starts at.
+    auto part = tt.slice(0, 1, 5).slice(1, 1, 3);
+    ASSERT_EQ(part(0, 0), 1001);
+    ASSERT_EQ(part(3, 1), 2004);
+}
+
+TEST(NdArray, TransformsAcrossLayouts)
+{
+    sc::ndarray<float, 2> a({37, 45}, 1.5f);
+    sc::ndarray<float, 2, sc::layout_left> b({37, 45});
+    sc::ndarray<float, 2, sc::layout_tiled<8>> c({37, 45});
+    number(b);
+
+    sc::transform(c.view(), a.view(), b.view(), [](float x, float y) { return x + y; });
+    for (unsigned long i = 0; i < 37; i++)
+        for (unsigned long j = 0; j < 45; j++)
+            ASSERT_EQ(c(i, j), 1.5f + float(1000 * i + j));
+
+    // In place, through a strided slice.
+    auto odd = a.view().slice(1, 1, 45, 2);
+    sc::transform(odd, odd, [](float x) { return -x; });
+    ASSERT_EQ(a(3, 1), -1.5f);
+    ASSERT_EQ(a(3, 2), 1.5f);
+}
+
+TEST(NdArray, Reduces)
+{
+    sc::ndarray<long, 3> a({3, 20, 50});
+    sc::ndarray<long, 3, sc::layout_tiled<8>> t({3, 20, 50});
+    long expected = 0;
+    for (unsigned long k = 0; k < 3; k++)
+        for (unsigned long i = 0; i < 20; i++)
+            for (unsigned long j = 0; j < 50; j++)
+            {
+                a(k, i, j) = t(k, i, j) = long(k * 7 + i * 3 + j);
+                expected += long(k * 7 + i * 3 + j);
+            }
+
+    ASSERT_EQ(sc::sum(a), expected);
+    ASSERT_EQ(sc::sum(t), expected);
+    ASSERT_EQ(sc::sum(a.view().transposed()), expected);
+    ASSERT_EQ(sc::reduce(t, 0L, [](long x, long y) { return x > y ? x : y; }), 2 * 7 + 19 * 3 + 49);
+
+    long column = 0;
+    for (unsigned long i = 0; i < 20; i++)
+        column += long(7 + i * 3 + 4);
+    ASSERT_EQ(sc::sum(a.view().fix(0, 1).fix(1, 4)), column);
+}
+
+TEST(NdArray, CopiesAndTransposes)
+{
+    sc::ndarray<int, 2> a({19, 23});
+    sc::ndarray<int, 2, sc::layout_tiled<8>> tiled({19, 23});
+    sc::ndarray<int, 2, sc::layout_tiled<8>> tiled_t({23, 19});
+    sc::ndarray<int, 2> back({23, 19});
+    number(a);
+
+    sc::copy(tiled.view(), a.view());
+    sc::transpose(tiled_t.view(), tiled.view());
+    sc::copy(back.view(), tiled_t.view());
+    for (unsigned long i = 0; i < 23; i++)
+        for (unsigned long j = 0; j < 19; j++)
+            ASSERT_EQ(back(i, j), int(1000 * j + i));
+
+    sc::ndarray<int, 2> strided_t({23, 19});
+    sc::transpose(strided_t.view(), a.view());
+    for (unsigned long i = 0; i < 23; i++)
+        for (unsigned long j = 0; j < 19; j++)
+            ASSERT_EQ(strided_t(i, j), back(i, j));
+}
+
+TEST(NdArray, CopyAndMove)
+{
+    sc::ndarray<int, 2, sc::layout_tiled<4>> a({5, 5});
+    number(a);
+
+    sc::ndarray<int, 2, sc::layout_tiled<4>> b(a);
+    ASSERT_NE(b.data(), a.data());
+    ASSERT_EQ(b(4, 3), 4003);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(b.data()) % 64, 0u);
+
+    const int *buffer = b.data();
+    sc::ndarray<int, 2, sc::layout_tiled<4>> c(std::move(b));
+    ASSERT_EQ(c.data(), buffer);
+    ASSERT_EQ(b.size(), 0u);
+
+    a = c;
+    ASSERT_EQ(a(4, 3), 4003);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,114 @@
+// Small threshold so that the larger vectors below run on pinned worker threads.
+#define SC_VECTOR_PARALLEL_THRESHOLD 4096
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"            // gtest lib
+#include "../include/numa_vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING NUMA PARTITIONED VECTORS
+// ============================================================================
+
+TEST(NumaVector, Nodes)
+{
+    const sc::vector<unsigned> &nodes = sc::numa::nodes();
+    ASSERT_FALSE(nodes.empty());
+    for (unsigned node : nodes)
+        ASSERT_GE(sc::numa::cpus_of(node), 1u);
+}
+
+TEST(NumaVector, OnePartitionPerNodeByDefault)
+{
+    sc::numa_vector<int> vec(1000, 7);
+    ASSERT_EQ(vec.size(), 1000u);
+    ASSERT_EQ(vec.partitions(), std::min<unsigned>(1000, unsigned(sc::numa::nodes().size())));
+    for (unsigned p = 0; p < vec.partitions(); p++)
+    {
+        ASSERT_EQ(vec.node(p), sc::numa::nodes()[p]);
+#ifdef SC_VECTOR_HAS_NUMA
+        int placed = sc::numa::node_of(vec.partition_view(p).data());
+        ASSERT_TRUE(placed < 0 || placed == int(vec.node(p)));
+#endif
+    }
+    ASSERT_EQ(vec[999], 7);
+}
+
+TEST(NumaVector, SplitsIntoPartitions)
+{
+    sc::vector<long> source;
+    for (long i = 0; i < 1003; i++)
+        source.push_back(i);
+
+    sc::numa_vector<long> vec(source, 4);
+    ASSERT_EQ(vec.partitions(), 4u);
+    ASSERT_EQ(vec.chunk(), 251u);
+    ASSERT_EQ(vec.partition_view(3).size(), 250u);
+    ASSERT_EQ(vec.partition_view(1)[0], 251);
+    for (long i = 0; i < 1003; i++)
+        ASSERT_EQ(vec[i], i);
+    ASSERT_THROW(vec.at(1003), std::out_of_range);
+
+    long expected = 0;
+    for (long value : vec)
+        ASSERT_EQ(value, expected++);
+    ASSERT_EQ(expected, 1003);
+
+    // Never more partitions than elements.
+    ASSERT_EQ(sc::numa_vector<int>(3, 1, 8).partitions(), 3u);
+}
+
+TEST(NumaVector, ParallelForEachAndReduce)
+{
+    sc::numa_vector<double> vec(100000, 1.0, 3);
+    vec.for_each([](double &value) { value *= 2; });
+    ASSERT_EQ(vec.reduce(0.0, std::plus<double>()), 200000.0);
+
+    // Partials are folded in element order, so non-commutative operations work too.
+    sc::vector<std::string> letters{"a", "b", "c", "d", "e"};
+    sc::numa_vector<std::string> words(letters, 2);
+    ASSERT_EQ(words.reduce(std::string(">"), std::plus<std::string>()), ">abcde");
+
+    std::atomic<unsigned long> seen(0);
+    vec.for_each_partition([&seen](sc::vector_view<double> slice, unsigned) { seen += slice.size(); });
+    ASSERT_EQ(seen, 100000u);
+}
+
+TEST(NumaVector, WorkerExceptionsPropagate)
+{
+    sc::numa_vector<int> vec(50000, 1, 2);
+    auto fail = [](int &value) {
+        if (value == 1)
+            throw std::runtime_error("stop");
+    };
+    ASSERT_THROW(vec.for_each(fail), std::runtime_error);
+    ASSERT_EQ(vec.size(), 50000u);
+}
+
+TEST(NumaVector, CopyAndMove)
+{
+    sc::numa_vector<std::string> vec(10, "x", 3);
+    sc::numa_vector<std::string> copy(vec);
+    copy[9] = "y";
+    ASSERT_EQ(vec[9], "x");
+    ASSERT_EQ(copy.partitions(), 3u);
+
+    sc::numa_vector<std::string> moved(std::move(copy));
+    ASSERT_TRUE(copy.empty());
+    ASSERT_EQ(moved[9], "y");
+
+    vec = moved;
+    ASSERT_EQ(vec[9], "y");
+    vec = sc::numa_vector<std::string>();
+    ASSERT_TRUE(vec.empty());
+    ASSERT_TRUE(vec.begin() == vec.end());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"                 // gtest lib
+#include "../include/segmented_vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING SEGMENTED_VECTOR
+// ============================================================================
+
+TEST(SegmentedVector, DefaultChunkSizeFillsAPage)
+{
+    ASSERT_EQ((sc::segmented_vector<int>().capacity()), 0u);
+    ASSERT_EQ(sc::detail::floor_pow2(4096 / sizeof(int)), 1024u);
+    ASSERT_EQ(sc::detail::floor_pow2(4096 / 24), 128u);
+    ASSERT_EQ(sc::detail::floor_pow2(0), 1u);
+}
+
+TEST(SegmentedVector, PushBackNeverMovesElements)
+{
+    sc::segmented_vector<int, 4> vec{0};
+    std::vector<int *> addresses{&vec[0]};
+    auto first = vec.begin();
+
+    for (auto i{1}; i < 100; ++i)
+    {
+        vec.push_back(i);
+        addresses.push_back(&vec.back());
+    }
+
+    // Iterators survive the reallocations of the chunk directory too.
+    ASSERT_EQ(*first, 0);
+    ASSERT_EQ(first[99], 99);
+
+    ASSERT_EQ(vec.size(), 100);
+    ASSERT_EQ(vec.capacity(), 100);
+    for (auto i{0}; i < 100; ++i)
+    {
+        ASSERT_EQ(&vec[i], addresses[i]);
+        ASSERT_EQ(*addresses[i], i);
+    }
+}
+
+TEST(SegmentedVector, PopBackKeepsChunks)
+{
+    sc::segmented_vector<std::string, 2> vec{"a", "b", "c"};
+
+    vec.pop_back();
+    vec.pop_back();
+    ASSERT_EQ(vec.size(), 1);
+    ASSERT_EQ(vec.capacity(), 4);
+    ASSERT_EQ(vec.back(), "a");
+
+    vec.shrink_to_fit();
+    ASSERT_EQ(vec.capacity(), 2);
+    vec.clear();
+    vec.shrink_to_fit();
+    ASSERT_EQ(vec.capacity(), 0);
+    ASSERT_TRUE(vec.empty());
+}
+
+#ifdef SC_VECTOR_HAS_CONCEPTS
+static_assert(std::random_access_iterator<sc::segmented_vector<int, 8>::iterator>);
+static_assert(std::random_access_iterator<sc::segmented_vector<int, 8>::const_iterator>);
+#endif
+
+TEST(SegmentedVector, IteratorsAndAlgorithms)
+{
+    sc::segmented_vector<int, 8> vec;
+    for (auto i{0}; i < 50; ++i)
+        vec.push_back(49 - i);
+
+    ASSERT_EQ(vec.end() - vec.begin(), 50);
+    std::sort(vec.begin(), vec.end());
+    for (auto i{0u}; i < vec.size(); ++i)
+        ASSERT_EQ(vec[i], static_cast<int>(i));
+
+    const auto &cvec = vec;
+    ASSERT_EQ(*std::find(cvec.begin(), cvec.end(), 17), 17);
+    ASSERT_EQ(cvec.begin()[9], 9);
+    ASSERT_EQ(*(9 + cvec.begin()), 9);
+    ASSERT_TRUE(3 + vec.begin() == vec.begin() + 3);
+    ASSERT_EQ(sc::reduce(cvec, 0), 49 * 50 / 2);
+}
+
+TEST(SegmentedVector, Segments)
+{
+    sc::segmented_vector<int, 4> vec;
+    for (auto i{0}; i < 10; ++i)
+        vec.push_back(i);
+
+    ASSERT_EQ(vec.segment_count(), 3u);
+    ASSERT_EQ(vec.segment(0).size(), 4u);
+    ASSERT_EQ(vec.segment(2).size(), 2u);
+    ASSERT_TRUE(sc::equal(vec.segment(1), sc::vector<int>{4, 5, 6, 7}));
+
+    // Runs split at chunk boundaries and at the end of the range.
+    std::vector<unsigned long> runs;
+    sc::for_each_segment(vec.begin() + 3, vec.end() - 1, [&](sc::vector_view<int> run) {
+        runs.push_back(run.size());
+        for (auto &x : run)
+            x *= 10;
+    });
+    ASSERT_EQ(runs, (std::vector<unsigned long>{1, 4, 1}));
+    ASSERT_EQ(vec[2], 2);
+    ASSERT_EQ(vec[3], 30);
+    ASSERT_EQ(vec[8], 80);
+    ASSERT_EQ(vec[9], 9);
+}
+
+TEST(SegmentedVector, CopyAndCompare)
+{
+    sc::segmented_vector<int, 4> vec{1, 2, 3, 4, 5, 6};
+    sc::segmented_vector<int, 4> copy(vec);
+
+    ASSERT_EQ(copy, vec);
+    ASSERT_NE(&copy[0], &vec[0]);
+    copy[5] = 60;
+    ASSERT_NE(copy, vec);
+
+    copy = {7, 8};
+    ASSERT_EQ(copy.size(), 2);
+    ASSERT_EQ(copy.at(1), 8);
+    EXPECT_THROW(copy.at(2), std::out_of_range);
+}
+
+TEST(SegmentedVector, MoveTakesTheChunks)
+{
+    sc::segmented_vector<int, 4> vec{1, 2, 3, 4, 5, 6};
+    const int *first = &vec[0];
+
+    sc::segmented_vector<int, 4> moved(std::move(vec));
+    ASSERT_EQ(&moved[0], first);
+    ASSERT_EQ(moved.size(), 6);
+    ASSERT_TRUE(vec.empty());
+    ASSERT_EQ(vec.capacity(), 0);
+
+    sc::segmented_vector<int, 4> other{7, 8};
+    other = std::move(moved);
+    ASSERT_EQ(&other[0], first);
+    ASSERT_EQ(other, (sc::segmented_vector<int, 4>{1, 2, 3, 4, 5, 6}));
+    ASSERT_TRUE(moved.empty());
+
+    // A moved-from list is usable again.
+    moved.push_back(9);
+    ASSERT_EQ(moved.back(), 9);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
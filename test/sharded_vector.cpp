@@ -0,0 +1,168 @@
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"               // gtest lib
+#include "../include/sharded_vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING SHARDED VECTORS
+// ============================================================================
+
+namespace
+{
+/// Two halves that every writer keeps equal; a torn read would see them differ.
+struct pair64
+{
+    long first, second;
+};
+
+/// Runs `work(t)` on `count` threads and waits for them.
+template <typename Work>
+void run_threads(unsigned count, Work work)
+{
+    sc::vector<std::thread *> pool;
+    for (unsigned t = 0; t < count; t++)
+        pool.push_back(new std::thread(work, t));
+    for (unsigned t = 0; t < count; t++)
+    {
+        pool[t]->join();
+        delete pool[t];
+    }
+}
+} // namespace
+
+TEST(ShardedVector, Basics)
+{
+    sc::sharded_vector<int> vec(10, 3, 5);
+    ASSERT_EQ(vec.shards(), 8u); // rounded up to a power of two
+    ASSERT_EQ(vec.size(), 10u);
+    for (unsigned long i = 0; i < vec.size(); i++)
+        ASSERT_EQ(vec.load(i), 3);
+
+    vec.store(4, 40);
+    ASSERT_EQ(vec.update(4, [](int &value) { return ++value; }), 41);
+    ASSERT_EQ(vec.read(4, [](const int &value) { return value * 2; }), 82);
+
+    ASSERT_EQ(vec.push_back(7), 10u);
+    ASSERT_EQ(vec.size(), 11u);
+    ASSERT_EQ(vec.load(10), 7);
+
+    sc::vector<int> copy = vec.snapshot();
+    ASSERT_EQ(copy.size(), 11u);
+    ASSERT_EQ(copy[4], 41);
+    ASSERT_EQ(copy[10], 7);
+
+    ASSERT_GE(sc::sharded_vector<int>().shards(), 4u);
+    ASSERT_TRUE(sc::sharded_vector<int>().empty());
+}
+
+TEST(ShardedVector, GrowthKeepsTheElements)
+{
+    sc::sharded_vector<long> vec(0, 0, 4);
+    for (long i = 0; i < 10000; i++)
+        ASSERT_EQ(vec.push_back(i), static_cast<unsigned long>(i));
+    for (long i = 0; i < 10000; i++)
+        ASSERT_EQ(vec.load(i), i);
+    vec.reclaim();
+    ASSERT_EQ(vec.load(9999), 9999);
+}
+
+TEST(ShardedVector, UpdateReleasesTheLockWhenItThrows)
+{
+    sc::sharded_vector<int> vec(4, 0, 2);
+    ASSERT_THROW(vec.update(1, [](int &) -> int { throw std::runtime_error("no"); }), std::runtime_error);
+    vec.store(1, 5); // would spin forever if the shard were still held
+    ASSERT_EQ(vec.load(1), 5);
+}
+
+TEST(ShardedVector, ElementsThatAreNotTriviallyCopyable)
+{
+    sc::sharded_vector<std::string> vec(3, "a", 2);
+    vec.update(2, [](std::string &value) { value += "bc"; });
+    ASSERT_EQ(vec.load(2), "abc");
+    ASSERT_EQ(vec.read(2, [](const std::string &value) { return value.size(); }), 3u);
+    vec.push_back("d");
+    ASSERT_EQ(vec.load(3), "d");
+}
+
+TEST(ShardedVector, ConcurrentIncrementsAreNotLost)
+{
+    const unsigned threads = 4;
+    const long rounds = 20000;
+    sc::sharded_vector<long> counters(64, 0, 16);
+    run_threads(threads, [&](unsigned t) {
+        for (long r = 0; r < rounds; r++)
+            counters.update((r * 7 + t) % 64, [](long &value) { value++; });
+    });
+
+    long total = 0;
+    for (unsigned long i = 0; i < counters.size(); i++)
+        total += counters.load(i);
+    ASSERT_EQ(total, threads * rounds);
+}
+
+TEST(ShardedVector, LockFreeReadsAreNeverTorn)
+{
+    sc::sharded_vector<pair64> vec(16, pair64{0, 0}, 4);
+    std::atomic<bool> done(false);
+    std::atomic<long> torn(0);
+
+    run_threads(3, [&](unsigned t) {
+        if (t == 0)
+        {
+            // Writes, and appends so that the shards grow under the readers.
+            for (long r = 1; r <= 200000; r++)
+            {
+                vec.update(r % 16, [r](pair64 &value) {
+                    value.first = r;
+                    value.second = r;
+                });
+                if (r % 100 == 0)
+                    vec.push_back(pair64{-r, -r});
+            }
+            done = true;
+        }
+        else
+            do
+                for (unsigned long i = 0; i < vec.size(); i += 3)
+                {
+                    pair64 value = vec.load(i);
+                    torn += value.first != value.second;
+                }
+            while (!done);
+    });
+    ASSERT_EQ(torn, 0);
+    ASSERT_EQ(vec.size(), 16u + 2000u);
+}
+
+TEST(ShardedVector, SharedReadersAndWritersOfStrings)
+{
+    sc::sharded_vector<std::string> vec(8, "xx", 2);
+    std::atomic<bool> done(false);
+    std::atomic<long> bad(0);
+
+    run_threads(3, [&](unsigned t) {
+        if (t == 0)
+        {
+            for (int r = 0; r < 100000; r++)
+                vec.store(r % 8, std::string(2 + r % 5, char('a' + r % 26)));
+            done = true;
+        }
+        else
+            do
+                for (unsigned long i = 0; i < vec.size(); i++)
+                    bad += vec.read(i, [](const std::string &value) {
+                        return value.find_first_not_of(value[0]) != std::string::npos;
+                    });
+            while (!done);
+    });
+    ASSERT_EQ(bad, 0);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "gtest/gtest.h"                    // gtest lib
+#include "../include/static_search_index.h" // header file for tested functions
+
+// ============================================================================
+// TESTING THE EYTZINGER SEARCH INDEX
+// ============================================================================
+
+/// Checks every lookup on `sorted` against std::lower_bound.
+static void expect_same_as_binary_search(const sc::vector<int> &sorted, int lo, int hi)
+{
+    sc::static_search_index<int> index(sorted);
+    ASSERT_EQ(index.size(), sorted.size());
+
+    for (int key = lo; key <= hi; ++key)
+    {
+        auto expected = std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+        ASSERT_EQ(index.lower_bound(key), static_cast<unsigned long>(expected)) << "n=" << sorted.size() << " key=" << key;
+        ASSERT_EQ(index.contains(key), std::binary_search(sorted.begin(), sorted.end(), key));
+    }
+}
+
+TEST(StaticSearchIndex, EverySizeUpTo100)
+{
+    sc::vector<int> sorted;
+    for (auto n{0}; n <= 100; ++n)
+    {
+        expect_same_as_binary_search(sorted, -1, 2 * n + 1);
+        sorted.push_back(2 * n);
+    }
+}
+
+TEST(StaticSearchIndex, Duplicates)
+{
+    sc::vector<int> sorted{1, 1, 1, 3, 3, 7, 7, 7, 7, 9};
+    expect_same_as_binary_search(sorted, 0, 10);
+}
+
+TEST(StaticSearchIndex, Empty)
+{
+    sc::static_search_index<int> index;
+    ASSERT_TRUE(index.empty());
+    ASSERT_EQ(index.lower_bound(3), 0u);
+    ASSERT_FALSE(index.contains(3));
+}
+
+TEST(StaticSearchIndex, CustomOrder)
+{
+    sc::vector<int> sorted{9, 7, 5, 3, 1};
+    sc::static_search_index<int, std::greater<int>> index(sorted);
+
+    ASSERT_EQ(index.lower_bound(6), 2u);
+    ASSERT_EQ(index.lower_bound(0), 5u);
+    ASSERT_TRUE(index.contains(9));
+}
+
+TEST(StaticSearchIndex, BatchedQueries)
+{
+    std::mt19937_64 rng(42);
+    sc::vector<std::uint64_t> sorted;
+    for (auto i{0}; i < 5000; ++i)
+        sorted.push_back(rng() % 100000);
+    std::sort(sorted.data(), sorted.data() + sorted.size());
+
+    sc::static_search_index<std::uint64_t> index(sorted);
+
+    sc::vector<std::uint64_t> queries;
+    for (auto i{0}; i < 1000; ++i)
+        queries.push_back(rng() % 110000);
+    sc::vector<unsigned long> ranks;
+    ranks.assign(queries.size(), 0ul);
+    sc::vector<bool> found;
+    found.assign(queries.size(), false);
+
+    index.lower_bound(queries, ranks);
+    index.contains(queries, found);
+
+    for (auto i{0u}; i < queries.size(); ++i)
+    {
+        auto expected = std::lower_bound(sorted.begin(), sorted.end(), queries[i]) - sorted.begin();
+        ASSERT_EQ(ranks[i], static_cast<unsigned long>(expected));
+        ASSERT_EQ(index.lower_bound(queries[i]), ranks[i]);
+        ASSERT_EQ(found[i], std::binary_search(sorted.begin(), sorted.end(), queries[i]));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
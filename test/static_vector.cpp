@@ -0,0 +1,134 @@
+#include <iterator> // std::next
+
+#include "gtest/gtest.h"              // gtest lib
+#include "../include/static_vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING STATIC_VECTOR AS A CONTAINER OF INTEGERS
+// ============================================================================
+
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+/// Squares of 0..N-1, built at compile time.
+template <std::size_t N>
+constexpr sc::static_vector<int, N> squares()
+{
+    sc::static_vector<int, N> vec;
+    for (auto i = 0u; i < N; ++i)
+        vec.push_back(i * i);
+    return vec;
+}
+
+constexpr auto kSquares = squares<8>();
+static_assert(kSquares.size() == 8, "built in a constant expression");
+static_assert(kSquares[7] == 49, "built in a constant expression");
+static_assert(kSquares.back() == 49, "built in a constant expression");
+#endif
+
+TEST(StaticVector, DefaultConstructor)
+{
+    sc::static_vector<int, 10> vec;
+    EXPECT_EQ(vec.size(), 0);
+    EXPECT_EQ(vec.capacity(), 10);
+    EXPECT_TRUE(vec.empty());
+}
+
+TEST(StaticVector, ListConstructor)
+{
+    sc::static_vector<int, 10> vec{1, 2, 3, 4, 5};
+    ASSERT_EQ(vec.size(), 5);
+    EXPECT_EQ(vec.capacity(), 10);
+
+    for (auto i{0u}; i < vec.size(); ++i)
+        ASSERT_EQ(i + 1, vec[i]);
+}
+
+TEST(StaticVector, PushAndPop)
+{
+    sc::static_vector<int, 5> vec;
+
+    for (auto i{0}; i < 3; ++i)
+        vec.push_back(i + 3);
+    vec.push_front(2);
+    vec.push_front(1);
+    ASSERT_EQ(vec, (sc::static_vector<int, 5>{1, 2, 3, 4, 5}));
+
+    vec.pop_front();
+    vec.pop_back();
+    ASSERT_EQ(vec, (sc::static_vector<int, 5>{2, 3, 4}));
+}
+
+TEST(StaticVector, InsertErase)
+{
+    sc::static_vector<int, 10> vec{1, 2, 6};
+
+    vec.insert(std::next(vec.begin(), 2), {3, 4, 5});
+    ASSERT_EQ(vec, (sc::static_vector<int, 10>{1, 2, 3, 4, 5, 6}));
+
+    auto past_last = vec.erase(std::next(vec.begin(), 1), std::next(vec.begin(), 4));
+    ASSERT_EQ(std::next(vec.begin(), 1), past_last);
+    ASSERT_EQ(vec, (sc::static_vector<int, 10>{1, 5, 6}));
+}
+
+TEST(StaticVector, InsertOwnElement)
+{
+    sc::static_vector<int, 10> vec{1, 2, 3};
+    vec.insert(vec.begin(), vec[1]);
+    ASSERT_EQ(vec, (sc::static_vector<int, 10>{2, 1, 2, 3}));
+
+    sc::static_vector<int, 10> front{1, 2, 3};
+    front.push_front(front[2]);
+    ASSERT_EQ(front, (sc::static_vector<int, 10>{3, 1, 2, 3}));
+}
+
+TEST(StaticVector, AssignCountValue)
+{
+    sc::static_vector<char, 8> vec{'a', 'b', 'c', 'd', 'e'};
+
+    vec.assign(3u, 'x');
+    ASSERT_EQ(vec, (sc::static_vector<char, 8>{'x', 'x', 'x'}));
+    vec.assign(8u, 'z');
+    ASSERT_EQ(vec.size(), 8);
+    ASSERT_EQ(vec.capacity(), 8);
+}
+
+TEST(StaticVector, OverflowThrows)
+{
+    sc::static_vector<int, 3, sc::overflow_policy::throws> vec{1, 2, 3};
+
+    EXPECT_THROW(vec.push_back(4), std::length_error);
+    EXPECT_THROW(vec.insert(vec.begin(), 0), std::length_error);
+    EXPECT_THROW(vec.reserve(4), std::length_error);
+    EXPECT_THROW(vec.assign(4u, 0), std::length_error);
+    EXPECT_THROW((sc::static_vector<int, 2, sc::overflow_policy::throws>{1, 2, 3}), std::length_error);
+
+    // The contents stay untouched by a rejected insertion or assignment.
+    vec = {1, 2, 3};
+    EXPECT_THROW(vec.push_back(4), std::length_error);
+    ASSERT_EQ(vec, (sc::static_vector<int, 3, sc::overflow_policy::throws>{1, 2, 3}));
+    EXPECT_THROW(vec.assign(4u, 0), std::length_error);
+    EXPECT_THROW(vec.assign({4, 5, 6, 7}), std::length_error);
+    ASSERT_EQ(vec, (sc::static_vector<int, 3, sc::overflow_policy::throws>{1, 2, 3}));
+}
+
+#ifndef NDEBUG
+TEST(StaticVectorDeathTest, OverflowAsserts)
+{
+    sc::static_vector<int, 3, sc::overflow_policy::asserts> vec{1, 2, 3};
+
+    EXPECT_DEATH(vec.push_back(4), "capacity exceeded");
+}
+#endif
+
+TEST(StaticVector, AtChecksBounds)
+{
+    const sc::static_vector<int, 4> vec{1, 2};
+
+    ASSERT_EQ(vec.at(1), 2);
+    EXPECT_THROW(vec.at(2), std::out_of_range);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"               // gtest lib
+#include "../include/vector_builder.h" // header file for tested functions
+
+// ============================================================================
+// TESTING VECTOR_BUILDER
+// ============================================================================
+
+namespace
+{
+/// A value whose copy assignment throws while `fail` is set.
+struct fragile
+{
+    static bool fail;
+    int n = 0;
+
+    fragile() = default;
+    fragile(int value) : n(value) {}
+    fragile(const fragile &) = default;
+    fragile &operator=(const fragile &other)
+    {
+        if (fail)
+            throw std::runtime_error("copy failed");
+        n = other.n;
+        return *this;
+    }
+};
+bool fragile::fail = false;
+} // namespace
+
+TEST(VectorBuilder, ProducerAndConsumerThreads)
+{
+    sc::vector_builder<int> builder(100, 4);
+
+    std::thread producer([&] {
+        for (auto i{0}; i < 100000; ++i)
+            builder.push_back(i);
+        builder.close();
+    });
+    auto vec = builder.finish();
+    producer.join();
+
+    ASSERT_EQ(vec.size(), 100000);
+    ASSERT_EQ(vec.capacity(), 100000);
+    for (auto i{0u}; i < vec.size(); ++i)
+        ASSERT_EQ(vec[i], static_cast<int>(i));
+}
+
+TEST(VectorBuilder, PartialLastChunk)
+{
+    sc::vector_builder<std::string> builder(8, 4);
+
+    for (auto i{0}; i < 19; ++i)
+        builder.push_back(std::to_string(i));
+    builder.close();
+    auto vec = builder.finish(3);
+
+    ASSERT_EQ(vec.size(), 19);
+    ASSERT_EQ(vec.front(), "0");
+    ASSERT_EQ(vec.back(), "18");
+}
+
+TEST(VectorBuilder, EmptyStream)
+{
+    sc::vector_builder<int> builder;
+
+    builder.close();
+    ASSERT_TRUE(builder.finish().empty());
+}
+
+TEST(VectorBuilder, BackpressureOnSlowConsumer)
+{
+    sc::vector_builder<int> builder(10, 2);
+
+    std::thread producer([&] {
+        for (auto i{0}; i < 1000; ++i)
+            builder.push_back(i);
+        builder.close();
+    });
+    // Give the producer time to fill the queue before consuming anything.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto vec = builder.finish(2);
+    producer.join();
+
+    ASSERT_GT(builder.stalls(), 0u);
+    ASSERT_EQ(vec.size(), 1000);
+    ASSERT_EQ(vec[999], 999);
+}
+
+TEST(VectorBuilder, SmallestQueue)
+{
+    sc::vector_builder<int> builder(0, 0);
+
+    std::thread producer([&] {
+        for (auto i{0}; i < 500; ++i)
+            builder.push_back(i);
+        builder.close();
+    });
+    auto vec = builder.finish();
+    producer.join();
+
+    ASSERT_EQ(vec.size(), 500);
+    for (auto i{0u}; i < vec.size(); ++i)
+        ASSERT_EQ(vec[i], static_cast<int>(i));
+}
+
+TEST(VectorBuilder, FailedPushBackAddsNothing)
+{
+    sc::vector_builder<fragile> builder(4, 2);
+
+    builder.push_back(fragile(1));
+    fragile::fail = true;
+    ASSERT_THROW(builder.push_back(fragile(2)), std::runtime_error);
+    fragile::fail = false;
+    builder.push_back(fragile(3));
+    builder.close();
+    auto vec = builder.finish();
+
+    ASSERT_EQ(vec.size(), 2);
+    ASSERT_EQ(vec[0].n, 1);
+    ASSERT_EQ(vec[1].n, 3);
+}
+
+TEST(VectorBuilder, UnfinishedBuilderReleasesChunks)
+{
+    sc::vector_builder<std::string> builder(2, 8);
+
+    for (auto i{0}; i < 7; ++i)
+        builder.push_back("leak check");
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+// Small minimum so that the streaming kernels run on ranges of a few cache lines.
+#define SC_VECTOR_STREAM_MIN_BYTES 256
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"            // gtest lib
+#include "../include/vector.h"      // header file for tested functions
+#include "../include/vector_bulk.h" // header file for tested functions
+
+// ============================================================================
+// TESTING STREAMING FILL AND COPY
+// ============================================================================
+
+namespace
+{
+struct rgb
+{
+    std::uint8_t r, g, b;
+};
+
+struct pair32
+{
+    std::uint32_t first, second;
+};
+
+/// Streams from the first byte on, for the duration of a test.
+struct always_stream
+{
+    always_stream()
+    {
+        sc::bulk::set_stream_threshold(sc::bulk::kernel::fill, 0);
+        sc::bulk::set_stream_threshold(sc::bulk::kernel::copy, 0);
+    }
+    ~always_stream()
+    {
+        sc::bulk::set_stream_threshold(sc::bulk::kernel::fill, sc::bulk::NEVER);
+        sc::bulk::set_stream_threshold(sc::bulk::kernel::copy, sc::bulk::NEVER);
+    }
+};
+
+/// Fills `count` elements at every offset of a buffer and checks them and their neighbours.
+template <typename T>
+void check_fill(const T &value, const T &guard)
+{
+    for (std::size_t count : {1u, 7u, 64u, 300u, 1000u, 4099u})
+        for (std::size_t offset = 0; offset < 9; offset++)
+        {
+            sc::vector<T> buffer;
+            buffer.resize(count + 20, guard);
+            sc::bulk::fill(buffer.data() + offset, count, value);
+            for (std::size_t i = 0; i < buffer.size(); i++)
+            {
+                bool inside = i >= offset && i < offset + count;
+                ASSERT_EQ(std::memcmp(&buffer[i], inside ? &value : &guard, sizeof(T)), 0)
+                    << "count " << count << ", offset " << offset << ", element " << i;
+            }
+        }
+}
+} // namespace
+
+TEST(VectorBulk, StreamingFill)
+{
+    always_stream streaming;
+    check_fill<std::uint8_t>(0xAB, 0);
+    check_fill<std::uint16_t>(0xABCD, 0);
+    check_fill<int>(-7, 0);
+    check_fill<double>(3.25, 0);
+    check_fill<pair32>(pair32{1, 2}, pair32{0, 0});
+    check_fill<rgb>(rgb{1, 2, 3}, rgb{9, 9, 9}); // does not divide the block: cached path
+}
+
+TEST(VectorBulk, StreamingCopy)
+{
+    always_stream streaming;
+    sc::vector<std::uint8_t> source;
+    for (int i = 0; i < 10000; i++)
+        source.push_back(std::uint8_t(i * 7));
+
+    for (std::size_t count : {0u, 1u, 63u, 64u, 65u, 1000u, 9000u})
+        for (std::size_t from = 0; from < 5; from++)
+            for (std::size_t to = 0; to < 5; to++)
+            {
+                sc::vector<std::uint8_t> target;
+                target.resize(count + 10, 0xEE);
+                sc::bulk::copy(source.data() + from, count, target.data() + to);
+                for (std::size_t i = 0; i < target.size(); i++)
+                    ASSERT_EQ(target[i], i >= to && i < to + count ? source[from + i - to] : 0xEE) << i;
+            }
+}
+
+TEST(VectorBulk, VectorOperationsUseTheKernels)
+{
+    always_stream streaming;
+    sc::vector<long> vec;
+    vec.assign(std::size_t(5000), 42L);
+    ASSERT_EQ(vec[0], 42);
+    ASSERT_EQ(vec[4999], 42);
+
+    vec.resize(20000, -1);
+    ASSERT_EQ(vec[4999], 42);
+    ASSERT_EQ(vec[5000], -1);
+    ASSERT_EQ(vec[19999], -1);
+
+    sc::vector<long> copy(vec);
+    ASSERT_EQ(copy, vec);
+    vec.reserve(100000); // growth relocates through the copy kernel
+    ASSERT_EQ(copy, vec);
+
+    sc::vector<std::string> words;
+    words.assign(1000, "not trivially copyable");
+    sc::vector<std::string> other(words);
+    ASSERT_EQ(other[999], "not trivially copyable");
+}
+
+TEST(VectorBulk, Thresholds)
+{
+    sc::bulk::set_stream_threshold(sc::bulk::kernel::copy, 1 << 20);
+    ASSERT_EQ(sc::bulk::stream_threshold(sc::bulk::kernel::copy), std::size_t(1) << 20);
+    ASSERT_FALSE(sc::bulk::should_stream(sc::bulk::kernel::copy, 100)); // below SC_VECTOR_STREAM_MIN_BYTES
+    ASSERT_FALSE(sc::bulk::should_stream(sc::bulk::kernel::copy, 1 << 19));
+#ifdef SC_VECTOR_HAS_STREAMING
+    ASSERT_TRUE(sc::bulk::should_stream(sc::bulk::kernel::copy, 1 << 20));
+#endif
+
+    // A calibration returns a size between the minimum and the largest size measured, or NEVER.
+    std::size_t measured = sc::bulk::calibrate(sc::bulk::kernel::fill, 1 << 16);
+    ASSERT_TRUE(measured == sc::bulk::NEVER || (measured >= 256 && measured <= (1 << 16)));
+
+    // Buffers that cannot be allocated turn streaming off instead of throwing.
+    ASSERT_EQ(sc::bulk::calibrate(sc::bulk::kernel::copy, std::size_t(1) << 62), sc::bulk::NEVER);
+    sc::bulk::set_stream_threshold(sc::bulk::kernel::copy, sc::bulk::NEVER);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"       // gtest lib
+#include "../include/vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING LEXICOGRAPHIC ORDERING
+// ============================================================================
+
+namespace
+{
+/// Checks every relational operator of sc::vector against std::vector on the same contents.
+template <typename T>
+void expect_same_order(const std::vector<T> &a, const std::vector<T> &b)
+{
+    sc::vector<T> sa(a.begin(), a.end()), sb(b.begin(), b.end());
+    EXPECT_EQ(sa < sb, a < b);
+    EXPECT_EQ(sa > sb, a > b);
+    EXPECT_EQ(sa <= sb, a <= b);
+    EXPECT_EQ(sa >= sb, a >= b);
+    EXPECT_EQ(sa == sb, a == b);
+}
+
+/// Checks pairs of random vectors that share a prefix, then differ at one position, for lengths around the SIMD widths.
+template <typename T>
+void check_random_pairs(T low, T high)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<long long> value(static_cast<long long>(low), static_cast<long long>(high));
+    for (std::size_t n : {0u, 1u, 7u, 15u, 16u, 17u, 31u, 32u, 33u, 64u, 100u})
+        for (auto trial{0}; trial < 20; ++trial)
+        {
+            std::vector<T> a(n), b;
+            for (auto &x : a)
+                x = static_cast<T>(value(gen));
+            b = a;
+            if (n > 0 && trial % 4 != 0)
+                b[gen() % n] = static_cast<T>(value(gen));
+            if (trial % 5 == 1)
+                b.push_back(low);
+            expect_same_order(a, b);
+            expect_same_order(b, a);
+        }
+}
+} // namespace
+
+TEST(VectorCompare, UnsignedBytes)
+{
+    check_random_pairs<std::uint8_t>(0, 255);
+}
+
+TEST(VectorCompare, SignedIntegers)
+{
+    check_random_pairs<std::int8_t>(-128, 127);
+    check_random_pairs<int>(-3, 3);
+    check_random_pairs<long long>(std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max());
+    check_random_pairs<std::uint32_t>(0, 0xFFFFFFFFu);
+}
+
+TEST(VectorCompare, Prefix)
+{
+    expect_same_order<int>({1, 2, 3}, {1, 2, 3, 0});
+    expect_same_order<int>({}, {0});
+    expect_same_order<int>({}, {});
+    expect_same_order<std::uint8_t>({1, 2}, {1, 2, 0});
+}
+
+TEST(VectorCompare, FloatingPoint)
+{
+    expect_same_order<double>({0.0, 1.5, 2.0}, {-0.0, 1.5, 2.5});
+    expect_same_order<double>({1.0, 2.0}, {1.0, 2.0});
+    expect_same_order<float>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18},
+                             {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 19});
+}
+
+TEST(VectorCompare, OtherTypes)
+{
+    expect_same_order<std::string>({"apple", "pear"}, {"apple", "plum"});
+    expect_same_order<std::string>({"b"}, {"a", "z"});
+}
+
+TEST(VectorCompare, SortKeys)
+{
+    std::mt19937 gen(7);
+    sc::vector<sc::vector<std::uint8_t>> keys;
+    std::vector<std::vector<std::uint8_t>> expected;
+    for (auto i{0}; i < 1000; ++i)
+    {
+        std::vector<std::uint8_t> key(gen() % 12);
+        for (auto &b : key)
+            b = std::uint8_t(gen() % 4);
+        keys.push_back(sc::vector<std::uint8_t>(key.begin(), key.end()));
+        expected.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    // The reference order, spelled out element by element.
+    std::sort(expected.begin(), expected.end(), [](const std::vector<std::uint8_t> &a, const std::vector<std::uint8_t> &b) {
+        for (auto i{0u}; i < a.size() && i < b.size(); ++i)
+            if (a[i] != b[i])
+                return a[i] < b[i];
+        return a.size() < b.size();
+    });
+    for (auto i{0u}; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(keys[i].size(), expected[i].size()) << i;
+        ASSERT_TRUE(std::equal(keys[i].begin(), keys[i].end(), expected[i].begin())) << i;
+    }
+}
+
+#ifdef SC_VECTOR_HAS_THREE_WAY
+TEST(VectorCompare, ThreeWay)
+{
+    sc::vector<int> a{1, 2}, b{1, 3};
+    ASSERT_TRUE((a <=> b) < 0);
+    ASSERT_TRUE((b <=> a) > 0);
+    ASSERT_TRUE((a <=> a) == 0);
+
+    sc::vector<double> x{1.0, std::numeric_limits<double>::quiet_NaN()}, y{1.0, 2.0};
+    ASSERT_EQ(x <=> y, std::partial_ordering::unordered);
+}
+
+static_assert(sc::vector<int>{1, 2} < sc::vector<int>{1, 2, 0}, "constant-evaluated ordering");
+#endif
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,128 @@
+// Small threshold so that the larger vectors below take the multi-threaded path.
+#define SC_VECTOR_PARALLEL_THRESHOLD 4096
+
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"            // gtest lib
+#include "../include/vector.h"      // header file for tested functions
+#include "../include/vector_expr.h" // header file for tested functions
+
+// ============================================================================
+// TESTING LAZY ELEMENTWISE EXPRESSIONS
+// ============================================================================
+
+static_assert(not sc::detail::expr_operand<sc::vector<std::string>>::is_operand,
+              "only vectors of numbers take part in expressions");
+
+namespace
+{
+sc::vector<float> iota(unsigned long n, float start)
+{
+    sc::vector<float> vec;
+    for (unsigned long i = 0; i < n; i++)
+        vec.push_back(start + float(i));
+    return vec;
+}
+} // namespace
+
+TEST(VectorExpr, FusesArithmetic)
+{
+    sc::vector<float> a = iota(100, 0), b = iota(100, 1), c;
+    c = a * 2 + b;
+
+    ASSERT_EQ(c.size(), 100u);
+    for (auto i(0u); i < c.size(); i++)
+        ASSERT_EQ(c[i], 2 * a[i] + b[i]);
+
+    sc::vector<float> d = (a - b) / 2.0f - -a;
+    for (auto i(0u); i < d.size(); i++)
+        ASSERT_EQ(d[i], (a[i] - b[i]) / 2.0f + a[i]);
+}
+
+TEST(VectorExpr, ScalarsOnEitherSide)
+{
+    sc::vector<float> a = iota(10, 1);
+    sc::vector<float> b = 1.0f / a + 3.0f * a - 1.0f;
+    for (auto i(0u); i < b.size(); i++)
+        ASSERT_FLOAT_EQ(b[i], 1.0f / a[i] + 3.0f * a[i] - 1.0f);
+}
+
+TEST(VectorExpr, MixedElementTypes)
+{
+    sc::vector<int> counts{1, 2, 3, 4};
+    sc::vector<double> scaled = counts * 0.5;
+    ASSERT_EQ(scaled[3], 2.0);
+
+    // The result converts to the element type of the destination, as with scalar assignment.
+    sc::vector<std::uint8_t> bytes{250, 251, 252};
+    sc::vector<std::uint8_t> wrapped = bytes + 10;
+    ASSERT_EQ(wrapped[0], 4);
+}
+
+TEST(VectorExpr, AssignsToAnOperand)
+{
+    sc::vector<float> a = iota(1000, 0), b = iota(1000, 5);
+    const float *buffer = a.data();
+
+    a = a * 2 + a;
+    ASSERT_EQ(a.data(), buffer);
+    ASSERT_EQ(a[999], 3 * 999.0f);
+
+    a += b;
+    a -= 1;
+    a *= 2;
+    a /= b;
+    ASSERT_FLOAT_EQ(a[10], (30 + 15 - 1) * 2 / 15.0f);
+}
+
+TEST(VectorExpr, ResizesTheDestination)
+{
+    sc::vector<int> a{1, 2, 3}, c{9, 9, 9, 9, 9};
+    c = a + a;
+    ASSERT_EQ(c.size(), 3u);
+    ASSERT_EQ(c, (sc::vector<int>{2, 4, 6}));
+
+    sc::vector<int> empty, result{1};
+    result = empty * 2;
+    ASSERT_TRUE(result.empty());
+}
+
+TEST(VectorExpr, FusedReductions)
+{
+    sc::vector<float> a = iota(1001, 1), b = iota(1001, -500);
+
+    ASSERT_EQ(sc::sum(a), 1001.0f * 1002 / 2);
+    ASSERT_EQ(sc::sum(a - a), 0.0f);
+    ASSERT_EQ(sc::sum(sc::vector<float>()), 0.0f);
+    ASSERT_EQ(sc::min(b * 2), -1000.0f);
+    ASSERT_EQ(sc::max(-a), -1.0f);
+
+    sc::vector<long> x{1, 2, 3}, y{4, 5, 6};
+    ASSERT_EQ(sc::dot(x, y), 32);
+    ASSERT_EQ(sc::dot(x + 1, y), 47);
+}
+
+TEST(VectorExpr, LargeExpressions)
+{
+    sc::vector<double> a, b;
+    for (long i = 0; i < 100000; i++)
+    {
+        a.push_back(double(i));
+        b.push_back(double(i % 7));
+    }
+
+    sc::vector<double> c = a * b + 1.0;
+    for (long i = 0; i < 100000; i += 997)
+        ASSERT_EQ(c[i], double(i) * double(i % 7) + 1);
+
+    ASSERT_EQ(sc::sum(a), 99999.0 * 100000 / 2);
+    ASSERT_EQ(sc::max(a * b), 99994.0 * 6); // the largest i with i % 7 == 6
+    ASSERT_EQ(sc::min(b - a), -99999.0 + 99999 % 7);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
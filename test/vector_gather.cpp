@@ -0,0 +1,146 @@
+// Small thresholds so that both gather kernels and the threaded split run on small vectors.
+#define SC_VECTOR_GATHER_PREFETCH_BYTES 4096
+#define SC_VECTOR_PARALLEL_THRESHOLD 1000
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"            // gtest lib
+#include "../include/vector.h"      // header file for tested functions
+#include "../include/vector_view.h" // header file for tested functions
+
+// ============================================================================
+// TESTING GATHER, SCATTER AND PERMUTE
+// ============================================================================
+
+namespace
+{
+/// Returns `count` random indices below `bound`.
+template <typename Index>
+sc::vector<Index> random_indices(unsigned long count, unsigned long bound, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    sc::vector<Index> indices;
+    for (unsigned long i = 0; i < count; i++)
+        indices.push_back(Index(rng() % bound));
+    return indices;
+}
+
+/// Returns a random permutation of [0, count).
+sc::vector<unsigned> random_permutation(unsigned count, unsigned seed)
+{
+    sc::vector<unsigned> order;
+    for (unsigned i = 0; i < count; i++)
+        order.push_back(i);
+    std::mt19937 rng(seed);
+    for (unsigned i = count; i > 1; i--)
+        std::swap(order[i - 1], order[rng() % i]);
+    return order;
+}
+
+/// Gathers through every size pair of source and index count, on one and on several threads.
+template <typename T, typename Index>
+void check_gather()
+{
+    for (unsigned long size : {1ul, 37ul, 500ul, 5000ul}) // 500 and 5000 elements cross the prefetch threshold
+    {
+        sc::vector<T> source;
+        for (unsigned long i = 0; i < size; i++)
+            source.push_back(T(i * 3 + 1));
+        for (unsigned long count : {0ul, 3ul, 9ul, 4099ul})
+            for (unsigned threads : {1u, 0u, 3u})
+            {
+                sc::vector<Index> indices = random_indices<Index>(count, size, unsigned(count + size));
+                sc::vector<T> out;
+                out.resize(count);
+                source.gather(indices, out, threads);
+                for (unsigned long i = 0; i < count; i++)
+                    ASSERT_EQ(out[i], source[indices[i]]) << "size " << size << ", index " << i;
+            }
+    }
+}
+} // namespace
+
+TEST(VectorGather, GatherEveryKernel)
+{
+    check_gather<int, std::uint32_t>();
+    check_gather<int, long>();
+    check_gather<float, int>();
+    check_gather<long, std::uint32_t>();
+    check_gather<double, std::uint64_t>();
+    check_gather<short, unsigned>(); // no gather instruction for 2-byte elements
+    check_gather<long, std::uint16_t>();
+}
+
+TEST(VectorGather, GatherIntoViewsAndOfStrings)
+{
+    sc::vector<std::string> words{"zero", "one", "two", "three"};
+    sc::vector<unsigned> indices{3, 0, 3, 1};
+    sc::vector<std::string> out;
+    out.resize(6, "-");
+    words.gather(indices, sc::subview(out, 1, 4));
+    ASSERT_EQ(out, (sc::vector<std::string>{"-", "three", "zero", "three", "one", "-"}));
+}
+
+TEST(VectorGather, Scatter)
+{
+    sc::vector<long> target;
+    target.resize(5000, -1);
+    sc::vector<unsigned> indices = random_permutation(5000, 7);
+    indices.resize(3000); // distinct indices, so threads may write them in any order
+    sc::vector<long> values;
+    for (long i = 0; i < 3000; i++)
+        values.push_back(i);
+
+    for (unsigned threads : {1u, 0u, 4u})
+    {
+        target.assign(std::size_t(5000), -1L);
+        target.scatter(indices, values, threads);
+        long untouched = 0;
+        for (long value : target)
+            untouched += value == -1;
+        ASSERT_EQ(untouched, 2000);
+        for (unsigned long i = 0; i < indices.size(); i++)
+            ASSERT_EQ(target[indices[i]], values[i]);
+    }
+
+    // On one thread, a repeated index keeps its last value.
+    sc::vector<int> small{0, 0, 0};
+    small.scatter(sc::vector<int>{2, 0, 2}, sc::vector<int>{7, 8, 9});
+    ASSERT_EQ(small, (sc::vector<int>{8, 0, 9}));
+}
+
+TEST(VectorGather, PermuteInPlace)
+{
+    for (unsigned count : {0u, 1u, 2u, 10u, 1000u})
+    {
+        sc::vector<unsigned> order = random_permutation(count, count);
+        sc::vector<std::string> vec;
+        for (unsigned i = 0; i < count; i++)
+            vec.push_back(std::to_string(i));
+
+        sc::vector<std::string> expected = vec.permuted(order);
+        vec.permute(order);
+        ASSERT_EQ(vec, expected);
+        for (unsigned i = 0; i < count; i++)
+            ASSERT_EQ(vec[i], std::to_string(order[i]));
+    }
+
+    sc::vector<int> rotate{1, 2, 3, 4};
+    rotate.permute(sc::vector<long>{1, 2, 3, 0});
+    ASSERT_EQ(rotate, (sc::vector<int>{2, 3, 4, 1}));
+}
+
+TEST(VectorGather, PermutedMayRepeatAndDrop)
+{
+    sc::vector<double> vec{0.5, 1.5, 2.5};
+    ASSERT_EQ(vec.permuted(sc::vector<int>{2, 2, 0, 2}), (sc::vector<double>{2.5, 2.5, 0.5, 2.5}));
+    ASSERT_TRUE(vec.permuted(sc::vector<int>()).empty());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
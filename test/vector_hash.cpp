@@ -0,0 +1,157 @@
+#define SC_VECTOR_FINGERPRINT
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+#include "gtest/gtest.h"       // gtest lib
+#include "../include/vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING VECTOR HASHING AND FINGERPRINTS
+// ============================================================================
+
+TEST(VectorHash, EqualVectorsHashEqual)
+{
+    std::hash<sc::vector<int>> hash;
+    for (auto n : {0, 1, 3, 4, 5, 16, 17, 31, 32, 33, 100, 1000, 1023, 4096, 10000})
+    {
+        sc::vector<int> a, b;
+        for (auto i{0}; i < n; ++i)
+        {
+            a.push_back(i * 7);
+            b.push_back(i * 7);
+        }
+        b.reserve(b.capacity() * 2); // capacity must not matter
+        ASSERT_EQ(hash(a), hash(b)) << n;
+    }
+}
+
+TEST(VectorHash, EveryByteMatters)
+{
+    std::hash<sc::vector<std::uint8_t>> hash;
+    for (auto n : {1, 15, 16, 17, 64, 65, 127, 128, 129, 1000, 1024 + 64 + 1})
+    {
+        sc::vector<std::uint8_t> bytes;
+        bytes.assign(std::size_t(n), std::uint8_t(0));
+        auto base = hash(bytes);
+        for (auto i{0}; i < n; ++i)
+        {
+            bytes[i] = 1;
+            ASSERT_NE(hash(bytes), base) << "length " << n << ", byte " << i;
+            bytes[i] = 0;
+        }
+    }
+}
+
+TEST(VectorHash, LengthMatters)
+{
+    std::hash<sc::vector<std::uint8_t>> hash;
+    sc::vector<std::uint8_t> a, b{0};
+    ASSERT_NE(hash(a), hash(b));
+}
+
+TEST(VectorHash, NonBytewiseElements)
+{
+    sc::vector<std::string> a{"a", "bc"}, b{"ab", "c"}, c{"a", "bc"};
+    std::hash<sc::vector<std::string>> hash;
+    ASSERT_EQ(hash(a), hash(c));
+    ASSERT_NE(hash(a), hash(b));
+}
+
+TEST(VectorHash, UnorderedSetOfVectors)
+{
+    std::unordered_set<sc::vector<int>, std::hash<sc::vector<int>>> seen;
+    for (auto i{0}; i < 100; ++i)
+        seen.insert(sc::vector<int>{i % 10, i % 10 + 1});
+    ASSERT_EQ(seen.size(), 10);
+}
+
+TEST(VectorFingerprint, TrackedByPushAndPop)
+{
+    sc::vector<int> a, b;
+    ASSERT_EQ(a.fingerprint(), 0);
+    for (auto i{0}; i < 100; ++i)
+        a.push_back(i);
+    for (auto i{0}; i < 101; ++i)
+        b.push_back(i);
+    ASSERT_NE(a.fingerprint(), b.fingerprint());
+
+    b.pop_back();
+    ASSERT_EQ(a.fingerprint(), b.fingerprint());
+
+    // Recomputing from scratch gives the same value as the running sum.
+    sc::vector<int> c(a);
+    c[0] = 0;
+    ASSERT_EQ(c.fingerprint(), a.fingerprint());
+}
+
+TEST(VectorFingerprint, OrderMatters)
+{
+    sc::vector<int> a{1, 2}, b{2, 1};
+    ASSERT_NE(a.fingerprint(), b.fingerprint());
+    ASSERT_NE(a, b);
+}
+
+TEST(VectorFingerprint, WritableAccessMarksStale)
+{
+    sc::vector<int> a, b;
+    for (auto i{0}; i < 10; ++i)
+    {
+        a.push_back(i);
+        b.push_back(i);
+    }
+    a.fingerprint();
+    b.fingerprint();
+
+    a[3] = 42;
+    ASSERT_FALSE(a == b);
+    a.data()[3] = 3;
+    ASSERT_TRUE(a == b);
+    *a.begin() = 5;
+    ASSERT_NE(a.fingerprint(), b.fingerprint());
+    ASSERT_TRUE(a != b);
+
+    a.clear();
+    b.clear();
+    ASSERT_EQ(a.fingerprint(), b.fingerprint());
+    ASSERT_TRUE(a == b);
+}
+
+TEST(VectorFingerprint, CachingOrMovingKeepsEquality)
+{
+    sc::vector<int> a{1, 2, 3};
+    sc::vector<int> b;
+    b.push_back(1);
+    b.push_back(2);
+    b.push_back(3);
+    a.fingerprint();
+    ASSERT_TRUE(a == b);
+
+    sc::vector<int> moved(std::move(b));
+    ASSERT_TRUE(moved == a);
+    ASSERT_EQ(b.fingerprint(), 0);
+    ASSERT_TRUE(b == sc::vector<int>());
+}
+
+TEST(VectorFingerprint, OutstandingPointerDoesNotBreakEquality)
+{
+    sc::vector<int> c{1, 2, 3};
+    sc::vector<int> d{1, 2, 3};
+    int *p = c.data();
+    c.fingerprint();
+    d.fingerprint();
+
+    // The write through `p` does not mark c's fingerprint stale; d's write does.
+    p[1] = 7;
+    d[1] = 7;
+    d.fingerprint();
+    ASSERT_TRUE(c == d);
+    ASSERT_FALSE(c != d);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
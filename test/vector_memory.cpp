@@ -0,0 +1,154 @@
+// Small floor so that auto-shrink acts on small vectors.
+#define SC_VECTOR_SHRINK_MIN_BYTES 64UL
+
+#include <string>
+
+#include "gtest/gtest.h"       // gtest lib
+#include "../include/vector.h" // header file for tested functions
+
+// ============================================================================
+// TESTING MEMORY REPORTING AND SHRINK POLICIES
+// ============================================================================
+
+namespace
+{
+/// An element that reports a fixed amount of memory of its own.
+struct reports
+{
+    unsigned long memory_usage() const
+    {
+        return sizeof(reports) + 100;
+    }
+};
+} // namespace
+
+TEST(VectorMemory, CountsTheWholeBuffer)
+{
+    sc::vector<int> vec;
+    ASSERT_EQ(vec.memory_usage(), sizeof(vec));
+
+    vec.reserve(10);
+    vec.push_back(1);
+    ASSERT_EQ(vec.memory_usage(), sizeof(vec) + 10 * sizeof(int));
+}
+
+TEST(VectorMemory, RecursesIntoNestedContainers)
+{
+    sc::vector<sc::vector<int>> nested;
+    nested.resize(3);
+    nested[0].reserve(8);
+    nested[2].reserve(32);
+    unsigned long outer = sizeof(nested) + nested.capacity() * sizeof(sc::vector<int>);
+    ASSERT_EQ(nested.memory_usage(), outer + (8 + 32) * sizeof(int));
+
+    // A popped element keeps its buffer until its slot is reused, and is still counted.
+    nested.pop_back();
+    ASSERT_EQ(nested.memory_usage(), outer + (8 + 32) * sizeof(int));
+
+    sc::vector<reports> custom;
+    custom.resize(2);
+    ASSERT_EQ(custom.memory_usage(), sizeof(custom) + custom.capacity() * (sizeof(reports) + 100));
+}
+
+TEST(VectorMemory, CountsLongStringsOnly)
+{
+    sc::vector<std::string> words{"", std::string(200, 'x')};
+    unsigned long base = sizeof(words) + 2 * sizeof(std::string);
+    ASSERT_GE(words.memory_usage(), base + 201);
+    ASSERT_LT(words.memory_usage(), base + 201 + 64);
+
+    words[1] = "short";
+    words[1].shrink_to_fit();
+    ASSERT_EQ(words.memory_usage(), base);
+}
+
+TEST(VectorMemory, ShrinkToFitKeepsAFullBuffer)
+{
+    sc::vector<int> vec{1, 2, 3};
+    const int *data = vec.data();
+    vec.shrink_to_fit();
+    ASSERT_EQ(vec.data(), data);
+
+    vec.pop_back();
+    vec.shrink_to_fit();
+    ASSERT_NE(vec.data(), data);
+    ASSERT_EQ(vec.capacity(), 2u);
+}
+
+TEST(VectorMemory, AutoShrinkHasHysteresis)
+{
+    sc::vector<long> vec; // 8 longs fill the 64-byte floor
+    vec.set_auto_shrink(true);
+    for (long i = 0; i < 256; i++)
+        vec.push_back(i);
+    ASSERT_EQ(vec.capacity(), 256u);
+
+    // Nothing happens until fewer than a quarter of the slots are in use.
+    while (vec.size() > 64)
+        vec.pop_back();
+    ASSERT_EQ(vec.capacity(), 256u);
+    vec.pop_back();
+    ASSERT_EQ(vec.size(), 63u);
+    ASSERT_EQ(vec.capacity(), 126u);
+
+    // Twice the size is left, so refilling to the old size does not reallocate.
+    const long *data = vec.data();
+    while (vec.size() < 126)
+        vec.push_back(0);
+    ASSERT_EQ(vec.data(), data);
+    for (long i = 0; i < 63; i++)
+        ASSERT_EQ(vec[i], i);
+
+    // Never below the floor.
+    vec.clear();
+    ASSERT_EQ(vec.capacity(), 8u);
+    vec.clear();
+    ASSERT_EQ(vec.capacity(), 8u);
+}
+
+TEST(VectorMemory, AutoShrinkOnEveryRemoval)
+{
+    sc::vector<int> base;
+    for (int i = 0; i < 100; i++)
+        base.push_back(i);
+    base.shrink_to_fit();
+    base.set_auto_shrink(true);
+
+    sc::vector<int> vec(base);
+    ASSERT_TRUE(vec.auto_shrink());
+    auto it = vec.erase(vec.begin() + 10, vec.begin() + 90);
+    ASSERT_EQ(vec.capacity(), 40u);
+    ASSERT_EQ(*it, 90);
+
+    vec = base;
+    vec.resize(5);
+    ASSERT_EQ(vec.capacity(), 16u); // 64-byte floor
+
+    vec = base;
+    while (vec.size() > 24)
+        vec.pop_front();
+    ASSERT_EQ(vec.capacity(), 48u);
+    ASSERT_EQ(vec.front(), 76);
+
+    // Turning the policy on applies it at once; turning it off keeps the capacity.
+    sc::vector<int> manual(base);
+    manual.set_auto_shrink(false);
+    manual.resize(1);
+    ASSERT_EQ(manual.capacity(), 200u); // copies start at twice the size
+    manual.set_auto_shrink(true);
+    ASSERT_EQ(manual.capacity(), 16u);
+
+    // Assignment and swap keep each vector's own setting.
+    sc::vector<int> other;
+    other = base;
+    ASSERT_FALSE(other.auto_shrink());
+    other.swap(vec);
+    ASSERT_FALSE(other.auto_shrink());
+    ASSERT_TRUE(vec.auto_shrink());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,169 @@
+// Every vector of this suite takes its buffers from the pool.
+#define SC_VECTOR_POOL 1
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"            // gtest lib
+#include "../include/vector.h"      // header file for tested functions
+#include "../include/vector_pool.h" // header file for tested functions
+
+// ============================================================================
+// TESTING BUFFER RECYCLING
+// ============================================================================
+
+TEST(VectorPool, SizeClasses)
+{
+    using sc::pool::detail::class_bytes;
+    using sc::pool::detail::size_class;
+
+    ASSERT_EQ(size_class(1), 0u);
+    ASSERT_EQ(class_bytes(0), 64u);
+    for (std::size_t bytes = 1; bytes < (1 << 16); bytes += 7)
+    {
+        std::size_t capacity = class_bytes(size_class(bytes));
+        ASSERT_GE(capacity, bytes);
+        ASSERT_TRUE(bytes <= 64 || capacity * 4 < bytes * 5 + 64) << bytes; // under 25% rounding
+    }
+    ASSERT_EQ(class_bytes(size_class(1 << 20)), std::size_t(1) << 20);
+}
+
+TEST(VectorPool, SteadyStateMakesNoSystemCalls)
+{
+    sc::pool::trim();
+    auto work = []() {
+        for (int request = 0; request < 200; request++)
+        {
+            sc::vector<int> ids;
+            sc::vector<double> scores;
+            for (int i = 0; i < 100 + request % 50; i++)
+            {
+                ids.push_back(i);
+                scores.push_back(i * 0.5);
+            }
+            sc::vector<int> copy(ids);
+            ASSERT_EQ(copy.size(), ids.size());
+        }
+    };
+
+    work(); // warm-up
+    sc::pool::pool_stats before = sc::pool::thread_stats();
+    work();
+    sc::pool::pool_stats after = sc::pool::thread_stats();
+
+    ASSERT_EQ(after.misses, before.misses);
+    ASSERT_GT(after.hits, before.hits);
+    ASSERT_GT(after.hit_rate(), before.hit_rate());
+    ASSERT_GT(after.retained_bytes, 0u);
+}
+
+TEST(VectorPool, CrossThreadReturn)
+{
+    sc::pool::trim();
+    sc::vector<sc::vector<int>> batch;
+    for (int i = 0; i < 10; i++)
+        batch.push_back(sc::vector<int>{i, i + 1, i + 2});
+    sc::pool::pool_stats before = sc::pool::thread_stats();
+
+    // Another thread destroys the buffers; they go back to this thread's return stack.
+    std::thread consumer([&batch]() { batch = sc::vector<sc::vector<int>>(); });
+    consumer.join();
+
+    sc::pool::pool_stats returned = sc::pool::thread_stats();
+    ASSERT_GE(returned.remote_frees, before.remote_frees + 10);
+
+    // ...and serve the next allocations of this thread.
+    sc::vector<int> again{1, 2, 3};
+    sc::pool::pool_stats after = sc::pool::thread_stats();
+    ASSERT_EQ(after.misses, returned.misses);
+    ASSERT_EQ(again[2], 3);
+}
+
+TEST(VectorPool, ExitedThreads)
+{
+    // Buffers allocated by a thread that has exited are freed directly, and its cache is reused.
+    sc::vector<std::string> kept;
+    std::thread producer([&kept]() {
+        for (int i = 0; i < 100; i++)
+            kept.push_back(std::to_string(i));
+    });
+    producer.join();
+    ASSERT_EQ(kept[42], "42");
+    kept = sc::vector<std::string>();
+
+    std::thread next([]() {
+        sc::vector<int> vec{1, 2, 3};
+        ASSERT_EQ(vec.size(), 3u);
+    });
+    next.join();
+    ASSERT_GE(sc::pool::global_stats().misses, 1u);
+}
+
+TEST(VectorPool, TrimAndRetentionLimit)
+{
+    {
+        sc::vector<char> a, b;
+        a.resize(1000);
+        b.resize(5000);
+    }
+    ASSERT_GT(sc::pool::thread_stats().retained_bytes, 0u);
+
+    sc::pool::trim(1024);
+    ASSERT_LE(sc::pool::thread_stats().retained_bytes, 1024u);
+    sc::pool::trim();
+    ASSERT_EQ(sc::pool::thread_stats().retained_bytes, 0u);
+
+    sc::pool::set_retention_limit(0);
+    {
+        sc::vector<char> c;
+        c.resize(1000);
+    }
+    ASSERT_EQ(sc::pool::thread_stats().retained_bytes, 0u);
+    sc::pool::set_retention_limit(SC_VECTOR_POOL_RETAIN);
+}
+
+TEST(VectorPool, LargeAndOverAlignedBuffersBypassThePool)
+{
+    sc::pool::pool_stats before = sc::pool::thread_stats();
+    {
+        sc::vector<std::uint8_t> big;
+        big.resize(SC_VECTOR_POOL_MAX_BYTES + 1);
+        big[SC_VECTOR_POOL_MAX_BYTES] = 7;
+    }
+    sc::pool::pool_stats after = sc::pool::thread_stats();
+    ASSERT_EQ(after.hits + after.misses, before.hits + before.misses);
+
+    struct alignas(64) line
+    {
+        char bytes[64];
+    };
+    static_assert(not sc::pool::is_poolable<line>::value, "over-aligned elements keep using new[]");
+#ifdef __cpp_aligned_new
+    sc::vector<line> lines;
+    lines.push_back(line());
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(lines.data()) % 64, 0u);
+#endif
+}
+
+TEST(VectorPool, VectorsBehaveAsUsual)
+{
+    sc::vector<std::string> words{"a", "b"};
+    words.push_back("c");
+    sc::vector<std::string> copy = words;
+    sc::vector<std::string> moved = std::move(copy);
+    moved.resize(10, "z");
+    words = moved;
+    words = {"x"};
+
+    ASSERT_EQ(words.size(), 1u);
+    ASSERT_EQ(moved[9], "z");
+    ASSERT_TRUE(copy.empty());
+    ASSERT_TRUE(sc::vector<int>().empty());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,710 @@
+// Randomized differential testing of sc::vector against std::vector, with an instrumented element
+// type and allocation-failure injection. This suite replaces the global operator new, which is
+// why it lives in its own executable.
+//
+// SC_VECTOR_STRESS_SEED and SC_VECTOR_STRESS_OPS (environment) pick the first seed and the length
+// of the operation sequences, for longer runs than the default one.
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"       // gtest lib
+#include "../include/vector.h" // header file for tested functions
+
+// ============================================================================
+// INSTRUMENTATION
+// ============================================================================
+
+namespace
+{
+long live_blocks = 0;  // blocks currently allocated through operator new
+long fail_after = -1;  // allocations left before the next one throws; -1 never throws
+long failures = 0;     // allocations that were made to throw
+
+void *checked_new(std::size_t bytes)
+{
+    if (fail_after == 0)
+    {
+        fail_after = -1;
+        failures++;
+        throw std::bad_alloc();
+    }
+    if (fail_after > 0)
+        fail_after--;
+    void *block = std::malloc(bytes == 0 ? 1 : bytes);
+    if (block == nullptr)
+        throw std::bad_alloc();
+    live_blocks++;
+    return block;
+}
+
+void checked_delete(void *block) noexcept
+{
+    if (block == nullptr)
+        return;
+    live_blocks--;
+    std::free(block);
+}
+} // namespace
+
+void *operator new(std::size_t bytes)
+{
+    return checked_new(bytes);
+}
+
+void *operator new[](std::size_t bytes)
+{
+    return checked_new(bytes);
+}
+
+void operator delete(void *block) noexcept
+{
+    checked_delete(block);
+}
+
+void operator delete[](void *block) noexcept
+{
+    checked_delete(block);
+}
+
+void operator delete(void *block, std::size_t) noexcept
+{
+    checked_delete(block);
+}
+
+void operator delete[](void *block, std::size_t) noexcept
+{
+    checked_delete(block);
+}
+
+namespace
+{
+/// Element type that counts its special member calls and detects use after destruction.
+struct tracked
+{
+    static long constructed;  // all constructions
+    static long destroyed;    // all destructions
+    static long copies;       // copy constructions and copy assignments
+    static long moves;        // move constructions and move assignments
+    static long dead_reads;   // copies or moves from a destroyed object
+
+    static const int DEAD = -0x5EAD;
+
+    int value;
+
+    tracked() : value(0)
+    {
+        constructed++;
+    }
+
+    tracked(int v) : value(v)
+    {
+        constructed++;
+    }
+
+    tracked(const tracked &other) : value(other.read())
+    {
+        constructed++;
+        copies++;
+    }
+
+    tracked(tracked &&other) noexcept : value(other.read())
+    {
+        constructed++;
+        moves++;
+    }
+
+    tracked &operator=(const tracked &other)
+    {
+        value = other.read();
+        copies++;
+        return *this;
+    }
+
+    tracked &operator=(tracked &&other) noexcept
+    {
+        value = other.read();
+        moves++;
+        return *this;
+    }
+
+    ~tracked()
+    {
+        value = DEAD;
+        destroyed++;
+    }
+
+    int read() const
+    {
+        if (value == DEAD)
+            dead_reads++;
+        return value;
+    }
+
+    static long live()
+    {
+        return constructed - destroyed;
+    }
+
+    friend bool operator==(const tracked &lhs, const tracked &rhs)
+    {
+        return lhs.value == rhs.value;
+    }
+
+    friend bool operator!=(const tracked &lhs, const tracked &rhs)
+    {
+        return lhs.value != rhs.value;
+    }
+};
+
+long tracked::constructed = 0;
+long tracked::destroyed = 0;
+long tracked::copies = 0;
+long tracked::moves = 0;
+long tracked::dead_reads = 0;
+
+/// Reads a positive number from the environment, or returns `fallback`.
+unsigned long env_or(const char *name, unsigned long fallback)
+{
+    const char *text = std::getenv(name);
+    return text == nullptr ? fallback : std::strtoul(text, nullptr, 10);
+}
+
+/// Makes element values of each tested type from random numbers.
+template <typename T>
+T make(std::uint32_t n)
+{
+    return T(int(n % 1000));
+}
+
+template <>
+std::string make<std::string>(std::uint32_t n)
+{
+    // Long enough to live on the heap for some of the values.
+    return n % 3 == 0 ? std::string(20 + n % 20, char('a' + n % 26)) : std::to_string(n % 1000);
+}
+
+template <typename T>
+::testing::AssertionResult same(const sc::vector<T> &vec, const std::vector<T> &model)
+{
+    if (vec.size() != model.size())
+        return ::testing::AssertionFailure() << "size " << vec.size() << ", expected " << model.size();
+    if (vec.capacity() < vec.size())
+        return ::testing::AssertionFailure() << "capacity " << vec.capacity() << " below size " << vec.size();
+    for (std::size_t i = 0; i < model.size(); i++)
+        if (!(vec[i] == model[i]))
+            return ::testing::AssertionFailure() << "element " << i << " differs";
+    return ::testing::AssertionSuccess();
+}
+
+/// Applies `ops` random operations to an sc::vector and a std::vector and compares them after each one.
+template <typename T>
+void run_differential(std::uint32_t seed, unsigned long ops)
+{
+    std::mt19937 rng(seed);
+    sc::vector<T> vec, other;
+    std::vector<T> model, other_model;
+
+    for (unsigned long step = 0; step < ops; step++)
+    {
+        std::uint32_t r = rng();
+        std::size_t n = model.size();
+        std::size_t pos = n == 0 ? 0 : rng() % (n + 1);
+        T value = make<T>(rng());
+        unsigned op = r % 20;
+        SCOPED_TRACE(::testing::Message() << "seed " << seed << ", step " << step << ", op " << op);
+
+        switch (op)
+        {
+        case 0:
+        case 1:
+        case 2:
+            vec.push_back(value);
+            model.push_back(value);
+            break;
+        case 3:
+            if (n > 0)
+            {
+                // The argument is an element of the vector itself and growth may reallocate.
+                vec.push_back(vec[pos % n]);
+                model.push_back(T(model[pos % n]));
+            }
+            break;
+        case 4:
+            if (n > 0)
+            {
+                vec.pop_back();
+                model.pop_back();
+            }
+            break;
+        case 5:
+            vec.push_front(value);
+            model.insert(model.begin(), value);
+            break;
+        case 6:
+            if (n > 0)
+            {
+                vec.pop_front();
+                model.erase(model.begin());
+            }
+            break;
+        case 7:
+            vec.insert(vec.begin() + pos, value);
+            model.insert(model.begin() + pos, value);
+            break;
+        case 8:
+        {
+            std::vector<T> range(rng() % 8, value);
+            vec.insert(vec.begin() + pos, range.begin(), range.end());
+            model.insert(model.begin() + pos, range.begin(), range.end());
+            break;
+        }
+        case 9:
+            vec.insert(vec.begin() + pos, {value, make<T>(r), value});
+            model.insert(model.begin() + pos, {value, make<T>(r), value});
+            break;
+        case 10:
+            if (pos < n)
+            {
+                vec.erase(vec.begin() + pos);
+                model.erase(model.begin() + pos);
+            }
+            break;
+        case 11:
+        {
+            std::size_t last = pos + (n - pos) / 2;
+            vec.erase(vec.begin() + pos, vec.begin() + last);
+            model.erase(model.begin() + pos, model.begin() + last);
+            break;
+        }
+        case 12:
+        {
+            std::size_t count = rng() % (2 * n + 10);
+            vec.resize(count, value);
+            model.resize(count, value);
+            break;
+        }
+        case 13:
+            vec.reserve(rng() % (2 * n + 10));
+            break;
+        case 14:
+            vec.shrink_to_fit();
+            break;
+        case 15:
+            if (r % 7 == 0)
+            {
+                vec.clear();
+                model.clear();
+            }
+            else if (n > 0)
+            {
+                vec[pos % n] = value;
+                model[pos % n] = value;
+            }
+            break;
+        case 16:
+        {
+            std::size_t count = rng() % 16;
+            if (r % 2)
+            {
+                vec.assign(count, value);
+                model.assign(count, value);
+            }
+            else
+            {
+                vec.assign(other_model.begin(), other_model.end());
+                model = other_model;
+            }
+            break;
+        }
+        case 17:
+            vec.swap(other);
+            model.swap(other_model);
+            break;
+        case 18:
+            other = vec;
+            other_model = model;
+            break;
+        case 19:
+            if (r % 2)
+            {
+                sc::vector<T> moved(std::move(vec));
+                vec = sc::vector<T>(moved.begin(), moved.end());
+            }
+            else
+            {
+                other = std::move(vec);
+                other_model = std::move(model);
+                vec = sc::vector<T>();
+                model.clear();
+            }
+            break;
+        }
+
+        ASSERT_TRUE(same(vec, model));
+        ASSERT_TRUE(same(other, other_model));
+    }
+}
+} // namespace
+
+// ============================================================================
+// DIFFERENTIAL FUZZING AGAINST std::vector
+// ============================================================================
+
+TEST(VectorStress, DifferentialInts)
+{
+    std::uint32_t first = std::uint32_t(env_or("SC_VECTOR_STRESS_SEED", 1));
+    unsigned long ops = env_or("SC_VECTOR_STRESS_OPS", 3000);
+    for (std::uint32_t seed = first; seed < first + 10; seed++)
+        ASSERT_NO_FATAL_FAILURE(run_differential<int>(seed, ops));
+}
+
+TEST(VectorStress, DifferentialStrings)
+{
+    std::uint32_t first = std::uint32_t(env_or("SC_VECTOR_STRESS_SEED", 1));
+    unsigned long ops = env_or("SC_VECTOR_STRESS_OPS", 3000);
+    for (std::uint32_t seed = first; seed < first + 10; seed++)
+        ASSERT_NO_FATAL_FAILURE(run_differential<std::string>(seed, ops));
+}
+
+TEST(VectorStress, DifferentialTrackedElements)
+{
+    std::uint32_t first = std::uint32_t(env_or("SC_VECTOR_STRESS_SEED", 1));
+    unsigned long ops = env_or("SC_VECTOR_STRESS_OPS", 3000);
+    long live = tracked::live(), blocks = live_blocks;
+    for (std::uint32_t seed = first; seed < first + 10; seed++)
+        ASSERT_NO_FATAL_FAILURE(run_differential<tracked>(seed, ops));
+
+    // Every element and every buffer created by the runs is gone, and no destroyed element was read.
+    ASSERT_EQ(tracked::live(), live);
+    ASSERT_EQ(live_blocks, blocks);
+    ASSERT_EQ(tracked::dead_reads, 0);
+}
+
+TEST(VectorStress, LargeSizes)
+{
+    const std::size_t n = 1 << 21;
+    sc::vector<std::uint64_t> vec;
+    std::vector<std::uint64_t> model;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        vec.push_back(i * 0x9E3779B97F4A7C15ull);
+        model.push_back(i * 0x9E3779B97F4A7C15ull);
+    }
+    ASSERT_TRUE(same(vec, model));
+
+    vec.erase(vec.begin() + 1000, vec.begin() + n / 2);
+    model.erase(model.begin() + 1000, model.begin() + n / 2);
+    vec.resize(n + 12345, 7);
+    model.resize(n + 12345, 7);
+    ASSERT_TRUE(same(vec, model));
+
+    sc::vector<sc::vector<std::string>> nested;
+    for (int i = 0; i < 2000; i++)
+    {
+        nested.push_back(sc::vector<std::string>());
+        for (int j = 0; j < i % 17; j++)
+            nested.back().push_back(std::to_string(i * j));
+    }
+    sc::vector<sc::vector<std::string>> copy(nested);
+    nested.erase(nested.begin(), nested.begin() + 1000);
+    ASSERT_EQ(copy[1988].size(), 16u);
+    ASSERT_EQ(copy[1988][15], std::to_string(1988 * 15));
+    ASSERT_EQ(nested[988][15], std::to_string(1988 * 15));
+}
+
+// ============================================================================
+// ALLOCATION-FAILURE INJECTION
+// ============================================================================
+
+namespace
+{
+/// Runs `op` on copies of `start`, making its first, second, ... allocation throw, and checks that
+/// every failed attempt left the vector exactly as it was and leaked nothing. Returns the number of
+/// allocations the successful attempt needed.
+template <typename Op>
+long sweep_failures(const sc::vector<tracked> &start, Op op)
+{
+    for (long k = 0;; k++)
+    {
+        sc::vector<tracked> vec; // same capacity as `start`, which a copy would not keep
+        vec.reserve(start.capacity());
+        for (const tracked &element : start)
+            vec.push_back(element);
+        const tracked *buffer = vec.data();
+        std::size_t capacity = vec.capacity();
+        long live = tracked::live(), blocks = live_blocks, failed = failures;
+
+        fail_after = k;
+        try
+        {
+            op(vec);
+        }
+        catch (const std::bad_alloc &)
+        {
+        }
+        fail_after = -1;
+        if (failures == failed)
+            return k; // the operation needed fewer than k + 1 allocations and succeeded
+
+        // Strong guarantee: same elements, same buffer, nothing leaked.
+        EXPECT_EQ(vec, start) << "after failing allocation " << k;
+        EXPECT_EQ(vec.data(), buffer);
+        EXPECT_EQ(vec.capacity(), capacity);
+        EXPECT_EQ(tracked::live(), live);
+        EXPECT_EQ(live_blocks, blocks);
+    }
+}
+} // namespace
+
+TEST(VectorStress, GrowthHasTheStrongGuaranteeOnAllocationFailure)
+{
+    sc::vector<tracked> full;
+    for (int i = 0; i < 8; i++)
+        full.push_back(tracked(i));
+    full.shrink_to_fit();
+    ASSERT_EQ(full.capacity(), full.size());
+
+    long dead_reads = tracked::dead_reads;
+    ASSERT_EQ(sweep_failures(full, [](sc::vector<tracked> &vec) { vec.push_back(tracked(100)); }), 1);
+    ASSERT_EQ(sweep_failures(full, [](sc::vector<tracked> &vec) { vec.push_back(vec[3]); }), 1);
+    ASSERT_EQ(sweep_failures(full, [](sc::vector<tracked> &vec) { vec.push_front(tracked(100)); }), 1);
+    ASSERT_EQ(sweep_failures(full, [](sc::vector<tracked> &vec) { vec.insert(vec.begin() + 4, tracked(1)); }), 1);
+    ASSERT_EQ(sweep_failures(full, [](sc::vector<tracked> &vec) { vec.insert(vec.begin() + 2, {1, 2, 3}); }), 1);
+    ASSERT_EQ(sweep_failures(full, [](sc::vector<tracked> &vec) { vec.reserve(100); }), 1);
+    ASSERT_EQ(sweep_failures(full, [](sc::vector<tracked> &vec) { vec.resize(20, tracked(5)); }), 1);
+    ASSERT_EQ(sweep_failures(full, [](sc::vector<tracked> &vec) { vec.assign(30, tracked(5)); }), 1);
+
+    sc::vector<tracked> roomy(full);
+    roomy.reserve(64);
+    ASSERT_EQ(sweep_failures(roomy, [](sc::vector<tracked> &vec) { vec.shrink_to_fit(); }), 1);
+    ASSERT_EQ(sweep_failures(roomy, [&full](sc::vector<tracked> &vec) { vec = full; }), 1);
+    ASSERT_EQ(tracked::dead_reads, dead_reads);
+}
+
+TEST(VectorStress, CountsCopiesAndMoves)
+{
+    sc::vector<tracked> vec;
+    vec.reserve(4);
+    long copies = tracked::copies;
+    for (int i = 0; i < 4; i++)
+        vec.push_back(tracked(i));
+    // Without growth, push_back copies each element once into its slot.
+    ASSERT_EQ(tracked::copies - copies, 4);
+
+    long live = tracked::live();
+    {
+        sc::vector<tracked> copy(vec);
+        ASSERT_GE(tracked::live(), live + 4);
+    }
+    ASSERT_EQ(tracked::live(), live);
+}
+
+// ============================================================================
+// EXCEPTION SAFETY OF ELEMENT COPIES
+// ============================================================================
+
+namespace
+{
+long copies_left = -1; // copies of a `fragile` left before the next one throws; -1 never throws
+
+/// Element whose copies throw on demand; moves cannot throw when NothrowMove is true.
+template <bool NothrowMove>
+struct fragile
+{
+    std::string text; // a heap allocation, so leaks show up in live_blocks
+
+    fragile() = default;
+
+    fragile(int n) : text(40, char('a' + n % 26))
+    {
+    }
+
+    fragile(const fragile &other) : text(copy(other))
+    {
+    }
+
+    fragile(fragile &&other) noexcept(NothrowMove) : text(std::move(other.text))
+    {
+    }
+
+    fragile &operator=(const fragile &other)
+    {
+        text = copy(other);
+        return *this;
+    }
+
+    fragile &operator=(fragile &&other) noexcept(NothrowMove)
+    {
+        text = std::move(other.text);
+        return *this;
+    }
+
+    static std::string copy(const fragile &other)
+    {
+        if (copies_left == 0)
+        {
+            copies_left = -1;
+            throw std::runtime_error("copy failed");
+        }
+        if (copies_left > 0)
+            copies_left--;
+        return other.text;
+    }
+
+    friend bool operator==(const fragile &lhs, const fragile &rhs)
+    {
+        return lhs.text == rhs.text;
+    }
+
+    friend bool operator!=(const fragile &lhs, const fragile &rhs)
+    {
+        return lhs.text != rhs.text;
+    }
+};
+
+/// Runs `op` on a full vector of `fragile` elements, making its first, second, ... element copy
+/// throw, and checks that each failed attempt left the vector unchanged and leaked nothing.
+/// Returns the number of copies the successful attempt made.
+template <typename T, typename Op>
+long sweep_copy_failures(Op op)
+{
+    for (long k = 0;; k++)
+    {
+        sc::vector<T> vec;
+        vec.reserve(8);
+        for (int i = 0; i < 8; i++)
+            vec.push_back(T(i));
+        sc::vector<T> start(vec);
+        const T *buffer = vec.data();
+        long blocks = live_blocks;
+
+        copies_left = k;
+        bool threw = false;
+        try
+        {
+            op(vec);
+        }
+        catch (const std::runtime_error &)
+        {
+            threw = true;
+        }
+        copies_left = -1;
+        if (!threw)
+            return k;
+
+        EXPECT_EQ(vec, start) << "after failing copy " << k;
+        EXPECT_EQ(vec.data(), buffer);
+        EXPECT_EQ(vec.capacity(), 8u);
+        EXPECT_EQ(live_blocks, blocks);
+    }
+}
+} // namespace
+
+TEST(VectorStress, GrowthMovesNothrowMovableElements)
+{
+    sc::vector<tracked> vec;
+    for (int i = 0; i < 8; i++)
+        vec.push_back(tracked(i));
+    vec.shrink_to_fit();
+
+    long copies = tracked::copies, moves = tracked::moves;
+    vec.reserve(100);
+    ASSERT_EQ(tracked::copies, copies);
+    ASSERT_EQ(tracked::moves - moves, 8);
+
+    // Inserting in the middle of a full vector moves every element once, straight to its new place.
+    vec.shrink_to_fit();
+    moves = tracked::moves;
+    vec.insert(vec.begin() + 3, tracked(42));
+    ASSERT_EQ(tracked::moves - moves, 8 + 1);
+    ASSERT_EQ(vec[3].value, 42);
+    ASSERT_EQ(vec[8].value, 7);
+}
+
+TEST(VectorStress, GrowthHasTheStrongGuaranteeWhenCopiesThrow)
+{
+    typedef fragile<false> copied; // its move may throw, so growth has to copy
+
+    // Growth copies all 8 elements (and the new one), and any of those copies may fail.
+    ASSERT_EQ(sweep_copy_failures<copied>([](sc::vector<copied> &vec) { vec.reserve(20); }), 8);
+    ASSERT_GE(sweep_copy_failures<copied>([](sc::vector<copied> &vec) { vec.push_back(copied(9)); }), 9);
+    ASSERT_GE(sweep_copy_failures<copied>([](sc::vector<copied> &vec) { vec.insert(vec.begin() + 2, copied(9)); }), 9);
+    ASSERT_GE(sweep_copy_failures<copied>([](sc::vector<copied> &vec) {
+                  copied source[3] = {copied(9), copied(10), copied(11)};
+                  vec.insert(vec.begin() + 2, source, source + 3);
+              }),
+              11);
+    ASSERT_GE(sweep_copy_failures<copied>([](sc::vector<copied> &vec) {
+                  vec.insert(vec.begin() + 2, {copied(9), copied(10), copied(11)});
+              }),
+              11);
+    ASSERT_GE(sweep_copy_failures<copied>([](sc::vector<copied> &vec) { vec.assign(12, copied(9)); }), 12);
+    ASSERT_GE(sweep_copy_failures<copied>([](sc::vector<copied> &vec) {
+                  sc::vector<copied> source(vec);
+                  vec = source;
+              }),
+              16);
+
+    // With a noexcept move, growth copies nothing: only the new element is copied.
+    typedef fragile<true> moved;
+    ASSERT_EQ(sweep_copy_failures<moved>([](sc::vector<moved> &vec) { vec.reserve(20); }), 0);
+    ASSERT_EQ(sweep_copy_failures<moved>([](sc::vector<moved> &vec) { vec.push_back(moved(9)); }), 1);
+    ASSERT_EQ(sweep_copy_failures<moved>([](sc::vector<moved> &vec) {
+                  moved source[3] = {moved(9), moved(10), moved(11)};
+                  vec.insert(vec.begin() + 2, source, source + 3);
+              }),
+              3);
+}
+
+TEST(VectorStress, InPlaceRangeInsertIsUndoneWhenCopiesThrow)
+{
+    typedef fragile<true> moved;
+    sc::vector<moved> vec;
+    vec.reserve(16);
+    for (int i = 0; i < 8; i++)
+        vec.push_back(moved(i));
+    sc::vector<moved> start(vec);
+    moved source[3] = {moved(9), moved(10), moved(11)};
+
+    for (long k = 0; k < 3; k++)
+    {
+        long blocks = live_blocks;
+        copies_left = k;
+        ASSERT_THROW(vec.insert(vec.begin() + 2, source, source + 3), std::runtime_error);
+        copies_left = k + 3; // building the list copies the source first
+        ASSERT_THROW(vec.insert(vec.begin() + 2, {source[0], source[1], source[2]}), std::runtime_error);
+        ASSERT_EQ(vec, start);
+        ASSERT_EQ(live_blocks, blocks);
+    }
+    vec.insert(vec.begin() + 2, source, source + 3);
+    ASSERT_EQ(vec.size(), 11u);
+    ASSERT_EQ(vec[4], source[2]);
+    ASSERT_EQ(vec[5], start[2]);
+}
+
+TEST(VectorStress, ConstructorsReleaseTheirBufferWhenCopiesThrow)
+{
+    sc::vector<fragile<true>> source;
+    for (int i = 0; i < 10; i++)
+        source.push_back(fragile<true>(i));
+
+    long blocks = live_blocks;
+    copies_left = 5;
+    ASSERT_THROW(sc::vector<fragile<true>> copy(source), std::runtime_error);
+    copies_left = 3;
+    ASSERT_THROW(sc::vector<fragile<true>> range(source.begin(), source.end()), std::runtime_error);
+    copies_left = -1;
+    ASSERT_EQ(live_blocks, blocks);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,165 @@
+#include <vector>
+
+#include "gtest/gtest.h"              // gtest lib
+#include "../include/vector.h"        // header file for tested functions
+#include "../include/static_vector.h" // header file for tested functions
+#include "../include/vector_view.h"   // header file for tested functions
+
+#ifdef __cpp_lib_span
+#include <span>
+#endif
+
+// ============================================================================
+// TESTING NON-OWNING VIEWS
+// ============================================================================
+
+TEST(VectorView, ViewsWithoutCopying)
+{
+    sc::vector<int> vec{1, 2, 3, 4, 5};
+    sc::vector_view<int> view(vec);
+
+    ASSERT_EQ(view.size(), 5);
+    ASSERT_EQ(view.data(), vec.data());
+
+    // Writes through the view land in the vector.
+    view[2] = 30;
+    ASSERT_EQ(vec[2], 30);
+}
+
+TEST(VectorView, FromOtherContainers)
+{
+    const sc::vector<int> vec{1, 2, 3};
+    sc::static_vector<int, 4> svec{4, 5};
+    std::vector<int> svec2{6};
+
+    sc::vector_view<const int> a(vec);
+    sc::vector_view<int> b(svec);
+    sc::vector_view<const int> c = b;
+    auto d = sc::view(svec2);
+
+    ASSERT_EQ(a.back(), 3);
+    ASSERT_EQ(c.front(), 4);
+    ASSERT_EQ(d.size(), 1);
+    ASSERT_EQ(d[0], 6);
+}
+
+TEST(VectorView, Subview)
+{
+    sc::vector<int> vec{1, 2, 3, 4, 5, 6};
+    auto view = sc::subview(vec, 1, 3);
+
+    ASSERT_EQ(view.size(), 3);
+    ASSERT_EQ(view.data(), vec.data() + 1);
+    ASSERT_TRUE(sc::equal(view, sc::vector<int>{2, 3, 4}));
+
+    // Lengths are clamped to the end of the parent view.
+    ASSERT_EQ(view.subview(2, 10).size(), 1);
+    ASSERT_TRUE(sc::equal(view.first(2), sc::vector<int>{2, 3}));
+    ASSERT_TRUE(sc::equal(view.last(2), sc::vector<int>{3, 4}));
+    ASSERT_TRUE(view.subview(3).empty());
+    EXPECT_THROW(view.subview(4), std::out_of_range);
+}
+
+TEST(VectorView, Strided)
+{
+    // A 3x3 row-major matrix.
+    sc::vector<int> mat{1, 2, 3,
+                        4, 5, 6,
+                        7, 8, 9};
+
+    auto column = sc::view(mat).subview(1).strided(3);
+    ASSERT_EQ(column.size(), 3);
+    ASSERT_TRUE(sc::equal(column, sc::vector<int>{2, 5, 8}));
+    ASSERT_EQ(column[2], 8);
+    ASSERT_EQ(column.end() - column.begin(), 3);
+
+    auto diagonal = sc::view(mat).strided(4);
+    ASSERT_EQ(sc::reduce(diagonal, 0), 15);
+    ASSERT_TRUE(sc::equal(diagonal.subview(1), sc::vector<int>{5, 9}));
+}
+
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+/// Sum of every fourth of 0..9 (0 + 4 + 8), walked up to end() in a constant expression. Stepping a
+/// pointer by 4 from the 8 would land two elements past the array, which is undefined.
+constexpr int every_fourth_sum()
+{
+    int data[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    sc::strided_view<int> view(data, 3, 4);
+    int sum = 0;
+    for (auto it = view.begin(); it != view.end(); ++it)
+        sum += *it;
+    return sum + int(view.subview(3).size());
+}
+static_assert(every_fourth_sum() == 12, "strided iteration stays inside the array");
+#endif
+
+TEST(VectorView, StridedEndStaysInsideTheArray)
+{
+    sc::vector<int> vec{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto every_fourth = sc::view(vec).strided(4);
+
+    ASSERT_EQ(every_fourth.size(), 3);
+    ASSERT_TRUE(sc::equal(every_fourth, sc::vector<int>{0, 4, 8}));
+    ASSERT_EQ(every_fourth.end() - every_fourth.begin(), 3);
+    ASSERT_EQ(*(every_fourth.end() - 1), 8);
+    ASSERT_EQ(every_fourth.begin()[2], 8);
+    ASSERT_TRUE(every_fourth.subview(3).empty());
+    ASSERT_TRUE(every_fourth.subview(3).begin() == every_fourth.subview(3).end());
+}
+
+TEST(VectorView, Chunked)
+{
+    sc::vector<int> vec{1, 2, 3, 4, 5, 6, 7};
+    auto chunks = sc::view(vec).chunks(3);
+
+    ASSERT_EQ(chunks.size(), 3);
+    ASSERT_TRUE(sc::equal(chunks[2], sc::vector<int>{7}));
+
+    sc::vector<int> sums;
+    for (auto chunk : chunks)
+        sums.push_back(sc::reduce(chunk, 0));
+    ASSERT_EQ(sums, (sc::vector<int>{6, 15, 7}));
+}
+
+TEST(VectorView, Algorithms)
+{
+    sc::vector<int> vec{4, 8, 15, 16, 23, 42};
+    auto view = sc::view(vec);
+
+    ASSERT_EQ(sc::reduce(view, 0), 108);
+    ASSERT_EQ(sc::reduce(view.first(3), 1, [](int a, int b) { return a * b; }), 480);
+    ASSERT_EQ(sc::find(view, 16) - view.begin(), 3);
+    ASSERT_EQ(sc::find(view, 17), view.end());
+    ASSERT_EQ(*sc::find_if(vec, [](int x) { return x > 20; }), 23);
+
+    ASSERT_EQ(sc::compare(view.first(2), view.first(3)), -1);
+    ASSERT_EQ(sc::compare(view, vec), 0);
+    ASSERT_EQ(sc::compare(view.last(1), view.first(1)), 1);
+    ASSERT_FALSE(sc::equal(view, view.first(5)));
+}
+
+#ifdef SC_VECTOR_HAS_CONCEPTS
+TEST(VectorView, SpanInterop)
+{
+    sc::vector<int> vec{1, 2, 3, 4};
+
+    std::span<int> whole = vec;
+    std::span<int> part = sc::view(vec).subview(1, 2);
+    std::span<const int> cpart = sc::vector_view<const int>(vec).last(1);
+
+    ASSERT_EQ(whole.size(), 4u);
+    ASSERT_EQ(part.data(), vec.data() + 1);
+    ASSERT_EQ(part.size(), 2u);
+    ASSERT_EQ(cpart[0], 4);
+
+    sc::vector_view<int> back(part.data(), part.size());
+    ASSERT_EQ(back[1], 3);
+    static_assert(std::ranges::view<sc::vector_view<int>>, "vector_view models std::ranges::view");
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}